@@ -178,6 +178,52 @@ static void print_results(benchmark_result_t *results, int count, const char *ti
     printf("\nMOPS = Million operations per second (2n^3 ops for nxn matrix multiply)\n");
 }
 
+/* Hardware counters per tropical operation for max-plus multiplication */
+static void print_counters(palma_profiler_t *prof, const size_t *sizes, int count) {
+    printf("\n=== Hardware Counters (max-plus multiply, per n^3 operations) ===\n");
+    if (!prof) {
+        printf("Not available (needs Linux perf events; see perf_event_paranoid)\n");
+        return;
+    }
+    printf("%-6s | %8s | %8s | %10s | %10s | %10s\n",
+           "Size", "Cycles", "IPC", "L1D miss", "LLC miss", "Br. miss");
+    printf("-------+----------+----------+------------+------------+-----------\n");
+    
+    for (int i = 0; i < count; i++) {
+        size_t n = sizes[i];
+        palma_matrix_t *A = palma_matrix_create(n, n);
+        palma_matrix_t *C = palma_matrix_create(n, n);
+        if (!A || !C) {
+            palma_matrix_destroy(A);
+            palma_matrix_destroy(C);
+            continue;
+        }
+        fill_random(A, PALMA_MAXPLUS);
+        
+        int iters = n >= 512 ? 3 : (n >= 256 ? 10 : 100);
+        palma_matrix_mul_into(C, A, A, PALMA_MAXPLUS);     /* Warm up */
+        
+        palma_profile_t p;
+        palma_profile_begin(prof);
+        for (int it = 0; it < iters; it++) {
+            palma_matrix_mul_into(C, A, A, PALMA_MAXPLUS);
+        }
+        palma_profile_end(prof, (double)n * n * n * iters, &p);
+        
+        double cycles = palma_profile_per_op(&p, PALMA_COUNTER_CYCLES);
+        double instr = palma_profile_per_op(&p, PALMA_COUNTER_INSTRUCTIONS);
+        printf("%-6zu | %8.3f | %8.2f | %10.5f | %10.5f | %10.5f\n", n, cycles,
+               cycles > 0 && instr >= 0 ? instr / cycles : -1.0,
+               palma_profile_per_op(&p, PALMA_COUNTER_L1D_MISSES),
+               palma_profile_per_op(&p, PALMA_COUNTER_LLC_MISSES),
+               palma_profile_per_op(&p, PALMA_COUNTER_BRANCH_MISSES));
+        
+        palma_matrix_destroy(A);
+        palma_matrix_destroy(C);
+    }
+    printf("\n-1 = counter not exposed by this CPU or hypervisor\n");
+}
+
 int main(int argc, char *argv[]) {
     (void)argc; (void)argv;
     
@@ -203,7 +249,11 @@ int main(int argc, char *argv[]) {
     printf("NEON SIMD: %s\n", palma_has_neon() ? "ENABLED" : "DISABLED");
     printf("OpenMP: %s\n\n", palma_has_openmp() ? "ENABLED" : "DISABLED");
     
-    srand((unsigned int)time(NULL));
+    /* Fixed seed: runs time the same inputs */
+    srand(42);
+    
+    /* Opened before the first kernel so OpenMP worker threads are counted */
+    palma_profiler_t *prof = palma_profiler_create();
     
     /* Matrix sizes to test */
     size_t sizes[] = {8, 16, 32, 64, 128, 256, 512};
@@ -264,6 +314,9 @@ int main(int argc, char *argv[]) {
     print_results(results_maxmin, num_sizes, 
                   "=== Max-Min Semiring (bottleneck/bandwidth) ===");
     
+    print_counters(prof, sizes, num_sizes);
+    palma_profiler_destroy(prof);
+    
     /* Memory usage */
     printf("\n=== Memory Usage ===\n");
     printf("%-6s | %12s | %s\n", "Size", "Dense (KB)", "Typical Use Case");
@@ -295,5 +348,7 @@ int main(int argc, char *argv[]) {
     printf("For 100ms deadline: Use <=512x512 matrices\n");
     
     printf("\n=== Benchmark Complete ===\n");
+    printf("For repeatable timings of every kernel with confidence intervals\n");
+    printf("and baseline comparison, use palma_bench (make bench).\n");
     return 0;
 }
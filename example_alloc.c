@@ -0,0 +1,111 @@
+/**
+ * @file example_alloc.c
+ * @brief Tuning Matrix Memory Layout with the Allocation Policy
+ *
+ * Shows how palma_set_alloc_policy changes alignment and row strides, and
+ * checks that the policy can be switched while other threads create
+ * matrices: every matrix and every palma_get_alloc_policy result must
+ * follow one of the two policies in full.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "example_check.h"
+
+#define WIDE_COLS     1024    /* 4 KiB rows: the aliasing case */
+#define CREATORS      3
+#define SWITCHES      2000
+
+static palma_alloc_policy_t policy_a, policy_b;
+static int stop_flag;
+static int mixed_count;
+
+static bool same_policy(const palma_alloc_policy_t *x, const palma_alloc_policy_t *y) {
+    return x->alignment == y->alignment && x->avoid_aliasing == y->avoid_aliasing &&
+           x->huge_pages == y->huge_pages && x->huge_page_threshold == y->huge_page_threshold &&
+           x->numa == y->numa;
+}
+
+/* Policy A: 64-byte alignment, no padding. Policy B: 256-byte alignment, padded strides. */
+static bool layout_consistent(const palma_matrix_t *M) {
+    uintptr_t addr = (uintptr_t)M->data;
+    if (M->stride == WIDE_COLS) return addr % 64 == 0;
+    if (M->stride == WIDE_COLS + 256 / sizeof(palma_val_t)) return addr % 256 == 0;
+    return false;
+}
+
+static void* creator(void *arg) {
+    (void)arg;
+    while (!__atomic_load_n(&stop_flag, __ATOMIC_RELAXED)) {
+        palma_matrix_t *M = palma_matrix_create(2, WIDE_COLS);
+        palma_alloc_policy_t seen;
+        palma_get_alloc_policy(&seen);
+        if (!M || !layout_consistent(M) ||
+            (!same_policy(&seen, &policy_a) && !same_policy(&seen, &policy_b))) {
+            __atomic_fetch_add(&mixed_count, 1, __ATOMIC_RELAXED);
+        }
+        palma_matrix_destroy(M);
+    }
+    return NULL;
+}
+
+int main(void) {
+    printf("=== Allocation Policy ===\n");
+
+    palma_alloc_policy_t def;
+    palma_get_alloc_policy(&def);
+    printf("Default: %zu-byte alignment, aliasing-aware strides %s\n",
+           def.alignment, def.avoid_aliasing ? "on" : "off");
+
+    /* Default layout: rows padded away from the 4 KiB aliasing period */
+    palma_matrix_t *M = palma_matrix_create(4, WIDE_COLS);
+    printf("1024 columns -> stride %zu\n", M->stride);
+    CHECK(M->stride > WIDE_COLS, "wide rows are padded by default");
+    CHECK((uintptr_t)M->data % def.alignment == 0, "data is aligned to the policy");
+    palma_matrix_destroy(M);
+
+    /* Invalid settings are rejected and leave the policy unchanged */
+    palma_alloc_policy_t bad = def;
+    bad.alignment = 48;
+    CHECK(palma_set_alloc_policy(&bad) == PALMA_ERR_INVALID_ARG, "non-power-of-two alignment rejected");
+    palma_alloc_policy_t now;
+    palma_get_alloc_policy(&now);
+    CHECK(same_policy(&now, &def), "rejected policy leaves the old one");
+
+    /* Two complete policies, switched under concurrent creation */
+    policy_a = def;
+    policy_a.alignment = 64;
+    policy_a.avoid_aliasing = false;
+    policy_a.huge_pages = PALMA_HUGEPAGES_NONE;
+    policy_b = policy_a;
+    policy_b.alignment = 256;
+    policy_b.avoid_aliasing = true;
+    policy_b.huge_page_threshold = 1u << 30;
+
+    palma_set_alloc_policy(&policy_a);
+    pthread_t threads[CREATORS];
+    for (int t = 0; t < CREATORS; t++) pthread_create(&threads[t], NULL, creator, NULL);
+    for (int i = 0; i < SWITCHES; i++) {
+        palma_set_alloc_policy((i & 1) ? &policy_a : &policy_b);
+    }
+    __atomic_store_n(&stop_flag, 1, __ATOMIC_RELAXED);
+    for (int t = 0; t < CREATORS; t++) pthread_join(threads[t], NULL);
+
+    printf("%d policy switches under %d creating threads: %d inconsistent layouts\n",
+           SWITCHES, CREATORS, mixed_count);
+    CHECK(mixed_count == 0, "concurrent policy switches are never observed half-done");
+
+    /* NULL restores the default */
+    palma_set_alloc_policy(NULL);
+    palma_get_alloc_policy(&now);
+    CHECK(same_policy(&now, &def), "NULL restores the default policy");
+
+    return example_result();
+}
@@ -0,0 +1,363 @@
+/**
+ * @file example_bench.c
+ * @brief Gating a Build on palma_bench
+ *
+ * Runs the palma_bench built next to this program the way a CI job does:
+ * a short JSON run to store a baseline, then comparisons against baselines
+ * that are much faster, much slower or written in the older format without
+ * a median interval. Checks that the numbers are consistent (median inside
+ * its interval, per-call p95 and p99 in order), that CSV rows match their
+ * header, and that the exit status is 1 exactly when a kernel regressed.
+ * A short --scaling run must report a roofline per thread count and
+ * speedups and efficiencies that agree, with thread counts above 1 only
+ * in an OpenMP build. A --latency run must give ordered percentiles and a
+ * histogram that reproduces them, and --strict must pass an
+ * allocation-free path and fail one that allocates. --counters must
+ * report every event per tropical operation, or leave the counter fields
+ * out and still exit 0 where the host exposes no PMU.
+ *
+ * Usage: example_bench [path/to/palma_bench]
+ * (default: palma_bench next to this program)
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "example_check.h"
+
+#define MAX_RESULTS 8
+
+static char bench_bin[4096];
+static char dir[] = "/tmp/palma_bench_XXXXXX";
+static char out_path[128], err_path[128], base_path[128];
+
+/* Short runs: every case stops after at most 50 batches or 0.2 s */
+static const char *quick[] = { "--warmup", "0.01", "--min-reps", "10", "--max-reps", "50", "--max-time", "0.2" };
+#define N_QUICK (sizeof(quick) / sizeof(quick[0]))
+
+/* Kernels and size of every run */
+static const char *filter = "matvec", *size = "16";
+
+/* Run palma_bench with the quick options plus extra; stdout and stderr go to files */
+static int run_bench(const char *extra[], size_t n_extra) {
+    const char *argv[N_QUICK + 12];
+    size_t argc = 0;
+    argv[argc++] = bench_bin;
+    argv[argc++] = "-f";
+    argv[argc++] = filter;
+    argv[argc++] = "-n";
+    argv[argc++] = size;
+    for (size_t i = 0; i < N_QUICK; i++) argv[argc++] = quick[i];
+    for (size_t i = 0; i < n_extra && argc + 1 < sizeof(argv) / sizeof(argv[0]); i++) argv[argc++] = extra[i];
+    argv[argc] = NULL;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        int err = open(err_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (out >= 0) dup2(out, STDOUT_FILENO);
+        if (err >= 0) dup2(err, STDERR_FILENO);
+        execv(bench_bin, (char* const*)argv);
+        _exit(127);
+    }
+    int status = -1;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static bool file_contains(const char *path, const char *text) {
+    FILE *fp = fopen(path, "r");
+    char line[1024];
+    bool found = false;
+    while (fp && !found && fgets(line, sizeof(line), fp)) found = strstr(line, text) != NULL;
+    if (fp) fclose(fp);
+    return found;
+}
+
+static bool field_num(const char *line, const char *key, double *out) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return false;
+    char *end;
+    *out = strtod(p + strlen(pattern), &end);
+    return end != p + strlen(pattern);
+}
+
+static bool field_str(const char *line, const char *key, char *out, size_t len) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return false;
+    p += strlen(pattern);
+    const char *q = strchr(p, '"');
+    if (!q || (size_t)(q - p) >= len) return false;
+    memcpy(out, p, (size_t)(q - p));
+    out[q - p] = '\0';
+    return true;
+}
+
+typedef struct {
+    char kernel[64];
+    char semiring[16];
+    double n, reps, median, lo, hi, p95, p99, min, tail;
+} result_t;
+
+/* Result lines of a JSON run */
+static size_t read_results(const char *path, result_t *res) {
+    FILE *fp = fopen(path, "r");
+    char line[1024];
+    size_t n = 0;
+    while (fp && n < MAX_RESULTS && fgets(line, sizeof(line), fp)) {
+        result_t *r = &res[n];
+        if (field_str(line, "kernel", r->kernel, sizeof(r->kernel)) &&
+            field_str(line, "semiring", r->semiring, sizeof(r->semiring)) &&
+            field_num(line, "n", &r->n) && field_num(line, "reps", &r->reps) &&
+            field_num(line, "median_ns", &r->median) && field_num(line, "median_lo_ns", &r->lo) &&
+            field_num(line, "median_hi_ns", &r->hi) && field_num(line, "p95_ns", &r->p95) &&
+            field_num(line, "p99_ns", &r->p99) && field_num(line, "min_ns", &r->min) &&
+            field_num(line, "tail_calls", &r->tail)) {
+            n++;
+        }
+    }
+    if (fp) fclose(fp);
+    return n;
+}
+
+/* Baseline with every median scaled; legacy baselines carry only ci95_ns */
+static void write_baseline(const result_t *res, size_t n, double scale, bool legacy) {
+    FILE *fp = fopen(base_path, "w");
+    if (!fp) return;
+    fprintf(fp, "{\n  \"palma_bench\": 1,\n  \"results\": [\n");
+    for (size_t i = 0; i < n; i++) {
+        double m = res[i].median * scale;
+        fprintf(fp, "    {\"kernel\": \"%s\", \"semiring\": \"%s\", \"n\": %.0f, \"median_ns\": %.3f, "
+                    "\"ci95_ns\": %.3f", res[i].kernel, res[i].semiring, res[i].n, m, 0.01 * m);
+        if (!legacy) fprintf(fp, ", \"median_lo_ns\": %.3f, \"median_hi_ns\": %.3f", 0.99 * m, 1.01 * m);
+        fprintf(fp, "}%s\n", i + 1 < n ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+}
+
+static size_t count_char(const char *s, char c) {
+    size_t n = 0;
+    for (; *s; s++) n += (*s == c);
+    return n;
+}
+
+int main(int argc, char **argv) {
+    printf("=== Benchmark Gating ===\n");
+
+    if (argc > 1) {
+        snprintf(bench_bin, sizeof(bench_bin), "%s", argv[1]);
+    } else {
+        const char *slash = strrchr(argv[0], '/');
+        int len = slash ? (int)(slash - argv[0]) : 1;
+        snprintf(bench_bin, sizeof(bench_bin), "%.*s/palma_bench", len, slash ? argv[0] : ".");
+    }
+    if (!mkdtemp(dir)) return EXIT_FAILURE;
+    snprintf(out_path, sizeof(out_path), "%s/out", dir);
+    snprintf(err_path, sizeof(err_path), "%s/err", dir);
+    snprintf(base_path, sizeof(base_path), "%s/base.json", dir);
+
+    /* A baseline run */
+    const char *json[] = { "-o", "json" };
+    CHECK(run_bench(json, 2) == 0, "JSON run exits 0");
+    result_t res[MAX_RESULTS];
+    size_t n = read_results(out_path, res);
+    printf("%zu cases timed\n", n);
+    CHECK(n >= 2, "matvec kernels in the JSON output");
+    bool consistent = true;
+    for (size_t i = 0; i < n; i++) {
+        const result_t *r = &res[i];
+        printf("  %-16s median %8.1f ns [%.1f, %.1f], p95 %.1f, p99 %.1f over %.0f single calls\n",
+               r->kernel, r->median, r->lo, r->hi, r->p95, r->p99, r->tail);
+        if (!(r->min <= r->lo && r->lo <= r->median && r->median <= r->hi)) consistent = false;
+        if (!(r->p95 > 0 && r->p95 <= r->p99 && r->tail >= r->reps)) consistent = false;
+        if (r->reps < 10 || r->reps > 50) consistent = false;
+    }
+    CHECK(consistent, "median inside its interval, p95 <= p99 from single calls, reps within limits");
+
+    /* Baselines 100x slower, 100x faster and 100x faster in the old format */
+    const char *compare[] = { "-o", "json", "-c", base_path };
+    write_baseline(res, n, 100.0, false);
+    CHECK(run_bench(compare, 4) == 0 && file_contains(err_path, "improvement") &&
+          !file_contains(err_path, "REGRESSION"), "much faster run is an improvement, exit 0");
+    write_baseline(res, n, 0.01, false);
+    CHECK(run_bench(compare, 4) == 1 && file_contains(err_path, "REGRESSION"), "much slower run exits 1");
+    write_baseline(res, n, 0.01, true);
+    CHECK(run_bench(compare, 4) == 1, "baseline without a median interval still gates");
+
+    /* Within the threshold is never a regression, however narrow the intervals */
+    const char *loose[] = { "-o", "json", "-c", base_path, "-t", "1000" };
+    CHECK(run_bench(loose, 6) == 0 && !file_contains(err_path, "REGRESSION"), "threshold respected");
+
+    const char *missing[] = { "-c", "/nonexistent/base.json" };
+    CHECK(run_bench(missing, 2) == 2, "missing baseline exits 2");
+
+    /* CSV rows have as many fields as the header */
+    const char *csv[] = { "-o", "csv" };
+    CHECK(run_bench(csv, 2) == 0, "CSV run exits 0");
+    FILE *fp = fopen(out_path, "r");
+    char header[1024], line[1024];
+    size_t rows = 0;
+    bool columns_ok = fp && fgets(header, sizeof(header), fp) && strstr(header, "median_lo_ns");
+    while (columns_ok && fgets(line, sizeof(line), fp)) {
+        if (count_char(line, ',') != count_char(header, ',')) columns_ok = false;
+        rows++;
+    }
+    if (fp) fclose(fp);
+    CHECK(columns_ok && rows == n, "CSV rows match the header");
+
+    /* Hardware counters, or a clean fallback on hosts without a PMU */
+    const char *counters[] = { "--counters", "-o", "json" };
+    CHECK(run_bench(counters, 3) == 0, "--counters run exits 0");
+    bool unavailable = file_contains(err_path, "hardware counters unavailable");
+    size_t profiled = 0, timed = 0;
+    bool counters_ok = true;
+    fp = fopen(out_path, "r");
+    while (fp && fgets(line, sizeof(line), fp)) {
+        if (!strstr(line, "\"kernel\"")) continue;
+        timed++;
+        const char *c = strstr(line, "\"counters\": {");
+        if (!c) continue;
+        profiled++;
+        double calls, v;
+        if (!strstr(c, "\"per\": \"op\"") || !field_num(c, "calls", &calls) || calls < 1) counters_ok = false;
+        for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+            const char *name = palma_counter_name((palma_counter_t)i);
+            char null_field[64];
+            snprintf(null_field, sizeof(null_field), "\"%s\": null", name);
+            if (!strstr(c, null_field) && !(field_num(c, name, &v) && v >= 0)) counters_ok = false;
+        }
+    }
+    if (fp) fclose(fp);
+    printf("counters: %s, %zu of %zu cases profiled\n", unavailable ? "unavailable" : "available", profiled, timed);
+    CHECK(counters_ok && timed == n && profiled == (unavailable ? 0 : n),
+          "every case profiled per op, or none when the host has no counters");
+
+    const char *counters_csv[] = { "--counters", "-o", "csv" };
+    CHECK(run_bench(counters_csv, 3) == 0, "--counters CSV run exits 0");
+    fp = fopen(out_path, "r");
+    rows = 0;
+    columns_ok = fp && fgets(header, sizeof(header), fp) && strstr(header, ",counted_per,ipc,cycles,");
+    while (columns_ok && fgets(line, sizeof(line), fp)) {
+        if (count_char(line, ',') != count_char(header, ',')) columns_ok = false;
+        if (unavailable && !strstr(line, ",,,,,,,\n")) columns_ok = false;
+        rows++;
+    }
+    if (fp) fclose(fp);
+    CHECK(columns_ok && rows == n, "counter columns match the header");
+
+    /* Thread scaling: counts above 1 only where the build has OpenMP */
+    const char *scaling[] = { "--scaling", "--threads", "1,2", "-o", "json" };
+    CHECK(run_bench(scaling, 5) == 0, "scaling run exits 0");
+    bool openmp = file_contains(out_path, "OpenMP:ON");
+    size_t roofs = 0, points = 0, serial = 0;
+    bool scaling_ok = true;
+    fp = fopen(out_path, "r");
+    while (fp && fgets(line, sizeof(line), fp)) {
+        double threads, bandwidth, peak, speedup, efficiency, gops, roof, fraction;
+        if (field_num(line, "bandwidth_gbs", &bandwidth) && field_num(line, "peak_gops", &peak)) {
+            if (!(bandwidth > 0 && peak > 0)) scaling_ok = false;
+            roofs++;
+            continue;
+        }
+        if (!field_num(line, "speedup", &speedup)) continue;
+        if (!field_num(line, "threads", &threads) || !field_num(line, "efficiency", &efficiency) ||
+            !field_num(line, "gops", &gops) || !field_num(line, "roof_gops", &roof) ||
+            !field_num(line, "roof_fraction", &fraction)) {
+            scaling_ok = false;
+            continue;
+        }
+        points++;
+        if (threads == 1) {
+            serial++;
+            if (speedup != 1.0 || efficiency != 1.0) scaling_ok = false;
+        }
+        if (fabs(efficiency - speedup / threads) > 1e-3 || !(gops > 0 && roof > 0 && fraction > 0)) {
+            scaling_ok = false;
+        }
+        if (!strstr(line, "\"bound\": \"memory\"") && !strstr(line, "\"bound\": \"compute\"")) scaling_ok = false;
+    }
+    if (fp) fclose(fp);
+    printf("scaling: %zu thread count(s) probed, %zu point(s)%s\n", roofs, points,
+           openmp ? "" : ", serial build");
+    CHECK(scaling_ok && serial == 1, "speedup, efficiency and roofline fields are consistent");
+    CHECK(roofs == (openmp ? 2u : 1u) && points == roofs, "thread counts above 1 only with OpenMP");
+
+    /* Latency: a clean path passes --strict, an allocating one fails it */
+    const char *latency[] = { "--latency", "--iterations", "20000", "--strict", "-o", "json" };
+    CHECK(run_bench(latency, 6) == 0, "allocation-free matvec passes --strict");
+    bool latency_ok = false;
+    fp = fopen(out_path, "r");
+    char *text = NULL;
+    size_t cap = 0;
+    double overhead = -1;
+    while (fp && getline(&text, &cap, fp) > 0) {
+        double v;
+        if (field_num(text, "timer_overhead_ns", &v)) overhead = v;
+        double count, min, max, mean, allocs, p[6];
+        static const char *pct[6] = { "p50_ns", "p90_ns", "p99_ns", "p99.9_ns", "p99.99_ns", "p99.999_ns" };
+        if (!field_num(text, "count", &count) || !field_num(text, "min_ns", &min) ||
+            !field_num(text, "max_ns", &max) || !field_num(text, "mean_ns", &mean)) {
+            continue;
+        }
+        bool ordered = min >= overhead && overhead >= 0 && mean >= min && mean <= max;
+        for (int i = 0; i < 6; i++) {
+            if (!field_num(text, pct[i], &p[i]) || p[i] < (i ? p[i - 1] : min) || p[i] > max) ordered = false;
+        }
+        bool counted = strstr(text, "\"allocs\": null") ||
+                       (field_num(text, "allocs", &allocs) && allocs == 0);
+
+        /* The histogram, on the next line, adds up to the count and reproduces p50 */
+        const char *h = getline(&text, &cap, fp) > 0 ? strstr(text, "\"histogram\": [") : NULL;
+        double total = 0, last = -1, p50 = -1;
+        bool hist_ok = h != NULL;
+        for (h = h ? strchr(h, '[') + 1 : NULL; h && (h = strchr(h, '[')) != NULL; h++) {
+            unsigned long long value, n_value;
+            if (sscanf(h, "[%llu, %llu]", &value, &n_value) != 2 || (double)value <= last) {
+                hist_ok = false;
+                break;
+            }
+            total += (double)n_value;
+            last = (double)value;
+            if (p50 < 0 && total >= ceil(0.5 * count)) p50 = fmin(last, max);
+        }
+        hist_ok = hist_ok && total == count && last >= max && p50 == p[0];
+        printf("latency: %.0f calls, p50 %.0f ns, p99.999 %.0f ns, max %.0f ns, timer %.0f ns\n",
+               count, p[0], p[5], max, overhead);
+        latency_ok = count == 20000 && ordered && counted && hist_ok;
+    }
+    free(text);
+    if (fp) fclose(fp);
+    CHECK(latency_ok, "percentiles ordered, no allocations, histogram matches the count and p50");
+
+    /* palma_scheduler_solve allocates its state vectors on every call */
+    const char *flagged[] = { "--latency", "--iterations", "2000", "--strict", "-o", "csv" };
+    filter = "scheduler";
+    size = "8";
+    int status = run_bench(flagged, 6);
+    CHECK(status == 1 || (status == 0 && file_contains(out_path, ",n/a,")), "--strict flags an allocating path");
+    const char *no_iterations[] = { "--latency", "--iterations", "0" };
+    CHECK(run_bench(no_iterations, 3) == 2, "zero iterations is a usage error");
+
+    unlink(out_path);
+    unlink(err_path);
+    unlink(base_path);
+    rmdir(dir);
+
+    return example_result();
+}
@@ -0,0 +1,68 @@
+/**
+ * @file example_check.h
+ * @brief Shared fixture of the examples that run under make test
+ *
+ * CHECK counts failed conditions, example_result prints the closing line
+ * and turns the count into the exit status, and same/make_graph are the
+ * comparison and test graph most examples need.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#ifndef EXAMPLE_CHECK_H
+#define EXAMPLE_CHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "palma.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) do { \
+    if (!(cond)) { fprintf(stderr, "FAIL: %s\n", what); failures++; } \
+} while (0)
+
+/* Closing line; the exit status of main */
+static inline int example_result(void) {
+    printf("\n=== Example %s ===\n", failures ? "FAILED" : "Complete");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* Same shape and entries */
+static inline bool same(const palma_matrix_t *X, const palma_matrix_t *Y) {
+    if (!X || !Y || X->rows != Y->rows || X->cols != Y->cols) return false;
+    for (size_t i = 0; i < X->rows; i++) {
+        for (size_t j = 0; j < X->cols; j++) {
+            if (palma_matrix_get(X, i, j) != palma_matrix_get(Y, i, j)) return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Graph on n nodes with an edge i → j (i ≠ j) for one pair in `every` and
+ * weights 1..9 (1 in Boolean). Only the first `cyclic` nodes have backward
+ * edges, so 0 gives a DAG and n a general graph; when there can be cycles,
+ * max-plus weights are negated so no cycle improves on e. `salt` shifts
+ * the pattern.
+ */
+static inline palma_matrix_t* make_graph(size_t n, palma_semiring_t s, size_t every, size_t cyclic,
+                                         size_t salt) {
+    palma_matrix_t *G = palma_matrix_create_zero(n, n, s);
+    if (!G) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (i == j || (i * 11 + j * 7 + salt) % every != 0 || (i >= cyclic && j < i)) continue;
+            palma_val_t w = (palma_val_t)((i * 3 + j + salt) % 9 + 1);
+            if (s == PALMA_MAXPLUS && cyclic > 0) w = -w;
+            if (s == PALMA_BOOLEAN) w = 1;
+            palma_matrix_set(G, i, j, w);
+        }
+    }
+    return G;
+}
+
+#endif /* EXAMPLE_CHECK_H */
@@ -0,0 +1,151 @@
+/**
+ * @file example_cpp.cpp
+ * @brief Scheduling and Path Analysis from C++ with palma.hpp
+ *
+ * Uses the RAII types and expression templates of the C++ interface and
+ * checks every result against the C API: fused A ⊗ B ⊕ C, sums of products
+ * accumulated into the destination, self-referencing assignment, closures, sparse products, the scheduler wrapper, move
+ * semantics and error reporting through palma::Error.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "palma.hpp"
+#include "example_check.h"
+
+constexpr size_t N = 24;
+
+using palma::MaxPlusMatrix;
+
+template <palma_semiring_t S>
+static bool same(const palma::Matrix<S>& X, const palma_matrix_t* Y) {
+    if (!Y || X.rows() != Y->rows || X.cols() != Y->cols) return false;
+    for (size_t i = 0; i < X.rows(); i++) {
+        for (size_t j = 0; j < X.cols(); j++) {
+            if (X(i, j) != palma_matrix_get(Y, i, j)) return false;
+        }
+    }
+    return true;
+}
+
+static void fill(MaxPlusMatrix& M, size_t salt) {
+    for (size_t i = 0; i < M.rows(); i++) {
+        for (size_t j = 0; j < M.cols(); j++) {
+            M(i, j) = (i * 3 + j * 7 + salt) % 5 == 0 ? PALMA_NEG_INF
+                                                     : static_cast<palma_val_t>((i + j * salt) % 13);
+        }
+    }
+}
+
+int main() {
+    std::printf("=== C++ Interface ===\n");
+
+    MaxPlusMatrix A(N, N), B(N, N), C(N, N);
+    fill(A, 1);
+    fill(B, 2);
+    fill(C, 3);
+
+    /* D = A ⊗ B ⊕ C, fused, against the C API */
+    MaxPlusMatrix D = A * B + C;
+    palma_matrix_t* ab = palma_matrix_mul(A.get(), B.get(), PALMA_MAXPLUS);
+    palma_matrix_t* ref = palma_matrix_add(ab, C.get(), PALMA_MAXPLUS);
+    CHECK(same(D, ref), "A * B + C matches palma_matrix_mul/add");
+
+    /* D is an operand of its own assignment: staged, not clobbered */
+    D = A * D + C;
+    palma_matrix_t* adc = palma_matrix_mul(A.get(), ref, PALMA_MAXPLUS);
+    palma_matrix_t* ref2 = palma_matrix_add(adc, C.get(), PALMA_MAXPLUS);
+    CHECK(same(D, ref2), "D = A * D + C reads the old D");
+
+    MaxPlusMatrix E = A.clone();
+    E += B;
+    palma_matrix_t* ref3 = palma_matrix_add(A.get(), B.get(), PALMA_MAXPLUS);
+    CHECK(same(E, ref3), "operator+= matches palma_matrix_add");
+
+    /* Products after the first accumulate into the destination */
+    MaxPlusMatrix F = A * B + C * A;
+    palma_matrix_t* ca = palma_matrix_mul(C.get(), A.get(), PALMA_MAXPLUS);
+    palma_matrix_t* ref4 = palma_matrix_add(ab, ca, PALMA_MAXPLUS);
+    CHECK(same(F, ref4), "A * B + C * A matches palma_matrix_mul/add");
+    F += C * C;
+    palma_matrix_t* cc = palma_matrix_mul(C.get(), C.get(), PALMA_MAXPLUS);
+    palma_matrix_add_into(ref4, ref4, cc, PALMA_MAXPLUS);
+    CHECK(same(F, ref4), "F += C * C accumulates the product");
+    F += A * F;
+    palma_matrix_t* af = palma_matrix_mul(A.get(), ref4, PALMA_MAXPLUS);
+    palma_matrix_add_into(ref4, ref4, af, PALMA_MAXPLUS);
+    CHECK(same(F, ref4), "F += A * F reads the old F");
+
+    /* Closures of an acyclic graph */
+    palma::MinPlusMatrix G(N, N);
+    for (size_t i = 0; i + 1 < N; i++) {
+        G(i, i + 1) = static_cast<palma_val_t>(i % 4 + 1);
+        if (i + 3 < N) G(i, i + 3) = 5;
+    }
+    palma::MinPlusMatrix star = G.closure();
+    palma_matrix_t* star_ref = palma_matrix_closure(G.get(), PALMA_MINPLUS);
+    CHECK(same(star, star_ref), "closure matches palma_matrix_closure");
+    palma::MinPlusMatrix G2 = G * G + G;
+    palma_matrix_t* gg = palma_matrix_mul(G.get(), G.get(), PALMA_MINPLUS);
+    palma_matrix_add_into(gg, gg, G.get(), PALMA_MINPLUS);
+    CHECK(same(G2, gg), "min-plus product kernel matches palma_matrix_mul");
+    palma::MinPlusMatrix plus = G.transitive_closure();
+    CHECK(plus(0, 0) == PALMA_POS_INF && plus(0, N - 1) == star(0, N - 1), "A+ has no empty paths");
+    std::vector<palma_val_t> x(N, PALMA_POS_INF);
+    x[1] = 0;
+    CHECK(G.apply(x)[0] == G(0, 1), "apply is A ⊗ x");
+
+    /* Sparse product */
+    palma::SparseMatrix<PALMA_MAXPLUS> SA(A), SB(B);
+    auto SC = SA * SB;
+    CHECK(same(SC.to_dense(), ab), "sparse product matches the dense product");
+
+    /* Scheduler: 0 → 1 → 3 and 0 → 2 → 3 */
+    palma::Scheduler sched(4);
+    sched.set_name(0, "load").set_name(1, "filter").set_name(2, "fft").set_name(3, "store");
+    sched.add_constraint(0, 1, 2).add_constraint(0, 2, 2)
+         .add_constraint(1, 3, 3).add_constraint(2, 3, 7)
+         .set_ready_time(0, 0);
+    CHECK(sched.solve() >= 0, "scheduler solves");
+    std::vector<size_t> path = sched.critical_path();
+    CHECK(sched.completion(3) == 9 && path.size() >= 2 && path[path.size() - 2] == 2,
+          "critical path runs through the fft task");
+    std::printf("Schedule: store completes at %d, critical path of %zu tasks\n",
+                static_cast<int>(sched.completion(3)), path.size());
+
+    /* Moves transfer ownership; errors throw */
+    MaxPlusMatrix moved = std::move(E);
+    CHECK(E.empty() && moved.rows() == N, "move leaves the source empty");
+    bool threw = false;
+    try {
+        MaxPlusMatrix R(N, N + 1);
+        MaxPlusMatrix bad = A * R * A;
+        (void)bad;
+    } catch (const palma::Error& err) {
+        threw = err.code() == PALMA_ERR_INVALID_DIM;
+    }
+    CHECK(threw, "dimension mismatch throws palma::Error(INVALID_DIM)");
+
+    std::printf("Expressions, closures, sparse product and scheduler checked against the C API\n");
+
+    palma_matrix_destroy(ab);
+    palma_matrix_destroy(ref);
+    palma_matrix_destroy(adc);
+    palma_matrix_destroy(ref2);
+    palma_matrix_destroy(ref3);
+    palma_matrix_destroy(star_ref);
+    palma_matrix_destroy(ca);
+    palma_matrix_destroy(ref4);
+    palma_matrix_destroy(cc);
+    palma_matrix_destroy(af);
+    palma_matrix_destroy(gg);
+
+    return example_result();
+}
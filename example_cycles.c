@@ -0,0 +1,104 @@
+/**
+ * @file example_cycles.c
+ * @brief Detecting Feedback Loops with the Transitive Closure A+
+ *
+ * A+ = A ⊕ A² ⊕ ... holds the best path of length ≥ 1, so its diagonal
+ * marks the nodes that lie on a cycle. This example checks A+ against
+ * A ⊗ A* in every semiring, runs it in place, and checks that a positive
+ * max-plus cycle drives exactly the entries routed through it to +∞.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define N 24
+
+int main(void) {
+    const palma_semiring_t semirings[] = {
+        PALMA_MAXPLUS, PALMA_MINPLUS, PALMA_MAXMIN, PALMA_MINMAX, PALMA_BOOLEAN
+    };
+
+    printf("=== Cycles and A+ ===\n");
+    for (size_t si = 0; si < 5; si++) {
+        palma_semiring_t s = semirings[si];
+        /* Cyclic core on the first 16 nodes, a DAG tail behind it */
+        palma_matrix_t *A = make_graph(N, s, 5, 16, 0);
+        palma_matrix_t *star = palma_matrix_closure(A, s);
+        palma_matrix_t *ref = palma_matrix_mul(A, star, s);
+        palma_matrix_t *plus = palma_matrix_transitive_closure(A, s);
+
+        char what[64];
+        snprintf(what, sizeof(what), "A+ = A ⊗ A* in %s", palma_semiring_name(s));
+        CHECK(same(plus, ref), what);
+
+        palma_matrix_t *inplace = palma_matrix_clone(A);
+        snprintf(what, sizeof(what), "in-place A+ in %s", palma_semiring_name(s));
+        CHECK(palma_matrix_transitive_closure_into(inplace, inplace, s) == PALMA_SUCCESS &&
+              same(inplace, ref), what);
+
+        int on_cycle[N];
+        int cyclic = palma_matrix_cycle_nodes(plus, on_cycle, s);
+        bool tail_acyclic = true;
+        for (size_t i = 16; i < N; i++) tail_acyclic = tail_acyclic && !on_cycle[i];
+        snprintf(what, sizeof(what), "cycle nodes in %s", palma_semiring_name(s));
+        CHECK(cyclic > 0 && cyclic <= 16 && tail_acyclic, what);
+        printf("%-20s %d of %d nodes on cycles\n", palma_semiring_name(s), cyclic, N);
+
+        palma_matrix_destroy(inplace);
+        palma_matrix_destroy(plus);
+        palma_matrix_destroy(ref);
+        palma_matrix_destroy(star);
+        palma_matrix_destroy(A);
+    }
+
+    /*
+     * 0 → 1 ⇄ 2 → 3 with a positive loop between 1 and 2: every path that
+     * can pass through the loop has unbounded max-plus weight.
+     */
+    palma_matrix_t *L = palma_matrix_create_zero(4, 4, PALMA_MAXPLUS);
+    palma_matrix_set(L, 0, 1, 2);
+    palma_matrix_set(L, 1, 2, 1);
+    palma_matrix_set(L, 2, 1, 1);
+    palma_matrix_set(L, 2, 3, 5);
+    palma_matrix_t *plus = palma_matrix_transitive_closure(L, PALMA_MAXPLUS);
+    CHECK(plus != NULL, "A+ of a graph with a positive cycle");
+
+    bool routed = plus != NULL;
+    for (size_t i = 0; routed && i < 4; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            bool through_loop = i <= 2 && j >= 1;
+            palma_val_t expect = through_loop ? PALMA_POS_INF : PALMA_NEG_INF;
+            if (palma_matrix_get(plus, i, j) != expect) routed = false;
+        }
+    }
+    CHECK(routed, "exactly the paths through the positive cycle diverge to +inf");
+
+    int on_cycle[4];
+    int cyclic = plus ? palma_matrix_cycle_nodes(plus, on_cycle, PALMA_MAXPLUS) : -1;
+    CHECK(cyclic == 2 && !on_cycle[0] && on_cycle[1] && on_cycle[2] && !on_cycle[3],
+          "nodes 1 and 2 reported on the cycle");
+    printf("Positive loop 1 <-> 2: %d nodes on cycles, (A+)_03 = %s\n", cyclic,
+           plus && palma_matrix_get(plus, 0, 3) == PALMA_POS_INF ? "+inf" : "finite");
+
+    /* Removing the back edge leaves a DAG */
+    palma_matrix_set(L, 2, 1, PALMA_NEG_INF);
+    palma_matrix_transitive_closure_into(plus, L, PALMA_MAXPLUS);
+    CHECK(palma_matrix_cycle_nodes(plus, on_cycle, PALMA_MAXPLUS) == 0, "acyclic graph has no cycle nodes");
+    CHECK(palma_matrix_get(plus, 0, 3) == 8, "longest path 0 -> 3 in the DAG");
+
+    palma_matrix_t *rect = palma_matrix_create(3, 4);
+    CHECK(palma_matrix_transitive_closure_into(plus, rect, PALMA_MAXPLUS) == PALMA_ERR_NOT_SQUARE,
+          "non-square input is rejected");
+
+    palma_matrix_destroy(rect);
+    palma_matrix_destroy(plus);
+    palma_matrix_destroy(L);
+
+    return example_result();
+}
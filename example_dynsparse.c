@@ -0,0 +1,139 @@
+/**
+ * @file example_dynsparse.c
+ * @brief Dynamic Sparse Graphs - Edge Updates Between Queries
+ *
+ * A road network changes edge by edge (closures, new links, travel time
+ * updates) while shortest-path queries keep running on it. This example
+ * replays a long random sequence of inserts, updates and deletes against
+ * a palma_dynsparse_t and a dense reference matrix, and checks reads, the
+ * entry count, the merged CSR view and sparse matvec on it after every
+ * batch, across many automatic merges.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define N       300
+#define BATCHES 40
+#define UPDATES 2500
+
+static unsigned long long rng = 88172645463325252ULL;
+
+static unsigned next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (unsigned)(rng >> 11);
+}
+
+/* CSR invariants of the view plus equality with the reference */
+static bool view_matches(const palma_sparse_t *S, const palma_matrix_t *R, palma_val_t zero) {
+    if (!S || S->rows != N || S->cols != N || S->row_ptr[0] != 0) return false;
+    size_t count = 0;
+    for (size_t i = 0; i < N; i++) {
+        for (palma_ptr_t k = S->row_ptr[i]; k < S->row_ptr[i + 1]; k++) {
+            if (k > S->row_ptr[i] && S->col_idx[k] <= S->col_idx[k - 1]) return false;
+            if (S->values[k] == zero) return false;
+            if (S->values[k] != palma_matrix_get(R, i, S->col_idx[k])) return false;
+        }
+        count += S->row_ptr[i + 1] - S->row_ptr[i];
+    }
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            if (palma_matrix_get(R, i, j) != zero) count--;
+        }
+    }
+    return count == 0 && S->nnz == S->row_ptr[N];
+}
+
+int main(void) {
+    printf("=== Dynamic Sparse Graphs ===\n");
+
+    const palma_semiring_t s = PALMA_MINPLUS;
+    const palma_val_t zero = palma_zero(s);
+
+    /* Start from a ring so the base is not empty */
+    palma_matrix_t *R = palma_matrix_create_zero(N, N, s);
+    for (size_t i = 0; i < N; i++) palma_matrix_set(R, i, (i + 1) % N, 10);
+    palma_sparse_t *ring = palma_sparse_from_dense(R, s);
+    palma_dynsparse_t *D = palma_dynsparse_from_sparse(ring);
+    palma_sparse_destroy(ring);
+    CHECK(D && palma_dynsparse_nnz(D) == N, "from_sparse copies the ring");
+
+    size_t nnz = N, max_nnz = N, max_pending = 0;
+    bool reads_ok = true, count_ok = true, views_ok = true, matvec_ok = true;
+    palma_val_t x[N], y[N], yref[N];
+
+    for (int b = 0; b < BATCHES; b++) {
+        for (int u = 0; u < UPDATES; u++) {
+            /* Small row and column ranges make updates of pending entries common */
+            size_t i = next_rand() % N, j = next_rand() % (b % 2 ? N : 40);
+            palma_val_t old = palma_matrix_get(R, i, j);
+            palma_val_t val = (next_rand() % 3 == 0) ? zero : (palma_val_t)(next_rand() % 50 + 1);
+            if (next_rand() % 4 == 0) {
+                palma_dynsparse_remove(D, i, j);
+                val = zero;
+            } else {
+                palma_dynsparse_set(D, i, j, val);
+            }
+            palma_matrix_set(R, i, j, val);
+            if (old == zero && val != zero) nnz++;
+            if (old != zero && val == zero) nnz--;
+            if (nnz > max_nnz) max_nnz = nnz;
+            if (palma_dynsparse_pending(D) > max_pending) max_pending = palma_dynsparse_pending(D);
+            if (palma_dynsparse_get(D, i, j) != val) reads_ok = false;
+        }
+        if (palma_dynsparse_nnz(D) != nnz) count_ok = false;
+
+        /* Reads with pending changes, then the merged view */
+        for (int q = 0; q < 500; q++) {
+            size_t i = next_rand() % N, j = next_rand() % N;
+            if (palma_dynsparse_get(D, i, j) != palma_matrix_get(R, i, j)) reads_ok = false;
+        }
+        const palma_sparse_t *S = palma_dynsparse_view(D);
+        if (!view_matches(S, R, zero) || palma_dynsparse_pending(D) != 0) views_ok = false;
+
+        for (size_t k = 0; k < N; k++) x[k] = (palma_val_t)(next_rand() % 100);
+        palma_matvec(R, x, yref, s);
+        if (!S || palma_sparse_matvec(S, x, y) != PALMA_SUCCESS) matvec_ok = false;
+        for (size_t k = 0; S && k < N; k++) {
+            if (y[k] != yref[k]) matvec_ok = false;
+        }
+    }
+
+    printf("%d updates in %d batches, %zu entries at the end, at most %zu pending\n",
+           BATCHES * UPDATES, BATCHES, nnz, max_pending);
+    CHECK(reads_ok, "get sees every insert, update and delete");
+    CHECK(count_ok, "nnz tracks the reference");
+    CHECK(views_ok, "merged view is sorted, has no zeros and matches the reference");
+    CHECK(matvec_ok, "sparse matvec on the view matches dense matvec");
+    CHECK(max_pending <= (max_nnz + N) / 4 + 256, "automatic merges bound the delta buffer");
+
+    /* Bounds and degenerate calls */
+    CHECK(palma_dynsparse_set(D, N, 0, 1) == PALMA_ERR_INDEX_BOUNDS, "row out of bounds");
+    CHECK(palma_dynsparse_set(D, 0, N, 1) == PALMA_ERR_INDEX_BOUNDS, "column out of bounds");
+    CHECK(palma_dynsparse_get(D, N, N) == zero, "get out of bounds reads zero");
+    CHECK(palma_dynsparse_merge(D) == PALMA_SUCCESS && palma_dynsparse_pending(D) == 0,
+          "merge with nothing pending");
+    CHECK(palma_dynsparse_set(NULL, 0, 0, 1) == PALMA_ERR_NULL_PTR, "NULL matrix");
+    palma_dynsparse_destroy(D);
+
+    /* Empty start, everything deleted again */
+    D = palma_dynsparse_create(N, N, s);
+    for (size_t i = 0; i < N; i++) palma_dynsparse_set(D, i, N - 1 - i, (palma_val_t)i + 1);
+    for (size_t i = 0; i < N; i++) palma_dynsparse_remove(D, i, N - 1 - i);
+    const palma_sparse_t *E = palma_dynsparse_view(D);
+    CHECK(palma_dynsparse_nnz(D) == 0 && E && E->nnz == 0 && E->row_ptr[N] == 0, "all entries deleted");
+    palma_dynsparse_destroy(D);
+    palma_dynsparse_destroy(NULL);
+
+    palma_matrix_destroy(R);
+
+    return example_result();
+}
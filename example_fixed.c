@@ -0,0 +1,123 @@
+/**
+ * @file example_fixed.c
+ * @brief Control Loops Sized for the Fixed 4x4, 8x8 and 16x16 Kernels
+ *
+ * palma_matrix_mul_into, palma_matvec and palma_matrix_closure switch to
+ * fully unrolled kernels for these dimensions. This example runs them in
+ * every semiring, including ε entries and saturating values, and checks
+ * the results against a plain triple loop built from palma_add/palma_mul.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+/* Entries with ε, ⊤-like extremes and ordinary weights */
+static palma_val_t sample(size_t i, size_t j, size_t seed, palma_semiring_t s) {
+    size_t h = (i * 31 + j * 17 + seed * 7) % 23;
+    if (h < 5) return palma_zero(s);
+    if (s == PALMA_BOOLEAN) return 1;
+    if (h == 5) return PALMA_POS_INF - 1;
+    if (h == 6) return PALMA_NEG_INF + 1;
+    return (palma_val_t)h - 11;
+}
+
+static palma_val_t ref_get(const palma_matrix_t *M, size_t i, size_t j) {
+    return palma_matrix_get(M, i, j);
+}
+
+static void ref_mul(palma_matrix_t *C, const palma_matrix_t *A, const palma_matrix_t *B,
+                    palma_semiring_t s) {
+    for (size_t i = 0; i < A->rows; i++) {
+        for (size_t j = 0; j < B->cols; j++) {
+            palma_val_t acc = palma_zero(s);
+            for (size_t k = 0; k < A->cols; k++) {
+                acc = palma_add(acc, palma_mul(ref_get(A, i, k), ref_get(B, k, j), s), s);
+            }
+            palma_matrix_set(C, i, j, acc);
+        }
+    }
+}
+
+int main(void) {
+    const size_t dims[] = { 4, 8, 16 };
+    const palma_semiring_t semirings[] = {
+        PALMA_MAXPLUS, PALMA_MINPLUS, PALMA_MAXMIN, PALMA_MINMAX, PALMA_BOOLEAN
+    };
+
+    printf("=== Fixed-Size Kernels ===\n");
+    printf("%-6s %-20s %6s %8s %9s\n", "size", "semiring", "mul", "matvec", "closure");
+
+    for (size_t di = 0; di < 3; di++) {
+        size_t n = dims[di];
+        palma_matrix_t *A = palma_matrix_create(n, n);
+        palma_matrix_t *B = palma_matrix_create(n, n);
+        palma_matrix_t *C = palma_matrix_create(n, n);
+        palma_matrix_t *R = palma_matrix_create(n, n);
+        palma_val_t x[16], y[16];
+
+        for (size_t si = 0; si < 5; si++) {
+            palma_semiring_t s = semirings[si];
+            for (size_t i = 0; i < n; i++) {
+                x[i] = sample(i, 0, 3, s);
+                for (size_t j = 0; j < n; j++) {
+                    palma_matrix_set(A, i, j, sample(i, j, 1, s));
+                    palma_matrix_set(B, i, j, sample(i, j, 2, s));
+                }
+            }
+
+            palma_matrix_mul_into(C, A, B, s);
+            ref_mul(R, A, B, s);
+            bool mul_ok = same(C, R);
+
+            palma_matvec(A, x, y, s);
+            bool mv_ok = true;
+            for (size_t i = 0; i < n; i++) {
+                palma_val_t acc = palma_zero(s);
+                for (size_t k = 0; k < n; k++) acc = palma_add(acc, palma_mul(ref_get(A, i, k), x[k], s), s);
+                mv_ok = mv_ok && y[i] == acc;
+            }
+
+            /* Closure of an acyclic matrix: I ⊕ A ⊕ ... ⊕ A^(n-1) by repeated products */
+            for (size_t i = 0; i < n; i++) {
+                for (size_t j = 0; j < n; j++) {
+                    if (j <= i) palma_matrix_set(A, i, j, palma_zero(s));
+                }
+            }
+            palma_matrix_t *star = palma_matrix_closure(A, s);
+            palma_matrix_t *P = palma_matrix_create_identity(n, s);
+            palma_matrix_t *sum = palma_matrix_create_identity(n, s);
+            for (size_t k = 1; k < n; k++) {
+                ref_mul(R, P, A, s);
+                palma_matrix_copy(P, R);
+                for (size_t i = 0; i < n; i++) {
+                    for (size_t j = 0; j < n; j++) {
+                        palma_matrix_set(sum, i, j, palma_add(ref_get(sum, i, j), ref_get(P, i, j), s));
+                    }
+                }
+            }
+            bool star_ok = star && same(star, sum);
+
+            char what[64];
+            snprintf(what, sizeof(what), "%zux%zu %s kernels", n, n, palma_semiring_name(s));
+            CHECK(mul_ok && mv_ok && star_ok, what);
+            printf("%2zux%-3zu %-20s %6s %8s %9s\n", n, n, palma_semiring_name(s),
+                   mul_ok ? "ok" : "FAIL", mv_ok ? "ok" : "FAIL", star_ok ? "ok" : "FAIL");
+
+            palma_matrix_destroy(star);
+            palma_matrix_destroy(P);
+            palma_matrix_destroy(sum);
+        }
+        palma_matrix_destroy(A);
+        palma_matrix_destroy(B);
+        palma_matrix_destroy(C);
+        palma_matrix_destroy(R);
+    }
+
+    return example_result();
+}
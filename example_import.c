@@ -0,0 +1,261 @@
+/**
+ * @file example_import.c
+ * @brief Importing Matrix Market and DIMACS Graphs
+ *
+ * Graphs downloaded from SuiteSparse or the DIMACS challenge are imported
+ * straight into CSR. This example checks what the importer promises:
+ * symmetric and skew-symmetric expansion, rounding of real values,
+ * pattern entries, duplicates combined with ⊕, a multi-megabyte file
+ * split into parallel chunks, and then the broken files people send -
+ * wrong banners, bad size lines, entry counts that disagree with the
+ * header, out-of-range indices and values, and every single-byte
+ * corruption of small files. Each must load exactly or fail with its
+ * documented error code.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "example_check.h"
+
+#define BIG_N     300
+#define BIG_LINES 250000
+
+static char path[] = "/tmp/palma_import_XXXXXX";
+
+static void put_file(const char *text, size_t len) {
+    FILE *fp = fopen(path, "wb");
+    if (fp) {
+        fwrite(text, 1, len, fp);
+        fclose(fp);
+    }
+}
+
+static void put_text(const char *text) {
+    put_file(text, strlen(text));
+}
+
+/* Load the file and return the error; *out keeps the matrix if asked */
+static palma_error_t load(bool dimacs, palma_semiring_t s, palma_sparse_t **out) {
+    palma_clear_error();
+    palma_sparse_t *S = dimacs ? palma_sparse_load_dimacs(path, s) : palma_sparse_load_mtx(path, s);
+    palma_error_t err = S ? PALMA_SUCCESS : palma_get_last_error();
+    if (S && err == PALMA_SUCCESS && S->row_ptr[S->rows] != S->nnz) err = PALMA_ERR_SPARSE_FORMAT;
+    if (out) *out = S;
+    else palma_sparse_destroy(S);
+    return err;
+}
+
+/* Rows sorted by column, no duplicates, indices in range */
+static bool canonical(const palma_sparse_t *S) {
+    if (!S || S->row_ptr[0] != 0 || S->row_ptr[S->rows] != S->nnz) return false;
+    for (size_t i = 0; i < S->rows; i++) {
+        if (S->row_ptr[i + 1] < S->row_ptr[i]) return false;
+        for (palma_ptr_t k = S->row_ptr[i]; k < S->row_ptr[i + 1]; k++) {
+            if (S->col_idx[k] >= S->cols) return false;
+            if (k > S->row_ptr[i] && S->col_idx[k] <= S->col_idx[k - 1]) return false;
+        }
+    }
+    return true;
+}
+
+static unsigned long long rng = 2463534242ULL;
+
+static unsigned next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (unsigned)(rng >> 11);
+}
+
+int main(void) {
+    printf("=== Graph Import ===\n");
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return EXIT_FAILURE;
+    }
+    close(fd);
+
+    /* Symmetric integer file: comments, blank lines, CRLF, duplicates, no final newline */
+    palma_sparse_t *S = NULL;
+    put_text("%%MatrixMarket matrix coordinate integer symmetric\r\n"
+             "% a comment\n\n"
+             "  4 4 5\r\n"
+             "2 1 7\n3 3 -2\n4 1 5\n4 1 9\r\n\t4 2 +3");
+    CHECK(load(false, PALMA_MAXPLUS, &S) == PALMA_SUCCESS && canonical(S), "symmetric file loads");
+    if (S) {
+        CHECK(S->nnz == 7 && palma_sparse_get(S, 0, 1) == 7 && palma_sparse_get(S, 1, 0) == 7 &&
+              palma_sparse_get(S, 2, 2) == -2 && palma_sparse_get(S, 3, 0) == 9 &&
+              palma_sparse_get(S, 0, 3) == 9 && palma_sparse_get(S, 1, 3) == 3,
+              "mirrored entries and duplicates combined with max");
+        palma_sparse_destroy(S);
+    }
+
+    put_text("%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 2\n2 1 1.6\n3 2 -2.5e0\n");
+    CHECK(load(false, PALMA_MINPLUS, &S) == PALMA_SUCCESS && canonical(S), "skew-symmetric file loads");
+    if (S) {
+        CHECK(S->nnz == 4 && palma_sparse_get(S, 1, 0) == 2 && palma_sparse_get(S, 0, 1) == -2 &&
+              palma_sparse_get(S, 2, 1) == -2 && palma_sparse_get(S, 1, 2) == 2,
+              "real values rounded, mirrored entries negated");
+        palma_sparse_destroy(S);
+    }
+
+    put_text("%%MatrixMarket MATRIX Coordinate Pattern General\n2 5 3\n1 5\n2 1\n1 5\n");
+    CHECK(load(false, PALMA_MINPLUS, &S) == PALMA_SUCCESS && canonical(S), "pattern file loads");
+    if (S) {
+        CHECK(S->rows == 2 && S->cols == 5 && S->nnz == 2 &&
+              palma_sparse_get(S, 0, 4) == palma_one(PALMA_MINPLUS), "pattern entries get the unit");
+        palma_sparse_destroy(S);
+    }
+
+    put_text("%%MatrixMarket matrix coordinate integer general\n3 2 0\n");
+    CHECK(load(false, PALMA_MINPLUS, &S) == PALMA_SUCCESS && S && S->nnz == 0 && S->rows == 3, "no entries");
+    palma_sparse_destroy(S);
+
+    put_text("c road network\nc\np sp 4 5\na 1 2 10\na 2 3 4\nc inline comment\na 1 2 6\na 4 1 -3\n\na 3 3 0\n");
+    CHECK(load(true, PALMA_MINPLUS, &S) == PALMA_SUCCESS && canonical(S), "DIMACS file loads");
+    if (S) {
+        CHECK(S->nnz == 4 && palma_sparse_get(S, 0, 1) == 6 && palma_sparse_get(S, 3, 0) == -3 &&
+              palma_sparse_get(S, 2, 2) == 0, "parallel arcs combined with min");
+        palma_sparse_destroy(S);
+    }
+
+    /* Several megabytes: parsed in chunks, checked against a dense reference */
+    palma_matrix_t *R = palma_matrix_create_zero(BIG_N, BIG_N, PALMA_MAXPLUS);
+    char *text = (char*)malloc((size_t)BIG_LINES * 24 + 128);
+    if (!R || !text) return EXIT_FAILURE;
+    size_t len = (size_t)sprintf(text, "%%%%MatrixMarket matrix coordinate integer general\n%d %d %d\n",
+                                 BIG_N, BIG_N, BIG_LINES);
+    for (int k = 0; k < BIG_LINES; k++) {
+        size_t i = next_rand() % BIG_N, j = next_rand() % BIG_N;
+        palma_val_t v = (palma_val_t)(next_rand() % 2000000) - 1000000;
+        len += (size_t)snprintf(text + len, 32, "%zu %zu %d\n", i + 1, j + 1, (int)v);
+        palma_matrix_set(R, i, j, palma_add(palma_matrix_get(R, i, j), v, PALMA_MAXPLUS));
+    }
+    put_file(text, len);
+    free(text);
+    bool big_ok = load(false, PALMA_MAXPLUS, &S) == PALMA_SUCCESS && canonical(S);
+    for (size_t i = 0; big_ok && i < BIG_N; i++) {
+        for (size_t j = 0; j < BIG_N; j++) {
+            if (palma_sparse_get(S, i, j) != palma_matrix_get(R, i, j)) big_ok = false;
+        }
+    }
+    printf("%zu-byte file with %d entries: %zu distinct\n", len, BIG_LINES, S ? S->nnz : 0);
+    CHECK(big_ok, "large file matches the dense reference");
+    palma_sparse_destroy(S);
+    palma_matrix_destroy(R);
+
+    /* Broken Matrix Market files */
+    static const struct { const char *text; palma_error_t err; const char *what; } bad_mtx[] = {
+        { "3 3 1\n1 1 1\n",                                                  PALMA_ERR_FILE_FORMAT, "no banner" },
+        { "%%MatrixMarket matrix coordinate integer\n3 3 1\n1 1 1\n",        PALMA_ERR_FILE_FORMAT, "short banner" },
+        { "%%MatrixMarket vector coordinate integer general\n3 3 1\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "not a matrix" },
+        { "%%MatrixMarket matrix array integer general\n3 3\n1\n",           PALMA_ERR_UNSUPPORTED, "array format" },
+        { "%%MatrixMarket matrix coordinate complex general\n3 3 1\n1 1 1 0\n", PALMA_ERR_UNSUPPORTED, "complex field" },
+        { "%%MatrixMarket matrix coordinate real hermitian\n3 3 1\n1 1 1\n", PALMA_ERR_UNSUPPORTED, "Hermitian" },
+        { "%%MatrixMarket matrix coordinate pattern skew-symmetric\n3 3 1\n2 1\n", PALMA_ERR_FILE_FORMAT, "pattern skew" },
+        { "%%MatrixMarket matrix coordinate integer general\n% only comments\n", PALMA_ERR_FILE_FORMAT, "no size line" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3\n1 1 1\n",  PALMA_ERR_FILE_FORMAT, "size line too short" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1 1\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "size line too long" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 -3 1\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "negative size" },
+        { "%%MatrixMarket matrix coordinate integer symmetric\n3 4 1\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "symmetric, not square" },
+        { "%%MatrixMarket matrix coordinate integer general\n0 3 0\n",       PALMA_ERR_INVALID_DIM, "zero rows" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 2\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "fewer entries than declared" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1 1\n2 2 2\n", PALMA_ERR_FILE_FORMAT, "more entries than declared" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n0 1 1\n", PALMA_ERR_INDEX_BOUNDS, "zero index" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n4 1 1\n", PALMA_ERR_INDEX_BOUNDS, "row past the end" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 4 1\n", PALMA_ERR_INDEX_BOUNDS, "column past the end" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 99999999999999999999 1\n", PALMA_ERR_FILE_FORMAT, "index past uint64_t" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1 2147483648\n", PALMA_ERR_FILE_FORMAT, "value above int32_t" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1 -2147483649\n", PALMA_ERR_FILE_FORMAT, "value below int32_t" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1 1.5\n", PALMA_ERR_FILE_FORMAT, "real in an integer file" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1\n",  PALMA_ERR_FILE_FORMAT, "missing value" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 3 1\n1 1 1 1\n", PALMA_ERR_FILE_FORMAT, "trailing token" },
+        { "%%MatrixMarket matrix coordinate pattern general\n3 3 1\n1 1 1\n", PALMA_ERR_FILE_FORMAT, "value in a pattern file" },
+        { "%%MatrixMarket matrix coordinate real general\n3 3 1\n1 1 1e300\n", PALMA_ERR_FILE_FORMAT, "real above int32_t" },
+        { "%%MatrixMarket matrix coordinate real general\n3 3 1\n1 1 nan\n", PALMA_ERR_FILE_FORMAT, "NaN" },
+        { "%%MatrixMarket matrix coordinate real general\n3 3 1\n1 1 1.0x\n", PALMA_ERR_FILE_FORMAT, "junk after a real" },
+        { "%%MatrixMarket matrix coordinate integer skew-symmetric\n3 3 1\n2 2 1\n", PALMA_ERR_FILE_FORMAT, "skew diagonal" },
+        { "%%MatrixMarket matrix coordinate integer skew-symmetric\n3 3 1\n2 1 -2147483648\n", PALMA_ERR_FILE_FORMAT, "skew value without a negation" },
+        { "%%MatrixMarket matrix coordinate integer general\n3 8589934592 0\n", PALMA_ERR_OVERFLOW, "more columns than palma_idx_t" },
+        { "%%MatrixMarket matrix coordinate integer general\n18446744073709551615 3 0\n", PALMA_ERR_OVERFLOW, "row count past size_t" },
+        { "%%MatrixMarket matrix coordinate integer general\n4611686018427387904 3 0\n", PALMA_ERR_OVERFLOW, "row pointers past size_t" },
+    };
+    for (size_t k = 0; k < sizeof(bad_mtx) / sizeof(bad_mtx[0]); k++) {
+        put_text(bad_mtx[k].text);
+        CHECK(load(false, PALMA_MINPLUS, NULL) == bad_mtx[k].err, bad_mtx[k].what);
+    }
+
+    /* Broken DIMACS files */
+    static const struct { const char *text; palma_error_t err; const char *what; } bad_gr[] = {
+        { "c no problem line\na 1 2 3\n",       PALMA_ERR_FILE_FORMAT, "no problem line" },
+        { "p max 3 1\na 1 2 3\n",               PALMA_ERR_FILE_FORMAT, "not a shortest-path problem" },
+        { "p sp 3\na 1 2 3\n",                  PALMA_ERR_FILE_FORMAT, "problem line too short" },
+        { "x\np sp 3 1\na 1 2 3\n",             PALMA_ERR_FILE_FORMAT, "junk before the problem line" },
+        { "p sp 3 1\ne 1 2 3\n",                PALMA_ERR_FILE_FORMAT, "unknown line type" },
+        { "p sp 3 1\na 1 2\n",                  PALMA_ERR_FILE_FORMAT, "arc without a weight" },
+        { "p sp 3 2\na 1 2 3\n",                PALMA_ERR_FILE_FORMAT, "fewer arcs than declared" },
+        { "p sp 3 1\na 1 4 3\n",                PALMA_ERR_INDEX_BOUNDS, "vertex past the end" },
+        { "p sp 3 1\na 0 1 3\n",                PALMA_ERR_INDEX_BOUNDS, "vertex zero" },
+        { "p sp 0 0\n",                         PALMA_ERR_INVALID_DIM, "no vertices" },
+    };
+    for (size_t k = 0; k < sizeof(bad_gr) / sizeof(bad_gr[0]); k++) {
+        put_text(bad_gr[k].text);
+        CHECK(load(true, PALMA_MINPLUS, NULL) == bad_gr[k].err, bad_gr[k].what);
+    }
+
+    put_text("");
+    CHECK(load(false, PALMA_MINPLUS, NULL) == PALMA_ERR_FILE_FORMAT, "empty file");
+    palma_clear_error();
+    CHECK(palma_sparse_load_mtx("/nonexistent/graph.mtx", PALMA_MINPLUS) == NULL &&
+          palma_get_last_error() == PALMA_ERR_FILE_OPEN, "missing file");
+    palma_clear_error();
+    CHECK(palma_sparse_load_dimacs(NULL, PALMA_MINPLUS) == NULL &&
+          palma_get_last_error() == PALMA_ERR_NULL_PTR, "NULL file name");
+
+    /* Every byte of small files, damaged: loads are canonical or fail cleanly */
+    static const char *seeds[] = {
+        "%%MatrixMarket matrix coordinate integer symmetric\n% c\n4 4 4\n2 1 7\n3 3 -2\n4 1 5\n4 2 3\n",
+        "%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 2\n2 1 1.5\n3 1 -4e1\n",
+        "c graph\np sp 4 3\na 1 2 10\na 2 3 4\na 4 1 -3\n",
+    };
+    static const char swaps[] = { '\n', ' ', '-', '0', '9', '%', 'c', '\0', '.', 'e' };
+    size_t ok = 0, refused = 0;
+    bool fuzz_ok = true;
+    for (int kind = 0; kind < 3; kind++) {
+        size_t n = strlen(seeds[kind]);
+        char *copy = (char*)malloc(n);
+        if (!copy) return EXIT_FAILURE;
+        for (size_t at = 0; at < n; at++) {
+            for (size_t s = 0; s < sizeof(swaps); s++) {
+                memcpy(copy, seeds[kind], n);
+                copy[at] = swaps[s];
+                put_file(copy, n);
+                palma_error_t err = load(kind == 2, PALMA_MINPLUS, &S);
+                if (err == PALMA_SUCCESS) {
+                    if (!canonical(S)) fuzz_ok = false;
+                    ok++;
+                } else {
+                    refused++;
+                }
+                palma_sparse_destroy(S);
+            }
+        }
+        free(copy);
+    }
+    printf("single-byte corruptions: %zu loaded, %zu refused\n", ok, refused);
+    CHECK(fuzz_ok && ok > 0 && refused > 0, "corruptions load canonically or are refused");
+
+    unlink(path);
+
+    return example_result();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file example_into.c
+ * @brief Allocation-Free Control Loops with the _into Variants
+ *
+ * A periodic controller reuses the same result matrices every cycle. This
+ * example checks each _into variant against its allocating counterpart,
+ * runs the in-place forms, and checks that palma_matrix_power_into rejects
+ * an output or workspace that overlaps its input, including through views.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define N 12
+
+static bool same_sparse(const palma_sparse_t *X, const palma_sparse_t *Y) {
+    palma_matrix_t *dx = palma_sparse_to_dense(X);
+    palma_matrix_t *dy = palma_sparse_to_dense(Y);
+    bool eq = same(dx, dy);
+    palma_matrix_destroy(dx);
+    palma_matrix_destroy(dy);
+    return eq;
+}
+
+int main(void) {
+    printf("=== _into Variants ===\n");
+
+    palma_matrix_t *A = make_graph(N, PALMA_MAXPLUS, 4, 0, 0);
+    palma_matrix_t *B = make_graph(N, PALMA_MAXPLUS, 4, 0, 1);
+    palma_matrix_t *C = palma_matrix_create(N, N);
+    palma_matrix_t *ref;
+
+    ref = palma_matrix_add(A, B, PALMA_MAXPLUS);
+    CHECK(palma_matrix_add_into(C, A, B, PALMA_MAXPLUS) == PALMA_SUCCESS && same(C, ref), "add_into");
+    palma_matrix_destroy(ref);
+
+    /* Power with a caller workspace: no allocation inside */
+    palma_matrix_t *work = palma_matrix_create(2 * N, N);
+    ref = palma_matrix_power(A, 5, PALMA_MAXPLUS);
+    CHECK(palma_matrix_power_into(C, A, 5, PALMA_MAXPLUS, work) == PALMA_SUCCESS && same(C, ref),
+          "power_into with workspace");
+    CHECK(palma_matrix_power_into(C, A, 5, PALMA_MAXPLUS, NULL) == PALMA_SUCCESS && same(C, ref),
+          "power_into without workspace");
+    palma_matrix_destroy(ref);
+
+    ref = palma_matrix_closure(A, PALMA_MAXPLUS);
+    CHECK(palma_matrix_closure_into(C, A, PALMA_MAXPLUS) == PALMA_SUCCESS && same(C, ref), "closure_into");
+    palma_matrix_t *inplace = palma_matrix_clone(A);
+    CHECK(palma_matrix_closure_into(inplace, inplace, PALMA_MAXPLUS) == PALMA_SUCCESS && same(inplace, ref),
+          "closure_into in place");
+    palma_matrix_destroy(inplace);
+    palma_matrix_destroy(ref);
+
+    ref = palma_matrix_transitive_closure(A, PALMA_MAXPLUS);
+    CHECK(palma_matrix_transitive_closure_into(C, A, PALMA_MAXPLUS) == PALMA_SUCCESS && same(C, ref),
+          "transitive_closure_into");
+    palma_matrix_destroy(ref);
+
+    palma_matrix_t *M = make_graph(N, PALMA_MINPLUS, 4, 0, 2);
+    ref = palma_all_pairs_paths(M, PALMA_MINPLUS);
+    CHECK(palma_all_pairs_paths_into(C, M, PALMA_MINPLUS) == PALMA_SUCCESS && same(C, ref), "all_pairs_paths_into");
+    palma_matrix_destroy(ref);
+    palma_matrix_destroy(M);
+
+    M = make_graph(N, PALMA_MAXMIN, 4, 0, 3);
+    ref = palma_bottleneck_paths(M);
+    CHECK(palma_bottleneck_paths_into(C, M) == PALMA_SUCCESS && same(C, ref), "bottleneck_paths_into");
+    palma_matrix_destroy(ref);
+    palma_matrix_destroy(M);
+
+    M = make_graph(N, PALMA_BOOLEAN, 4, 0, 4);
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            if (palma_matrix_get(M, i, j) != palma_zero(PALMA_BOOLEAN)) palma_matrix_set(M, i, j, 1);
+        }
+    }
+    ref = palma_reachability(M);
+    CHECK(palma_reachability_into(C, M) == PALMA_SUCCESS && same(C, ref), "reachability_into");
+    palma_matrix_destroy(ref);
+    palma_matrix_destroy(M);
+
+    /* Sparse outputs are reused across calls */
+    palma_sparse_t *SA = palma_sparse_from_dense(A, PALMA_MAXPLUS);
+    palma_sparse_t *SB = palma_sparse_from_dense(B, PALMA_MAXPLUS);
+    palma_sparse_t *SC = palma_sparse_create(1, 1, 0, PALMA_MAXPLUS);
+    palma_sparse_t *sref = palma_sparse_mul(SA, SB);
+    CHECK(palma_sparse_mul_into(SC, SA, SB) == PALMA_SUCCESS && same_sparse(SC, sref), "sparse_mul_into");
+    palma_sparse_destroy(sref);
+    sref = palma_sparse_closure(SA);
+    CHECK(palma_sparse_closure_into(SC, SA) == PALMA_SUCCESS && same_sparse(SC, sref), "sparse_closure_into");
+    palma_sparse_destroy(sref);
+
+    /* Overlapping operands of power_into are rejected */
+    palma_matrix_t *big = palma_matrix_create(2 * N, 2 * N);
+    palma_matrix_t src, dst;
+    palma_matrix_view(&src, big, 0, 0, N, N);
+    palma_matrix_view(&dst, big, N / 2, N / 2, N, N);     /* Shares rows and columns with src */
+    palma_matrix_copy(&src, A);
+    CHECK(palma_matrix_power_into(&dst, &src, 3, PALMA_MAXPLUS, NULL) == PALMA_ERR_INVALID_ARG,
+          "power_into rejects an overlapping output view");
+    CHECK(palma_matrix_power_into(C, A, 3, PALMA_MAXPLUS, A) == PALMA_ERR_INVALID_ARG,
+          "power_into rejects the input as workspace");
+    palma_matrix_t *shared = palma_matrix_create(3 * N, N);
+    palma_matrix_t out, scratch;
+    palma_matrix_view(&out, shared, 0, 0, N, N);
+    palma_matrix_view(&scratch, shared, N - 1, 0, 2 * N, N);  /* One row shared with out */
+    CHECK(palma_matrix_power_into(&out, A, 3, PALMA_MAXPLUS, &scratch) == PALMA_ERR_INVALID_ARG,
+          "power_into rejects a workspace overlapping the output");
+    palma_matrix_view(&scratch, shared, N, 0, 2 * N, N);
+    ref = palma_matrix_power(A, 3, PALMA_MAXPLUS);
+    CHECK(palma_matrix_power_into(&out, A, 3, PALMA_MAXPLUS, &scratch) == PALMA_SUCCESS && same(&out, ref),
+          "power_into with output and workspace carved from one buffer");
+    palma_matrix_destroy(ref);
+    palma_matrix_destroy(shared);
+    palma_matrix_view(&dst, big, N, N, N, N);              /* Disjoint from src */
+    ref = palma_matrix_power(A, 3, PALMA_MAXPLUS);
+    CHECK(palma_matrix_power_into(&dst, &src, 3, PALMA_MAXPLUS, NULL) == PALMA_SUCCESS && same(&dst, ref),
+          "power_into between disjoint views of one matrix");
+    palma_matrix_destroy(ref);
+
+    printf("add, power, closure, A+, all-pairs, bottleneck, reachability,\n"
+           "sparse mul and sparse closure checked against allocating versions\n");
+
+    palma_matrix_destroy(big);
+    palma_sparse_destroy(SA);
+    palma_sparse_destroy(SB);
+    palma_sparse_destroy(SC);
+    palma_matrix_destroy(work);
+    palma_matrix_destroy(A);
+    palma_matrix_destroy(B);
+    palma_matrix_destroy(C);
+
+    return example_result();
+}
@@ -0,0 +1,136 @@
+/**
+ * @file example_jobs.c
+ * @brief Background Route Planning with Asynchronous Jobs
+ *
+ * A controller offloads all-pairs closures to worker threads and learns
+ * about completion through palma_job_wait(), a callback and an eventfd.
+ * Checks that results match the synchronous calls, that the eventfd is
+ * readable whenever a final state is observed, and that cancellation, time
+ * budgets and palma_job_shutdown() stop queued and running jobs.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <poll.h>
+#include "example_check.h"
+
+#define SMALL   24
+#define LARGE   1000        /* Long enough to be caught running */
+#define ROUNDS  200
+
+static int callbacks;
+
+static void on_done(palma_job_t *job, void *user_data) {
+    (void)job;
+    __atomic_fetch_add((int*)user_data, 1, __ATOMIC_RELAXED);
+}
+
+static bool fd_readable(int fd) {
+    struct pollfd p = { fd, POLLIN, 0 };
+    return poll(&p, 1, 0) == 1 && (p.revents & POLLIN);
+}
+
+/* Submit a long closure and return once a worker has picked it up */
+static palma_job_t* start_large(const palma_matrix_t *big, const palma_job_options_t *opts) {
+    palma_job_t *job = palma_job_closure(big, PALMA_MINPLUS, opts);
+    while (job && palma_job_poll(job) == PALMA_JOB_QUEUED) palma_job_wait(job, 0.001);
+    return job;
+}
+
+int main(void) {
+    printf("=== Asynchronous Jobs ===\n");
+    palma_job_set_workers(2);
+
+    /* Results, callback and eventfd */
+    palma_job_options_t opts = { 0.0, on_done, &callbacks, true };
+    int fd_misses = 0, wrong = 0, done = 0;
+    for (size_t r = 0; r < ROUNDS; r++) {
+        palma_matrix_t *G = make_graph(SMALL, PALMA_MINPLUS, 7, SMALL, r);
+        palma_job_t *job = palma_job_closure(G, PALMA_MINPLUS, &opts);
+        if (!job && palma_get_last_error() == PALMA_ERR_UNSUPPORTED) {
+            opts.notify_fd = false;             /* No eventfd on this platform */
+            job = palma_job_closure(G, PALMA_MINPLUS, &opts);
+        }
+        palma_matrix_destroy(G);                /* The job works on a copy */
+        if (!job) {
+            wrong++;
+            continue;
+        }
+
+        if (palma_job_wait(job, -1.0) == PALMA_JOB_DONE) done++;
+        if (opts.notify_fd && !fd_readable(palma_job_fd(job))) fd_misses++;
+
+        G = make_graph(SMALL, PALMA_MINPLUS, 7, SMALL, r);
+        palma_matrix_t *ref = palma_matrix_closure(G, PALMA_MINPLUS);
+        palma_matrix_t *star = palma_job_take_matrix(job);
+        if (!same(star, ref)) wrong++;
+        palma_matrix_destroy(star);
+        palma_matrix_destroy(ref);
+        palma_matrix_destroy(G);
+        palma_job_destroy(job);
+    }
+    CHECK(done == ROUNDS && wrong == 0, "job results match palma_matrix_closure");
+    CHECK(fd_misses == 0, "eventfd is readable as soon as wait returns");
+    CHECK(callbacks == ROUNDS, "callback runs once per job");
+    printf("%d closure jobs: %d done, %d mismatches, eventfd late %d times, %d callbacks\n",
+           ROUNDS, done, wrong, fd_misses, callbacks);
+
+    palma_matrix_t *G = make_graph(SMALL, PALMA_MINPLUS, 7, SMALL, 3);
+    palma_job_t *eig = palma_job_eigenvalue(G, PALMA_MAXPLUS, NULL);
+    palma_job_wait(eig, -1.0);
+    CHECK(palma_job_value(eig) == palma_eigenvalue(G, PALMA_MAXPLUS), "eigenvalue job matches");
+    palma_job_destroy(eig);
+    palma_matrix_destroy(G);
+
+    /* Cancelling a running job */
+    palma_matrix_t *big = make_graph(LARGE, PALMA_MINPLUS, 7, LARGE, 1);
+    palma_job_t *job = start_large(big, NULL);
+    palma_job_cancel(job);
+    CHECK(palma_job_wait(job, 10.0) == PALMA_JOB_CANCELLED &&
+          palma_job_error(job) == PALMA_ERR_CANCELLED, "running job stops when cancelled");
+    palma_job_destroy(job);
+
+    /* Time budget */
+    palma_job_options_t budget = { 0.01, NULL, NULL, false };
+    job = palma_job_closure(big, PALMA_MINPLUS, &budget);
+    CHECK(palma_job_wait(job, 10.0) == PALMA_JOB_FAILED &&
+          palma_job_error(job) == PALMA_ERR_TIMEOUT, "job over its budget fails with TIMEOUT");
+    palma_job_destroy(job);
+
+    /* Shutdown cancels running and queued jobs, then the pool restarts */
+    palma_job_t *running[2], *queued;
+    running[0] = start_large(big, NULL);
+    running[1] = start_large(big, NULL);
+    queued = palma_job_closure(big, PALMA_MINPLUS, NULL);
+    palma_job_shutdown();
+    CHECK(palma_job_poll(running[0]) == PALMA_JOB_CANCELLED &&
+          palma_job_poll(running[1]) == PALMA_JOB_CANCELLED, "shutdown cancels running jobs");
+    CHECK(palma_job_poll(queued) == PALMA_JOB_CANCELLED, "shutdown cancels queued jobs");
+    palma_job_destroy(running[0]);
+    palma_job_destroy(running[1]);
+    palma_job_destroy(queued);
+
+    G = make_graph(SMALL, PALMA_MINPLUS, 7, SMALL, 5);
+    job = palma_job_all_pairs_paths(G, PALMA_MINPLUS, NULL);
+    palma_matrix_t *ref = palma_all_pairs_paths(G, PALMA_MINPLUS);
+    CHECK(palma_job_wait(job, -1.0) == PALMA_JOB_DONE, "pool restarts after shutdown");
+    palma_matrix_t *paths = palma_job_take_matrix(job);
+    CHECK(same(paths, ref), "all-pairs job matches palma_all_pairs_paths");
+    printf("Cancel, budget and shutdown stopped every long job\n");
+
+    palma_matrix_destroy(paths);
+    palma_matrix_destroy(ref);
+    palma_job_destroy(job);
+    palma_matrix_destroy(G);
+    palma_matrix_destroy(big);
+    palma_job_shutdown();
+
+    return example_result();
+}
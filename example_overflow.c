@@ -0,0 +1,82 @@
+/**
+ * @file example_overflow.c
+ * @brief Sparse Index Limits
+ *
+ * Sparse matrices store column indices in palma_idx_t (32 bits) and row
+ * pointers in palma_ptr_t (32 bits, or 64 with PALMA_USE_WIDE_ROW_PTR=1).
+ * This example checks that shapes and entry counts just inside the limits
+ * work exactly and that everything beyond them fails with
+ * PALMA_ERR_OVERFLOW up front, before any large allocation, instead of
+ * silently truncating an index.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "example_check.h"
+
+/* NULL result with PALMA_ERR_OVERFLOW as the recorded error */
+static bool overflowed(const void *result) {
+    bool ok = result == NULL && palma_get_last_error() == PALMA_ERR_OVERFLOW;
+    palma_clear_error();
+    return ok;
+}
+
+int main(void) {
+    printf("=== Sparse Index Limits ===\n");
+    printf("palma_ptr_t is %zu bits, palma_idx_t %zu bits\n",
+           8 * sizeof(palma_ptr_t), 8 * sizeof(palma_idx_t));
+
+    CHECK(sizeof(palma_ptr_t) == (PALMA_USE_WIDE_ROW_PTR ? 8 : 4), "row pointer width follows the build flag");
+    CHECK((uint64_t)PALMA_PTR_MAX == (PALMA_USE_WIDE_ROW_PTR ? UINT64_MAX : UINT32_MAX), "PALMA_PTR_MAX");
+    CHECK(palma_strerror(PALMA_ERR_OVERFLOW) != NULL, "error string");
+
+    /* The widest representable matrix keeps its last column exactly */
+    size_t wide_cols = (size_t)PALMA_IDX_MAX + 1;
+    palma_sparse_t *S = palma_sparse_create(2, wide_cols, 4, PALMA_MAXPLUS);
+    CHECK(S != NULL, "PALMA_IDX_MAX + 1 columns");
+    if (S) {
+        CHECK(palma_sparse_set(S, 1, wide_cols - 1, 7) == PALMA_SUCCESS &&
+              palma_sparse_set(S, 1, 0, 3) == PALMA_SUCCESS, "set at the last column");
+        CHECK(palma_sparse_get(S, 1, wide_cols - 1) == 7 && palma_sparse_get(S, 1, 0) == 3 &&
+              S->col_idx[S->row_ptr[1] + 1] == PALMA_IDX_MAX, "last column stored untruncated");
+        palma_sparse_destroy(S);
+    }
+    CHECK(overflowed(palma_sparse_create(2, wide_cols + 1, 4, PALMA_MAXPLUS)),
+          "one column too many overflows");
+    CHECK(overflowed(palma_dynsparse_create((size_t)UINT32_MAX + 1, 4, PALMA_MINPLUS)),
+          "dynamic matrix with 2^32 rows overflows");
+    CHECK(overflowed(palma_gen_erdos_renyi(wide_cols + 1, 0.0, PALMA_MINPLUS, NULL)),
+          "generator with 2^32 + 1 vertices overflows");
+
+#if !PALMA_USE_WIDE_ROW_PTR
+    /* Entry counts past 32-bit row pointers are rejected before allocating */
+    CHECK(overflowed(palma_sparse_create(4, 4, (size_t)UINT32_MAX + 1, PALMA_MAXPLUS)),
+          "capacity past PALMA_PTR_MAX overflows");
+    CHECK(overflowed(palma_gen_rmat(31, 4.0, PALMA_RMAT_A, PALMA_RMAT_B, PALMA_RMAT_C, PALMA_MAXPLUS, NULL)),
+          "R-MAT with 2^33 edges overflows");
+
+    char path[] = "/tmp/palma_overflow_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *fp = fd >= 0 ? fdopen(fd, "w") : NULL;
+    CHECK(fp != NULL, "temporary file");
+    if (fp) {
+        /* 3e9 declared entries, mirrored to 6e9 */
+        fprintf(fp, "%%%%MatrixMarket matrix coordinate integer symmetric\n"
+                    "100000 100000 3000000000\n1 2 5\n");
+        fclose(fp);
+        CHECK(overflowed(palma_sparse_load_mtx(path, PALMA_MINPLUS)),
+              "Matrix Market file declaring 6e9 entries overflows");
+        unlink(path);
+    }
+#endif
+
+    return example_result();
+}
@@ -0,0 +1,268 @@
+/**
+ * @file example_pack.c
+ * @brief Packed Files from Untrusted Sources
+ *
+ * Packed files are exchanged between sites, so the loader must treat them
+ * as untrusted input. This example round-trips dense and sparse matrices
+ * (whole and by row range), then loads damaged copies: header fields that
+ * promise more rows, columns or entries than the file holds, dimensions
+ * whose product overflows, offsets past the end, truncation, and every
+ * single-byte corruption of small files. Each must fail with an error
+ * code, never crash or allocate on the strength of the header alone.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "example_check.h"
+
+/* Byte offsets of the header fields, as written by palma_pack.c */
+#define OFF_ROWS      16
+#define OFF_COLS      24
+#define OFF_NNZ       32
+#define OFF_N_CHUNKS  44
+#define HEADER_SIZE   48
+
+static char dir[] = "/tmp/palma_pack_XXXXXX";
+
+static char* path_of(const char *name) {
+    static char buf[2][128];
+    static int which = 0;
+    which ^= 1;
+    snprintf(buf[which], sizeof(buf[which]), "%s/%s", dir, name);
+    return buf[which];
+}
+
+static uint8_t* slurp(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    *len = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *b = (uint8_t*)malloc(*len);
+    if (b && fread(b, 1, *len, fp) != *len) {
+        free(b);
+        b = NULL;
+    }
+    fclose(fp);
+    return b;
+}
+
+static void spill(const char *path, const uint8_t *b, size_t len) {
+    FILE *fp = fopen(path, "wb");
+    if (fp) {
+        fwrite(b, 1, len, fp);
+        fclose(fp);
+    }
+}
+
+static void put_u64(uint8_t *b, size_t at, uint64_t v) { memcpy(b + at, &v, sizeof(v)); }
+static void put_u32(uint8_t *b, size_t at, uint32_t v) { memcpy(b + at, &v, sizeof(v)); }
+
+static bool same_dense(const palma_matrix_t *A, const palma_matrix_t *B, size_t first) {
+    if (!A || !B || A->cols != B->cols) return false;
+    for (size_t i = 0; i < B->rows; i++) {
+        for (size_t j = 0; j < B->cols; j++) {
+            if (palma_matrix_get(A, first + i, j) != palma_matrix_get(B, i, j)) return false;
+        }
+    }
+    return true;
+}
+
+static bool same_sparse(const palma_sparse_t *A, const palma_sparse_t *B, size_t first) {
+    if (!A || !B || A->cols != B->cols) return false;
+    for (size_t i = 0; i < B->rows; i++) {
+        for (size_t j = 0; j < B->cols; j++) {
+            if (palma_sparse_get(A, first + i, j) != palma_sparse_get(B, i, j)) return false;
+        }
+    }
+    return B->row_ptr[B->rows] == B->nnz;
+}
+
+/* Load a damaged dense copy and expect `expect` */
+static void dense_fails(const uint8_t *good, size_t len, size_t field, uint64_t value, int width,
+                        palma_error_t expect, const char *what) {
+    uint8_t *b = (uint8_t*)malloc(len);
+    memcpy(b, good, len);
+    if (width == 8) put_u64(b, field, value);
+    else put_u32(b, field, (uint32_t)value);
+    spill(path_of("bad.plz"), b, len);
+    free(b);
+
+    palma_clear_error();
+    palma_matrix_t *M = palma_matrix_load_packed(path_of("bad.plz"));
+    CHECK(M == NULL && palma_get_last_error() == expect, what);
+    palma_matrix_destroy(M);
+}
+
+static void sparse_fails(const uint8_t *good, size_t len, size_t field, uint64_t value, int width,
+                         palma_error_t expect, const char *what) {
+    uint8_t *b = (uint8_t*)malloc(len);
+    memcpy(b, good, len);
+    if (width == 8) put_u64(b, field, value);
+    else put_u32(b, field, (uint32_t)value);
+    spill(path_of("bad.plz"), b, len);
+    free(b);
+
+    palma_clear_error();
+    palma_sparse_t *S = palma_sparse_load_packed(path_of("bad.plz"));
+    CHECK(S == NULL && palma_get_last_error() == expect, what);
+    palma_sparse_destroy(S);
+}
+
+int main(void) {
+    printf("=== Packed Files ===\n");
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    /* Dense: runs of -inf and +inf between finite values, several chunks */
+    palma_matrix_t *A = palma_matrix_create(150, 90);
+    for (size_t i = 0; i < A->rows; i++) {
+        for (size_t j = 0; j < A->cols; j++) {
+            palma_val_t v = (j % 17 < 6) ? PALMA_NEG_INF : (i % 31 == 0 ? PALMA_POS_INF
+                                                                        : (palma_val_t)((i * 7 + j * 13) % 1000 - 200));
+            palma_matrix_set(A, i, j, v);
+        }
+    }
+    CHECK(palma_matrix_save_packed(A, path_of("dense.plz")) == PALMA_SUCCESS, "save dense");
+    palma_matrix_t *B = palma_matrix_load_packed(path_of("dense.plz"));
+    CHECK(B && B->rows == 150 && same_dense(A, B, 0), "dense round trip");
+    palma_matrix_destroy(B);
+    B = palma_matrix_load_packed_rows(path_of("dense.plz"), 70, 40);
+    CHECK(B && B->rows == 40 && same_dense(A, B, 70), "dense rows 70..109");
+    palma_matrix_destroy(B);
+
+    /* Sparse: banded with gaps, several chunks */
+    palma_sparse_t *S = palma_sparse_create(200, 300, 0, PALMA_MINPLUS);
+    for (size_t i = 0; i < 200; i++) {
+        for (size_t j = i; j < 300; j += 1 + (i + j) % 37) palma_sparse_set(S, i, j, (palma_val_t)((i + j) % 50));
+    }
+    CHECK(palma_sparse_save_packed(S, path_of("sparse.plz")) == PALMA_SUCCESS, "save sparse");
+    palma_sparse_t *T = palma_sparse_load_packed(path_of("sparse.plz"));
+    CHECK(T && T->nnz == S->nnz && T->semiring == PALMA_MINPLUS && same_sparse(S, T, 0), "sparse round trip");
+    palma_sparse_destroy(T);
+    T = palma_sparse_load_packed_rows(path_of("sparse.plz"), 63, 70);
+    CHECK(T && T->rows == 70 && same_sparse(S, T, 63), "sparse rows 63..132");
+    palma_sparse_destroy(T);
+    printf("%zu x %zu dense and %zu-entry sparse matrices round-tripped\n", A->rows, A->cols, S->nnz);
+
+    /* Damaged headers */
+    size_t dlen = 0, slen = 0;
+    uint8_t *dense = slurp(path_of("dense.plz"), &dlen);
+    uint8_t *sparse = slurp(path_of("sparse.plz"), &slen);
+    CHECK(dense && sparse, "read back both files");
+    if (dense && sparse) {
+        dense_fails(dense, dlen, OFF_COLS, ((uint64_t)1 << 62) + 8, 8, PALMA_ERR_OVERFLOW,
+                    "dense rows x cols past the address space");
+        dense_fails(dense, dlen, OFF_COLS, (uint64_t)1 << 40, 8, PALMA_ERR_FILE_FORMAT,
+                    "dense columns the chunks do not contain");
+        dense_fails(dense, dlen, OFF_ROWS, (uint64_t)PALMA_PACK_CHUNK_ROWS << 31, 8, PALMA_ERR_FILE_FORMAT,
+                    "dense rows with a mismatched chunk count");
+        dense_fails(dense, dlen, OFF_N_CHUNKS, UINT32_MAX, 4, PALMA_ERR_FILE_FORMAT,
+                    "chunk count larger than the file");
+        dense_fails(dense, dlen, HEADER_SIZE + 8, (uint64_t)1 << 50, 8, PALMA_ERR_FILE_FORMAT,
+                    "chunk offset past the end of the file");
+        dense_fails(dense, dlen, HEADER_SIZE, 0, 8, PALMA_ERR_FILE_FORMAT,
+                    "chunk offset inside the header");
+
+        /* A header consistent with itself, but far larger than the payload */
+        uint8_t *b = (uint8_t*)malloc(dlen);
+        memcpy(b, dense, dlen);
+        uint64_t rows = (uint64_t)PALMA_PACK_CHUNK_ROWS * 65536;
+        put_u64(b, OFF_ROWS, rows);
+        put_u32(b, OFF_N_CHUNKS, 65536);
+        spill(path_of("bad.plz"), b, dlen);
+        free(b);
+        palma_clear_error();
+        B = palma_matrix_load_packed(path_of("bad.plz"));
+        CHECK(B == NULL && palma_get_last_error() == PALMA_ERR_FILE_FORMAT, "4M rows declared in a small file");
+        palma_matrix_destroy(B);
+
+        sparse_fails(sparse, slen, OFF_NNZ, S->nnz + 1, 8, PALMA_ERR_FILE_FORMAT,
+                     "sparse nnz disagreeing with the chunks");
+        sparse_fails(sparse, slen, OFF_ROWS, 255, 8, PALMA_ERR_FILE_FORMAT,
+                     "sparse rows past the stored chunks");
+
+        /* First chunk claims 2^28 entries in a few hundred bytes */
+        uint64_t first;
+        memcpy(&first, sparse + HEADER_SIZE, sizeof(first));
+        b = (uint8_t*)malloc(slen);
+        memcpy(b, sparse, slen);
+        b[first] = 0xFF;
+        b[first + 1] = 0xFF;
+        b[first + 2] = 0xFF;
+        b[first + 3] = 0x7F;
+        spill(path_of("bad.plz"), b, slen);
+        free(b);
+        palma_clear_error();
+        T = palma_sparse_load_packed(path_of("bad.plz"));
+        CHECK(T == NULL && palma_get_last_error() == PALMA_ERR_FILE_FORMAT, "chunk entry count past its bytes");
+        palma_sparse_destroy(T);
+
+        spill(path_of("bad.plz"), sparse, slen - 9);
+        palma_clear_error();
+        T = palma_sparse_load_packed(path_of("bad.plz"));
+        CHECK(T == NULL && palma_get_last_error() == PALMA_ERR_FILE_FORMAT, "truncated file");
+        palma_sparse_destroy(T);
+    }
+    free(dense);
+    free(sparse);
+
+    /* Every byte of small files, damaged one at a time: loads or fails, never crashes */
+    palma_matrix_t *a = palma_matrix_create(5, 7);
+    palma_sparse_t *s = palma_sparse_create(6, 9, 0, PALMA_MAXPLUS);
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 7; j++) palma_matrix_set(a, i, j, (i + j) % 3 ? (palma_val_t)(i * j) : PALMA_NEG_INF);
+    }
+    for (size_t i = 0; i < 6; i++) palma_sparse_set(s, i, (i * 4) % 9, (palma_val_t)i + 1);
+    palma_matrix_save_packed(a, path_of("small_dense.plz"));
+    palma_sparse_save_packed(s, path_of("small_sparse.plz"));
+    size_t loaded = 0, refused = 0;
+    for (int kind = 0; kind < 2; kind++) {
+        size_t len = 0;
+        uint8_t *good = slurp(path_of(kind ? "small_sparse.plz" : "small_dense.plz"), &len);
+        for (size_t at = 0; good && at < len; at++) {
+            for (int flip = 0; flip < 3; flip++) {
+                static const uint8_t masks[3] = { 0x01, 0x80, 0xFF };
+                good[at] ^= masks[flip];
+                spill(path_of("fuzz.plz"), good, len);
+                good[at] ^= masks[flip];
+                if (kind) {
+                    palma_sparse_t *t = palma_sparse_load_packed(path_of("fuzz.plz"));
+                    if (t && t->row_ptr[t->rows] != t->nnz) failures++;
+                    t ? loaded++ : refused++;
+                    palma_sparse_destroy(t);
+                } else {
+                    palma_matrix_t *t = palma_matrix_load_packed(path_of("fuzz.plz"));
+                    t ? loaded++ : refused++;
+                    palma_matrix_destroy(t);
+                }
+            }
+        }
+        free(good);
+    }
+    printf("single-byte corruptions: %zu loaded, %zu refused\n", loaded, refused);
+    CHECK(refused > 0, "corrupt files are refused");
+
+    const char *names[] = { "dense.plz", "sparse.plz", "bad.plz", "small_dense.plz", "small_sparse.plz", "fuzz.plz" };
+    for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++) unlink(path_of(names[k]));
+    rmdir(dir);
+
+    palma_matrix_destroy(a);
+    palma_sparse_destroy(s);
+    palma_matrix_destroy(A);
+    palma_sparse_destroy(S);
+
+    return example_result();
+}
@@ -0,0 +1,126 @@
+/**
+ * @file example_planner.c
+ * @brief Letting the Planner Pick the Path Engine
+ *
+ * Builds graphs that favour different engines (a max-plus DAG, sparse
+ * nonnegative min-plus, min-plus with negative edges but no negative cycle,
+ * a dense bottleneck graph), checks the structure analysis and the chosen
+ * engine, and checks every automatic result against the direct closure and
+ * product, which must agree whatever the plan.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define N 160
+
+typedef enum { DAG_MAXPLUS, NONNEG_MINPLUS, NEGATIVE_MINPLUS, DENSE_MAXMIN } graph_kind_t;
+
+static const char *kind_names[] = {
+    "max-plus DAG", "min-plus, w >= 0", "min-plus, w < 0", "dense max-min"
+};
+
+/* Potential p(i): reweighting w + p(i) - p(j) keeps every cycle weight */
+static palma_val_t potential(size_t i) { return (palma_val_t)((i * 5) % 13); }
+
+/* Sparse kinds take one pair in 20 from make_graph; the max-min graph is dense and symmetric */
+static palma_matrix_t* planner_graph(graph_kind_t kind, palma_semiring_t *s) {
+    *s = kind == DAG_MAXPLUS ? PALMA_MAXPLUS : kind == DENSE_MAXMIN ? PALMA_MAXMIN : PALMA_MINPLUS;
+    if (kind == DAG_MAXPLUS) return make_graph(N, *s, 20, 0, 0);
+    if (kind != DENSE_MAXMIN) {
+        palma_matrix_t *G = make_graph(N, *s, 20, N, 0);
+        for (size_t i = 0; G && kind == NEGATIVE_MINPLUS && i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                palma_val_t w = palma_matrix_get(G, i, j);
+                if (w != PALMA_POS_INF) palma_matrix_set(G, i, j, w + potential(i) - potential(j));
+            }
+        }
+        return G;
+    }
+
+    palma_matrix_t *G = palma_matrix_create_zero(N, N, *s);
+    for (size_t i = 0; G && i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            if (i != j && (i + j) % 3 != 0) palma_matrix_set(G, i, j, (palma_val_t)((i + j) % 20 + 1));
+        }
+    }
+    return G;
+}
+
+int main(void) {
+    printf("=== Algorithm Planner ===\n");
+    printf("%-18s %6s %4s %7s | %-20s %-20s\n", "graph", "nnz", "dag", "nonneg", "closure", "single source");
+
+    for (int kind = DAG_MAXPLUS; kind <= DENSE_MAXMIN; kind++) {
+        palma_semiring_t s;
+        palma_matrix_t *A = planner_graph((graph_kind_t)kind, &s);
+        palma_sparse_t *S = palma_sparse_from_dense(A, s);
+
+        palma_structure_t info, sinfo;
+        CHECK(palma_analyze(&info, A, s) == PALMA_SUCCESS, "analyze");
+        CHECK(palma_sparse_analyze(&sinfo, S) == PALMA_SUCCESS, "sparse analyze");
+        CHECK(info.nnz == S->nnz && sinfo.nnz == S->nnz && info.is_dag == sinfo.is_dag &&
+              info.nonnegative == sinfo.nonnegative && info.symmetric == sinfo.symmetric,
+              "dense and sparse analysis agree");
+        CHECK(info.is_dag == (kind == DAG_MAXPLUS), "acyclicity detected");
+        CHECK(info.nonnegative == (kind == NONNEG_MINPLUS || kind == DENSE_MAXMIN), "weight signs detected");
+        CHECK(info.symmetric == (kind == DENSE_MAXMIN), "symmetry detected");
+
+        /* Closure: every engine must match Floyd-Warshall */
+        palma_matrix_t *ref = palma_matrix_closure(A, s);
+        palma_matrix_t *D = palma_matrix_create(N, N);
+        palma_plan_t closure_plan, sparse_plan, source_plan;
+        CHECK(palma_auto_closure_into(D, A, s, &closure_plan) == PALMA_SUCCESS && same(D, ref),
+              "auto closure matches the direct closure");
+        CHECK(palma_sparse_auto_closure_into(D, S, &sparse_plan) == PALMA_SUCCESS && same(D, ref),
+              "sparse auto closure matches the direct closure");
+        CHECK(closure_plan.cost <= closure_plan.dense_cost, "plan never costs more than the baseline");
+
+        /* Single source: row `source` of A* */
+        palma_val_t dist[N];
+        bool rows_ok = true;
+        for (size_t src = 0; src < N; src += 23) {
+            rows_ok = rows_ok && palma_auto_single_source(A, src, dist, s, &source_plan) == PALMA_SUCCESS;
+            for (size_t j = 0; rows_ok && j < N; j++) rows_ok = dist[j] == palma_matrix_get(ref, src, j);
+            rows_ok = rows_ok && palma_sparse_auto_single_source(S, src, dist, NULL) == PALMA_SUCCESS;
+            for (size_t j = 0; rows_ok && j < N; j++) rows_ok = dist[j] == palma_matrix_get(ref, src, j);
+        }
+        CHECK(rows_ok, "auto single source matches rows of the closure");
+
+        palma_engine_t expect = kind == DAG_MAXPLUS ? PALMA_ENGINE_DAG_SWEEP :
+                                kind == NEGATIVE_MINPLUS ? PALMA_ENGINE_BELLMAN_FORD :
+                                kind == NONNEG_MINPLUS ? PALMA_ENGINE_DIJKSTRA : source_plan.engine;
+        CHECK(source_plan.engine == expect, "single-source engine follows the structure");
+
+        printf("%-18s %6zu %4s %7s | %-20s %-20s\n", kind_names[kind], info.nnz,
+               info.is_dag ? "yes" : "no", info.nonnegative ? "yes" : "no",
+               palma_engine_name(closure_plan.engine), palma_engine_name(source_plan.engine));
+
+        /* Multiplication: sparse graphs go sparse, the dense one stays dense */
+        palma_matrix_t *prod = palma_matrix_mul(A, A, s);
+        palma_plan_t mul_plan;
+        CHECK(palma_auto_mul_into(D, A, A, s, &mul_plan) == PALMA_SUCCESS && same(D, prod),
+              "auto multiplication matches the direct product");
+        CHECK(mul_plan.engine == (kind == DENSE_MAXMIN ? PALMA_ENGINE_DENSE_GEMM : PALMA_ENGINE_SPARSE_GEMM),
+              "multiplication engine follows the density");
+
+        palma_matrix_destroy(prod);
+        palma_matrix_destroy(D);
+        palma_matrix_destroy(ref);
+        palma_sparse_destroy(S);
+        palma_matrix_destroy(A);
+    }
+
+    palma_structure_t info;
+    palma_matrix_t *rect = palma_matrix_create(3, 4);
+    CHECK(palma_analyze(&info, rect, PALMA_MAXPLUS) == PALMA_ERR_NOT_SQUARE, "non-square input is rejected");
+    palma_matrix_destroy(rect);
+
+    return example_result();
+}
@@ -0,0 +1,159 @@
+/**
+ * @file example_profile.c
+ * @brief Hardware Counters per Tropical Operation
+ *
+ * Profiles max-plus multiplications with palma_profile_begin/end and
+ * checks what the counters promise: a region ten times larger counts more
+ * cycles and instructions, begin resets the counts, the available mask
+ * matches palma_profiler_has, and per-operation rates are the counts
+ * divided by the attributed operations. Hosts without a PMU or with
+ * perf_event_paranoid too high (containers, most VMs) must instead get
+ * NULL with PALMA_ERR_UNSUPPORTED from palma_profiler_create; the NULL
+ * handling, per-operation rates and printing are checked on both.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "example_check.h"
+
+#define N 64
+
+/* Profile calls max-plus products of A with itself, attributing N³ ops to each */
+static bool profile_mul(palma_profiler_t *prof, palma_matrix_t *C, const palma_matrix_t *A,
+                        int calls, palma_profile_t *out) {
+    bool ok = palma_profile_begin(prof) == PALMA_SUCCESS;
+    for (int i = 0; i < calls; i++) {
+        if (palma_matrix_mul_into(C, A, A, PALMA_MAXPLUS) != PALMA_SUCCESS) ok = false;
+    }
+    return palma_profile_end(prof, (double)calls * N * N * N, out) == PALMA_SUCCESS && ok;
+}
+
+static bool counted(const palma_profile_t *p, palma_counter_t c) {
+    return (p->available & (1u << c)) != 0;
+}
+
+/* Print p and check the output names every counter and shows IPC when it can */
+static bool prints(const palma_profile_t *p) {
+    FILE *fp = tmpfile();
+    if (!fp) return false;
+    palma_profile_print(p, "mul", fp);
+    char text[2048];
+    rewind(fp);
+    size_t len = fread(text, 1, sizeof(text) - 1, fp);
+    text[len] = '\0';
+    fclose(fp);
+
+    bool ok = strncmp(text, "mul: ", 5) == 0;
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (!strstr(text, palma_counter_name((palma_counter_t)i))) ok = false;
+    }
+    bool missing = (p->available & ((1u << PALMA_COUNTER_COUNT) - 1)) != ((1u << PALMA_COUNTER_COUNT) - 1);
+    if (missing != (strstr(text, "not available") != NULL)) ok = false;
+    bool ipc = counted(p, PALMA_COUNTER_CYCLES) && counted(p, PALMA_COUNTER_INSTRUCTIONS) &&
+               p->value[PALMA_COUNTER_CYCLES] > 0;
+    if (ipc != (strstr(text, "IPC") != NULL)) ok = false;
+    return ok;
+}
+
+int main(void) {
+    printf("=== Performance Counters ===\n");
+
+    palma_matrix_t *A = palma_matrix_create(N, N);
+    palma_matrix_t *C = palma_matrix_create(N, N);
+    if (!A || !C) return EXIT_FAILURE;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) palma_matrix_set(A, i, j, (palma_val_t)((i * 31 + j * 17) % 97));
+    }
+
+    palma_profiler_t *prof = palma_profiler_create();
+    if (!prof) {
+        /* The benchmark and callers rely on exactly this to fall back */
+        printf("no hardware counters here (%s)\n", palma_strerror(palma_get_last_error()));
+        CHECK(palma_get_last_error() == PALMA_ERR_UNSUPPORTED, "unavailable counters report UNSUPPORTED");
+    } else {
+        uint32_t opened = 0;
+        for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+            if (palma_profiler_has(prof, (palma_counter_t)i)) opened |= 1u << i;
+        }
+        CHECK(opened != 0, "a profiler has at least one counter");
+
+        palma_profile_t small, large, again;
+        CHECK(profile_mul(prof, C, A, 2, &small), "profile 2 products");
+        CHECK(profile_mul(prof, C, A, 20, &large), "profile 20 products");
+        CHECK(profile_mul(prof, C, A, 2, &again), "profile 2 products again");
+        palma_profile_print(&large, "20 products", stdout);
+
+        CHECK((large.available & ~opened) == 0, "only opened counters are available");
+        CHECK(large.ops == 20.0 * N * N * N && large.time_ns > small.time_ns, "ops and wall time recorded");
+        for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+            palma_counter_t c = (palma_counter_t)i;
+            if (!counted(&large, c)) {
+                CHECK(palma_profile_per_op(&large, c) == -1.0, "no rate for an uncounted event");
+                continue;
+            }
+            CHECK(palma_profile_per_op(&large, c) == (double)large.value[c] / large.ops, "rate is count / ops");
+        }
+        /* Misses may be near zero in cache; work scales cycles and instructions */
+        palma_counter_t work[2] = { PALMA_COUNTER_CYCLES, PALMA_COUNTER_INSTRUCTIONS };
+        for (int k = 0; k < 2; k++) {
+            if (!counted(&large, work[k]) || !counted(&small, work[k]) || !counted(&again, work[k])) continue;
+            CHECK(large.value[work[k]] > small.value[work[k]], "ten times the work counts more");
+            CHECK(again.value[work[k]] < large.value[work[k]], "begin resets the counts");
+        }
+        CHECK(prints(&large), "profile printed");
+
+        /* A region without attributed operations has no per-op rates */
+        CHECK(profile_mul(prof, C, A, 1, &small), "profile without ops");
+        small.ops = 0;
+        CHECK(palma_profile_per_op(&small, PALMA_COUNTER_CYCLES) == -1.0, "no rate without ops");
+        palma_profiler_destroy(prof);
+    }
+
+    /* Rates and printing of a given profile, with and without counters */
+    palma_profile_t p;
+    memset(&p, 0, sizeof(p));
+    p.ops = 1000;
+    p.time_ns = 1500;
+    p.value[PALMA_COUNTER_CYCLES] = 4000;
+    p.value[PALMA_COUNTER_INSTRUCTIONS] = 6000;
+    p.value[PALMA_COUNTER_LLC_MISSES] = 25;
+    p.available = (1u << PALMA_COUNTER_CYCLES) | (1u << PALMA_COUNTER_INSTRUCTIONS) |
+                  (1u << PALMA_COUNTER_LLC_MISSES);
+    CHECK(palma_profile_per_op(&p, PALMA_COUNTER_CYCLES) == 4.0 &&
+          palma_profile_per_op(&p, PALMA_COUNTER_LLC_MISSES) == 0.025, "per-op rates");
+    CHECK(palma_profile_per_op(&p, PALMA_COUNTER_L1D_MISSES) == -1.0, "missing counter has no rate");
+    CHECK(palma_profile_per_op(&p, PALMA_COUNTER_COUNT) == -1.0 &&
+          palma_profile_per_op(NULL, PALMA_COUNTER_CYCLES) == -1.0, "invalid rate queries");
+    CHECK(prints(&p), "partial profile printed with IPC");
+    p.available = 0;
+    CHECK(prints(&p), "empty profile printed");
+
+    bool names_ok = strcmp(palma_counter_name(PALMA_COUNTER_COUNT), "unknown") == 0;
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        for (int j = 0; j < i; j++) {
+            if (strcmp(palma_counter_name((palma_counter_t)i), palma_counter_name((palma_counter_t)j)) == 0) {
+                names_ok = false;
+            }
+        }
+    }
+    CHECK(names_ok, "distinct counter names");
+
+    /* NULL profilers are rejected, never dereferenced */
+    CHECK(!palma_profiler_has(NULL, PALMA_COUNTER_CYCLES), "NULL profiler has no counters");
+    CHECK(palma_profile_begin(NULL) == PALMA_ERR_NULL_PTR, "begin on NULL");
+    CHECK(palma_profile_end(NULL, 0, &p) == PALMA_ERR_NULL_PTR, "end on NULL");
+    palma_profiler_destroy(NULL);
+    palma_profile_print(NULL, "none", stdout);
+    palma_clear_error();
+
+    palma_matrix_destroy(A);
+    palma_matrix_destroy(C);
+
+    return example_result();
+}
@@ -0,0 +1,252 @@
+/**
+ * @file example_query.c
+ * @brief Serving Route Queries from a Resident Closure
+ *
+ * Starts palma_server on a temporary socket with a road network, queries
+ * distances, reachability and completion times through the client API and
+ * checks them against palma_matrix_closure. Then checks the server's
+ * defences: a client that floods requests without reading is throttled
+ * instead of growing server memory, a live or foreign socket path is never
+ * replaced, and a stale socket from a killed server is.
+ *
+ * Usage: example_query [path/to/palma_server]
+ * (default: palma_server next to this program)
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "example_check.h"
+
+#define N             30
+#define FLOOD_LIMIT   (12u << 20)     /* INFO requests: 240 MiB if never throttled */
+#define HWM_LIMIT_KB  (192u << 10)    /* 64 MiB output cap plus slack */
+
+static char server_bin[4096];
+static char dir[] = "/tmp/palma_query_XXXXXX";
+static char sock_path[128], model_path[128], model_spec[160];
+
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static pid_t start_server(const char *path) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+        }
+        execl(server_bin, server_bin, "-s", path, model_spec, (char*)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+/* Connect once the server listens; NULL if it exited or never came up */
+static palma_client_t* await_server(pid_t pid, const char *path) {
+    for (int i = 0; i < 500; i++) {
+        palma_client_t *c = palma_client_connect(path);
+        if (c) return c;
+        if (waitpid(pid, NULL, WNOHANG) == pid) return NULL;
+        sleep_ms(10);
+    }
+    return NULL;
+}
+
+static int stop_server(pid_t pid, int sig) {
+    int status = -1;
+    kill(pid, sig);
+    waitpid(pid, &status, 0);
+    return status;
+}
+
+/* Exit status of a server expected to refuse its socket path, -1 if it keeps running */
+static int refused_status(const char *path) {
+    pid_t pid = start_server(path);
+    for (int i = 0; i < 300; i++) {
+        int status;
+        if (waitpid(pid, &status, WNOHANG) == pid) return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        sleep_ms(10);
+    }
+    stop_server(pid, SIGKILL);
+    return -1;
+}
+
+static long peak_rss_kb(pid_t pid) {
+    char path[64], line[256];
+    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
+    FILE *f = fopen(path, "r");
+    long kb = -1;
+    while (f && fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) kb = strtol(line + 6, NULL, 10);
+    }
+    if (f) fclose(f);
+    return kb;
+}
+
+/* Pipeline INFO requests without reading; returns how many the server let through */
+static size_t flood(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) return 0;
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+
+    enum { BATCH = 3200 };
+    static palma_query_header_t reqs[BATCH];
+    for (size_t i = 0; i < BATCH; i++) {
+        palma_query_header_t h = { PALMA_QUERY_MAGIC, PALMA_QUERY_INFO, 0, (uint32_t)i, 0, 0 };
+        reqs[i] = h;
+    }
+
+    size_t sent_bytes = 0, batch_pos = 0;
+    while (sent_bytes / sizeof(palma_query_header_t) < FLOOD_LIMIT) {
+        ssize_t n = send(fd, (char*)reqs + batch_pos, sizeof(reqs) - batch_pos, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent_bytes += (size_t)n;
+            batch_pos = (batch_pos + (size_t)n) % sizeof(reqs);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) break;
+
+        /* The server has stopped reading if the socket stays full */
+        struct pollfd p = { fd, POLLOUT, 0 };
+        if (poll(&p, 1, 500) == 0) break;
+    }
+
+    close(fd);
+    return sent_bytes / sizeof(palma_query_header_t);
+}
+
+int main(int argc, char **argv) {
+    printf("=== Query Server ===\n");
+
+    if (argc > 1) {
+        snprintf(server_bin, sizeof(server_bin), "%s", argv[1]);
+    } else {
+        const char *slash = strrchr(argv[0], '/');
+        int len = slash ? (int)(slash - argv[0]) : 1;
+        snprintf(server_bin, sizeof(server_bin), "%.*s/palma_server", len, slash ? argv[0] : ".");
+    }
+    if (!mkdtemp(dir)) return EXIT_FAILURE;
+    snprintf(sock_path, sizeof(sock_path), "%s/palma.sock", dir);
+    snprintf(model_path, sizeof(model_path), "%s/roads.bin", dir);
+    snprintf(model_spec, sizeof(model_spec), "%s@minplus", model_path);
+
+    /* Ring road with shortcuts */
+    palma_matrix_t *roads = palma_matrix_create_zero(N, N, PALMA_MINPLUS);
+    for (size_t i = 0; i < N; i++) {
+        palma_matrix_set(roads, i, (i + 1) % N, (palma_val_t)(i % 5 + 1));
+        if (i % 4 == 0) palma_matrix_set(roads, i, (i + 7) % N, 9);
+    }
+    palma_matrix_save_binary(roads, model_path);
+    palma_matrix_t *star = palma_matrix_closure(roads, PALMA_MINPLUS);
+
+    pid_t pid = start_server(sock_path);
+    palma_client_t *c = await_server(pid, sock_path);
+    CHECK(c != NULL, "server starts and accepts connections");
+    if (!c) {
+        stop_server(pid, SIGKILL);
+        return EXIT_FAILURE;
+    }
+
+    /* Answers match the closure */
+    palma_val_t info[2];
+    size_t count;
+    CHECK(palma_client_query(c, PALMA_QUERY_INFO, 0, NULL, 0, info, 2, &count) == PALMA_SUCCESS &&
+          count == 2 && info[0] == N && info[1] == PALMA_MINPLUS, "INFO reports the model");
+
+    uint32_t pairs[2 * N * N];
+    palma_val_t dist[N * N], reach[N * N];
+    for (uint32_t i = 0; i < N; i++) {
+        for (uint32_t j = 0; j < N; j++) {
+            pairs[2 * (i * N + j)] = i;
+            pairs[2 * (i * N + j) + 1] = j;
+        }
+    }
+    CHECK(palma_client_query(c, PALMA_QUERY_DISTANCE, 0, pairs, N * N, dist, N * N, &count) == PALMA_SUCCESS &&
+          count == N * N, "batched DISTANCE query");
+    CHECK(palma_client_query(c, PALMA_QUERY_REACHABLE, 0, pairs, N * N, reach, N * N, &count) == PALMA_SUCCESS,
+          "batched REACHABLE query");
+    bool match = true;
+    for (size_t k = 0; k < (size_t)N * N; k++) {
+        palma_val_t d = palma_matrix_get(star, k / N, k % N);
+        match = match && dist[k] == d && reach[k] == (d != PALMA_POS_INF);
+    }
+    CHECK(match, "distances and reachability match palma_matrix_closure");
+
+    uint32_t bad[2] = { 0, N };
+    CHECK(palma_client_query(c, PALMA_QUERY_DISTANCE, 0, bad, 1, dist, 1, &count) == PALMA_ERR_INDEX_BOUNDS,
+          "out-of-range node is rejected");
+    CHECK(palma_client_query(c, PALMA_QUERY_INFO, 7, NULL, 0, info, 2, &count) == PALMA_ERR_INVALID_ARG,
+          "unknown model is rejected");
+    printf("%d x %d distances served and checked\n", N, N);
+
+    /* A client that never reads is throttled */
+    size_t through = flood(sock_path);
+    long hwm = peak_rss_kb(pid);
+    printf("Flooding client: %zu of %u requests accepted, server peak RSS %ld KiB\n",
+           through, FLOOD_LIMIT, hwm);
+    CHECK(through < FLOOD_LIMIT, "server stops reading from a client that does not read");
+    CHECK(hwm < 0 || hwm < (long)HWM_LIMIT_KB, "server memory stays bounded under a flood");
+    CHECK(palma_client_query(c, PALMA_QUERY_INFO, 0, NULL, 0, info, 2, &count) == PALMA_SUCCESS,
+          "other clients are still served");
+    palma_client_close(c);
+
+    /* A live server's socket is not taken over; neither is a regular file */
+    CHECK(refused_status(sock_path) > 0, "second server refuses a live socket");
+    char file_path[160];
+    snprintf(file_path, sizeof(file_path), "%s/not-a-socket", dir);
+    FILE *f = fopen(file_path, "w");
+    if (f) fclose(f);
+    struct stat st;
+    CHECK(refused_status(file_path) > 0 && stat(file_path, &st) == 0 && S_ISREG(st.st_mode),
+          "server refuses to remove a regular file");
+
+    /* SIGTERM cleans up; a killed server leaves a stale socket that is reused */
+    CHECK(WIFEXITED(stop_server(pid, SIGTERM)) && access(sock_path, F_OK) != 0,
+          "SIGTERM removes the socket");
+    pid = start_server(sock_path);
+    c = await_server(pid, sock_path);
+    palma_client_close(c);
+    stop_server(pid, SIGKILL);
+    CHECK(access(sock_path, F_OK) == 0, "killed server leaves its socket behind");
+    pid = start_server(sock_path);
+    c = await_server(pid, sock_path);
+    CHECK(c != NULL, "stale socket from a killed server is replaced");
+    palma_client_close(c);
+    stop_server(pid, SIGTERM);
+
+    unlink(file_path);
+    unlink(model_path);
+    unlink(sock_path);
+    rmdir(dir);
+    palma_matrix_destroy(star);
+    palma_matrix_destroy(roads);
+
+    return example_result();
+}
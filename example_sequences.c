@@ -0,0 +1,86 @@
+/**
+ * @file example_sequences.c
+ * @brief Time-Varying Max-Plus Systems with Matrix Sequences
+ *
+ * A production line whose processing times change every cycle is the
+ * system x(k) = A(k) ⊗ x(k-1). This example propagates it with
+ * palma_matrix_sequence_product, _prefix and _apply and checks each result
+ * against the plain step-by-step products.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define STAGES  4
+#define CYCLES  13
+
+int main(void) {
+    printf("=== Time-Varying Production Line ===\n");
+    printf("%d stages, %d cycles with changing processing times.\n\n", STAGES, CYCLES);
+
+    /* A(k): stage i waits for stage i-1 and for itself, times vary by cycle */
+    palma_matrix_t *mats[CYCLES];
+    for (int k = 0; k < CYCLES; k++) {
+        mats[k] = palma_matrix_create_zero(STAGES, STAGES, PALMA_MAXPLUS);
+        for (int i = 0; i < STAGES; i++) {
+            palma_matrix_set(mats[k], i, i, 2 + (k + i) % 3);
+            if (i > 0) palma_matrix_set(mats[k], i, i - 1, 1 + (k * i) % 4);
+        }
+    }
+
+    /* Reference: P(k) = A(k) ⊗ P(k-1), one multiplication per cycle */
+    palma_matrix_t *ref[CYCLES];
+    ref[0] = palma_matrix_clone(mats[0]);
+    for (int k = 1; k < CYCLES; k++) {
+        ref[k] = palma_matrix_mul(mats[k], ref[k - 1], PALMA_MAXPLUS);
+    }
+
+    const palma_matrix_t *const *seq = (const palma_matrix_t *const *)mats;
+
+    /* Whole product by tree reduction */
+    palma_matrix_t *P = palma_matrix_sequence_product(seq, CYCLES, PALMA_MAXPLUS);
+    CHECK(same(P, ref[CYCLES - 1]), "tree product matches step-by-step product");
+    palma_matrix_print(P, "A(13) ⊗ ... ⊗ A(1)", PALMA_MAXPLUS, stdout);
+
+    /* Every intermediate product by parallel prefix scan */
+    palma_matrix_t *prefix[CYCLES];
+    for (int k = 0; k < CYCLES; k++) prefix[k] = palma_matrix_create(STAGES, STAGES);
+    CHECK(palma_matrix_sequence_prefix(prefix, seq, CYCLES, PALMA_MAXPLUS) == PALMA_SUCCESS,
+          "prefix scan succeeds");
+    for (int k = 0; k < CYCLES; k++) {
+        CHECK(same(prefix[k], ref[k]), "prefix product matches step-by-step product");
+    }
+
+    /* State after all cycles from x(0) = 0 */
+    palma_val_t x[STAGES] = { 0, 0, 0, 0 };
+    palma_val_t y[STAGES], expect[STAGES];
+    CHECK(palma_matrix_sequence_apply(seq, CYCLES, x, y, PALMA_MAXPLUS) == PALMA_SUCCESS,
+          "sequence apply succeeds");
+    palma_matvec(ref[CYCLES - 1], x, expect, PALMA_MAXPLUS);
+    for (int i = 0; i < STAGES; i++) CHECK(y[i] == expect[i], "applied state matches product");
+    palma_vector_print(y, STAGES, "\nCompletion times x(13)", PALMA_MAXPLUS, stdout);
+
+    /* Chained dimensions are validated */
+    palma_matrix_t *wrong = palma_matrix_create(STAGES + 1, STAGES + 1);
+    const palma_matrix_t *bad[2] = { mats[0], wrong };
+    CHECK(palma_matrix_sequence_apply(bad, 2, x, y, PALMA_MAXPLUS) == PALMA_ERR_INVALID_DIM,
+          "mismatched sequence is rejected");
+    CHECK(palma_matrix_sequence_product(bad, 2, PALMA_MAXPLUS) == NULL,
+          "mismatched product is rejected");
+
+    palma_matrix_destroy(wrong);
+    palma_matrix_destroy(P);
+    for (int k = 0; k < CYCLES; k++) {
+        palma_matrix_destroy(mats[k]);
+        palma_matrix_destroy(ref[k]);
+        palma_matrix_destroy(prefix[k]);
+    }
+
+    return example_result();
+}
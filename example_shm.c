@@ -0,0 +1,158 @@
+/**
+ * @file example_shm.c
+ * @brief Shared-Memory Closure Tables
+ *
+ * A producer publishes a dense closure and a sparse graph; readers attach
+ * them without copying and follow new versions. The segments live in
+ * /dev/shm where anything with write access can scribble on them, so the
+ * example also corrupts a published segment in place (header offsets,
+ * row_ptr, col_idx) and checks that attach refuses it instead of handing
+ * out a view that faults in palma_sparse_matvec.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "example_check.h"
+
+#define N 24
+
+/* Map the data segment of one version read-write, as a rogue writer would */
+static void* map_segment(const char *name, uint64_t version, size_t *size) {
+    char seg[300];
+    snprintf(seg, sizeof(seg), "%s.%llu", name, (unsigned long long)version);
+    int fd = shm_open(seg, O_RDWR, 0);
+    if (fd < 0) return NULL;
+    struct stat st;
+    void *p = MAP_FAILED;
+    if (fstat(fd, &st) == 0) {
+        p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        *size = (size_t)st.st_size;
+    }
+    close(fd);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+/* Attach must fail with `expect`; if it wrongly succeeds, do not touch the view */
+static void expect_refused(const char *name, palma_error_t expect, const char *what) {
+    palma_clear_error();
+    palma_shm_view_t *view = palma_shm_attach(name);
+    CHECK(view == NULL && palma_get_last_error() == expect, what);
+    palma_shm_detach(view);
+}
+
+int main(void) {
+    printf("=== Shared-Memory Tables ===\n");
+
+    char dense_name[64], sparse_name[64];
+    snprintf(dense_name, sizeof(dense_name), "/palma_example_dense_%d", (int)getpid());
+    snprintf(sparse_name, sizeof(sparse_name), "/palma_example_sparse_%d", (int)getpid());
+
+    /* Ring with chords, shortest paths published as a dense table */
+    palma_matrix_t *G = palma_matrix_create_zero(N, N, PALMA_MINPLUS);
+    for (size_t i = 0; i < N; i++) {
+        palma_matrix_set(G, i, (i + 1) % N, (palma_val_t)(i % 5 + 1));
+        if (i % 3 == 0) palma_matrix_set(G, i, (i + 7) % N, (palma_val_t)(i % 4 + 2));
+    }
+    palma_matrix_t *D = palma_all_pairs_paths(G, PALMA_MINPLUS);
+
+    uint64_t version = 0;
+    CHECK(palma_shm_publish_matrix(dense_name, D, PALMA_MINPLUS, &version) == PALMA_SUCCESS && version == 1,
+          "publish dense version 1");
+    palma_shm_view_t *view = palma_shm_attach(dense_name);
+    const palma_matrix_t *T = palma_shm_matrix(view);
+    bool same = T && T->rows == N && T->cols == N;
+    for (size_t i = 0; same && i < N; i++) {
+        for (size_t j = 0; j < N; j++) same = same && palma_matrix_get(T, i, j) == palma_matrix_get(D, i, j);
+    }
+    CHECK(same && palma_shm_semiring(view) == PALMA_MINPLUS, "attached dense table matches the closure");
+    CHECK(palma_shm_sparse(view) == NULL, "dense view has no sparse table");
+
+    /* A new version leaves the old view intact until refresh */
+    palma_matrix_set(D, 0, 1, 0);
+    CHECK(palma_shm_publish_matrix(dense_name, D, PALMA_MINPLUS, &version) == PALMA_SUCCESS && version == 2,
+          "publish dense version 2");
+    CHECK(palma_shm_stale(view) && palma_matrix_get(palma_shm_matrix(view), 0, 1) == palma_matrix_get(G, 0, 1),
+          "old view keeps version 1");
+    CHECK(palma_shm_refresh(&view) == PALMA_SUCCESS && palma_shm_version(view) == 2 &&
+          palma_matrix_get(palma_shm_matrix(view), 0, 1) == 0, "refresh moves to version 2");
+    palma_shm_detach(view);
+
+    /* Sparse table, then matvec straight out of the mapping */
+    palma_sparse_t *S = palma_sparse_from_dense(G, PALMA_MINPLUS);
+    CHECK(palma_shm_publish_sparse(sparse_name, S, &version) == PALMA_SUCCESS, "publish sparse");
+    view = palma_shm_attach(sparse_name);
+    const palma_sparse_t *V = palma_shm_sparse(view);
+    CHECK(V && V->nnz == S->nnz && V->rows == N, "attached sparse table");
+    palma_val_t x[N], y[N], yref[N];
+    for (size_t i = 0; i < N; i++) x[i] = (palma_val_t)(i * 3 % 11);
+    palma_sparse_matvec(S, x, yref);
+    CHECK(V && palma_sparse_matvec(V, x, y) == PALMA_SUCCESS && memcmp(y, yref, sizeof(y)) == 0,
+          "sparse matvec on the mapping");
+    palma_shm_detach(view);
+
+    /* Corrupt the published segment in place; restore it after each case */
+    size_t size = 0;
+    char *seg = (char*)map_segment(sparse_name, version, &size);
+    CHECK(seg != NULL, "map the sparse segment read-write");
+    if (seg) {
+        char *saved = (char*)malloc(size);
+        memcpy(saved, seg, size);
+        palma_shm_header_t *h = (palma_shm_header_t*)seg;
+        palma_ptr_t *row_ptr = (palma_ptr_t*)(seg + h->row_ptr_offset);
+        palma_idx_t *col_idx = (palma_idx_t*)(seg + h->col_idx_offset);
+
+        row_ptr[0] = 1;
+        expect_refused(sparse_name, PALMA_ERR_SPARSE_FORMAT, "row_ptr[0] != 0 is refused");
+        memcpy(seg, saved, size);
+
+        row_ptr[N / 2] = (palma_ptr_t)(h->nnz + 1000);
+        expect_refused(sparse_name, PALMA_ERR_SPARSE_FORMAT, "decreasing row_ptr is refused");
+        memcpy(seg, saved, size);
+
+        row_ptr[N] = (palma_ptr_t)(h->nnz - 1);
+        expect_refused(sparse_name, PALMA_ERR_SPARSE_FORMAT, "row_ptr[rows] != nnz is refused");
+        memcpy(seg, saved, size);
+
+        col_idx[h->nnz / 2] = N;
+        expect_refused(sparse_name, PALMA_ERR_SPARSE_FORMAT, "col_idx >= cols is refused");
+        memcpy(seg, saved, size);
+
+        h->col_idx_offset += 2;
+        expect_refused(sparse_name, PALMA_ERR_FILE_FORMAT, "misaligned col_idx offset is refused");
+        memcpy(seg, saved, size);
+
+        h->row_ptr_offset = h->size;
+        expect_refused(sparse_name, PALMA_ERR_FILE_FORMAT, "row_ptr past the segment is refused");
+        memcpy(seg, saved, size);
+
+        view = palma_shm_attach(sparse_name);
+        CHECK(view != NULL, "restored segment attaches again");
+        palma_shm_detach(view);
+        printf("corrupted row_ptr, col_idx and offsets refused; %zu-byte segment checked\n", size);
+
+        free(saved);
+        munmap(seg, size);
+    }
+
+    CHECK(palma_shm_unlink(dense_name) == PALMA_SUCCESS && palma_shm_unlink(sparse_name) == PALMA_SUCCESS,
+          "unlink both tables");
+    expect_refused(dense_name, PALMA_ERR_FILE_OPEN, "attach after unlink fails");
+
+    palma_sparse_destroy(S);
+    palma_matrix_destroy(D);
+    palma_matrix_destroy(G);
+
+    return example_result();
+}
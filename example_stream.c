@@ -0,0 +1,278 @@
+/**
+ * @file example_stream.c
+ * @brief Streaming Readers and Writers on Real-World Files
+ *
+ * Files written block by block are read back with different block sizes,
+ * in CSV and binary and as edge lists with a count filled in on close.
+ * Then the readers get the files people actually send: short and long
+ * rows, stray tokens, values outside int32_t, CRLF line ends, a missing
+ * header, lines longer than the stream buffer, truncated binaries, bad or
+ * too-wide edge headers, and every single-byte corruption of small files.
+ * Each must give its documented error code, never a crash or a partly
+ * filled block reported as success.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "example_check.h"
+
+#define ROWS 150
+#define COLS 11
+
+static char dir[] = "/tmp/palma_stream_XXXXXX";
+
+static const char* path_of(const char *name) {
+    static char buf[4][128];
+    static int which = 0;
+    which = (which + 1) % 4;
+    snprintf(buf[which], sizeof(buf[which]), "%s/%s", dir, name);
+    return buf[which];
+}
+
+static void put_file(const char *name, const char *text, size_t len) {
+    FILE *fp = fopen(path_of(name), "wb");
+    if (fp) {
+        fwrite(text, 1, len, fp);
+        fclose(fp);
+    }
+}
+
+static void put_text(const char *name, const char *text) {
+    put_file(name, text, strlen(text));
+}
+
+/* Read a whole matrix file in blocks; return the first error */
+static palma_error_t read_matrix(const char *name, size_t block_rows, palma_matrix_t **out) {
+    palma_clear_error();
+    palma_reader_t *r = palma_reader_open_matrix(path_of(name));
+    if (!r) return palma_get_last_error();
+
+    /* The shape comes from the file: only trust it for files we wrote */
+    size_t rows, cols;
+    palma_reader_shape(r, &rows, &cols);
+    palma_matrix_t *M = out ? palma_matrix_create(rows, cols) : NULL;
+    palma_matrix_t *block = palma_matrix_create(block_rows, cols);
+    palma_error_t err = ((M || !out) && block) ? PALMA_SUCCESS : PALMA_ERR_OUT_OF_MEMORY;
+    size_t at = 0, got = 0;
+    while (err == PALMA_SUCCESS && (err = palma_reader_read_rows(r, block, &got)) == PALMA_SUCCESS && got > 0) {
+        for (size_t i = 0; M && i < got; i++) {
+            for (size_t j = 0; j < cols; j++) palma_matrix_set(M, at + i, j, palma_matrix_get(block, i, j));
+        }
+        at += got;
+    }
+    if (err == PALMA_SUCCESS && at != rows) err = PALMA_ERR_FILE_FORMAT;
+    palma_matrix_destroy(block);
+    palma_reader_close(r);
+    if (err == PALMA_SUCCESS && out) *out = M;
+    else palma_matrix_destroy(M);
+    return err;
+}
+
+/* Read a whole edge list; return the first error and the edge count */
+static palma_error_t read_edges(const char *name, size_t *count, palma_val_t *sum) {
+    palma_clear_error();
+    palma_reader_t *r = palma_reader_open_edges(path_of(name));
+    if (!r) return palma_get_last_error();
+
+    size_t rows[7], got = 0;
+    palma_idx_t cols[7];
+    palma_val_t vals[7];
+    palma_error_t err;
+    *count = 0;
+    if (sum) *sum = 0;
+    while ((err = palma_reader_read_edges(r, rows, cols, vals, 7, &got)) == PALMA_SUCCESS && got > 0) {
+        *count += got;
+        for (size_t k = 0; sum && k < got; k++) *sum += vals[k] + (palma_val_t)rows[k] + (palma_val_t)cols[k];
+    }
+    palma_reader_close(r);
+    return err;
+}
+
+int main(void) {
+    printf("=== Streaming I/O ===\n");
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        return EXIT_FAILURE;
+    }
+
+    palma_matrix_t *A = palma_matrix_create(ROWS, COLS);
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < COLS; j++) {
+            palma_val_t v = (palma_val_t)((i * 131 + j * 71) % 2001) - 1000;
+            if ((i + j) % 13 == 0) v = PALMA_NEG_INF;
+            if ((i + j) % 29 == 0) v = PALMA_POS_INF;
+            if (i == 7) v = j % 2 ? INT32_MAX - 1 : INT32_MIN + 1;
+            palma_matrix_set(A, i, j, v);
+        }
+    }
+
+    /* Written in blocks of 40 (one view per block), read back in blocks of 17 */
+    for (int fmt = 0; fmt < 2; fmt++) {
+        const char *name = fmt ? "a.bin" : "a.csv";
+        palma_writer_t *w = palma_writer_open_matrix(path_of(name), ROWS, COLS, PALMA_MAXPLUS,
+                                                     fmt ? PALMA_STREAM_BINARY : PALMA_STREAM_CSV);
+        palma_matrix_t view;
+        for (size_t r0 = 0; w && r0 < ROWS; r0 += 40) {
+            palma_matrix_view(&view, A, r0, 0, (ROWS - r0 < 40) ? ROWS - r0 : 40, COLS);
+            palma_writer_write_rows(w, &view);
+        }
+        CHECK(palma_writer_close(w) == PALMA_SUCCESS, fmt ? "write binary" : "write CSV");
+        palma_matrix_t *B = NULL;
+        CHECK(read_matrix(name, 17, &B) == PALMA_SUCCESS && same(A, B), fmt ? "binary round trip" : "CSV round trip");
+        palma_matrix_destroy(B);
+    }
+
+    /* Writer misuse */
+    palma_writer_t *w = palma_writer_open_matrix(path_of("short.csv"), 3, COLS, PALMA_MAXPLUS, PALMA_STREAM_CSV);
+    palma_matrix_t view;
+    palma_matrix_view(&view, A, 0, 0, 2, COLS);
+    CHECK(palma_writer_write_rows(w, &view) == PALMA_SUCCESS, "write 2 of 3 rows");
+    CHECK(palma_writer_write_rows(w, &view) == PALMA_ERR_INDEX_BOUNDS, "writing past the declared rows");
+    CHECK(palma_writer_close(w) == PALMA_ERR_INVALID_DIM, "closing a short file is reported");
+    CHECK(read_matrix("short.csv", 4, NULL) == PALMA_ERR_FILE_FORMAT, "short file reads as malformed");
+
+    /* Edge list with the count filled in on close */
+    palma_sparse_t *S = palma_sparse_from_dense(A, PALMA_MAXPLUS);
+    w = palma_writer_open_edges(path_of("e.csv"), ROWS, COLS, PALMA_STREAM_UNKNOWN, PALMA_MAXPLUS);
+    CHECK(palma_writer_write_sparse(w, S, 0) == PALMA_SUCCESS, "write sparse block");
+    CHECK(palma_writer_write_edge(w, ROWS, 0, 1) == PALMA_ERR_INDEX_BOUNDS, "edge row out of bounds");
+    CHECK(palma_writer_close(w) == PALMA_SUCCESS, "close edge writer");
+    palma_reader_t *r = palma_reader_open_edges(path_of("e.csv"));
+    CHECK(r && palma_reader_edge_count(r) == S->nnz, "edge count filled in on close");
+    palma_reader_close(r);
+    size_t count = 0;
+    CHECK(read_edges("e.csv", &count, NULL) == PALMA_SUCCESS && count == S->nnz, "all edges read back");
+    palma_sparse_destroy(S);
+    printf("%d x %d matrix in CSV and binary, %zu edges round-tripped\n", ROWS, COLS, count);
+
+    /* Malformed matrix files */
+    palma_matrix_t *M = NULL;
+    put_text("crlf.csv", "# PALMA matrix 2x3\r\n1,2,3\r\n-inf,inf,-4\r\n");
+    CHECK(read_matrix("crlf.csv", 1, &M) == PALMA_SUCCESS && palma_matrix_get(M, 1, 0) == PALMA_NEG_INF &&
+          palma_matrix_get(M, 1, 2) == -4, "CRLF line ends");
+    palma_matrix_destroy(M);
+    M = NULL;
+    put_text("neg.csv", "# PALMA matrix -1x2\n1,2\n3,4\n");
+    CHECK(read_matrix("neg.csv", 2, &M) == PALMA_SUCCESS && M->rows == 2, "negative header shape is ignored");
+    palma_matrix_destroy(M);
+    M = NULL;
+    put_text("bare.csv", "\n# no shape here\n1,2\n\n3,4\n5,6");
+    CHECK(read_matrix("bare.csv", 2, &M) == PALMA_SUCCESS && M->rows == 3 && palma_matrix_get(M, 2, 1) == 6,
+          "headerless CSV, blank lines, no final newline");
+    palma_matrix_destroy(M);
+
+    static const struct { const char *text; const char *what; } bad_csv[] = {
+        { "# PALMA matrix 2x3\n1,2,3\n4,5\n",              "short row" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,5,6,7\n",          "long row" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,5x,6\n",           "trailing junk in a value" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,,6\n",             "empty field" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,2147483648,6\n",   "value above int32_t" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,-2147483649,6\n",  "value below int32_t" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,99999999999999999999999,6\n", "value past uint64_t" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,-,6\n",            "lone sign" },
+        { "# PALMA matrix 3x3\n1,2,3\n4,5,6\n",            "fewer rows than declared" },
+        { "# PALMA matrix 2x4\n1,2,3\n4,5,6\n",            "header columns disagree" },
+        { "# PALMA matrix 2x3\n1,2,3\n4,in,6\n",           "truncated inf" },
+    };
+    for (size_t k = 0; k < sizeof(bad_csv) / sizeof(bad_csv[0]); k++) {
+        put_text("bad.csv", bad_csv[k].text);
+        CHECK(read_matrix("bad.csv", 2, NULL) == PALMA_ERR_FILE_FORMAT, bad_csv[k].what);
+    }
+    put_text("empty.csv", "");
+    CHECK(read_matrix("empty.csv", 2, NULL) == PALMA_ERR_FILE_FORMAT, "empty file");
+    put_text("comments.csv", "# only\n# comments\n");
+    CHECK(read_matrix("comments.csv", 2, NULL) == PALMA_ERR_FILE_FORMAT, "comments only");
+    CHECK(read_matrix("missing.csv", 2, NULL) == PALMA_ERR_FILE_OPEN, "missing file");
+
+    /* One line longer than the stream buffer */
+    size_t wide = PALMA_STREAM_BUFFER / 3 + 5;
+    char *text = (char*)malloc(wide * 4 + 64);
+    if (!text) return EXIT_FAILURE;
+    size_t len = (size_t)sprintf(text, "# PALMA matrix 1x%zu\n", wide);
+    for (size_t j = 0; j < wide; j++) {
+        text[len++] = (char)('0' + j % 10);
+        text[len++] = j + 1 < wide ? ',' : '\n';
+    }
+    put_file("wide.csv", text, len);
+    free(text);
+    M = NULL;
+    CHECK(read_matrix("wide.csv", 1, &M) == PALMA_SUCCESS && M->cols == wide &&
+          palma_matrix_get(M, 0, wide - 1) == (palma_val_t)((wide - 1) % 10), "line longer than the buffer");
+    palma_matrix_destroy(M);
+
+    /* Truncated and degenerate binaries */
+    FILE *fp = fopen(path_of("a.bin"), "rb");
+    char bin[4096];
+    size_t bin_len = fp ? fread(bin, 1, sizeof(bin), fp) : 0;
+    if (fp) fclose(fp);
+    put_file("cut.bin", bin, bin_len - 3);
+    CHECK(read_matrix("cut.bin", 64, NULL) == PALMA_ERR_FILE_FORMAT, "truncated binary");
+    memset(bin + 8, 0, 4);
+    put_file("zero.bin", bin, bin_len);
+    CHECK(read_matrix("zero.bin", 64, NULL) == PALMA_ERR_FILE_FORMAT, "binary with zero rows");
+
+    /* Malformed edge lists */
+    static const struct { const char *text; palma_error_t err; const char *what; } bad_edges[] = {
+        { "3,3\n0,1,5\n",                 PALMA_ERR_FILE_FORMAT, "header without a count" },
+        { "0,3,1\n0,1,5\n",               PALMA_ERR_FILE_FORMAT, "zero rows" },
+        { "3,3,1,9\n0,1,5\n",             PALMA_ERR_FILE_FORMAT, "header with an extra field" },
+        { "3,3,2\n0,1,5\n-1,2,3\n",       PALMA_ERR_FILE_FORMAT, "negative index" },
+        { "3,3,2\n0,1,5\n1,2\n",          PALMA_ERR_FILE_FORMAT, "missing value" },
+        { "3,3,2\n0,1,5\n1,2,3 x\n",      PALMA_ERR_FILE_FORMAT, "trailing token" },
+        { "3,3,2\n0,1,5\n1,2,3000000000\n", PALMA_ERR_FILE_FORMAT, "value above int32_t" },
+        { "3,3,2\n0,1,5\n3,0,1\n",        PALMA_ERR_INDEX_BOUNDS, "row outside the shape" },
+        { "3,3,2\n0,1,5\n0,3,1\n",        PALMA_ERR_INDEX_BOUNDS, "column outside the shape" },
+        { "3,8589934592,1\n0,4294967296,1\n", PALMA_ERR_OVERFLOW, "more columns than palma_idx_t" },
+        { "# nothing\n",                  PALMA_ERR_FILE_FORMAT, "no header line" },
+    };
+    for (size_t k = 0; k < sizeof(bad_edges) / sizeof(bad_edges[0]); k++) {
+        put_text("bad_e.csv", bad_edges[k].text);
+        CHECK(read_edges("bad_e.csv", &count, NULL) == bad_edges[k].err, bad_edges[k].what);
+    }
+    put_text("ok_e.csv", "# comment\n3,4,3\r\n\n0,3,-inf\n2,0,7  \n1,1,+5\n");
+    palma_val_t sum = 0;
+    CHECK(read_edges("ok_e.csv", &count, &sum) == PALMA_SUCCESS && count == 3, "comments, blanks, CRLF and signs");
+
+    /* Every byte of small files, damaged: reads succeed or fail cleanly */
+    static const char *seeds[] = {
+        "# PALMA matrix 3x3, semiring=max-plus\n1,-2,inf\n-inf,5,6\n7,8,-9\n",
+        "# PALMA sparse matrix 4x4, nnz=3, semiring=min-plus\n4,4,3\n0,1,5\n2,3,-inf\n3,0,12\n",
+    };
+    static const char swaps[] = { '\n', ',', '-', '9', '#', '\0', 'i', ' ' };
+    size_t ok = 0, refused = 0;
+    for (int kind = 0; kind < 2; kind++) {
+        size_t n = strlen(seeds[kind]);
+        char *copy = (char*)malloc(n);
+        for (size_t at = 0; at < n; at++) {
+            for (size_t s = 0; s < sizeof(swaps); s++) {
+                memcpy(copy, seeds[kind], n);
+                copy[at] = swaps[s];
+                put_file("fuzz.csv", copy, n);
+                palma_error_t err = kind ? read_edges("fuzz.csv", &count, NULL)
+                                         : read_matrix("fuzz.csv", 2, NULL);
+                err == PALMA_SUCCESS ? ok++ : refused++;
+            }
+        }
+        free(copy);
+    }
+    printf("single-byte corruptions: %zu read, %zu refused\n", ok, refused);
+    CHECK(refused > 0 && ok > 0, "corruptions are either read or refused");
+
+    static const char *names[] = { "a.csv", "a.bin", "short.csv", "e.csv", "crlf.csv", "bare.csv", "bad.csv",
+                                   "empty.csv", "comments.csv", "neg.csv", "wide.csv", "cut.bin", "zero.bin",
+                                   "bad_e.csv", "ok_e.csv", "fuzz.csv" };
+    for (size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++) unlink(path_of(names[k]));
+    rmdir(dir);
+    palma_matrix_destroy(A);
+
+    return example_result();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file example_views.c
+ * @brief Blocked Computation with Zero-Copy Views and Tiles
+ *
+ * Computes a max-plus product tile by tile, writing each result block
+ * through a view into the output, and checks it against the full product.
+ * Also checks view bounds, clipping of edge tiles and write-through.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "example_check.h"
+
+#define N     50
+#define TILE  16        /* Does not divide N: edge tiles are clipped */
+
+int main(void) {
+    printf("=== Views and Tiles ===\n");
+
+    palma_matrix_t *A = palma_matrix_create(N, N);
+    palma_matrix_t *B = palma_matrix_create(N, N);
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            palma_matrix_set(A, i, j, (palma_val_t)((i * 5 + j * 3) % 17));
+            palma_matrix_set(B, i, j, (palma_val_t)((i * 2 + j * 11) % 19));
+        }
+    }
+
+    palma_matrix_t *full = palma_matrix_mul(A, B, PALMA_MAXPLUS);
+    palma_matrix_t *blocked = palma_matrix_create_zero(N, N, PALMA_MAXPLUS);
+
+    /* C(ti, tj) = ⊕_k A(ti, k) ⊗ B(k, tj), each block written through a view */
+    size_t tiles = palma_matrix_tile_count(N, TILE);
+    printf("%dx%d product in %zux%zu tiles of %d\n", N, N, tiles, tiles, TILE);
+    for (size_t ti = 0; ti < tiles; ti++) {
+        for (size_t tj = 0; tj < tiles; tj++) {
+            palma_matrix_t c_tile, a_tile, b_tile;
+            palma_matrix_tile(&c_tile, blocked, TILE, TILE, ti, tj);
+            palma_matrix_t *part = palma_matrix_create(c_tile.rows, c_tile.cols);
+            for (size_t tk = 0; tk < tiles; tk++) {
+                palma_matrix_tile(&a_tile, A, TILE, TILE, ti, tk);
+                palma_matrix_tile(&b_tile, B, TILE, TILE, tk, tj);
+                palma_matrix_mul_into(part, &a_tile, &b_tile, PALMA_MAXPLUS);
+                palma_matrix_add_into(&c_tile, &c_tile, part, PALMA_MAXPLUS);
+            }
+            palma_matrix_destroy(part);
+        }
+    }
+
+    bool same = true;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            same = same && palma_matrix_get(blocked, i, j) == palma_matrix_get(full, i, j);
+        }
+    }
+    CHECK(same, "tiled product through views matches the full product");
+    printf("Tiled result %s the full product\n", same ? "matches" : "DIFFERS FROM");
+
+    /* Edge tiles are clipped to the matrix */
+    palma_matrix_t edge;
+    CHECK(palma_matrix_tile(&edge, A, TILE, TILE, tiles - 1, tiles - 1) == PALMA_SUCCESS, "edge tile");
+    CHECK(edge.rows == N % TILE && edge.cols == N % TILE, "edge tile is clipped");
+    CHECK(palma_matrix_tile(&edge, A, TILE, TILE, tiles, 0) != PALMA_SUCCESS, "tile index past the end is rejected");
+
+    /* Bounds, write-through and copy */
+    palma_matrix_t v;
+    CHECK(palma_matrix_view(&v, A, N - 4, N - 4, 5, 4) == PALMA_ERR_INDEX_BOUNDS, "view past the edge is rejected");
+    CHECK(palma_matrix_view(&v, A, 10, 20, 3, 4) == PALMA_SUCCESS, "inner view");
+    CHECK(v.stride == A->stride && !v.owns_data, "view shares the parent's storage");
+    palma_matrix_set(&v, 2, 3, 999);
+    CHECK(palma_matrix_get(A, 12, 23) == 999, "writes through a view reach the parent");
+
+    palma_matrix_t *copy = palma_matrix_create(3, 4);
+    CHECK(palma_matrix_copy(copy, &v) == PALMA_SUCCESS && palma_matrix_get(copy, 2, 3) == 999 &&
+          palma_matrix_get(copy, 0, 0) == palma_matrix_get(A, 10, 20), "copy out of a view");
+
+    palma_matrix_destroy(copy);
+    palma_matrix_destroy(A);
+    palma_matrix_destroy(B);
+    palma_matrix_destroy(full);
+    palma_matrix_destroy(blocked);
+
+    return example_result();
+}
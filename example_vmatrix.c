@@ -0,0 +1,142 @@
+/**
+ * @file example_vmatrix.c
+ * @brief Versioned Matrices under Concurrent Readers
+ *
+ * A routing table is republished continuously while reader threads take
+ * snapshots without locking. Every version v is filled with the value v,
+ * so a reader can tell a torn or reclaimed snapshot from a good one. The
+ * writer commits thousands of versions while readers pin and release
+ * snapshots as fast as they can and some hold theirs across many commits;
+ * run it under -fsanitize=address to catch a snapshot freed while a reader
+ * is pinning it.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "example_check.h"
+
+#define N        40
+#define TILE     16
+#define READERS  6
+#define VERSIONS 4000
+
+typedef struct {
+    palma_vmatrix_t *vm;
+    int done;
+    size_t snapshots;
+    size_t torn;
+    size_t regressed;
+} reader_arg_t;
+
+static void fill(palma_matrix_t *M, palma_val_t v) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) palma_matrix_set(M, i, j, v);
+    }
+}
+
+/* Every element of version v equals v */
+static bool uniform(const palma_vsnapshot_t *s) {
+    palma_val_t v = (palma_val_t)palma_vsnapshot_version(s);
+    for (size_t i = 0; i < N; i += 7) {
+        for (size_t j = 0; j < N; j += 5) {
+            if (palma_vsnapshot_get(s, i, j) != v) return false;
+        }
+    }
+    return palma_vsnapshot_get(s, N - 1, N - 1) == v;
+}
+
+static void* reader(void *p) {
+    reader_arg_t *arg = (reader_arg_t*)p;
+    const palma_vsnapshot_t *held = NULL;
+    uint64_t last = 0;
+
+    while (!__atomic_load_n(&arg->done, __ATOMIC_ACQUIRE)) {
+        const palma_vsnapshot_t *s = palma_vmatrix_snapshot(arg->vm);
+        uint64_t v = palma_vsnapshot_version(s);
+        if (!uniform(s)) arg->torn++;
+        if (v < last) arg->regressed++;
+        last = v;
+
+        /* Keep one snapshot across many commits, then check it is still intact */
+        if (++arg->snapshots % 64 == 0) {
+            if (held && !uniform(held)) arg->torn++;
+            palma_vsnapshot_release(held);
+            held = s;
+        } else {
+            palma_vsnapshot_release(s);
+        }
+    }
+    if (held && !uniform(held)) arg->torn++;
+    palma_vsnapshot_release(held);
+    return NULL;
+}
+
+int main(void) {
+    printf("=== Versioned Matrices ===\n");
+
+    palma_matrix_t *M = palma_matrix_create(N, N);
+    fill(M, 1);
+    palma_vmatrix_t *vm = palma_vmatrix_create(M, TILE);
+    CHECK(vm && palma_vmatrix_version(vm) == 1, "create at version 1");
+
+    /* Copy-on-write: a one-element edit leaves old snapshots unchanged */
+    const palma_vsnapshot_t *v1 = palma_vmatrix_snapshot(vm);
+    palma_vmatrix_edit_t *edit = palma_vmatrix_begin(vm);
+    palma_vmatrix_edit_set(edit, 3, 30, 99);
+    uint64_t version = 0;
+    CHECK(palma_vmatrix_commit(edit, &version) == PALMA_SUCCESS && version == 2, "commit version 2");
+    const palma_vsnapshot_t *v2 = palma_vmatrix_snapshot(vm);
+    CHECK(palma_vsnapshot_get(v1, 3, 30) == 1 && palma_vsnapshot_get(v2, 3, 30) == 99 &&
+          palma_vsnapshot_get(v2, 3, 29) == 1, "old snapshot keeps its value");
+    edit = palma_vmatrix_begin(vm);
+    palma_vmatrix_edit_set(edit, 0, 0, 1);
+    CHECK(palma_vmatrix_commit(edit, &version) == PALMA_SUCCESS && version == 2,
+          "edit without changes installs nothing");
+    palma_matrix_t *copy = palma_matrix_create(N, N);
+    CHECK(palma_vsnapshot_copy_into(copy, v2) == PALMA_SUCCESS && palma_matrix_get(copy, 3, 30) == 99,
+          "copy_into");
+    palma_matrix_destroy(copy);
+    palma_vsnapshot_release(v1);
+    palma_vsnapshot_release(v2);
+
+    fill(M, 3);
+    CHECK(palma_vmatrix_publish(vm, M, &version) == PALMA_SUCCESS && version == 3, "publish version 3");
+
+    /* Readers race the writer; every version rewrites every tile */
+    pthread_t threads[READERS];
+    reader_arg_t args[READERS];
+    for (int t = 0; t < READERS; t++) {
+        args[t] = (reader_arg_t){ vm, 0, 0, 0, 0 };
+        pthread_create(&threads[t], NULL, reader, &args[t]);
+    }
+    for (palma_val_t v = 4; v < 4 + VERSIONS; v++) {
+        fill(M, v);
+        if (palma_vmatrix_publish(vm, M, NULL) != PALMA_SUCCESS) {
+            failures++;
+            break;
+        }
+    }
+    size_t snapshots = 0, torn = 0, regressed = 0;
+    for (int t = 0; t < READERS; t++) {
+        __atomic_store_n(&args[t].done, 1, __ATOMIC_RELEASE);
+        pthread_join(threads[t], NULL);
+        snapshots += args[t].snapshots;
+        torn += args[t].torn;
+        regressed += args[t].regressed;
+    }
+    printf("%d versions committed, %zu snapshots taken by %d readers\n", VERSIONS, snapshots, READERS);
+    CHECK(palma_vmatrix_version(vm) == 3 + VERSIONS, "every publish installed a version");
+    CHECK(torn == 0, "no snapshot was torn or reclaimed under a reader");
+    CHECK(regressed == 0, "versions seen by a reader never go back");
+
+    palma_vmatrix_destroy(vm);
+    palma_matrix_destroy(M);
+
+    return example_result();
+}
@@ -22,8 +22,10 @@
  */
 
 #define _POSIX_C_SOURCE 200112L
+#define _DEFAULT_SOURCE
 
 #include "palma.h"
+#include "palma_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -38,6 +40,10 @@
 #include <omp.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 /*============================================================================
  * INTERNAL CONSTANTS
  *============================================================================*/
@@ -45,9 +51,11 @@
 #define ALIGN_SIZE 16
 #define ALIGN_STRIDE(cols) (((cols) + 3) & ~3)
 
-/* Binary file magic number */
-#define PALMA_BINARY_MAGIC 0x504C4D41  /* "PLMA" */
-#define PALMA_BINARY_VERSION 1
+/* Huge page size assumed for THP alignment and MAP_HUGETLB rounding */
+#define HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+
+/* Row pitches that are a multiple of this many bytes are padded by one cache line */
+#define ALIAS_PERIOD 512
 
 /*============================================================================
  * ERROR HANDLING
@@ -77,7 +85,10 @@ static const char* error_messages[] = {
     "Invalid file format",
     "Index out of bounds",
     "Invalid sparse matrix format",
-    "Unsupported operation"
+    "Unsupported operation",
+    "Job was cancelled",
+    "Job exceeded its time budget",
+    "Sparse index type too narrow"
 };
 
 const char* palma_strerror(palma_error_t err) {
@@ -100,22 +111,11 @@ void palma_clear_error(void) {
     g_last_error = PALMA_SUCCESS;
 }
 
-/* Internal macro for setting error and returning */
-#define PALMA_RETURN_ERROR(err) do { \
-    palma_set_last_error(err); \
-    return (err); \
-} while(0)
-
-#define PALMA_RETURN_NULL(err) do { \
-    palma_set_last_error(err); \
-    return NULL; \
-} while(0)
-
 /*============================================================================
  * MEMORY HELPERS
  *============================================================================*/
 
-static void* aligned_alloc_wrapper(size_t alignment, size_t size) {
+void* palma_aligned_alloc(size_t alignment, size_t size) {
 #if defined(_POSIX_C_SOURCE) && _POSIX_C_SOURCE >= 200112L
     void *ptr = NULL;
     if (posix_memalign(&ptr, alignment, size) != 0) return NULL;
@@ -126,6 +126,167 @@ static void* aligned_alloc_wrapper(size_t alignment, size_t size) {
 #endif
 }
 
+/*============================================================================
+ * ALLOCATION POLICY
+ *============================================================================*/
+
+static const palma_alloc_policy_t default_alloc_policy = {
+    64,                             /* cache line alignment */
+    true,                           /* avoid set aliasing */
+    PALMA_HUGEPAGES_TRANSPARENT,
+    4u * 1024u * 1024u,             /* 4 MiB */
+    PALMA_NUMA_FIRST_TOUCH
+};
+
+static palma_alloc_policy_t g_alloc_policy = {
+    64, true, PALMA_HUGEPAGES_TRANSPARENT, 4u * 1024u * 1024u, PALMA_NUMA_FIRST_TOUCH
+};
+
+/*
+ * Sequence lock around g_alloc_policy: odd while a writer copies fields in.
+ * Readers retry until they see the same even value before and after their
+ * copy, so matrix creation on other threads never mixes two policies.
+ * Fields are copied with atomic accesses to keep the race well-defined.
+ */
+static unsigned g_alloc_policy_seq;
+
+static void copy_policy_atomic(palma_alloc_policy_t *dst, const palma_alloc_policy_t *src) {
+    __atomic_store_n(&dst->alignment, __atomic_load_n(&src->alignment, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->avoid_aliasing, __atomic_load_n(&src->avoid_aliasing, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->huge_pages, __atomic_load_n(&src->huge_pages, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->huge_page_threshold, __atomic_load_n(&src->huge_page_threshold, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&dst->numa, __atomic_load_n(&src->numa, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
+
+static void load_policy(palma_alloc_policy_t *out) {
+    for (;;) {
+        unsigned seq = __atomic_load_n(&g_alloc_policy_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1u) continue;
+        copy_policy_atomic(out, &g_alloc_policy);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&g_alloc_policy_seq, __ATOMIC_RELAXED) == seq) return;
+    }
+}
+
+static void store_policy(const palma_alloc_policy_t *policy) {
+    unsigned seq;
+    do {
+        seq = __atomic_load_n(&g_alloc_policy_seq, __ATOMIC_RELAXED) & ~1u;
+    } while (!__atomic_compare_exchange_n(&g_alloc_policy_seq, &seq, seq + 1, false,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    copy_policy_atomic(&g_alloc_policy, policy);
+    __atomic_store_n(&g_alloc_policy_seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+palma_error_t palma_set_alloc_policy(const palma_alloc_policy_t *policy) {
+    if (!policy) {
+        store_policy(&default_alloc_policy);
+        return PALMA_SUCCESS;
+    }
+    
+    size_t a = policy->alignment;
+    if (a < ALIGN_SIZE || (a & (a - 1)) != 0 || a % sizeof(palma_val_t) != 0) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    }
+    if (policy->huge_pages > PALMA_HUGEPAGES_EXPLICIT || policy->numa > PALMA_NUMA_INTERLEAVE) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    }
+    
+    store_policy(policy);
+    return PALMA_SUCCESS;
+}
+
+void palma_get_alloc_policy(palma_alloc_policy_t *policy) {
+    if (policy) load_policy(policy);
+}
+
+static size_t policy_stride(const palma_alloc_policy_t *policy, size_t cols) {
+    size_t line = policy->alignment / sizeof(palma_val_t);
+    
+    /* Narrow matrices keep the compact 16-byte rounding; wide rows are line-aligned */
+    if (cols < line) return ALIGN_STRIDE(cols);
+    
+    size_t stride = (cols + line - 1) / line * line;
+    
+    /*
+     * A pitch that is a multiple of a large power of two maps the same column
+     * of every row to a handful of cache sets (and to the same 4 KiB page
+     * offset), so column walks in GEMM and closure thrash L1. One extra line
+     * of padding spreads the rows across all sets.
+     */
+    if (policy->avoid_aliasing && (stride * sizeof(palma_val_t)) % ALIAS_PERIOD == 0) {
+        stride += line;
+    }
+    
+    return stride;
+}
+
+size_t palma_alloc_stride(size_t cols) {
+    palma_alloc_policy_t policy;
+    load_policy(&policy);
+    return policy_stride(&policy, cols);
+}
+
+/*
+ * Allocate matrix storage according to the policy. *map_size is set to the
+ * mapped length for MAP_HUGETLB memory (release with munmap) and 0 for heap
+ * memory (release with free).
+ */
+static palma_val_t* alloc_matrix_data(const palma_alloc_policy_t *policy, size_t size,
+                                      size_t *map_size) {
+    *map_size = 0;
+    
+    bool huge = policy->huge_pages != PALMA_HUGEPAGES_NONE && size >= policy->huge_page_threshold;
+    
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (huge && policy->huge_pages == PALMA_HUGEPAGES_EXPLICIT) {
+        size_t len = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void *p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            *map_size = len;
+            return (palma_val_t*)p;
+        }
+        /* No reserved huge pages: fall through to THP */
+    }
+#endif
+    
+    if (huge) {
+        void *p = palma_aligned_alloc(HUGE_PAGE_SIZE, size);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (p) madvise(p, size, MADV_HUGEPAGE);
+#endif
+        if (p) return (palma_val_t*)p;
+    }
+    
+    return (palma_val_t*)palma_aligned_alloc(policy->alignment, size);
+}
+
+static void free_matrix_data(palma_val_t *data, size_t map_size) {
+#if defined(__linux__)
+    if (map_size > 0) {
+        munmap(data, map_size);
+        return;
+    }
+#else
+    (void)map_size;
+#endif
+    free(data);
+}
+
+/*============================================================================
+ * THREADING HELPERS
+ *============================================================================*/
+
+static int max_threads(void) {
+#if PALMA_USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
 /*============================================================================
  * SEMIRING OPERATIONS
  *============================================================================*/
@@ -221,17 +382,23 @@ palma_matrix_t* palma_matrix_create(size_t rows, size_t cols) {
     
     mat->rows = rows;
     mat->cols = cols;
-    mat->stride = ALIGN_STRIDE(cols);
+    /* One snapshot, so stride, backing and placement follow the same policy */
+    palma_alloc_policy_t policy;
+    load_policy(&policy);
+    
+    mat->stride = policy_stride(&policy, cols);
     mat->owns_data = true;
     
     size_t data_size = mat->rows * mat->stride * sizeof(palma_val_t);
-    mat->data = (palma_val_t*)aligned_alloc_wrapper(ALIGN_SIZE, data_size);
+    mat->data = alloc_matrix_data(&policy, data_size, &mat->map_size);
     
     if (!mat->data) {
         free(mat);
         PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
     }
     
+    palma_numa_place(mat->data, mat->rows, mat->stride, policy.numa);
+    
     palma_clear_error();
     return mat;
 }
@@ -277,11 +444,67 @@ palma_matrix_t* palma_matrix_wrap(palma_val_t *data, size_t rows, size_t cols, s
     mat->cols = cols;
     mat->stride = stride;
     mat->owns_data = false;
+    mat->map_size = 0;
     
     palma_clear_error();
     return mat;
 }
 
+/*============================================================================
+ * SUBMATRIX VIEWS
+ *============================================================================*/
+
+palma_error_t palma_matrix_view(palma_matrix_t *view, const palma_matrix_t *A,
+                                size_t row, size_t col, size_t rows, size_t cols) {
+    if (!view || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (rows == 0 || cols == 0) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (row > A->rows || rows > A->rows - row ||
+        col > A->cols || cols > A->cols - col) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    }
+    
+    view->data = &A->data[row * A->stride + col];
+    view->rows = rows;
+    view->cols = cols;
+    view->stride = A->stride;
+    view->owns_data = false;
+    view->map_size = 0;
+    
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_matrix_tile(palma_matrix_t *tile, const palma_matrix_t *A,
+                                size_t tile_rows, size_t tile_cols, size_t ti, size_t tj) {
+    if (!tile || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (tile_rows == 0 || tile_cols == 0) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (ti >= palma_matrix_tile_count(A->rows, tile_rows) ||
+        tj >= palma_matrix_tile_count(A->cols, tile_cols)) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    }
+    
+    size_t row = ti * tile_rows;
+    size_t col = tj * tile_cols;
+    size_t rows = (A->rows - row < tile_rows) ? A->rows - row : tile_rows;
+    size_t cols = (A->cols - col < tile_cols) ? A->cols - col : tile_cols;
+    
+    return palma_matrix_view(tile, A, row, col, rows, cols);
+}
+
+palma_error_t palma_matrix_copy(palma_matrix_t *dst, const palma_matrix_t *src) {
+    if (!dst || !src) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (dst->rows != src->rows || dst->cols != src->cols) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+    if (dst->data == src->data && dst->stride == src->stride) return PALMA_SUCCESS;
+    
+    for (size_t i = 0; i < src->rows; i++) {
+        memcpy(palma_matrix_row(dst, i), &src->data[i * src->stride],
+               src->cols * sizeof(palma_val_t));
+    }
+    
+    return PALMA_SUCCESS;
+}
+
 palma_matrix_t* palma_matrix_clone(const palma_matrix_t *src) {
     if (!src) {
         PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
@@ -302,7 +525,7 @@ palma_matrix_t* palma_matrix_clone(const palma_matrix_t *src) {
 void palma_matrix_destroy(palma_matrix_t *mat) {
     if (!mat) return;
     if (mat->owns_data && mat->data) {
-        free(mat->data);
+        free_matrix_data(mat->data, mat->map_size);
     }
     free(mat);
 }
@@ -335,6 +558,9 @@ palma_sparse_t* palma_sparse_create(size_t rows, size_t cols, size_t capacity, p
     if (rows == 0 || cols == 0) {
         PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
     }
+    if (cols - 1 > PALMA_IDX_MAX || capacity > PALMA_PTR_MAX || rows >= SIZE_MAX / sizeof(palma_ptr_t)) {
+        PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+    }
     
     palma_sparse_t *sp = (palma_sparse_t*)malloc(sizeof(palma_sparse_t));
     if (!sp) {
@@ -349,7 +575,7 @@ palma_sparse_t* palma_sparse_create(size_t rows, size_t cols, size_t capacity, p
     
     sp->values = (palma_val_t*)malloc(sp->capacity * sizeof(palma_val_t));
     sp->col_idx = (palma_idx_t*)malloc(sp->capacity * sizeof(palma_idx_t));
-    sp->row_ptr = (palma_idx_t*)calloc(rows + 1, sizeof(palma_idx_t));
+    sp->row_ptr = (palma_ptr_t*)calloc(rows + 1, sizeof(palma_ptr_t));
     
     if (!sp->values || !sp->col_idx || !sp->row_ptr) {
         free(sp->values);
@@ -385,7 +611,7 @@ palma_sparse_t* palma_sparse_from_dense(const palma_matrix_t *dense, palma_semir
     /* Fill CSR structure */
     size_t idx = 0;
     for (size_t i = 0; i < dense->rows; i++) {
-        sp->row_ptr[i] = (palma_idx_t)idx;
+        sp->row_ptr[i] = (palma_ptr_t)idx;
         for (size_t j = 0; j < dense->cols; j++) {
             palma_val_t val = palma_matrix_get(dense, i, j);
             if (val != zero) {
@@ -395,7 +621,7 @@ palma_sparse_t* palma_sparse_from_dense(const palma_matrix_t *dense, palma_semir
             }
         }
     }
-    sp->row_ptr[dense->rows] = (palma_idx_t)idx;
+    sp->row_ptr[dense->rows] = (palma_ptr_t)idx;
     sp->nnz = idx;
     
     return sp;
@@ -410,7 +636,7 @@ palma_matrix_t* palma_sparse_to_dense(const palma_sparse_t *sparse) {
     if (!dense) return NULL;
     
     for (size_t i = 0; i < sparse->rows; i++) {
-        for (palma_idx_t k = sparse->row_ptr[i]; k < sparse->row_ptr[i + 1]; k++) {
+        for (palma_ptr_t k = sparse->row_ptr[i]; k < sparse->row_ptr[i + 1]; k++) {
             palma_matrix_set(dense, i, sparse->col_idx[k], sparse->values[k]);
         }
     }
@@ -428,7 +654,7 @@ palma_sparse_t* palma_sparse_clone(const palma_sparse_t *src) {
     
     memcpy(dst->values, src->values, src->nnz * sizeof(palma_val_t));
     memcpy(dst->col_idx, src->col_idx, src->nnz * sizeof(palma_idx_t));
-    memcpy(dst->row_ptr, src->row_ptr, (src->rows + 1) * sizeof(palma_idx_t));
+    memcpy(dst->row_ptr, src->row_ptr, (src->rows + 1) * sizeof(palma_ptr_t));
     dst->nnz = src->nnz;
     
     return dst;
@@ -452,11 +678,11 @@ palma_val_t palma_sparse_get(const palma_sparse_t *sp, size_t row, size_t col) {
     }
     
     /* Binary search in the row */
-    palma_idx_t start = sp->row_ptr[row];
-    palma_idx_t end = sp->row_ptr[row + 1];
+    palma_ptr_t start = sp->row_ptr[row];
+    palma_ptr_t end = sp->row_ptr[row + 1];
     
     while (start < end) {
-        palma_idx_t mid = start + (end - start) / 2;
+        palma_ptr_t mid = start + (end - start) / 2;
         if (sp->col_idx[mid] == col) {
             return sp->values[mid];
         } else if (sp->col_idx[mid] < col) {
@@ -471,9 +697,11 @@ palma_val_t palma_sparse_get(const palma_sparse_t *sp, size_t row, size_t col) {
 
 static palma_error_t sparse_ensure_capacity(palma_sparse_t *sp, size_t needed) {
     if (needed <= sp->capacity) return PALMA_SUCCESS;
+    if (needed > PALMA_PTR_MAX) PALMA_RETURN_ERROR(PALMA_ERR_OVERFLOW);
     
     size_t new_cap = sp->capacity * 2;
     while (new_cap < needed) new_cap *= 2;
+    if (new_cap > PALMA_PTR_MAX) new_cap = PALMA_PTR_MAX;
     
     palma_val_t *new_values = (palma_val_t*)realloc(sp->values, new_cap * sizeof(palma_val_t));
     palma_idx_t *new_col_idx = (palma_idx_t*)realloc(sp->col_idx, new_cap * sizeof(palma_idx_t));
@@ -494,9 +722,9 @@ palma_error_t palma_sparse_set(palma_sparse_t *sp, size_t row, size_t col, palma
     if (row >= sp->rows || col >= sp->cols) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
     
     /* Find position in row */
-    palma_idx_t start = sp->row_ptr[row];
-    palma_idx_t end = sp->row_ptr[row + 1];
-    palma_idx_t pos = start;
+    palma_ptr_t start = sp->row_ptr[row];
+    palma_ptr_t end = sp->row_ptr[row + 1];
+    palma_ptr_t pos = start;
     
     while (pos < end && sp->col_idx[pos] < col) {
         pos++;
@@ -547,9 +775,9 @@ palma_error_t palma_sparse_compress(palma_sparse_t *sp) {
     size_t write_idx = 0;
     
     for (size_t row = 0; row < sp->rows; row++) {
-        palma_idx_t new_row_start = (palma_idx_t)write_idx;
+        palma_ptr_t new_row_start = (palma_ptr_t)write_idx;
         
-        for (palma_idx_t k = sp->row_ptr[row]; k < sp->row_ptr[row + 1]; k++) {
+        for (palma_ptr_t k = sp->row_ptr[row]; k < sp->row_ptr[row + 1]; k++) {
             if (sp->values[k] != zero) {
                 sp->values[write_idx] = sp->values[k];
                 sp->col_idx[write_idx] = sp->col_idx[k];
@@ -559,7 +787,7 @@ palma_error_t palma_sparse_compress(palma_sparse_t *sp) {
         
         sp->row_ptr[row] = new_row_start;
     }
-    sp->row_ptr[sp->rows] = (palma_idx_t)write_idx;
+    sp->row_ptr[sp->rows] = (palma_ptr_t)write_idx;
     sp->nnz = write_idx;
     
     return PALMA_SUCCESS;
@@ -586,10 +814,14 @@ palma_error_t palma_matrix_mul_into(palma_matrix_t *C, const palma_matrix_t *A,
     if (A->cols != B->rows) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
     if (C->rows != A->rows || C->cols != B->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
     
+#if PALMA_USE_FIXED_KERNELS
+    if (palma_fixed_mul(C, A, B, semiring)) return PALMA_SUCCESS;
+#endif
+    
     palma_val_t zero = palma_zero(semiring);
     
 #if PALMA_USE_OPENMP
-    #pragma omp parallel for collapse(2) if(A->rows * B->cols > 1000)
+    #pragma omp parallel for collapse(2) schedule(static) if(A->rows * B->cols > 1000)
 #endif
     for (size_t i = 0; i < A->rows; i++) {
         for (size_t j = 0; j < B->cols; j++) {
@@ -609,6 +841,20 @@ palma_error_t palma_matrix_mul_into(palma_matrix_t *C, const palma_matrix_t *A,
     return PALMA_SUCCESS;
 }
 
+/* Best available kernel for C = A ⊗ B (dimensions already validated) */
+static palma_error_t matrix_mul_kernel(palma_matrix_t *C, const palma_matrix_t *A,
+                                       const palma_matrix_t *B, palma_semiring_t semiring) {
+#if PALMA_USE_FIXED_KERNELS
+    if (palma_fixed_mul(C, A, B, semiring)) return PALMA_SUCCESS;
+#endif
+#if PALMA_USE_NEON
+    if (palma_matrix_mul_neon(C, A, B, semiring) == PALMA_SUCCESS) {
+        return PALMA_SUCCESS;
+    }
+#endif
+    return palma_matrix_mul_into(C, A, B, semiring);
+}
+
 palma_matrix_t* palma_matrix_mul(const palma_matrix_t *A, const palma_matrix_t *B,
                                   palma_semiring_t semiring) {
     if (!A || !B) {
@@ -621,13 +867,7 @@ palma_matrix_t* palma_matrix_mul(const palma_matrix_t *A, const palma_matrix_t *
     palma_matrix_t *C = palma_matrix_create(A->rows, B->cols);
     if (!C) return NULL;
     
-#if PALMA_USE_NEON
-    if (palma_matrix_mul_neon(C, A, B, semiring) == PALMA_SUCCESS) {
-        return C;
-    }
-#endif
-    
-    palma_error_t err = palma_matrix_mul_into(C, A, B, semiring);
+    palma_error_t err = matrix_mul_kernel(C, A, B, semiring);
     if (err != PALMA_SUCCESS) {
         palma_matrix_destroy(C);
         return NULL;
@@ -648,6 +888,17 @@ palma_matrix_t* palma_matrix_add(const palma_matrix_t *A, const palma_matrix_t *
     palma_matrix_t *C = palma_matrix_create(A->rows, A->cols);
     if (!C) return NULL;
     
+    palma_matrix_add_into(C, A, B, semiring);
+    return C;
+}
+
+palma_error_t palma_matrix_add_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                     const palma_matrix_t *B, palma_semiring_t semiring) {
+    if (!C || !A || !B) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != B->rows || A->cols != B->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (C->rows != A->rows || C->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    
+    /* Element-wise, so C may be A or B */
     for (size_t i = 0; i < A->rows; i++) {
         for (size_t j = 0; j < A->cols; j++) {
             palma_val_t a = palma_matrix_get(A, i, j);
@@ -656,7 +907,7 @@ palma_matrix_t* palma_matrix_add(const palma_matrix_t *A, const palma_matrix_t *
         }
     }
     
-    return C;
+    return PALMA_SUCCESS;
 }
 
 palma_matrix_t* palma_matrix_power(const palma_matrix_t *A, unsigned int n,
@@ -668,46 +919,88 @@ palma_matrix_t* palma_matrix_power(const palma_matrix_t *A, unsigned int n,
         PALMA_RETURN_NULL(PALMA_ERR_NOT_SQUARE);
     }
     
-    if (n == 0) {
-        return palma_matrix_create_identity(A->rows, semiring);
+    palma_matrix_t *result = palma_matrix_create(A->rows, A->cols);
+    if (!result) return NULL;
+    
+    if (palma_matrix_power_into(result, A, n, semiring, NULL) != PALMA_SUCCESS) {
+        palma_matrix_destroy(result);
+        return NULL;
+    }
+    
+    return result;
+}
+
+palma_error_t palma_matrix_power_into(palma_matrix_t *C, const palma_matrix_t *A, unsigned int n,
+                                       palma_semiring_t semiring, palma_matrix_t *work) {
+    if (!C || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (C->rows != A->rows || C->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (palma_matrix_overlaps(C, A)) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (work && (palma_matrix_overlaps(work, A) || palma_matrix_overlaps(work, C))) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
     }
     
-    /* Binary exponentiation */
-    palma_matrix_t *result = palma_matrix_create_identity(A->rows, semiring);
-    palma_matrix_t *base = palma_matrix_clone(A);
-    palma_matrix_t *temp = NULL;
+    size_t dim = A->rows;
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
     
-    if (!result || !base) {
-        palma_matrix_destroy(result);
-        palma_matrix_destroy(base);
-        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    /* C = I */
+    for (size_t i = 0; i < dim; i++) {
+        for (size_t j = 0; j < dim; j++) {
+            palma_matrix_set(C, i, j, (i == j) ? one : zero);
+        }
     }
+    if (n == 0) return PALMA_SUCCESS;
+    
+    /* Two n×n scratch blocks: the caller's 2n×n workspace or a temporary */
+    palma_matrix_t *owned = NULL;
+    if (!work) {
+        owned = palma_matrix_create(2 * dim, dim);
+        if (!owned) return PALMA_ERR_OUT_OF_MEMORY;
+        work = owned;
+    } else if (work->rows < 2 * dim || work->cols < dim) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+    
+    palma_matrix_t buf[2];
+    palma_matrix_view(&buf[0], work, 0, 0, dim, dim);
+    palma_matrix_view(&buf[1], work, dim, 0, dim, dim);
+    
+    /* Binary exponentiation rotating three buffers: result, base and a spare */
+    palma_matrix_t *result = C;
+    palma_matrix_t *base = &buf[0];
+    palma_matrix_t *spare = &buf[1];
+    palma_matrix_t *temp;
+    palma_error_t err = palma_matrix_copy(base, A);
     
-    while (n > 0) {
+    while (err == PALMA_SUCCESS && n > 0) {
         if (n & 1) {
-            temp = palma_matrix_mul(result, base, semiring);
-            palma_matrix_destroy(result);
-            result = temp;
-            if (!result) {
-                palma_matrix_destroy(base);
-                return NULL;
-            }
+            err = matrix_mul_kernel(spare, result, base, semiring);
+            temp = result; result = spare; spare = temp;
         }
         
         n >>= 1;
-        if (n > 0) {
-            temp = palma_matrix_mul(base, base, semiring);
-            palma_matrix_destroy(base);
-            base = temp;
-            if (!base) {
-                palma_matrix_destroy(result);
-                return NULL;
-            }
+        if (err == PALMA_SUCCESS && n > 0) {
+            err = matrix_mul_kernel(spare, base, base, semiring);
+            temp = base; base = spare; spare = temp;
         }
     }
     
-    palma_matrix_destroy(base);
-    return result;
+    if (err == PALMA_SUCCESS && result != C) {
+        err = palma_matrix_copy(C, result);
+    }
+    
+    palma_matrix_destroy(owned);
+    return err;
+}
+
+/* d_ij ← d_ij ⊕ d_ik ⊗ d_kj for one row; d_ik is re-read so it changes after j == k */
+static void closure_row_update(palma_val_t *row_i, const palma_val_t *row_k,
+                               size_t k, size_t n, palma_semiring_t semiring) {
+    for (size_t j = 0; j < n; j++) {
+        palma_val_t via_k = palma_mul(row_i[k], row_k[j], semiring);
+        row_i[j] = palma_add(row_i[j], via_k, semiring);
+    }
 }
 
 palma_matrix_t* palma_matrix_closure(const palma_matrix_t *A, palma_semiring_t semiring) {
@@ -718,11 +1011,27 @@ palma_matrix_t* palma_matrix_closure(const palma_matrix_t *A, palma_semiring_t s
         PALMA_RETURN_NULL(PALMA_ERR_NOT_SQUARE);
     }
     
+    palma_matrix_t *D = palma_matrix_create(A->rows, A->cols);
+    if (!D) return NULL;
+    
+    if (palma_matrix_closure_into(D, A, semiring) != PALMA_SUCCESS) {
+        palma_matrix_destroy(D);
+        return NULL;
+    }
+    
+    return D;
+}
+
+palma_error_t palma_matrix_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                         palma_semiring_t semiring) {
+    if (!D || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (D->rows != A->rows || D->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    
     size_t n = A->rows;
     
-    /* Floyd-Warshall style computation */
-    palma_matrix_t *D = palma_matrix_clone(A);
-    if (!D) return NULL;
+    /* Floyd-Warshall style computation (in place when D == A) */
+    palma_matrix_copy(D, A);
     
     /* Add identity */
     palma_val_t one = palma_one(semiring);
@@ -731,20 +1040,41 @@ palma_matrix_t* palma_matrix_closure(const palma_matrix_t *A, palma_semiring_t s
         palma_matrix_set(D, i, i, palma_add(diag, one, semiring));
     }
     
-    /* Floyd-Warshall iterations */
+#if PALMA_USE_FIXED_KERNELS
+    if (palma_fixed_closure(D, semiring)) return PALMA_SUCCESS;
+#endif
+    
+    /*
+     * Floyd-Warshall iterations. Row k is updated first; every other row only
+     * reads row k, so the remaining rows run in parallel. Rows above k see
+     * row k as it was before step k, exactly as in the sequential order.
+     */
+    palma_val_t *row_k_old = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    if (!row_k_old) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    
     for (size_t k = 0; k < n; k++) {
+        palma_error_t stop = palma_interrupt_check();
+        if (stop != PALMA_SUCCESS) {
+            free(row_k_old);
+            PALMA_RETURN_ERROR(stop);
+        }
+        
+        palma_val_t *row_k = palma_matrix_row(D, k);
+        memcpy(row_k_old, row_k, n * sizeof(palma_val_t));
+        closure_row_update(row_k, row_k, k, n, semiring);
+        
+#if PALMA_USE_OPENMP
+        #pragma omp parallel for schedule(static) if(n >= 64)
+#endif
         for (size_t i = 0; i < n; i++) {
-            for (size_t j = 0; j < n; j++) {
-                palma_val_t d_ij = palma_matrix_get(D, i, j);
-                palma_val_t d_ik = palma_matrix_get(D, i, k);
-                palma_val_t d_kj = palma_matrix_get(D, k, j);
-                palma_val_t via_k = palma_mul(d_ik, d_kj, semiring);
-                palma_matrix_set(D, i, j, palma_add(d_ij, via_k, semiring));
-            }
+            if (i == k) continue;
+            closure_row_update(palma_matrix_row(D, i), (i < k) ? row_k_old : row_k,
+                               k, n, semiring);
         }
     }
     
-    return D;
+    free(row_k_old);
+    return PALMA_SUCCESS;
 }
 
 palma_matrix_t* palma_matrix_transitive_closure(const palma_matrix_t *A, palma_semiring_t semiring) {
@@ -755,16 +1085,97 @@ palma_matrix_t* palma_matrix_transitive_closure(const palma_matrix_t *A, palma_s
         PALMA_RETURN_NULL(PALMA_ERR_NOT_SQUARE);
     }
     
-    /* A+ = A* ⊗ A = A ⊗ A* */
-    palma_matrix_t *star = palma_matrix_closure(A, semiring);
-    if (!star) return NULL;
+    palma_matrix_t *plus = palma_matrix_create(A->rows, A->cols);
+    if (!plus) return NULL;
     
-    palma_matrix_t *plus = palma_matrix_mul(star, A, semiring);
-    palma_matrix_destroy(star);
+    if (palma_matrix_transitive_closure_into(plus, A, semiring) != PALMA_SUCCESS) {
+        palma_matrix_destroy(plus);
+        return NULL;
+    }
     
     return plus;
 }
 
+palma_error_t palma_matrix_transitive_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                                    palma_semiring_t semiring) {
+    if (!D || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (D->rows != A->rows || D->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    
+    size_t n = A->rows;
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
+    
+    /*
+     * Floyd-Warshall on A itself, without seeding the identity:
+     *   d_ij ← d_ij ⊕ d_ik ⊗ d_kk* ⊗ d_kj
+     * using the values from before step k. The diagonal holds the best cycle
+     * through each node, so d_kk* is e when d_kk ⊕ e = e and diverges to the
+     * top element (+∞ max-plus, -∞ min-plus) when k lies on an improving
+     * cycle. Each row reads only its own old d_ik and a saved copy of row k,
+     * so all rows update in parallel. D may be A.
+     */
+    palma_matrix_copy(D, A);
+    
+    palma_val_t top = (semiring == PALMA_MINPLUS) ? PALMA_NEG_INF : PALMA_POS_INF;
+    palma_val_t *row_k_old = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    if (!row_k_old) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    
+    for (size_t k = 0; k < n; k++) {
+        palma_error_t stop = palma_interrupt_check();
+        if (stop != PALMA_SUCCESS) {
+            free(row_k_old);
+            PALMA_RETURN_ERROR(stop);
+        }
+        
+        memcpy(row_k_old, palma_matrix_row(D, k), n * sizeof(palma_val_t));
+        palma_val_t d_kk = row_k_old[k];
+        palma_val_t star_kk = (palma_add(d_kk, one, semiring) == one) ? one : top;
+        
+#if PALMA_USE_OPENMP
+        #pragma omp parallel for schedule(static) if(n >= 64)
+#endif
+        for (size_t i = 0; i < n; i++) {
+            palma_val_t *row_i = palma_matrix_row(D, i);
+            palma_val_t d_ik = row_i[k];
+            if (d_ik == zero) continue;
+            
+            palma_val_t f = palma_mul(d_ik, star_kk, semiring);
+            
+            if (palma_mul(f, zero, semiring) == zero) {
+                for (size_t j = 0; j < n; j++) {
+                    row_i[j] = palma_add(row_i[j], palma_mul(f, row_k_old[j], semiring), semiring);
+                }
+            } else {
+                /* f is the min-plus top (-∞), which palma_mul lets absorb ε */
+                for (size_t j = 0; j < n; j++) {
+                    if (row_k_old[j] == zero) continue;
+                    row_i[j] = palma_add(row_i[j], palma_mul(f, row_k_old[j], semiring), semiring);
+                }
+            }
+        }
+    }
+    
+    free(row_k_old);
+    return PALMA_SUCCESS;
+}
+
+int palma_matrix_cycle_nodes(const palma_matrix_t *plus, int *on_cycle, palma_semiring_t semiring) {
+    if (!plus || !on_cycle) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (plus->rows != plus->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    
+    /* (A+)_ii is the best weight of a cycle through i, ε if there is none */
+    palma_val_t zero = palma_zero(semiring);
+    int count = 0;
+    
+    for (size_t i = 0; i < plus->rows; i++) {
+        on_cycle[i] = (palma_matrix_get(plus, i, i) != zero) ? 1 : 0;
+        count += on_cycle[i];
+    }
+    
+    return count;
+}
+
 /*============================================================================
  * SPARSE MATRIX OPERATIONS
  *============================================================================*/
@@ -777,25 +1188,60 @@ palma_sparse_t* palma_sparse_mul(const palma_sparse_t *A, const palma_sparse_t *
         PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
     }
     
-    palma_semiring_t semiring = A->semiring;
-    palma_val_t zero = palma_zero(semiring);
-    
     /* Estimate capacity */
     size_t est_nnz = (A->nnz + B->nnz) * 2;
     if (est_nnz > A->rows * B->cols) est_nnz = A->rows * B->cols;
+    if (est_nnz > PALMA_PTR_MAX) est_nnz = PALMA_PTR_MAX;
     
-    palma_sparse_t *C = palma_sparse_create(A->rows, B->cols, est_nnz, semiring);
+    palma_sparse_t *C = palma_sparse_create(A->rows, B->cols, est_nnz, A->semiring);
     if (!C) return NULL;
     
-    /* Temporary array for accumulating row results */
-    palma_val_t *row_vals = (palma_val_t*)malloc(B->cols * sizeof(palma_val_t));
-    if (!row_vals) {
+    if (palma_sparse_mul_into(C, A, B) != PALMA_SUCCESS) {
         palma_sparse_destroy(C);
-        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+        return NULL;
     }
     
-    for (size_t i = 0; i < A->rows; i++) {
-        C->row_ptr[i] = (palma_idx_t)C->nnz;
+    return C;
+}
+
+/*
+ * Give sp the shape rows × cols with no entries, keeping its value/index
+ * capacity. row_ptr is reallocated only when the row count changes.
+ */
+static palma_error_t sparse_reset(palma_sparse_t *sp, size_t rows, size_t cols,
+                                  palma_semiring_t semiring) {
+    if (sp->rows != rows) {
+        palma_ptr_t *row_ptr = (palma_ptr_t*)realloc(sp->row_ptr, (rows + 1) * sizeof(palma_ptr_t));
+        if (!row_ptr) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+        sp->row_ptr = row_ptr;
+    }
+    
+    sp->rows = rows;
+    sp->cols = cols;
+    sp->nnz = 0;
+    sp->semiring = semiring;
+    memset(sp->row_ptr, 0, (rows + 1) * sizeof(palma_ptr_t));
+    
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_sparse_mul_into(palma_sparse_t *C, const palma_sparse_t *A,
+                                     const palma_sparse_t *B) {
+    if (!C || !A || !B) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->cols != B->rows || A->semiring != B->semiring) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (C == A || C == B) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    
+    palma_semiring_t semiring = A->semiring;
+    palma_val_t zero = palma_zero(semiring);
+    
+    /* Temporary array for accumulating row results */
+    palma_val_t *row_vals = (palma_val_t*)malloc(B->cols * sizeof(palma_val_t));
+    if (!row_vals) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    
+    palma_error_t err = sparse_reset(C, A->rows, B->cols, semiring);
+    
+    for (size_t i = 0; i < A->rows && err == PALMA_SUCCESS; i++) {
+        C->row_ptr[i] = (palma_ptr_t)C->nnz;
         
         /* Initialize row accumulator to zero */
         for (size_t j = 0; j < B->cols; j++) {
@@ -803,11 +1249,11 @@ palma_sparse_t* palma_sparse_mul(const palma_sparse_t *A, const palma_sparse_t *
         }
         
         /* Compute row i of C */
-        for (palma_idx_t ka = A->row_ptr[i]; ka < A->row_ptr[i + 1]; ka++) {
+        for (palma_ptr_t ka = A->row_ptr[i]; ka < A->row_ptr[i + 1]; ka++) {
             palma_idx_t k = A->col_idx[ka];
             palma_val_t a_ik = A->values[ka];
             
-            for (palma_idx_t kb = B->row_ptr[k]; kb < B->row_ptr[k + 1]; kb++) {
+            for (palma_ptr_t kb = B->row_ptr[k]; kb < B->row_ptr[k + 1]; kb++) {
                 palma_idx_t j = B->col_idx[kb];
                 palma_val_t b_kj = B->values[kb];
                 palma_val_t prod = palma_mul(a_ik, b_kj, semiring);
@@ -818,17 +1264,24 @@ palma_sparse_t* palma_sparse_mul(const palma_sparse_t *A, const palma_sparse_t *
         /* Store non-zeros */
         for (size_t j = 0; j < B->cols; j++) {
             if (row_vals[j] != zero) {
-                sparse_ensure_capacity(C, C->nnz + 1);
+                err = sparse_ensure_capacity(C, C->nnz + 1);
+                if (err != PALMA_SUCCESS) break;
                 C->values[C->nnz] = row_vals[j];
                 C->col_idx[C->nnz] = (palma_idx_t)j;
                 C->nnz++;
             }
         }
     }
-    C->row_ptr[A->rows] = (palma_idx_t)C->nnz;
+    
+    if (err == PALMA_SUCCESS) {
+        C->row_ptr[A->rows] = (palma_ptr_t)C->nnz;
+    } else if (C->rows == A->rows) {
+        /* Leave C as a valid empty matrix */
+        sparse_reset(C, C->rows, C->cols, semiring);
+    }
     
     free(row_vals);
-    return C;
+    return err;
 }
 
 palma_error_t palma_sparse_matvec(const palma_sparse_t *A, const palma_val_t *x,
@@ -841,7 +1294,7 @@ palma_error_t palma_sparse_matvec(const palma_sparse_t *A, const palma_val_t *x,
     for (size_t i = 0; i < A->rows; i++) {
         palma_val_t sum = zero;
         
-        for (palma_idx_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+        for (palma_ptr_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
             palma_idx_t j = A->col_idx[k];
             palma_val_t prod = palma_mul(A->values[k], x[j], semiring);
             sum = palma_add(sum, prod, semiring);
@@ -876,6 +1329,45 @@ palma_sparse_t* palma_sparse_closure(const palma_sparse_t *A) {
     return result;
 }
 
+palma_error_t palma_sparse_closure_into(palma_sparse_t *C, const palma_sparse_t *A) {
+    if (!C || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    
+    palma_semiring_t semiring = A->semiring;
+    palma_val_t zero = palma_zero(semiring);
+    
+    /* Dense closure in place, then compress into C's existing arrays (C may be A) */
+    palma_matrix_t *dense = palma_sparse_to_dense(A);
+    if (!dense) return palma_get_last_error();
+    
+    palma_error_t err = palma_matrix_closure_into(dense, dense, semiring);
+    if (err == PALMA_SUCCESS) {
+        err = sparse_reset(C, dense->rows, dense->cols, semiring);
+    }
+    
+    for (size_t i = 0; i < dense->rows && err == PALMA_SUCCESS; i++) {
+        C->row_ptr[i] = (palma_ptr_t)C->nnz;
+        for (size_t j = 0; j < dense->cols; j++) {
+            palma_val_t val = palma_matrix_get(dense, i, j);
+            if (val == zero) continue;
+            err = sparse_ensure_capacity(C, C->nnz + 1);
+            if (err != PALMA_SUCCESS) break;
+            C->values[C->nnz] = val;
+            C->col_idx[C->nnz] = (palma_idx_t)j;
+            C->nnz++;
+        }
+    }
+    
+    if (err == PALMA_SUCCESS) {
+        C->row_ptr[dense->rows] = (palma_ptr_t)C->nnz;
+    } else if (C->rows == dense->rows) {
+        sparse_reset(C, C->rows, C->cols, semiring);
+    }
+    
+    palma_matrix_destroy(dense);
+    return err;
+}
+
 /*============================================================================
  * VECTOR OPERATIONS
  *============================================================================*/
@@ -884,6 +1376,10 @@ palma_error_t palma_matvec(const palma_matrix_t *A, const palma_val_t *x,
                             palma_val_t *y, palma_semiring_t semiring) {
     if (!A || !x || !y) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
     
+#if PALMA_USE_FIXED_KERNELS
+    if (palma_fixed_matvec(A, x, y, semiring)) return PALMA_SUCCESS;
+#endif
+    
 #if PALMA_USE_NEON
     return palma_matvec_neon(A, x, y, semiring);
 #endif
@@ -931,3 +1427,298 @@ palma_val_t palma_dot(const palma_val_t *x, const palma_val_t *y,
     
     return result;
 }
+
+
+/*============================================================================
+ * MATRIX SEQUENCES (TIME-VARYING SYSTEMS)
+ *============================================================================*/
+
+static palma_error_t sequence_check(const palma_matrix_t *const *mats, size_t count) {
+    if (!mats) return PALMA_ERR_NULL_PTR;
+    if (count == 0) return PALMA_ERR_INVALID_ARG;
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!mats[i]) return PALMA_ERR_NULL_PTR;
+        if (i > 0 && mats[i]->cols != mats[i - 1]->rows) return PALMA_ERR_INVALID_DIM;
+    }
+    return PALMA_SUCCESS;
+}
+
+palma_matrix_t* palma_matrix_sequence_product(const palma_matrix_t *const *mats, size_t count,
+                                               palma_semiring_t semiring) {
+    palma_error_t err = sequence_check(mats, count);
+    if (err != PALMA_SUCCESS) {
+        PALMA_RETURN_NULL(err);
+    }
+    
+    if (count == 1) {
+        return palma_matrix_clone(mats[0]);
+    }
+    
+    /* Level buffers: level 0 borrows the inputs, later levels own their products */
+    const palma_matrix_t **cur = (const palma_matrix_t**)malloc(count * sizeof(*cur));
+    palma_matrix_t **next = (palma_matrix_t**)calloc((count + 1) / 2, sizeof(*next));
+    if (!cur || !next) {
+        free(cur);
+        free(next);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+    memcpy(cur, mats, count * sizeof(*cur));
+    
+    size_t m = count;
+    bool owned = false;
+    
+    /* Balanced tree: later factors multiply from the left, so pair (2j+1, 2j) */
+    while (m > 1) {
+        size_t pairs = m / 2;
+        palma_error_t level_err = PALMA_SUCCESS;
+        
+#if PALMA_USE_OPENMP
+        #pragma omp parallel for schedule(dynamic) if(pairs > 1)
+#endif
+        for (size_t j = 0; j < pairs; j++) {
+            const palma_matrix_t *L = cur[2 * j + 1];
+            const palma_matrix_t *R = cur[2 * j];
+            palma_matrix_t *P = palma_matrix_create(L->rows, R->cols);
+            palma_error_t e = P ? matrix_mul_kernel(P, L, R, semiring) : PALMA_ERR_OUT_OF_MEMORY;
+            if (e != PALMA_SUCCESS) {
+#if PALMA_USE_OPENMP
+                #pragma omp critical(palma_sequence_err)
+#endif
+                level_err = e;
+            }
+            next[j] = P;
+        }
+        
+        /* Odd element is carried up unchanged (ownership moves with it) */
+        palma_matrix_t *carry = NULL;
+        bool carry_owned = false;
+        if (m & 1) {
+            carry = (palma_matrix_t*)cur[m - 1];
+            carry_owned = owned;
+        }
+        
+        if (owned) {
+            for (size_t j = 0; j < 2 * pairs; j++) {
+                palma_matrix_destroy((palma_matrix_t*)cur[j]);
+            }
+        }
+        
+        if (level_err != PALMA_SUCCESS) {
+            for (size_t j = 0; j < pairs; j++) palma_matrix_destroy(next[j]);
+            if (carry_owned) palma_matrix_destroy(carry);
+            free(cur);
+            free(next);
+            PALMA_RETURN_NULL(level_err);
+        }
+        
+        /* A borrowed carry must be copied so every level is uniformly owned */
+        if (carry && !carry_owned) {
+            carry = palma_matrix_clone(carry);
+            if (!carry) {
+                for (size_t j = 0; j < pairs; j++) palma_matrix_destroy(next[j]);
+                free(cur);
+                free(next);
+                return NULL;
+            }
+        }
+        
+        for (size_t j = 0; j < pairs; j++) cur[j] = next[j];
+        if (carry) cur[pairs] = carry;
+        m = pairs + (carry ? 1 : 0);
+        owned = true;
+    }
+    
+    palma_matrix_t *result = (palma_matrix_t*)cur[0];
+    free(cur);
+    free(next);
+    
+    palma_clear_error();
+    return result;
+}
+
+palma_error_t palma_matrix_sequence_prefix(palma_matrix_t **prefix,
+                                            const palma_matrix_t *const *mats, size_t count,
+                                            palma_semiring_t semiring) {
+    if (!prefix) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    palma_error_t err = sequence_check(mats, count);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    
+    size_t max_dim = mats[0]->cols;
+    for (size_t i = 0; i < count; i++) {
+        if (!prefix[i]) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+        if (prefix[i]->rows != mats[i]->rows || prefix[i]->cols != mats[0]->cols) {
+            PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+        }
+        if (mats[i]->rows > max_dim) max_dim = mats[i]->rows;
+    }
+    
+    /*
+     * Blocked scan over nb blocks:
+     *   1. block 0 scans its prefixes; blocks 1.. reduce to a block total T_b
+     *   2. serial carry: P(end of b) = T_b ⊗ P(end of b-1)
+     *   3. blocks 1.. rescan from the previous block's final prefix
+     * Work is about 2x the serial scan, span about 2k/nb + nb products.
+     */
+    size_t nblocks = (size_t)max_threads();
+    if (nblocks > count / 2) nblocks = count / 2;
+    if (nblocks < 1) nblocks = 1;
+    size_t block = (count + nblocks - 1) / nblocks;
+    nblocks = (count + block - 1) / block;
+    
+    /* Two ping-pong buffers per block for the block totals */
+    size_t sstride = ALIGN_STRIDE(max_dim);
+    size_t slot = max_dim * sstride;
+    palma_val_t *scratch = NULL;
+    palma_matrix_t *totals = NULL;
+    if (nblocks > 1) {
+        scratch = (palma_val_t*)palma_aligned_alloc(ALIGN_SIZE,
+                      2 * nblocks * slot * sizeof(palma_val_t));
+        totals = (palma_matrix_t*)calloc(nblocks, sizeof(palma_matrix_t));
+        if (!scratch || !totals) {
+            free(scratch);
+            free(totals);
+            PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+        }
+    }
+    
+    palma_error_t scan_err = PALMA_SUCCESS;
+    
+    /* Phase 1 */
+#if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static, 1) if(nblocks > 1)
+#endif
+    for (size_t b = 0; b < nblocks; b++) {
+        size_t lo = b * block;
+        size_t hi = (lo + block < count) ? lo + block : count;
+        palma_error_t e = PALMA_SUCCESS;
+        
+        if (b == 0) {
+            for (size_t r = 0; r < mats[0]->rows; r++) {
+                memcpy(palma_matrix_row(prefix[0], r), &mats[0]->data[r * mats[0]->stride],
+                       mats[0]->cols * sizeof(palma_val_t));
+            }
+            for (size_t i = 1; i < hi && e == PALMA_SUCCESS; i++) {
+                e = matrix_mul_kernel(prefix[i], mats[i], prefix[i - 1], semiring);
+            }
+        } else {
+            palma_val_t *buf[2] = { &scratch[2 * b * slot], &scratch[(2 * b + 1) * slot] };
+            palma_matrix_t acc = *mats[lo];
+            int side = 0;
+            for (size_t i = lo + 1; i < hi && e == PALMA_SUCCESS; i++) {
+                palma_matrix_t out = { buf[side], mats[i]->rows, mats[lo]->cols, sstride, false, 0 };
+                e = matrix_mul_kernel(&out, mats[i], &acc, semiring);
+                acc = out;
+                side ^= 1;
+            }
+            totals[b] = acc;
+        }
+        
+        if (e != PALMA_SUCCESS) {
+#if PALMA_USE_OPENMP
+            #pragma omp critical(palma_sequence_err)
+#endif
+            scan_err = e;
+        }
+    }
+    
+    /* Phase 2 */
+    for (size_t b = 1; b < nblocks && scan_err == PALMA_SUCCESS; b++) {
+        size_t lo = b * block;
+        size_t hi = (lo + block < count) ? lo + block : count;
+        scan_err = matrix_mul_kernel(prefix[hi - 1], &totals[b], prefix[lo - 1], semiring);
+    }
+    
+    /* Phase 3 */
+#if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static, 1) if(nblocks > 2)
+#endif
+    for (size_t b = 1; b < nblocks; b++) {
+        if (scan_err != PALMA_SUCCESS) continue;
+        size_t lo = b * block;
+        size_t hi = (lo + block < count) ? lo + block : count;
+        palma_error_t e = PALMA_SUCCESS;
+        for (size_t i = lo; i + 1 < hi && e == PALMA_SUCCESS; i++) {
+            e = matrix_mul_kernel(prefix[i], mats[i], prefix[i - 1], semiring);
+        }
+        if (e != PALMA_SUCCESS) {
+#if PALMA_USE_OPENMP
+            #pragma omp critical(palma_sequence_err)
+#endif
+            scan_err = e;
+        }
+    }
+    
+    free(scratch);
+    free(totals);
+    if (scan_err != PALMA_SUCCESS) PALMA_RETURN_ERROR(scan_err);
+    
+    palma_clear_error();
+    return PALMA_SUCCESS;
+}
+
+/*
+ * Cost model for y = A(k) ⊗ ... ⊗ A(1) ⊗ x. The matvec chain does
+ * Σ rows·cols work but is strictly serial; the tree does the full matrix
+ * product (Σ rows·cols·cols(0)) spread over the available threads plus one
+ * final matvec. Pick whichever finishes first.
+ */
+static bool sequence_prefers_tree(const palma_matrix_t *const *mats, size_t count, int threads) {
+    if (threads <= 1 || count < 2) return false;
+    
+    double chain = 0.0, tree = 0.0;
+    double width = (double)mats[0]->cols;
+    for (size_t i = 0; i < count; i++) {
+        chain += (double)mats[i]->rows * (double)mats[i]->cols;
+        if (i > 0) tree += (double)mats[i]->rows * (double)mats[i]->cols * width;
+    }
+    tree = tree / (double)threads + (double)mats[count - 1]->rows * width;
+    
+    return tree < chain;
+}
+
+palma_error_t palma_matrix_sequence_apply(const palma_matrix_t *const *mats, size_t count,
+                                           const palma_val_t *x, palma_val_t *y,
+                                           palma_semiring_t semiring) {
+    if (!x || !y) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    palma_error_t err = sequence_check(mats, count);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    
+    if (sequence_prefers_tree(mats, count, max_threads())) {
+        palma_matrix_t *P = palma_matrix_sequence_product(mats, count, semiring);
+        if (!P) return palma_get_last_error();
+        err = palma_matvec(P, x, y, semiring);
+        palma_matrix_destroy(P);
+        return err;
+    }
+    
+    /* Serial chain with two ping-pong buffers; the last step writes into y */
+    size_t max_len = 0;
+    for (size_t i = 0; i + 1 < count; i++) {
+        if (mats[i]->rows > max_len) max_len = mats[i]->rows;
+    }
+    
+    palma_val_t *buf[2] = { NULL, NULL };
+    if (max_len > 0) {
+        buf[0] = (palma_val_t*)malloc(max_len * sizeof(palma_val_t));
+        buf[1] = (palma_val_t*)malloc(max_len * sizeof(palma_val_t));
+        if (!buf[0] || !buf[1]) {
+            free(buf[0]);
+            free(buf[1]);
+            PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+        }
+    }
+    
+    const palma_val_t *in = x;
+    for (size_t i = 0; i < count && err == PALMA_SUCCESS; i++) {
+        palma_val_t *out = (i + 1 == count) ? y : buf[i & 1];
+        err = palma_matvec(mats[i], in, out, semiring);
+        in = out;
+    }
+    
+    free(buf[0]);
+    free(buf[1]);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    palma_clear_error();
+    return PALMA_SUCCESS;
+}
@@ -70,12 +70,38 @@ extern "C" {
     #define PALMA_USE_OPENMP 0
 #endif
 
+/** Use fully unrolled kernels for 4×4, 8×8 and 16×16 matrices */
+#ifndef PALMA_USE_FIXED_KERNELS
+    #define PALMA_USE_FIXED_KERNELS 1
+#endif
+
+/**
+ * Use 64-bit sparse row pointers, for matrices with more than 2³² - 1
+ * non-zeros. Changes the layout of palma_sparse_t: applications must be
+ * built with the same setting as the library.
+ */
+#ifndef PALMA_USE_WIDE_ROW_PTR
+    #define PALMA_USE_WIDE_ROW_PTR 0
+#endif
+
 /** Integer type for tropical values (32-bit for NEON alignment) */
 typedef int32_t palma_val_t;
 
-/** Index type for sparse matrices */
+/** Column index type for sparse matrices (kept at 32 bits to save bandwidth) */
 typedef uint32_t palma_idx_t;
 
+/** Largest column index */
+#define PALMA_IDX_MAX       UINT32_MAX
+
+/** Row pointer type for sparse matrices; bounds the number of non-zeros */
+#if PALMA_USE_WIDE_ROW_PTR
+typedef uint64_t palma_ptr_t;
+#define PALMA_PTR_MAX       UINT64_MAX
+#else
+typedef uint32_t palma_ptr_t;
+#define PALMA_PTR_MAX       UINT32_MAX
+#endif
+
 /*============================================================================
  * CONSTANTS
  *============================================================================*/
@@ -110,7 +136,10 @@ typedef enum {
     PALMA_ERR_FILE_FORMAT = -10,    /**< Invalid file format */
     PALMA_ERR_INDEX_BOUNDS = -11,   /**< Index out of bounds */
     PALMA_ERR_SPARSE_FORMAT = -12,  /**< Invalid sparse matrix format */
-    PALMA_ERR_UNSUPPORTED = -13     /**< Unsupported operation */
+    PALMA_ERR_UNSUPPORTED = -13,    /**< Unsupported operation */
+    PALMA_ERR_CANCELLED = -14,      /**< Job was cancelled */
+    PALMA_ERR_TIMEOUT = -15,        /**< Job exceeded its time budget */
+    PALMA_ERR_OVERFLOW = -16        /**< Sparse index type too narrow */
 } palma_error_t;
 
 /**
@@ -215,7 +244,8 @@ const char* palma_semiring_name(palma_semiring_t semiring);
  * @brief Dense tropical matrix structure
  * 
  * Row-major storage for cache efficiency.
- * Rows are 16-byte aligned for NEON optimization.
+ * Row alignment and stride padding follow the allocation policy
+ * (see palma_set_alloc_policy()); rows are at least 16-byte aligned for NEON.
  */
 typedef struct {
     palma_val_t *data;      /**< Matrix data (row-major, aligned) */
@@ -223,6 +253,7 @@ typedef struct {
     size_t cols;            /**< Number of columns */
     size_t stride;          /**< Row stride (>= cols, aligned) */
     bool owns_data;         /**< Whether to free data on destroy */
+    size_t map_size;        /**< Bytes mapped with mmap() if owned, 0 if heap-allocated */
 } palma_matrix_t;
 
 /*============================================================================
@@ -240,11 +271,14 @@ typedef struct {
  * For row i, elements are in values[row_ptr[i]] to values[row_ptr[i+1]-1]
  * 
  * Memory: O(nnz + n) instead of O(n²) for dense
+ * 
+ * nnz is limited to PALMA_PTR_MAX and cols to PALMA_IDX_MAX + 1; operations
+ * that would exceed them fail with PALMA_ERR_OVERFLOW.
  */
 typedef struct {
     palma_val_t *values;    /**< Non-zero values (length = nnz) */
     palma_idx_t *col_idx;   /**< Column indices (length = nnz) */
-    palma_idx_t *row_ptr;   /**< Row pointers (length = rows + 1) */
+    palma_ptr_t *row_ptr;   /**< Row pointers (length = rows + 1) */
     size_t rows;            /**< Number of rows */
     size_t cols;            /**< Number of columns */
     size_t nnz;             /**< Number of non-zero entries */
@@ -252,6 +286,105 @@ typedef struct {
     palma_semiring_t semiring; /**< Semiring (determines what "zero" means) */
 } palma_sparse_t;
 
+/*============================================================================
+ * ALLOCATION POLICY
+ *============================================================================*/
+
+/**
+ * @brief Huge page backing for large matrices
+ */
+typedef enum {
+    PALMA_HUGEPAGES_NONE = 0,        /**< Regular pages only */
+    PALMA_HUGEPAGES_TRANSPARENT = 1, /**< 2 MiB-aligned heap memory advised for THP */
+    PALMA_HUGEPAGES_EXPLICIT = 2     /**< MAP_HUGETLB mapping, falls back to THP */
+} palma_hugepages_t;
+
+/**
+ * @brief NUMA placement for large matrices
+ */
+typedef enum {
+    PALMA_NUMA_NONE = 0,             /**< Pages land wherever they are first written */
+    PALMA_NUMA_FIRST_TOUCH = 1,      /**< Parallel first touch by the kernels' static row blocks */
+    PALMA_NUMA_INTERLEAVE = 2        /**< Pages interleaved round-robin across nodes */
+} palma_numa_t;
+
+/**
+ * @brief Memory layout policy applied by palma_matrix_create()
+ * 
+ * The default is 64-byte (cache line) alignment, aliasing-aware strides,
+ * transparent huge pages for matrices of 4 MiB or more and first-touch NUMA
+ * placement (a no-op on single-node machines).
+ */
+typedef struct {
+    size_t alignment;               /**< Base and row alignment in bytes (power of two, >= 16) */
+    bool avoid_aliasing;            /**< Pad strides that map every row to the same cache sets */
+    palma_hugepages_t huge_pages;   /**< Huge page mode for large matrices */
+    size_t huge_page_threshold;     /**< Minimum data size in bytes for huge pages */
+    palma_numa_t numa;              /**< NUMA placement for matrices of 256 KiB or more */
+} palma_alloc_policy_t;
+
+/**
+ * @brief Set the allocation policy for subsequently created matrices
+ * 
+ * Thread-safe: a matrix created while another thread changes the policy
+ * follows either the old or the new policy in full, never a mix. Matrices
+ * that already exist keep their layout.
+ * 
+ * @param policy New policy (NULL restores the default)
+ * @return PALMA_SUCCESS or PALMA_ERR_INVALID_ARG for a bad alignment
+ */
+palma_error_t palma_set_alloc_policy(const palma_alloc_policy_t *policy);
+
+/**
+ * @brief Get the current allocation policy
+ * @param policy Output policy
+ */
+void palma_get_alloc_policy(palma_alloc_policy_t *policy);
+
+/**
+ * @brief Row stride (in elements) the current policy uses for a column count
+ * 
+ * Useful for sizing external buffers passed to palma_matrix_wrap().
+ * 
+ * @param cols Number of columns
+ * @return Row stride in elements
+ */
+size_t palma_alloc_stride(size_t cols);
+
+/*============================================================================
+ * NUMA PLACEMENT
+ *============================================================================*/
+
+/**
+ * @brief Number of online NUMA nodes (1 when unknown or unsupported)
+ */
+int palma_numa_node_count(void);
+
+/**
+ * @brief Bind OpenMP threads to NUMA nodes
+ * 
+ * Thread t of T is pinned to the CPUs of node t·N/T, so the contiguous row
+ * block a static schedule gives thread t is first-touched and later computed
+ * on the same node. Call once at startup, before creating large matrices.
+ * Has no effect on single-node machines or without OpenMP.
+ * 
+ * @return PALMA_SUCCESS, or PALMA_ERR_UNSUPPORTED if binding failed
+ */
+palma_error_t palma_numa_bind_threads(void);
+
+/**
+ * @brief Interleave a matrix's pages across all NUMA nodes
+ * 
+ * Intended for large read-only operands shared by every thread (e.g. the B
+ * operand of a GEMM), which would otherwise saturate one node's memory
+ * controller. Existing pages are migrated. Partial pages at the ends of the
+ * buffer are left in place.
+ * 
+ * @param A Matrix to redistribute
+ * @return PALMA_SUCCESS (also on single-node machines) or error code
+ */
+palma_error_t palma_matrix_numa_interleave(palma_matrix_t *A);
+
 /*============================================================================
  * DENSE MATRIX LIFECYCLE
  *============================================================================*/
@@ -304,6 +437,61 @@ palma_matrix_t* palma_matrix_clone(const palma_matrix_t *src);
  */
 void palma_matrix_destroy(palma_matrix_t *mat);
 
+/*============================================================================
+ * SUBMATRIX VIEWS
+ *
+ * A view is a non-owning palma_matrix_t that points into its parent's
+ * storage with the parent's stride. It is filled into a caller-provided
+ * struct, so taking a view never allocates; do not pass it to
+ * palma_matrix_destroy(). Every kernel accepts views. Writes through a view
+ * modify the parent, and an output must not overlap an input unless the
+ * function documents in-place use.
+ *============================================================================*/
+
+/**
+ * @brief Take a rows×cols view of A starting at (row, col)
+ * @param view Output view
+ * @param A Parent matrix (or view)
+ * @param row First row
+ * @param col First column
+ * @param rows Number of rows (> 0)
+ * @param cols Number of columns (> 0)
+ * @return PALMA_SUCCESS or PALMA_ERR_INDEX_BOUNDS if the block exceeds A
+ */
+palma_error_t palma_matrix_view(palma_matrix_t *view, const palma_matrix_t *A,
+                                size_t row, size_t col, size_t rows, size_t cols);
+
+/**
+ * @brief View tile (ti, tj) of A partitioned into tile_rows×tile_cols blocks
+ * 
+ * Tiles in the last block row/column are clipped to A's edge.
+ * 
+ * @param tile Output view
+ * @param A Parent matrix (or view)
+ * @param tile_rows Tile height (> 0)
+ * @param tile_cols Tile width (> 0)
+ * @param ti Tile row index (< palma_matrix_tile_count(A->rows, tile_rows))
+ * @param tj Tile column index (< palma_matrix_tile_count(A->cols, tile_cols))
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_tile(palma_matrix_t *tile, const palma_matrix_t *A,
+                                size_t tile_rows, size_t tile_cols, size_t ti, size_t tj);
+
+/**
+ * @brief Number of tiles of size tile along a dimension of length n
+ */
+static inline size_t palma_matrix_tile_count(size_t n, size_t tile) {
+    return tile ? (n + tile - 1) / tile : 0;
+}
+
+/**
+ * @brief Copy values between same-sized matrices or views (dst = src)
+ * @param dst Destination
+ * @param src Source (may overlap dst only if identical)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_copy(palma_matrix_t *dst, const palma_matrix_t *src);
+
 /*============================================================================
  * DENSE MATRIX ACCESS
  *============================================================================*/
@@ -360,6 +548,7 @@ palma_error_t palma_matrix_set_safe(palma_matrix_t *mat, size_t row, size_t col,
  * @param capacity Initial capacity for non-zero elements
  * @param semiring Semiring type
  * @return Pointer to new sparse matrix, or NULL on failure
+ *         (PALMA_ERR_OVERFLOW if rows, cols or capacity exceed the index types)
  */
 palma_sparse_t* palma_sparse_create(size_t rows, size_t cols, size_t capacity, palma_semiring_t semiring);
 
@@ -410,6 +599,9 @@ palma_val_t palma_sparse_get(const palma_sparse_t *sp, size_t row, size_t col);
  * Note: Setting a value to semiring zero will NOT remove the entry.
  * Use palma_sparse_compress() to remove zeros after bulk modifications.
  * 
+ * Inserting shifts the rest of the arrays (O(nnz)); for streams of edge
+ * updates use palma_dynsparse_t.
+ * 
  * @param sp Sparse matrix
  * @param row Row index
  * @param col Column index
@@ -478,6 +670,21 @@ palma_matrix_t* palma_matrix_mul(const palma_matrix_t *A, const palma_matrix_t *
 palma_error_t palma_matrix_mul_into(palma_matrix_t *C, const palma_matrix_t *A, 
                                      const palma_matrix_t *B, palma_semiring_t semiring);
 
+/**
+ * @brief Accumulating tropical multiplication: C ← C ⊕ A ⊗ B
+ * 
+ * Folds the product into C without materializing it, so a sum of products
+ * needs no temporary. C must not overlap A or B.
+ * 
+ * @param C Accumulator (m × p)
+ * @param A Left matrix (m × n)
+ * @param B Right matrix (n × p)
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS, or PALMA_ERR_INVALID_ARG if C overlaps an operand
+ */
+palma_error_t palma_matrix_mul_acc_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                         const palma_matrix_t *B, palma_semiring_t semiring);
+
 /**
  * @brief Tropical matrix addition: C = A ⊕ B (element-wise)
  * @param A First matrix
@@ -488,6 +695,17 @@ palma_error_t palma_matrix_mul_into(palma_matrix_t *C, const palma_matrix_t *A,
 palma_matrix_t* palma_matrix_add(const palma_matrix_t *A, const palma_matrix_t *B,
                                   palma_semiring_t semiring);
 
+/**
+ * @brief Tropical matrix addition into an existing matrix: C = A ⊕ B
+ * @param C Pre-allocated result (same dimensions; may be A or B)
+ * @param A First matrix
+ * @param B Second matrix
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_add_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                     const palma_matrix_t *B, palma_semiring_t semiring);
+
 /**
  * @brief Tropical matrix power: A^n
  * 
@@ -501,6 +719,23 @@ palma_matrix_t* palma_matrix_add(const palma_matrix_t *A, const palma_matrix_t *
 palma_matrix_t* palma_matrix_power(const palma_matrix_t *A, unsigned int n,
                                     palma_semiring_t semiring);
 
+/**
+ * @brief Tropical matrix power into an existing matrix: C = A^n
+ * 
+ * With a workspace no memory is allocated.
+ * 
+ * @param C Pre-allocated result (n × n, must not overlap A)
+ * @param A Square matrix
+ * @param n Power (n >= 0)
+ * @param semiring Semiring type
+ * @param work Scratch of at least 2n × n, or NULL to allocate one (must not
+ *             overlap A or C)
+ * @return PALMA_SUCCESS, or PALMA_ERR_INVALID_ARG if C or work overlaps
+ *         another operand
+ */
+palma_error_t palma_matrix_power_into(palma_matrix_t *C, const palma_matrix_t *A, unsigned int n,
+                                       palma_semiring_t semiring, palma_matrix_t *work);
+
 /**
  * @brief Tropical closure (Kleene star): A* = I ⊕ A ⊕ A² ⊕ A³ ⊕ ...
  * 
@@ -513,10 +748,27 @@ palma_matrix_t* palma_matrix_power(const palma_matrix_t *A, unsigned int n,
  */
 palma_matrix_t* palma_matrix_closure(const palma_matrix_t *A, palma_semiring_t semiring);
 
+/**
+ * @brief Tropical closure into an existing matrix: D = A*
+ * Inside a job (see palma_job_closure()) cancellation stops the iteration
+ * with PALMA_ERR_CANCELLED or PALMA_ERR_TIMEOUT, leaving D partially updated.
+ * 
+ * @param D Pre-allocated result (same dimensions; may be A for in-place)
+ * @param A Square matrix
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                         palma_semiring_t semiring);
+
 /**
  * @brief Transitive closure: A+ = A ⊕ A² ⊕ A³ ⊕ ...
  * 
  * Like closure but without identity (requires at least one step).
+ * Computed in a single Floyd-Warshall pass over A. Entries reachable
+ * through an improving cycle (positive in max-plus, negative in min-plus)
+ * diverge to +∞ / -∞. The diagonal gives the best cycle through each node
+ * (see palma_matrix_cycle_nodes()).
  * 
  * @param A Square matrix
  * @param semiring Semiring type
@@ -524,6 +776,29 @@ palma_matrix_t* palma_matrix_closure(const palma_matrix_t *A, palma_semiring_t s
  */
 palma_matrix_t* palma_matrix_transitive_closure(const palma_matrix_t *A, palma_semiring_t semiring);
 
+/**
+ * @brief Transitive closure into an existing matrix: D = A+
+ * @param D Pre-allocated result (same dimensions; may be A for in-place)
+ * @param A Square matrix
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_transitive_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                                    palma_semiring_t semiring);
+
+/**
+ * @brief Nodes lying on a cycle, read from the diagonal of A+
+ * 
+ * Node i is on a cycle iff (A+)_ii ≠ ε; for max-plus the value is the
+ * heaviest cycle weight through i (+∞ if unbounded).
+ * 
+ * @param plus Transitive closure A+ (from palma_matrix_transitive_closure())
+ * @param on_cycle Output array (length n, set to 1 if on a cycle)
+ * @param semiring Semiring used to compute plus
+ * @return Number of nodes on cycles (0 means acyclic), or negative error code
+ */
+int palma_matrix_cycle_nodes(const palma_matrix_t *plus, int *on_cycle, palma_semiring_t semiring);
+
 /*============================================================================
  * SPARSE MATRIX OPERATIONS
  *============================================================================*/
@@ -536,6 +811,21 @@ palma_matrix_t* palma_matrix_transitive_closure(const palma_matrix_t *A, palma_s
  */
 palma_sparse_t* palma_sparse_mul(const palma_sparse_t *A, const palma_sparse_t *B);
 
+/**
+ * @brief Sparse multiplication into an existing matrix: C = A ⊗ B
+ * 
+ * C is reshaped to A->rows × B->cols and takes A's semiring. Its value and
+ * index arrays are reused and only grow when the result needs more capacity,
+ * so repeated products settle into a fixed buffer.
+ * 
+ * @param C Result sparse matrix (must not be A or B)
+ * @param A Left sparse matrix
+ * @param B Right sparse matrix
+ * @return PALMA_SUCCESS or error code (C is left empty on failure)
+ */
+palma_error_t palma_sparse_mul_into(palma_sparse_t *C, const palma_sparse_t *A,
+                                     const palma_sparse_t *B);
+
 /**
  * @brief Sparse matrix-vector multiplication: y = A ⊗ x
  * @param A Sparse matrix (m × n)
@@ -553,6 +843,93 @@ palma_error_t palma_sparse_matvec(const palma_sparse_t *A, const palma_val_t *x,
  */
 palma_sparse_t* palma_sparse_closure(const palma_sparse_t *A);
 
+/**
+ * @brief Sparse closure into an existing matrix: C = A*
+ * 
+ * Reuses C's capacity like palma_sparse_mul_into().
+ * 
+ * @param C Result sparse matrix (may be A)
+ * @param A Square sparse matrix
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_sparse_closure_into(palma_sparse_t *C, const palma_sparse_t *A);
+
+/*============================================================================
+ * DYNAMIC SPARSE MATRICES
+ *
+ * A palma_dynsparse_t accepts edge inserts, updates and deletes in O(1)
+ * amortized time: changes go to a hash-indexed delta buffer on top of a CSR
+ * base and are folded into the base by a linear-time merge once the buffer
+ * holds a fixed fraction of the entries. palma_dynsparse_view() merges and
+ * returns the base, which is an ordinary palma_sparse_t for
+ * palma_sparse_matvec(), palma_sparse_mul_into() and the other kernels.
+ *============================================================================*/
+
+/** Dynamic sparse matrix (opaque) */
+typedef struct palma_dynsparse palma_dynsparse_t;
+
+/**
+ * @brief Create an empty dynamic sparse matrix
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param semiring Semiring (its zero is the "no entry" value)
+ * @return Dynamic matrix, or NULL on failure
+ */
+palma_dynsparse_t* palma_dynsparse_create(size_t rows, size_t cols, palma_semiring_t semiring);
+
+/**
+ * @brief Create a dynamic sparse matrix from a CSR matrix (copied)
+ */
+palma_dynsparse_t* palma_dynsparse_from_sparse(const palma_sparse_t *S);
+
+/**
+ * @brief Destroy a dynamic sparse matrix (NULL-safe)
+ */
+void palma_dynsparse_destroy(palma_dynsparse_t *D);
+
+/**
+ * @brief Insert or update an entry; setting the semiring zero deletes it
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_dynsparse_set(palma_dynsparse_t *D, size_t row, size_t col, palma_val_t val);
+
+/**
+ * @brief Delete an entry (no effect if absent)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_dynsparse_remove(palma_dynsparse_t *D, size_t row, size_t col);
+
+/**
+ * @brief Read an entry (semiring zero if absent)
+ */
+palma_val_t palma_dynsparse_get(const palma_dynsparse_t *D, size_t row, size_t col);
+
+/**
+ * @brief Number of entries, pending changes included
+ */
+size_t palma_dynsparse_nnz(const palma_dynsparse_t *D);
+
+/**
+ * @brief Number of changes waiting in the delta buffer
+ */
+size_t palma_dynsparse_pending(const palma_dynsparse_t *D);
+
+/**
+ * @brief Fold pending changes into the CSR base now
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_dynsparse_merge(palma_dynsparse_t *D);
+
+/**
+ * @brief Merged CSR view
+ * 
+ * Merges pending changes, then returns the base: sorted columns, no
+ * stored zeros. The view stays valid until the next modification of D.
+ * 
+ * @return CSR matrix owned by D, or NULL on failure
+ */
+const palma_sparse_t* palma_dynsparse_view(palma_dynsparse_t *D);
+
 /*============================================================================
  * VECTOR OPERATIONS
  *============================================================================*/
@@ -591,120 +968,963 @@ palma_val_t palma_dot(const palma_val_t *x, const palma_val_t *y,
                        size_t len, palma_semiring_t semiring);
 
 /*============================================================================
- * EIGENVALUE & EIGENVECTOR COMPUTATION
+ * MATRIX SEQUENCES (TIME-VARYING SYSTEMS)
  *============================================================================*/
 
 /**
- * @brief Compute the maximum cycle mean (tropical eigenvalue)
+ * @brief Product of a matrix sequence: P = A(k) ⊗ ... ⊗ A(2) ⊗ A(1)
  * 
- * For max-plus, this is the growth rate of A^k as k → ∞.
- * Equivalent to the largest average weight over all cycles.
- * Uses Karp's algorithm: O(n³) time.
+ * mats[0] is A(1) and mats[count-1] is A(k). The sequence is reduced with
+ * a balanced binary tree; each level runs in parallel under OpenMP.
  * 
- * @param A Square matrix
+ * @param mats Matrices in time order (mats[i]->cols == mats[i-1]->rows)
+ * @param count Number of matrices (k >= 1)
  * @param semiring Semiring type
- * @return Tropical eigenvalue λ, or PALMA_NEG_INF if acyclic
+ * @return Product (rows of A(k) × cols of A(1)), or NULL on failure
  */
-palma_val_t palma_eigenvalue(const palma_matrix_t *A, palma_semiring_t semiring);
+palma_matrix_t* palma_matrix_sequence_product(const palma_matrix_t *const *mats, size_t count,
+                                               palma_semiring_t semiring);
 
 /**
- * @brief Compute tropical eigenvector
+ * @brief All intermediate products: prefix[i] = A(i+1) ⊗ ... ⊗ A(1)
  * 
- * Finds v such that A ⊗ v = λ ⊗ v (where λ is the eigenvalue).
- * Uses power iteration with normalization.
+ * Parallel blocked prefix scan. Outputs are pre-allocated and reused.
  * 
- * @param A Square matrix
- * @param eigenvector Output vector (length n, pre-allocated)
- * @param eigenvalue Output eigenvalue (optional, can be NULL)
+ * @param prefix Output matrices (prefix[i] is mats[i]->rows × mats[0]->cols)
+ * @param mats Matrices in time order
+ * @param count Number of matrices
  * @param semiring Semiring type
- * @param max_iter Maximum iterations (0 for default)
- * @return PALMA_SUCCESS or error code (including PALMA_ERR_NOT_CONVERGED)
+ * @return PALMA_SUCCESS or error code
  */
-palma_error_t palma_eigenvector(const palma_matrix_t *A, palma_val_t *eigenvector,
-                                 palma_val_t *eigenvalue, palma_semiring_t semiring,
-                                 unsigned int max_iter);
+palma_error_t palma_matrix_sequence_prefix(palma_matrix_t **prefix,
+                                            const palma_matrix_t *const *mats, size_t count,
+                                            palma_semiring_t semiring);
 
 /**
- * @brief Compute all nodes on critical cycles
+ * @brief Apply a matrix sequence to a vector: y = A(k) ⊗ ... ⊗ A(1) ⊗ x
  * 
- * Returns indices of nodes that participate in cycles achieving
- * the maximum cycle mean.
+ * Chooses by cost between a serial chain of matrix-vector products and a
+ * parallel tree product followed by one matrix-vector product.
  * 
- * @param A Square matrix
- * @param critical_nodes Output array (length n, set to 1 if on critical cycle)
+ * @param mats Matrices in time order
+ * @param count Number of matrices
+ * @param x Initial state x(0) (length mats[0]->cols)
+ * @param y Output state x(k) (length mats[count-1]->rows, must not alias x)
  * @param semiring Semiring type
- * @return Number of critical nodes, or negative error code
+ * @return PALMA_SUCCESS or error code
  */
-int palma_critical_nodes(const palma_matrix_t *A, int *critical_nodes,
-                          palma_semiring_t semiring);
+palma_error_t palma_matrix_sequence_apply(const palma_matrix_t *const *mats, size_t count,
+                                           const palma_val_t *x, palma_val_t *y,
+                                           palma_semiring_t semiring);
 
 /*============================================================================
- * GRAPH ALGORITHMS
+ * BATCHED SMALL MATRICES
  *============================================================================*/
 
+/** Matrices per kernel chunk (16 × int32 = one 64-byte cache line) */
+#define PALMA_BATCH_LANES 16
+
 /**
- * @brief All-pairs optimal paths
- * 
- * Computes optimal path weights between all pairs of nodes.
- * Uses tropical matrix closure.
+ * @brief Batch of same-size matrices in interleaved (SoA) layout
  * 
- * @param adj Adjacency matrix with edge weights
- * @param semiring PALMA_MINPLUS for shortest, PALMA_MAXPLUS for longest
- * @return Distance matrix, or NULL on failure
+ * Element (i,j) of matrix m is stored at data[(i * cols + j) * lanes + m],
+ * so one element of consecutive matrices is contiguous and SIMD lanes span
+ * matrices. Batched kernels process PALMA_BATCH_LANES matrices per chunk
+ * and parallelize across chunks.
  */
-palma_matrix_t* palma_all_pairs_paths(const palma_matrix_t *adj, palma_semiring_t semiring);
+typedef struct {
+    palma_val_t *data;      /**< Interleaved data (64-byte aligned when owned) */
+    size_t rows;            /**< Rows of each matrix */
+    size_t cols;            /**< Columns of each matrix */
+    size_t count;           /**< Number of matrices */
+    size_t lanes;           /**< Element stride (>= count, padded when owned) */
+    bool owns_data;         /**< Whether to free data on destroy */
+} palma_batch_t;
 
 /**
- * @brief Single-source optimal paths (Bellman-Ford style)
- * @param adj Adjacency matrix
- * @param source Source vertex index
- * @param dist Output distance vector (length n, pre-allocated)
- * @param semiring PALMA_MINPLUS for shortest, PALMA_MAXPLUS for longest
- * @return PALMA_SUCCESS or error code
+ * @brief Create a batch of count rows × cols matrices (zero-filled storage)
+ * @param rows Rows of each matrix
+ * @param cols Columns of each matrix
+ * @param count Number of matrices
+ * @return Pointer to new batch, or NULL on failure
  */
-palma_error_t palma_single_source_paths(const palma_matrix_t *adj, size_t source,
-                                         palma_val_t *dist, palma_semiring_t semiring);
+palma_batch_t* palma_batch_create(size_t rows, size_t cols, size_t count);
 
 /**
- * @brief Reachability analysis using Boolean semiring
- * @param adj Adjacency matrix (non-zero = edge exists)
- * @return Reachability matrix (1 if path exists, 0 otherwise), or NULL on failure
+ * @brief Wrap existing interleaved data as a batch (no copy)
+ * @param data Interleaved data (must remain valid)
+ * @param rows Rows of each matrix
+ * @param cols Columns of each matrix
+ * @param count Number of matrices
+ * @param lanes Element stride (>= count)
+ * @return Pointer to batch wrapper, or NULL on failure
  */
-palma_matrix_t* palma_reachability(const palma_matrix_t *adj);
+palma_batch_t* palma_batch_wrap(palma_val_t *data, size_t rows, size_t cols,
+                                size_t count, size_t lanes);
 
 /**
- * @brief Bottleneck paths (maximum capacity paths)
- * 
- * Finds paths maximizing the minimum edge weight (bandwidth/capacity).
- * Uses max-min semiring.
- * 
- * @param adj Adjacency matrix with edge capacities
- * @return Capacity matrix, or NULL on failure
+ * @brief Destroy a batch and free resources
+ * @param batch Batch to destroy (NULL-safe)
  */
-palma_matrix_t* palma_bottleneck_paths(const palma_matrix_t *adj);
-
-/*============================================================================
- * SCHEDULING APPLICATIONS
- *============================================================================*/
+void palma_batch_destroy(palma_batch_t *batch);
 
 /**
- * @brief Task scheduling system
- * 
- * Models precedence-constrained scheduling:
- * x(k+1) = A ⊗ x(k) ⊕ b
- * 
- * A[i,j] = duration of j if j precedes i
- * x[i] = completion time of task i
- * b[i] = external input (ready time)
+ * @brief Get element (row, col) of matrix m
  */
-typedef struct {
-    palma_matrix_t *system;     /**< System matrix A */
-    palma_val_t *state;         /**< Current state x */
-    palma_val_t *input;         /**< External input b */
-    size_t n_tasks;             /**< Number of tasks */
-    palma_semiring_t semiring;  /**< Semiring (usually MAXPLUS) */
-    char **task_names;          /**< Optional task names */
-} palma_scheduler_t;
+static inline palma_val_t palma_batch_get(const palma_batch_t *batch, size_t m,
+                                          size_t row, size_t col) {
+    return batch->data[(row * batch->cols + col) * batch->lanes + m];
+}
+
+/**
+ * @brief Set element (row, col) of matrix m
+ */
+static inline void palma_batch_set(palma_batch_t *batch, size_t m,
+                                   size_t row, size_t col, palma_val_t val) {
+    batch->data[(row * batch->cols + col) * batch->lanes + m] = val;
+}
+
+/**
+ * @brief Copy a dense matrix into slot index of a batch
+ * @param batch Batch
+ * @param index Matrix slot
+ * @param mat Source matrix (same dimensions as the batch)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_batch_set_matrix(palma_batch_t *batch, size_t index,
+                                      const palma_matrix_t *mat);
+
+/**
+ * @brief Copy slot index of a batch into a dense matrix
+ * @param batch Batch
+ * @param index Matrix slot
+ * @param mat Destination matrix (same dimensions as the batch)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_batch_get_matrix(const palma_batch_t *batch, size_t index,
+                                      palma_matrix_t *mat);
+
+/**
+ * @brief Batched multiplication: C[m] = A[m] ⊗ B[m] for every m
+ * @param C Pre-allocated result batch (must not alias A or B)
+ * @param A Left batch
+ * @param B Right batch (same count)
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_batch_mul_into(palma_batch_t *C, const palma_batch_t *A,
+                                    const palma_batch_t *B, palma_semiring_t semiring);
+
+/**
+ * @brief Batched closure: D[m] = A[m]* for every m
+ * @param D Pre-allocated result batch (may be A for in-place)
+ * @param A Batch of square matrices
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_batch_closure_into(palma_batch_t *D, const palma_batch_t *A,
+                                        palma_semiring_t semiring);
+
+/**
+ * @brief Batched eigenvalue: lambda[m] = palma_eigenvalue(A[m])
+ * @param A Batch of square matrices
+ * @param lambda Output array (length A->count)
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_batch_eigenvalue(const palma_batch_t *A, palma_val_t *lambda,
+                                      palma_semiring_t semiring);
+
+/*============================================================================
+ * DEFERRED EXPRESSIONS
+ *
+ * Build an operation graph of ⊗ and ⊕ over matrices and vectors, then
+ * evaluate it in one call. Before evaluation the graph is optimized:
+ * product chains are re-associated by dimension (A ⊗ B ⊗ x runs as two
+ * matrix-vector products), ⊗ is distributed over ⊕ when that is cheaper
+ * ((A ⊗ B ⊕ C) ⊗ x becomes A ⊗ (B ⊗ x) ⊕ C ⊗ x), and ⊕ of a product is
+ * fused into the product kernel's accumulator. Each chain is distributed
+ * over one sum factor at most, so planning stays polynomial in the size of
+ * the expression. The plan is kept on the node and reused by later cost and
+ * eval calls. Intermediates come from a buffer pool owned by the context
+ * and reused across evaluations.
+ * 
+ * Results equal the eager functions except where re-association changes
+ * which intermediate saturates at ±∞.
+ *============================================================================*/
+
+/** Expression context: owns nodes and scratch buffers (opaque) */
+typedef struct palma_expr_ctx palma_expr_ctx_t;
+
+/** Expression node (opaque, owned by its context) */
+typedef struct palma_expr palma_expr_t;
+
+/**
+ * @brief Create an expression context
+ * @param semiring Semiring used by every node
+ * @return New context, or NULL on failure
+ */
+palma_expr_ctx_t* palma_expr_create(palma_semiring_t semiring);
+
+/**
+ * @brief Destroy a context, its nodes and its buffers (NULL-safe)
+ */
+void palma_expr_destroy(palma_expr_ctx_t *ctx);
+
+/**
+ * @brief Drop all nodes but keep the buffer pool for the next expression
+ */
+void palma_expr_reset(palma_expr_ctx_t *ctx);
+
+/**
+ * @brief Leaf referring to a matrix (not copied; must outlive evaluation)
+ */
+palma_expr_t* palma_expr_matrix(palma_expr_ctx_t *ctx, const palma_matrix_t *A);
+
+/**
+ * @brief Leaf referring to a column vector of length n (not copied)
+ */
+palma_expr_t* palma_expr_vector(palma_expr_ctx_t *ctx, const palma_val_t *x, size_t n);
+
+/**
+ * @brief Deferred product a ⊗ b
+ * @return New node, or NULL on dimension mismatch or NULL operand
+ */
+palma_expr_t* palma_expr_mul(palma_expr_ctx_t *ctx, palma_expr_t *a, palma_expr_t *b);
+
+/**
+ * @brief Deferred element-wise sum a ⊕ b
+ * @return New node, or NULL on dimension mismatch or NULL operand
+ */
+palma_expr_t* palma_expr_add(palma_expr_ctx_t *ctx, palma_expr_t *a, palma_expr_t *b);
+
+/**
+ * @brief Result dimensions of an expression
+ */
+void palma_expr_shape(const palma_expr_t *e, size_t *rows, size_t *cols);
+
+/**
+ * @brief Estimated semiring operations of the optimized plan
+ * @param ctx Context
+ * @param e Expression
+ * @param naive Optional output: cost of evaluating in the order written
+ * @return Estimated cost, or a negative value on error
+ */
+double palma_expr_cost(palma_expr_ctx_t *ctx, palma_expr_t *e, double *naive);
+
+/**
+ * @brief Evaluate into a matrix of the expression's shape
+ * 
+ * out may be one of the leaves; the result is then staged in a pool buffer.
+ */
+palma_error_t palma_expr_eval(palma_expr_ctx_t *ctx, palma_expr_t *e, palma_matrix_t *out);
+
+/**
+ * @brief Evaluate a column-vector expression into y (length rows)
+ */
+palma_error_t palma_expr_eval_vector(palma_expr_ctx_t *ctx, palma_expr_t *e, palma_val_t *y);
+
+/*============================================================================
+ * ASYNCHRONOUS JOBS
+ *
+ * Long computations run on library worker threads while the caller keeps
+ * going. A job works on a private copy of its input, so the caller may
+ * modify or free the matrix right after submitting. Completion is reported
+ * by polling, by blocking in palma_job_wait(), by a callback, or through an
+ * eventfd that becomes readable (Linux; suitable for epoll).
+ *
+ * Cancellation and time budgets are cooperative: the closure and eigenvalue
+ * kernels check once per outer iteration and stop with PALMA_ERR_CANCELLED
+ * or PALMA_ERR_TIMEOUT. The budget counts from submission, so a job that
+ * waited too long in the queue fails without running.
+ *============================================================================*/
+
+/** Asynchronous job handle (opaque) */
+typedef struct palma_job palma_job_t;
+
+/**
+ * @brief Job lifecycle
+ */
+typedef enum {
+    PALMA_JOB_QUEUED = 0,     /**< Waiting for a worker */
+    PALMA_JOB_RUNNING,        /**< Being computed */
+    PALMA_JOB_DONE,           /**< Finished; result available */
+    PALMA_JOB_FAILED,         /**< Finished with an error (see palma_job_error()) */
+    PALMA_JOB_CANCELLED       /**< Stopped by palma_job_cancel() */
+} palma_job_state_t;
+
+/**
+ * @brief Completion callback
+ * 
+ * Runs on the worker thread once the job reaches a final state (on the
+ * cancelling thread for a job cancelled while queued), after the eventfd
+ * has been signalled. It may read the result but must not destroy the job.
+ */
+typedef void (*palma_job_callback_t)(palma_job_t *job, void *user_data);
+
+/**
+ * @brief Submission options (all fields may be zero)
+ */
+typedef struct {
+    double time_budget;             /**< Seconds from submission, 0 = unlimited */
+    palma_job_callback_t callback;  /**< Completion callback, or NULL */
+    void *user_data;                /**< Passed to the callback */
+    bool notify_fd;                 /**< Create an eventfd signalled on completion */
+} palma_job_options_t;
+
+/**
+ * @brief Submit A* (see palma_matrix_closure())
+ * @param A Square matrix (copied)
+ * @param semiring Semiring type
+ * @param opts Options, or NULL for defaults
+ * @return Job handle, or NULL on failure
+ */
+palma_job_t* palma_job_closure(const palma_matrix_t *A, palma_semiring_t semiring,
+                               const palma_job_options_t *opts);
+
+/**
+ * @brief Submit A+ (see palma_matrix_transitive_closure())
+ */
+palma_job_t* palma_job_transitive_closure(const palma_matrix_t *A, palma_semiring_t semiring,
+                                          const palma_job_options_t *opts);
+
+/**
+ * @brief Submit all-pairs optimal paths (see palma_all_pairs_paths())
+ */
+palma_job_t* palma_job_all_pairs_paths(const palma_matrix_t *adj, palma_semiring_t semiring,
+                                       const palma_job_options_t *opts);
+
+/**
+ * @brief Submit the tropical eigenvalue (see palma_eigenvalue())
+ */
+palma_job_t* palma_job_eigenvalue(const palma_matrix_t *A, palma_semiring_t semiring,
+                                  const palma_job_options_t *opts);
+
+/**
+ * @brief Current state without blocking
+ */
+palma_job_state_t palma_job_poll(palma_job_t *job);
+
+/**
+ * @brief Block until the job reaches a final state or the timeout expires
+ * @param job Job
+ * @param timeout Seconds to wait, negative to wait indefinitely
+ * @return State at return (QUEUED or RUNNING if the timeout expired)
+ */
+palma_job_state_t palma_job_wait(palma_job_t *job, double timeout);
+
+/**
+ * @brief Request cancellation (returns immediately)
+ * 
+ * A queued job is cancelled at once; a running job stops at its next
+ * check. Has no effect on finished jobs.
+ */
+void palma_job_cancel(palma_job_t *job);
+
+/**
+ * @brief Error of a finished job (PALMA_SUCCESS when DONE)
+ */
+palma_error_t palma_job_error(palma_job_t *job);
+
+/**
+ * @brief Take ownership of a matrix result
+ * @return Result of a DONE closure or path job (caller destroys it), or NULL
+ */
+palma_matrix_t* palma_job_take_matrix(palma_job_t *job);
+
+/**
+ * @brief Scalar result of a DONE eigenvalue job (PALMA_NEG_INF otherwise)
+ */
+palma_val_t palma_job_value(palma_job_t *job);
+
+/**
+ * @brief eventfd readable once the job is final, or -1 if not requested
+ * 
+ * The fd is signalled atomically with the final state: once it is readable
+ * palma_job_poll() reports a final state, and once palma_job_wait() returns
+ * a final state the fd is readable. Owned by the job and closed by
+ * palma_job_destroy().
+ */
+int palma_job_fd(const palma_job_t *job);
+
+/**
+ * @brief Cancel if needed, wait for the worker to release the job, and free it
+ * @param job Job to destroy (NULL-safe; not from its own callback)
+ */
+void palma_job_destroy(palma_job_t *job);
+
+/**
+ * @brief Set the number of worker threads (default 1)
+ * 
+ * Each worker runs its kernel with the full OpenMP team, so more than one
+ * worker mainly helps with many small jobs. The pool can grow while
+ * running but only shrinks through palma_job_shutdown().
+ * 
+ * @param n Number of workers (>= 1)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_job_set_workers(size_t n);
+
+/**
+ * @brief Cancel queued and running jobs, wait for the workers and stop them
+ * 
+ * Running jobs stop at their next interrupt check, as with
+ * palma_job_cancel(), and end CANCELLED. The pool restarts on the next
+ * submission.
+ */
+void palma_job_shutdown(void);
+
+/*============================================================================
+ * EIGENVALUE & EIGENVECTOR COMPUTATION
+ *============================================================================*/
+
+/**
+ * @brief Compute the maximum cycle mean (tropical eigenvalue)
+ * 
+ * For max-plus, this is the growth rate of A^k as k → ∞.
+ * Equivalent to the largest average weight over all cycles.
+ * Uses Karp's algorithm: O(n³) time.
+ * 
+ * @param A Square matrix
+ * @param semiring Semiring type
+ * @return Tropical eigenvalue λ, or PALMA_NEG_INF if acyclic
+ */
+palma_val_t palma_eigenvalue(const palma_matrix_t *A, palma_semiring_t semiring);
+
+/**
+ * @brief Compute tropical eigenvector
+ * 
+ * Finds v such that A ⊗ v = λ ⊗ v (where λ is the eigenvalue).
+ * Uses power iteration with normalization.
+ * 
+ * @param A Square matrix
+ * @param eigenvector Output vector (length n, pre-allocated)
+ * @param eigenvalue Output eigenvalue (optional, can be NULL)
+ * @param semiring Semiring type
+ * @param max_iter Maximum iterations (0 for default)
+ * @return PALMA_SUCCESS or error code (including PALMA_ERR_NOT_CONVERGED)
+ */
+palma_error_t palma_eigenvector(const palma_matrix_t *A, palma_val_t *eigenvector,
+                                 palma_val_t *eigenvalue, palma_semiring_t semiring,
+                                 unsigned int max_iter);
+
+/**
+ * @brief Compute all nodes on critical cycles
+ * 
+ * Returns indices of nodes that participate in cycles achieving
+ * the maximum cycle mean.
+ * 
+ * @param A Square matrix
+ * @param critical_nodes Output array (length n, set to 1 if on critical cycle)
+ * @param semiring Semiring type
+ * @return Number of critical nodes, or negative error code
+ */
+int palma_critical_nodes(const palma_matrix_t *A, int *critical_nodes,
+                          palma_semiring_t semiring);
+
+/*============================================================================
+ * VERSIONED MATRICES
+ *
+ * A palma_vmatrix_t holds a sequence of immutable versions of one dense
+ * matrix for concurrent readers. Each version is a grid of square tiles;
+ * a writer builds the next version copy-on-write, sharing every tile it
+ * does not modify, and installs it with one atomic pointer swap.
+ *
+ * Readers take a snapshot (no lock, a few atomic operations) and then read
+ * it with plain loads for as long as they like; the versions they hold are
+ * reclaimed when the last snapshot of them is released. Writers are
+ * serialized among themselves and never wait for readers beyond the few
+ * instructions of a snapshot acquisition in progress.
+ *============================================================================*/
+
+/** Versioned matrix (opaque) */
+typedef struct palma_vmatrix palma_vmatrix_t;
+
+/** Immutable version of a versioned matrix (opaque) */
+typedef struct palma_vsnapshot palma_vsnapshot_t;
+
+/** Pending edit on a versioned matrix (opaque) */
+typedef struct palma_vmatrix_edit palma_vmatrix_edit_t;
+
+/** Default tile edge (elements) */
+#define PALMA_VMATRIX_TILE 64
+
+/**
+ * @brief Create a versioned matrix whose version 1 is a copy of initial
+ * @param initial Initial contents (may be a view)
+ * @param tile Tile edge in elements, a power of two (0 for PALMA_VMATRIX_TILE)
+ * @return Versioned matrix, or NULL on failure
+ */
+palma_vmatrix_t* palma_vmatrix_create(const palma_matrix_t *initial, size_t tile);
+
+/**
+ * @brief Destroy a versioned matrix (NULL-safe)
+ * 
+ * Snapshots that are still held stay valid until released. No other
+ * thread may be using vm itself.
+ */
+void palma_vmatrix_destroy(palma_vmatrix_t *vm);
+
+/**
+ * @brief Take a snapshot of the current version (lock-free)
+ * @return Snapshot, to be released with palma_vsnapshot_release()
+ */
+const palma_vsnapshot_t* palma_vmatrix_snapshot(palma_vmatrix_t *vm);
+
+/**
+ * @brief Current version number (starts at 1)
+ */
+uint64_t palma_vmatrix_version(const palma_vmatrix_t *vm);
+
+/**
+ * @brief Release a snapshot (NULL-safe)
+ */
+void palma_vsnapshot_release(const palma_vsnapshot_t *snap);
+
+/**
+ * @brief Version number of a snapshot
+ */
+uint64_t palma_vsnapshot_version(const palma_vsnapshot_t *snap);
+
+/**
+ * @brief Dimensions of a snapshot
+ */
+void palma_vsnapshot_shape(const palma_vsnapshot_t *snap, size_t *rows, size_t *cols);
+
+/**
+ * @brief Read one element of a snapshot (unchecked, like palma_matrix_get)
+ */
+palma_val_t palma_vsnapshot_get(const palma_vsnapshot_t *snap, size_t i, size_t j);
+
+/**
+ * @brief Copy a snapshot into a dense matrix for use with the kernels
+ * @param out Output matrix of the same dimensions
+ * @param snap Snapshot
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_vsnapshot_copy_into(palma_matrix_t *out, const palma_vsnapshot_t *snap);
+
+/**
+ * @brief Start building the next version from the current one
+ * 
+ * Blocks while another edit on vm is open. Until commit or abort, the
+ * edit is private to the calling thread.
+ * 
+ * @param vm Versioned matrix
+ * @return Edit, or NULL on failure
+ */
+palma_vmatrix_edit_t* palma_vmatrix_begin(palma_vmatrix_t *vm);
+
+/**
+ * @brief Set an element in an edit (copies its tile on the first write)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_vmatrix_edit_set(palma_vmatrix_edit_t *edit, size_t i, size_t j,
+                                     palma_val_t value);
+
+/**
+ * @brief Read an element as the edit currently sees it
+ */
+palma_val_t palma_vmatrix_edit_get(const palma_vmatrix_edit_t *edit, size_t i, size_t j);
+
+/**
+ * @brief Install an edit as the new current version and free the edit
+ * 
+ * An edit that changed no tile installs nothing and reports the current
+ * version.
+ * 
+ * @param edit Edit from palma_vmatrix_begin()
+ * @param version Output: version now current (optional)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_vmatrix_commit(palma_vmatrix_edit_t *edit, uint64_t *version);
+
+/**
+ * @brief Discard an edit (NULL-safe)
+ */
+void palma_vmatrix_abort(palma_vmatrix_edit_t *edit);
+
+/**
+ * @brief Install a full matrix as the next version, sharing equal tiles
+ * 
+ * Tiles whose contents are unchanged are shared with the current version,
+ * so republishing a recomputed closure after a local update costs memory
+ * only for the tiles that actually moved.
+ * 
+ * @param vm Versioned matrix
+ * @param M New contents, same dimensions (may be a view)
+ * @param version Output: version now current (optional)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_vmatrix_publish(palma_vmatrix_t *vm, const palma_matrix_t *M,
+                                    uint64_t *version);
+
+/*============================================================================
+ * GRAPH ALGORITHMS
+ *============================================================================*/
+
+/**
+ * @brief All-pairs optimal paths
+ * 
+ * Computes optimal path weights between all pairs of nodes.
+ * Uses tropical matrix closure.
+ * 
+ * @param adj Adjacency matrix with edge weights
+ * @param semiring PALMA_MINPLUS for shortest, PALMA_MAXPLUS for longest
+ * @return Distance matrix, or NULL on failure
+ */
+palma_matrix_t* palma_all_pairs_paths(const palma_matrix_t *adj, palma_semiring_t semiring);
+
+/**
+ * @brief All-pairs optimal paths into an existing matrix
+ * @param dist Pre-allocated distance matrix (may be adj)
+ * @param adj Adjacency matrix
+ * @param semiring PALMA_MINPLUS for shortest, PALMA_MAXPLUS for longest
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_all_pairs_paths_into(palma_matrix_t *dist, const palma_matrix_t *adj,
+                                          palma_semiring_t semiring);
+
+/**
+ * @brief Single-source optimal paths (Bellman-Ford style)
+ * @param adj Adjacency matrix
+ * @param source Source vertex index
+ * @param dist Output distance vector (length n, pre-allocated)
+ * @param semiring PALMA_MINPLUS for shortest, PALMA_MAXPLUS for longest
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_single_source_paths(const palma_matrix_t *adj, size_t source,
+                                         palma_val_t *dist, palma_semiring_t semiring);
+
+/**
+ * @brief Reachability analysis using Boolean semiring
+ * @param adj Adjacency matrix (non-zero = edge exists)
+ * @return Reachability matrix (1 if path exists, 0 otherwise), or NULL on failure
+ */
+palma_matrix_t* palma_reachability(const palma_matrix_t *adj);
+
+/**
+ * @brief Reachability analysis into an existing matrix
+ * @param reach Pre-allocated result (may be adj)
+ * @param adj Adjacency matrix
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_reachability_into(palma_matrix_t *reach, const palma_matrix_t *adj);
+
+/**
+ * @brief Bottleneck paths (maximum capacity paths)
+ * 
+ * Finds paths maximizing the minimum edge weight (bandwidth/capacity).
+ * Uses max-min semiring.
+ * 
+ * @param adj Adjacency matrix with edge capacities
+ * @return Capacity matrix, or NULL on failure
+ */
+palma_matrix_t* palma_bottleneck_paths(const palma_matrix_t *adj);
+
+/**
+ * @brief Bottleneck paths into an existing matrix
+ * @param cap Pre-allocated capacity matrix (may be adj)
+ * @param adj Adjacency matrix with edge capacities
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_bottleneck_paths_into(palma_matrix_t *cap, const palma_matrix_t *adj);
+
+/*============================================================================
+ * WORKLOAD GENERATORS
+ *
+ * Synthetic graphs with the structure of real inputs, returned as n × n
+ * sparse adjacency matrices: R-MAT power-law graphs, road-like grids,
+ * random DAGs (project plans) and Erdős–Rényi graphs. Output depends only
+ * on the parameters and the seed, never on the thread count: every row
+ * (or R-MAT edge) draws from its own counter-based random stream, so
+ * generation runs in parallel. Duplicate edges are combined with ⊕ and
+ * there are no self-loops.
+ *
+ * Random positive weights form improving cycles under max-plus, so A*
+ * only exists for max-plus on DAGs, or with non-positive weights.
+ *============================================================================*/
+
+/**
+ * @brief Edge weight distribution
+ */
+typedef enum {
+    PALMA_WEIGHTS_UNIFORM = 0,      /**< Uniform integers in [min, max] */
+    PALMA_WEIGHTS_CONSTANT = 1,     /**< Always min */
+    PALMA_WEIGHTS_LOG_UNIFORM = 2   /**< log(w) uniform: many short, few long edges (1 <= min) */
+} palma_weight_dist_t;
+
+/**
+ * @brief Generator options
+ * 
+ * Weights are ignored for the Boolean semiring, where every edge is 1.
+ * Neither bound may be ±∞.
+ */
+typedef struct {
+    uint64_t seed;                  /**< Random seed */
+    palma_weight_dist_t weights;    /**< Weight distribution */
+    palma_val_t min_weight;         /**< Smallest weight */
+    palma_val_t max_weight;         /**< Largest weight */
+} palma_gen_options_t;
+
+/** Graph500 R-MAT quadrant probabilities (d = 1 - a - b - c = 0.05) */
+#define PALMA_RMAT_A 0.57
+#define PALMA_RMAT_B 0.19
+#define PALMA_RMAT_C 0.19
+
+/**
+ * @brief Get the default options: seed 1, uniform weights in [1, 100]
+ * @param opts Output options
+ */
+void palma_gen_default_options(palma_gen_options_t *opts);
+
+/**
+ * @brief R-MAT (stochastic Kronecker) power-law graph
+ * 
+ * Each of edge_factor · 2^scale edges descends scale levels of the 2 × 2
+ * initiator [a b; c d], choosing a quadrant per level. Vertex labels are
+ * then scrambled by a seeded permutation, so high-degree vertices are not
+ * clustered at low indices. Self-loops are dropped and duplicates combined,
+ * so nnz is somewhat below the edge count.
+ * 
+ * @param scale log2 of the vertex count (1..31)
+ * @param edge_factor Edges generated per vertex
+ * @param a, b, c Quadrant probabilities (d = 1 - a - b - c >= 0)
+ * @param semiring Semiring of the result
+ * @param opts Options, or NULL for defaults
+ * @return 2^scale × 2^scale sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_gen_rmat(unsigned int scale, double edge_factor, double a, double b,
+                               double c, palma_semiring_t semiring,
+                               const palma_gen_options_t *opts);
+
+/**
+ * @brief Road-like 2D grid
+ * 
+ * Vertex r · width + c is joined to its four lattice neighbours by edges
+ * in both directions with equal weights. Each street (undirected lattice
+ * edge) is kept with probability keep, which gives the irregular, low and
+ * nearly constant degree and long diameter of road networks.
+ * 
+ * @param width Columns of the lattice
+ * @param height Rows of the lattice
+ * @param keep Probability that a lattice edge exists (0..1)
+ * @param semiring Semiring of the result
+ * @param opts Options, or NULL for defaults
+ * @return (width · height) square sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_gen_grid(size_t width, size_t height, double keep,
+                               palma_semiring_t semiring, const palma_gen_options_t *opts);
+
+/**
+ * @brief Random DAG shaped like a project plan
+ * 
+ * Task i gets about avg_degree successors drawn from the next window tasks
+ * (i, i + window], so edges always point forward and the critical path
+ * grows with n / window. Suitable for max-plus closures and scheduling.
+ * 
+ * @param n Number of tasks
+ * @param avg_degree Mean successors per task
+ * @param window Successor range (0 = all later tasks)
+ * @param semiring Semiring of the result
+ * @param opts Options, or NULL for defaults
+ * @return n × n sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_gen_dag(size_t n, double avg_degree, size_t window,
+                              palma_semiring_t semiring, const palma_gen_options_t *opts);
+
+/**
+ * @brief Erdős–Rényi G(n, p) graph with p = avg_degree / (n - 1)
+ * 
+ * Every ordered pair i ≠ j is an edge independently with probability p.
+ * Rows are sampled by geometric skipping in O(n + nnz).
+ * 
+ * @param n Number of vertices
+ * @param avg_degree Expected out-degree (0..n-1)
+ * @param semiring Semiring of the result
+ * @param opts Options, or NULL for defaults
+ * @return n × n sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_gen_erdos_renyi(size_t n, double avg_degree, palma_semiring_t semiring,
+                                      const palma_gen_options_t *opts);
+
+/*============================================================================
+ * ALGORITHM SELECTION
+ *
+ * The planner inspects a matrix (density, acyclicity, weight signs,
+ * symmetry) and picks the cheapest engine for closure, single-source paths
+ * or multiplication. Every engine computes the same result; the plan only
+ * changes how. Costs are estimated semiring operations.
+ *
+ * Path conventions follow the closure: entry (i, j) is an edge i → j, and
+ * single-source results are row `source` of A*.
+ *============================================================================*/
+
+/**
+ * @brief Execution engines the planner can choose
+ */
+typedef enum {
+    PALMA_ENGINE_FLOYD_WARSHALL = 0,   /**< Dense Floyd-Warshall, O(n³) */
+    PALMA_ENGINE_DAG_SWEEP = 1,        /**< Topological-order sweep, O(n + nnz) per source */
+    PALMA_ENGINE_DIJKSTRA = 2,         /**< Label-setting with a binary heap, O(nnz log n) per source */
+    PALMA_ENGINE_BELLMAN_FORD = 3,     /**< Sparse label-correcting with early exit, O(n·nnz) */
+    PALMA_ENGINE_DENSE_BELLMAN_FORD = 4, /**< Dense label-correcting with early exit, O(n³) */
+    PALMA_ENGINE_DENSE_GEMM = 5,       /**< Dense multiplication, O(m·k·p) */
+    PALMA_ENGINE_SPARSE_GEMM = 6       /**< CSR multiplication, O(flops + m·p) */
+} palma_engine_t;
+
+/**
+ * @brief Structural properties of a square matrix seen as a graph
+ * 
+ * Diagonal entries that cannot improve a path (d ⊕ e = e) are ignored, so
+ * a zero-latency self-loop does not make a graph cyclic.
+ */
+typedef struct {
+    size_t n;                   /**< Number of nodes (rows) */
+    size_t nnz;                 /**< Number of edges (non-ε entries) */
+    double density;             /**< nnz / n² */
+    bool is_dag;                /**< No cycles */
+    bool nonnegative;           /**< No edge improves a path: w ≥ 0 (min-plus), w ≤ 0 (max-plus); always true for max-min, min-max, Boolean */
+    bool symmetric;             /**< A = Aᵀ */
+    palma_semiring_t semiring;  /**< Semiring the properties refer to */
+} palma_structure_t;
+
+/**
+ * @brief Planner decision
+ */
+typedef struct {
+    palma_engine_t engine;      /**< Selected engine */
+    double cost;                /**< Estimated semiring operations for the selected engine */
+    double dense_cost;          /**< Estimated cost of the dense baseline, for comparison */
+} palma_plan_t;
+
+/**
+ * @brief Analyze a dense square matrix (O(n²))
+ * @param info Output properties
+ * @param A Square matrix
+ * @param semiring Semiring type
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_analyze(palma_structure_t *info, const palma_matrix_t *A,
+                            palma_semiring_t semiring);
+
+/**
+ * @brief Analyze a square sparse matrix (O(n + nnz))
+ * @param info Output properties
+ * @param A Square sparse matrix
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_sparse_analyze(palma_structure_t *info, const palma_sparse_t *A);
+
+/**
+ * @brief Choose an engine for the closure A*
+ */
+palma_error_t palma_plan_closure(palma_plan_t *plan, const palma_structure_t *info);
+
+/**
+ * @brief Choose an engine for single-source paths
+ */
+palma_error_t palma_plan_single_source(palma_plan_t *plan, const palma_structure_t *info);
+
+/**
+ * @brief Choose between dense and sparse multiplication of A (m × k) and B (k × p)
+ * @param plan Output plan
+ * @param m Rows of A
+ * @param k Columns of A / rows of B
+ * @param p Columns of B
+ * @param nnz_a Non-ε entries of A
+ * @param nnz_b Non-ε entries of B
+ * @param dense_inputs Whether the operands are dense (conversion cost is added)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_plan_mul(palma_plan_t *plan, size_t m, size_t k, size_t p,
+                             size_t nnz_a, size_t nnz_b, bool dense_inputs);
+
+/**
+ * @brief Engine name for logs
+ */
+const char* palma_engine_name(palma_engine_t engine);
+
+/**
+ * @brief Closure with automatic engine selection: D = A*
+ * @param D Pre-allocated result (n × n; may be A)
+ * @param A Square matrix
+ * @param semiring Semiring type
+ * @param plan Optional output: the plan that was executed (may be NULL)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_auto_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                      palma_semiring_t semiring, palma_plan_t *plan);
+
+/**
+ * @brief Closure of a sparse matrix with automatic engine selection: D = A*
+ * @param D Pre-allocated dense result (n × n)
+ * @param A Square sparse matrix
+ * @param plan Optional output plan (may be NULL)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_sparse_auto_closure_into(palma_matrix_t *D, const palma_sparse_t *A,
+                                             palma_plan_t *plan);
+
+/**
+ * @brief Single-source paths with automatic engine selection
+ * 
+ * dist[j] = A*[source, j]: the best path weight from source to j
+ * (e at the source, ε if unreachable).
+ * 
+ * @param adj Square adjacency matrix
+ * @param source Source node
+ * @param dist Output vector (length n)
+ * @param semiring Semiring type
+ * @param plan Optional output plan (may be NULL)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_auto_single_source(const palma_matrix_t *adj, size_t source,
+                                       palma_val_t *dist, palma_semiring_t semiring,
+                                       palma_plan_t *plan);
+
+/**
+ * @brief Sparse single-source paths with automatic engine selection
+ * @see palma_auto_single_source()
+ */
+palma_error_t palma_sparse_auto_single_source(const palma_sparse_t *A, size_t source,
+                                              palma_val_t *dist, palma_plan_t *plan);
+
+/**
+ * @brief Multiplication with automatic dense/sparse selection: C = A ⊗ B
+ * @param C Pre-allocated result (m × p)
+ * @param A Left matrix (m × k)
+ * @param B Right matrix (k × p)
+ * @param semiring Semiring type
+ * @param plan Optional output plan (may be NULL)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_auto_mul_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                  const palma_matrix_t *B, palma_semiring_t semiring,
+                                  palma_plan_t *plan);
+
+/*============================================================================
+ * SCHEDULING APPLICATIONS
+ *============================================================================*/
+
+/**
+ * @brief Task scheduling system
+ * 
+ * Models precedence-constrained scheduling:
+ * x(k+1) = A ⊗ x(k) ⊕ b
+ * 
+ * A[i,j] = duration of j if j precedes i
+ * x[i] = completion time of task i
+ * b[i] = external input (ready time)
+ */
+typedef struct {
+    palma_matrix_t *system;     /**< System matrix A */
+    palma_val_t *state;         /**< Current state x */
+    palma_val_t *input;         /**< External input b */
+    size_t n_tasks;             /**< Number of tasks */
+    palma_semiring_t semiring;  /**< Semiring (usually MAXPLUS) */
+    char **task_names;          /**< Optional task names */
+} palma_scheduler_t;
 
 /**
  * @brief Create a scheduler
@@ -842,6 +2062,101 @@ palma_error_t palma_sparse_save_csv(const palma_sparse_t *sp, const char *filena
  */
 palma_sparse_t* palma_sparse_load_csv(const char *filename, palma_semiring_t semiring);
 
+/*
+ * Packed files store matrices compressed and split into chunks of
+ * PALMA_PACK_CHUNK_ROWS rows. Runs of ε and ⊤ cost a few bytes per row,
+ * sparse column indices are gap-coded varints, and values are bit-packed
+ * against a per-block minimum. Chunks are decoded in parallel, and a row
+ * range can be loaded by reading only the chunks that cover it.
+ */
+
+/** Rows per packed chunk */
+#define PALMA_PACK_CHUNK_ROWS 64
+
+/**
+ * @brief Save dense matrix to a packed (compressed) file
+ * @param mat Matrix to save
+ * @param filename Output file path
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_matrix_save_packed(const palma_matrix_t *mat, const char *filename);
+
+/**
+ * @brief Load dense matrix from a packed file
+ * @param filename Input file path
+ * @return Loaded matrix, or NULL on failure (PALMA_ERR_FILE_FORMAT if corrupt,
+ *         PALMA_ERR_OVERFLOW if rows × cols cannot be addressed)
+ */
+palma_matrix_t* palma_matrix_load_packed(const char *filename);
+
+/**
+ * @brief Load rows [first, first + count) of a packed dense matrix
+ * @param filename Input file path
+ * @param first First row
+ * @param count Number of rows
+ * @return count × cols matrix, or NULL on failure (PALMA_ERR_INDEX_BOUNDS
+ *         if the range is empty or exceeds the stored rows)
+ */
+palma_matrix_t* palma_matrix_load_packed_rows(const char *filename, size_t first, size_t count);
+
+/**
+ * @brief Save sparse matrix to a packed (compressed) file
+ * @param sp Sparse matrix to save (columns sorted within each row)
+ * @param filename Output file path
+ * @return PALMA_SUCCESS, PALMA_ERR_SPARSE_FORMAT if a row has unsorted or
+ *         duplicate columns, or another error code
+ */
+palma_error_t palma_sparse_save_packed(const palma_sparse_t *sp, const char *filename);
+
+/**
+ * @brief Load sparse matrix from a packed file
+ * @param filename Input file path
+ * @return Loaded sparse matrix, or NULL on failure (PALMA_ERR_OVERFLOW if it
+ *         needs PALMA_USE_WIDE_ROW_PTR)
+ */
+palma_sparse_t* palma_sparse_load_packed(const char *filename);
+
+/**
+ * @brief Load rows [first, first + count) of a packed sparse matrix
+ * @param filename Input file path
+ * @param first First row
+ * @param count Number of rows
+ * @return count × cols sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_sparse_load_packed_rows(const char *filename, size_t first, size_t count);
+
+/**
+ * @brief Import a Matrix Market coordinate file (.mtx)
+ *
+ * Integer, real (rounded to the nearest integer) and pattern fields are
+ * accepted; pattern entries get the semiring's unit. Symmetric and
+ * skew-symmetric files are expanded to both triangles. Duplicate entries
+ * are combined with ⊕. The file is parsed in parallel chunks and the CSR
+ * arrays are filled directly, without per-entry insertion.
+ *
+ * @param filename Input file path
+ * @param semiring Semiring of the result
+ * @return Sparse matrix, or NULL on failure: PALMA_ERR_FILE_FORMAT for a
+ *         malformed file or an entry count that does not match the header,
+ *         PALMA_ERR_INDEX_BOUNDS for an out-of-range index,
+ *         PALMA_ERR_OVERFLOW for a shape or entry count beyond the index types,
+ *         PALMA_ERR_UNSUPPORTED for array, complex or Hermitian files
+ */
+palma_sparse_t* palma_sparse_load_mtx(const char *filename, palma_semiring_t semiring);
+
+/**
+ * @brief Import a DIMACS shortest-path graph (.gr)
+ *
+ * Reads "p sp n m" and "a u v w" lines (1-based vertices) into an n × n
+ * adjacency matrix; parallel arcs are combined with ⊕. Parsing and errors
+ * are as for palma_sparse_load_mtx.
+ *
+ * @param filename Input file path
+ * @param semiring Semiring of the result (typically PALMA_MINPLUS)
+ * @return Sparse matrix, or NULL on failure
+ */
+palma_sparse_t* palma_sparse_load_dimacs(const char *filename, palma_semiring_t semiring);
+
 /**
  * @brief Export matrix to GraphViz DOT format
  * @param mat Matrix (adjacency matrix)
@@ -853,6 +2168,492 @@ palma_sparse_t* palma_sparse_load_csv(const char *filename, palma_semiring_t sem
 palma_error_t palma_matrix_export_dot(const palma_matrix_t *mat, const char *filename,
                                        palma_semiring_t semiring, const char **node_names);
 
+/*============================================================================
+ * STREAMING I/O
+ *
+ * Writers and readers that move one block of rows, or one batch of edges,
+ * at a time with memory independent of the file size: a closure computed
+ * tile by tile, or an edge list larger than RAM, can be written or read in
+ * a single pass. Files are the same as those of palma_matrix_save_csv,
+ * palma_matrix_save_binary and palma_sparse_save_csv.
+ *
+ * A writer records the first failure and reports it from every later call
+ * and from palma_writer_close, which must always be called.
+ *============================================================================*/
+
+/** Opaque streaming writer */
+typedef struct palma_writer palma_writer_t;
+
+/** Opaque streaming reader */
+typedef struct palma_reader palma_reader_t;
+
+/** Bytes buffered between writes (and read per refill) */
+#define PALMA_STREAM_BUFFER (1u << 20)
+
+/** Edge count for palma_writer_open_edges when it is not known up front */
+#define PALMA_STREAM_UNKNOWN SIZE_MAX
+
+/**
+ * @brief Dense matrix file format
+ */
+typedef enum {
+    PALMA_STREAM_CSV = 0,       /**< As palma_matrix_save_csv */
+    PALMA_STREAM_BINARY = 1     /**< As palma_matrix_save_binary */
+} palma_stream_format_t;
+
+/**
+ * @brief Open a dense matrix file for writing row blocks
+ * @param filename Output file path
+ * @param rows Total number of rows that will be written
+ * @param cols Number of columns
+ * @param semiring Semiring (recorded in the CSV header)
+ * @param format File format
+ * @return Writer, or NULL on failure
+ */
+palma_writer_t* palma_writer_open_matrix(const char *filename, size_t rows, size_t cols,
+                                         palma_semiring_t semiring,
+                                         palma_stream_format_t format);
+
+/**
+ * @brief Append the rows of a block (a matrix or a view)
+ * @param w Writer from palma_writer_open_matrix
+ * @param block Rows to append; block->cols must match the file
+ * @return PALMA_SUCCESS, PALMA_ERR_INDEX_BOUNDS if more rows than declared
+ *         would be written, or an error code
+ */
+palma_error_t palma_writer_write_rows(palma_writer_t *w, const palma_matrix_t *block);
+
+/**
+ * @brief Open a COO edge list for writing
+ * @param filename Output file path
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param nnz Number of edges that will be written, or PALMA_STREAM_UNKNOWN
+ *        to have palma_writer_close fill in the count
+ * @param semiring Semiring (recorded in the header)
+ * @return Writer, or NULL on failure
+ */
+palma_writer_t* palma_writer_open_edges(const char *filename, size_t rows, size_t cols,
+                                        size_t nnz, palma_semiring_t semiring);
+
+/**
+ * @brief Append one edge
+ * @return PALMA_SUCCESS, PALMA_ERR_INDEX_BOUNDS, or an error code
+ */
+palma_error_t palma_writer_write_edge(palma_writer_t *w, size_t row, size_t col, palma_val_t val);
+
+/**
+ * @brief Append every entry of a sparse block
+ * @param w Writer from palma_writer_open_edges
+ * @param sp Block of rows
+ * @param first_row Row of the file that holds the block's row 0
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_writer_write_sparse(palma_writer_t *w, const palma_sparse_t *sp,
+                                        size_t first_row);
+
+/**
+ * @brief Flush, close and free a writer
+ * @return PALMA_SUCCESS, PALMA_ERR_FILE_WRITE if any write failed, or
+ *         PALMA_ERR_INVALID_DIM if fewer rows (or a different number of
+ *         edges) than declared were written
+ */
+palma_error_t palma_writer_close(palma_writer_t *w);
+
+/**
+ * @brief Open a dense matrix file for reading row blocks
+ *
+ * The format (CSV or binary) is detected. A CSV file without the
+ * "# PALMA matrix" header is scanned once to count its rows.
+ *
+ * @param filename Input file path
+ * @return Reader, or NULL on failure
+ */
+palma_reader_t* palma_reader_open_matrix(const char *filename);
+
+/**
+ * @brief Open a COO edge list (as written by palma_sparse_save_csv)
+ * @param filename Input file path
+ * @return Reader, or NULL on failure (PALMA_ERR_FILE_FORMAT for a bad
+ *         header, PALMA_ERR_OVERFLOW if cols exceeds PALMA_IDX_MAX + 1)
+ */
+palma_reader_t* palma_reader_open_edges(const char *filename);
+
+/**
+ * @brief Dimensions declared by the file
+ * @return PALMA_SUCCESS or PALMA_ERR_NULL_PTR
+ */
+palma_error_t palma_reader_shape(const palma_reader_t *r, size_t *rows, size_t *cols);
+
+/**
+ * @brief Edge count declared by an edge list header (0 for matrices)
+ */
+size_t palma_reader_edge_count(const palma_reader_t *r);
+
+/**
+ * @brief Read the next rows into a block
+ * @param r Reader from palma_reader_open_matrix
+ * @param block Destination; fills up to block->rows rows, block->cols must
+ *        match the file
+ * @param n_read Rows read; 0 once every row has been read
+ * @return PALMA_SUCCESS, PALMA_ERR_FILE_FORMAT for a malformed or short
+ *         file, or an error code
+ */
+palma_error_t palma_reader_read_rows(palma_reader_t *r, palma_matrix_t *block, size_t *n_read);
+
+/**
+ * @brief Read up to max edges
+ * @param r Reader from palma_reader_open_edges
+ * @param rows, cols, values Output arrays of at least max elements
+ * @param max Capacity of the arrays
+ * @param n_read Edges read; 0 at end of file
+ * @return PALMA_SUCCESS, PALMA_ERR_FILE_FORMAT for a malformed line,
+ *         PALMA_ERR_INDEX_BOUNDS for an edge outside the declared shape,
+ *         or an error code
+ */
+palma_error_t palma_reader_read_edges(palma_reader_t *r, size_t *rows, palma_idx_t *cols,
+                                      palma_val_t *values, size_t max, size_t *n_read);
+
+/**
+ * @brief Close and free a reader
+ */
+void palma_reader_close(palma_reader_t *r);
+
+/*============================================================================
+ * QUERY SERVICE
+ *
+ * palma_server loads models once, precomputes their closures, completion
+ * times and cycle times, and answers queries over a Unix domain socket.
+ * Every message is a palma_query_header_t followed by a payload in host
+ * byte order (the socket is local):
+ *
+ *   request:  header, then `count` items of 2 (pair ops) or 1 uint32_t
+ *   response: header echoing op and id, `status` set, then `count` values
+ *
+ * Requests on one connection are answered in order, so a client may send
+ * any number of them before reading (pipelining), and each request carries
+ * a whole batch of items.
+ *============================================================================*/
+
+/** First field of every message ("PLMQ") */
+#define PALMA_QUERY_MAGIC    0x514D4C50u
+
+/** Default socket path */
+#define PALMA_QUERY_SOCKET   "/tmp/palma.sock"
+
+/** Largest number of items in one request */
+#define PALMA_QUERY_MAX_ITEMS (1u << 24)
+
+/**
+ * @brief Query operations
+ */
+typedef enum {
+    PALMA_QUERY_INFO = 0,        /**< No items -> [n, semiring] */
+    PALMA_QUERY_DISTANCE = 1,    /**< (from, to) pairs -> A*[from, to] */
+    PALMA_QUERY_REACHABLE = 2,   /**< (from, to) pairs -> 1 if A*[from, to] != ε, else 0 */
+    PALMA_QUERY_COMPLETION = 3,  /**< Task ids -> completion time with all inputs at e */
+    PALMA_QUERY_CYCLE_TIME = 4   /**< No items -> [eigenvalue] */
+} palma_query_op_t;
+
+/**
+ * @brief Message header (20 bytes)
+ */
+typedef struct {
+    uint32_t magic;     /**< PALMA_QUERY_MAGIC */
+    uint16_t op;        /**< palma_query_op_t */
+    int16_t status;     /**< Response: palma_error_t; request: 0 */
+    uint32_t id;        /**< Chosen by the client, echoed in the response */
+    uint32_t model;     /**< Model index, in server command-line order */
+    uint32_t count;     /**< Number of items (request) or values (response) */
+} palma_query_header_t;
+
+/** Query client connection (opaque) */
+typedef struct palma_client palma_client_t;
+
+/**
+ * @brief Connect to a query server
+ * @param path Socket path, or NULL for PALMA_QUERY_SOCKET
+ * @return Connection, or NULL on failure
+ */
+palma_client_t* palma_client_connect(const char *path);
+
+/**
+ * @brief Close a connection (NULL-safe)
+ */
+void palma_client_close(palma_client_t *client);
+
+/**
+ * @brief Send one request without waiting for the answer
+ * @param client Connection
+ * @param op Operation
+ * @param model Model index
+ * @param items Item array (2 × count entries for pair operations)
+ * @param count Number of items
+ * @param id Output: request id to match with palma_client_receive() (optional)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_client_send(palma_client_t *client, palma_query_op_t op, uint32_t model,
+                                const uint32_t *items, size_t count, uint32_t *id);
+
+/**
+ * @brief Receive the next response, in request order
+ * @param client Connection
+ * @param id Output: id of the answered request (optional)
+ * @param values Output values
+ * @param capacity Size of values
+ * @param count Output: number of values in the response
+ * @return The server's status, or a transport error; PALMA_ERR_INVALID_DIM
+ *         if the response did not fit (it is then consumed and dropped)
+ */
+palma_error_t palma_client_receive(palma_client_t *client, uint32_t *id, palma_val_t *values,
+                                   size_t capacity, size_t *count);
+
+/**
+ * @brief Send a request and wait for its response
+ */
+palma_error_t palma_client_query(palma_client_t *client, palma_query_op_t op, uint32_t model,
+                                 const uint32_t *items, size_t count, palma_val_t *values,
+                                 size_t capacity, size_t *n_values);
+
+/*============================================================================
+ * SHARED-MEMORY TABLES
+ *
+ * One producer publishes a dense or sparse matrix (typically a closure) in
+ * a POSIX shared-memory segment; any number of processes attach it
+ * read-only, without copying. A publication named "/routes" consists of
+ *
+ *   "/routes"     control segment: the current version number
+ *   "/routes.N"   data segment for version N: palma_shm_header_t, then data
+ *
+ * Publishing writes a complete new data segment, switches the version with
+ * one atomic store and unlinks the previous segment. Readers never block:
+ * an attached view keeps its mapping (and its version) until it is
+ * detached, even after the segment has been replaced and unlinked.
+ *============================================================================*/
+
+/** First field of every segment ("PLMS") */
+#define PALMA_SHM_MAGIC      0x534D4C50u
+
+/** Layout revision of palma_shm_header_t */
+#define PALMA_SHM_FORMAT     1u
+
+/**
+ * @brief Kind of table stored in a data segment
+ */
+typedef enum {
+    PALMA_SHM_DENSE = 0,     /**< Row-major palma_matrix_t */
+    PALMA_SHM_SPARSE = 1     /**< CSR palma_sparse_t */
+} palma_shm_kind_t;
+
+/**
+ * @brief Data segment header (offsets are in bytes from the segment start)
+ */
+typedef struct {
+    uint32_t magic;          /**< PALMA_SHM_MAGIC */
+    uint32_t format;         /**< PALMA_SHM_FORMAT */
+    uint64_t version;        /**< Publication number, starting at 1 */
+    uint32_t kind;           /**< palma_shm_kind_t */
+    int32_t semiring;        /**< palma_semiring_t */
+    uint16_t val_size;       /**< sizeof(palma_val_t) */
+    uint16_t idx_size;       /**< sizeof(palma_idx_t) */
+    uint16_t ptr_size;       /**< sizeof(palma_ptr_t) */
+    uint16_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t stride;         /**< Dense: row stride in elements */
+    uint64_t nnz;            /**< Sparse: number of entries */
+    uint64_t values_offset;  /**< Dense data or sparse values */
+    uint64_t col_idx_offset; /**< Sparse only */
+    uint64_t row_ptr_offset; /**< Sparse only */
+    uint64_t size;           /**< Total segment size */
+} palma_shm_header_t;
+
+/** Attached, read-only version of a publication (opaque) */
+typedef struct palma_shm_view palma_shm_view_t;
+
+/**
+ * @brief Publish a dense matrix as the next version of a table
+ * 
+ * Creates the control segment on first use. The matrix may be a view.
+ * 
+ * @param name Shared-memory name ("/name", no other '/')
+ * @param A Matrix to publish
+ * @param semiring Semiring recorded with the table
+ * @param version Output: the new version number (optional)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_shm_publish_matrix(const char *name, const palma_matrix_t *A,
+                                       palma_semiring_t semiring, uint64_t *version);
+
+/**
+ * @brief Publish a sparse matrix as the next version of a table
+ * @param name Shared-memory name
+ * @param S Sparse matrix to publish (its semiring is recorded)
+ * @param version Output: the new version number (optional)
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_shm_publish_sparse(const char *name, const palma_sparse_t *S,
+                                       uint64_t *version);
+
+/**
+ * @brief Remove a publication (current data segment and control segment)
+ * 
+ * Views that are still attached stay valid until detached.
+ */
+palma_error_t palma_shm_unlink(const char *name);
+
+/**
+ * @brief Attach the current version of a publication read-only
+ * 
+ * The header is checked against the segment size, and a sparse table is
+ * checked to be a well-formed CSR (O(rows + nnz)) before it is returned.
+ * 
+ * @param name Shared-memory name
+ * @return View, or NULL on failure (PALMA_ERR_FILE_OPEN if nothing is published,
+ *         PALMA_ERR_FILE_FORMAT for a bad header, PALMA_ERR_SPARSE_FORMAT for
+ *         a bad row_ptr or col_idx)
+ */
+palma_shm_view_t* palma_shm_attach(const char *name);
+
+/**
+ * @brief Detach a view and unmap its segment (NULL-safe)
+ */
+void palma_shm_detach(palma_shm_view_t *view);
+
+/**
+ * @brief Check whether a newer version has been published (one atomic load)
+ */
+bool palma_shm_stale(const palma_shm_view_t *view);
+
+/**
+ * @brief Replace *view by the current version if it is stale
+ * 
+ * On failure *view is left attached to its old version.
+ * 
+ * @param view In/out: attached view
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_shm_refresh(palma_shm_view_t **view);
+
+/**
+ * @brief Version number of an attached view
+ */
+uint64_t palma_shm_version(const palma_shm_view_t *view);
+
+/**
+ * @brief Semiring recorded with the table
+ */
+palma_semiring_t palma_shm_semiring(const palma_shm_view_t *view);
+
+/**
+ * @brief Dense table of a view, or NULL if it is sparse
+ * 
+ * The matrix wraps the mapping (no copy, owns_data = false) and is valid
+ * until the view is detached. Its pages are read-only: use it only as an
+ * input.
+ */
+const palma_matrix_t* palma_shm_matrix(const palma_shm_view_t *view);
+
+/**
+ * @brief Sparse table of a view, or NULL if it is dense (same rules as above)
+ */
+const palma_sparse_t* palma_shm_sparse(const palma_shm_view_t *view);
+
+/*============================================================================
+ * PERFORMANCE COUNTERS
+ *============================================================================*/
+
+/**
+ * @brief Hardware events counted by a profiler (Linux perf events)
+ */
+typedef enum {
+    PALMA_COUNTER_CYCLES = 0,       /**< CPU cycles */
+    PALMA_COUNTER_INSTRUCTIONS,     /**< Retired instructions */
+    PALMA_COUNTER_L1D_MISSES,       /**< L1 data cache read misses */
+    PALMA_COUNTER_LLC_MISSES,       /**< Last-level cache misses */
+    PALMA_COUNTER_BRANCH_MISSES,    /**< Mispredicted branches */
+    PALMA_COUNTER_COUNT             /**< Number of counters */
+} palma_counter_t;
+
+/**
+ * @brief Open set of hardware counters (opaque)
+ */
+typedef struct palma_profiler palma_profiler_t;
+
+/**
+ * @brief Counts of one profiled region
+ */
+typedef struct {
+    uint64_t value[PALMA_COUNTER_COUNT];  /**< Event counts, scaled if multiplexed */
+    uint32_t available;                   /**< Bit (1 << counter) set if counted */
+    uint64_t time_ns;                     /**< Wall time of the region */
+    double ops;                           /**< Tropical operations attributed to it */
+} palma_profile_t;
+
+/**
+ * @brief Open the hardware counters for the calling thread
+ * 
+ * Threads the caller creates afterwards are counted too, so create the
+ * profiler before the first parallel kernel to include the OpenMP team.
+ * Only user-space events are counted. Counters the host does not expose
+ * are left out (see palma_profiler_has).
+ * 
+ * @return Profiler, or NULL with PALMA_ERR_UNSUPPORTED if no counter could
+ *         be opened (non-Linux, no PMU access, perf_event_paranoid > 2)
+ */
+palma_profiler_t* palma_profiler_create(void);
+
+/**
+ * @brief Close the counters (NULL-safe)
+ */
+void palma_profiler_destroy(palma_profiler_t *prof);
+
+/**
+ * @brief Check whether a counter was opened
+ */
+bool palma_profiler_has(const palma_profiler_t *prof, palma_counter_t counter);
+
+/**
+ * @brief Reset and start the counters
+ * 
+ * A profiler measures one region at a time and must not be shared between
+ * threads that profile concurrently.
+ * 
+ * @param prof Profiler
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_profile_begin(palma_profiler_t *prof);
+
+/**
+ * @brief Stop the counters and read them
+ * 
+ * @param prof Profiler
+ * @param ops Tropical operations performed in the region (e.g. n³ for an
+ *            n×n multiplication times the number of calls), or 0
+ * @param out Receives counts, wall time and ops
+ * @return PALMA_SUCCESS or error code
+ */
+palma_error_t palma_profile_end(palma_profiler_t *prof, double ops, palma_profile_t *out);
+
+/**
+ * @brief Events per tropical operation
+ * @return value / ops, or -1 if the counter is unavailable or ops is 0
+ */
+double palma_profile_per_op(const palma_profile_t *p, palma_counter_t counter);
+
+/**
+ * @brief Short counter name ("cycles", "l1d-misses", ...)
+ */
+const char* palma_counter_name(palma_counter_t counter);
+
+/**
+ * @brief Print counts, per-operation rates and IPC
+ * @param p Profile to print
+ * @param name Region name (NULL for "profile")
+ * @param fp Output file
+ */
+void palma_profile_print(const palma_profile_t *p, const char *name, FILE *fp);
+
 /*============================================================================
  * NEON-OPTIMIZED OPERATIONS (ARM only)
  *============================================================================*/
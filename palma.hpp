@@ -0,0 +1,757 @@
+/**
+ * @file palma.hpp
+ * @brief PALMA C++17 interface - RAII types and expression templates
+ *
+ * Header-only layer over palma.h. Matrices, sparse matrices and schedulers
+ * own their C object, are movable and never copy implicitly (use clone()).
+ * Errors are reported as palma::Error exceptions instead of NULL returns and
+ * palma_get_last_error().
+ *
+ * The semiring is a template parameter, so mixing semirings is a compile
+ * error, and products and element-wise passes are specialized and inlined
+ * per semiring. Operators build expression templates that are evaluated
+ * into the destination when assigned:
+ *
+ *   palma::Matrix<PALMA_MAXPLUS> D = A * B + C;
+ *
+ * writes A ⊗ B into D with the product kernel of the semiring, then folds C
+ * in with one fused ⊕ pass, with no temporary matrix. Further products of a
+ * sum (D = A * B + C * E, D += A * B) are accumulated into D by
+ * palma_matrix_mul_acc_into. Temporaries are only created for operands of a
+ * product that are themselves expressions, and when the destination is also
+ * an operand. Expressions hold references to their operands and must be
+ * evaluated before those operands are destroyed.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#ifndef PALMA_HPP
+#define PALMA_HPP
+
+#if __cplusplus < 201703L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#error "palma.hpp requires C++17"
+#endif
+
+#include "palma.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace palma {
+
+/*============================================================================
+ * ERRORS
+ *============================================================================*/
+
+/** Exception carrying a palma_error_t */
+class Error : public std::runtime_error {
+public:
+    explicit Error(palma_error_t code)
+        : std::runtime_error(palma_strerror(code)), code_(code) {}
+
+    palma_error_t code() const noexcept { return code_; }
+
+private:
+    palma_error_t code_;
+};
+
+namespace detail {
+
+inline void check(palma_error_t err) {
+    if (err != PALMA_SUCCESS) throw Error(err);
+}
+
+/* NULL from a C constructor: report the last error, or out-of-memory */
+template <class T>
+T* check_ptr(T* p) {
+    if (!p) {
+        palma_error_t err = palma_get_last_error();
+        throw Error(err != PALMA_SUCCESS ? err : PALMA_ERR_OUT_OF_MEMORY);
+    }
+    return p;
+}
+
+/* Same saturation as palma_mul(): -∞ wins, then +∞ */
+constexpr palma_val_t sat_plus(palma_val_t a, palma_val_t b) noexcept {
+    if (a == PALMA_NEG_INF || b == PALMA_NEG_INF) return PALMA_NEG_INF;
+    if (a == PALMA_POS_INF || b == PALMA_POS_INF) return PALMA_POS_INF;
+    const int64_t sum = static_cast<int64_t>(a) + b;
+    if (sum > INT32_MAX) return PALMA_POS_INF;
+    if (sum < INT32_MIN) return PALMA_NEG_INF;
+    return static_cast<palma_val_t>(sum);
+}
+
+} // namespace detail
+
+/*============================================================================
+ * SEMIRINGS
+ *============================================================================*/
+
+/**
+ * @brief Compile-time semiring operations, identical to palma_add()/palma_mul()
+ */
+template <palma_semiring_t S>
+struct Semiring;
+
+template <>
+struct Semiring<PALMA_MAXPLUS> {
+    static constexpr palma_val_t zero = PALMA_NEG_INF;
+    static constexpr palma_val_t one = 0;
+    static constexpr palma_val_t add(palma_val_t a, palma_val_t b) noexcept { return a > b ? a : b; }
+    static constexpr palma_val_t mul(palma_val_t a, palma_val_t b) noexcept { return detail::sat_plus(a, b); }
+};
+
+template <>
+struct Semiring<PALMA_MINPLUS> {
+    static constexpr palma_val_t zero = PALMA_POS_INF;
+    static constexpr palma_val_t one = 0;
+    static constexpr palma_val_t add(palma_val_t a, palma_val_t b) noexcept { return a < b ? a : b; }
+    static constexpr palma_val_t mul(palma_val_t a, palma_val_t b) noexcept { return detail::sat_plus(a, b); }
+};
+
+template <>
+struct Semiring<PALMA_MAXMIN> {
+    static constexpr palma_val_t zero = PALMA_NEG_INF;
+    static constexpr palma_val_t one = PALMA_POS_INF;
+    static constexpr palma_val_t add(palma_val_t a, palma_val_t b) noexcept { return a > b ? a : b; }
+    static constexpr palma_val_t mul(palma_val_t a, palma_val_t b) noexcept { return a < b ? a : b; }
+};
+
+template <>
+struct Semiring<PALMA_MINMAX> {
+    static constexpr palma_val_t zero = PALMA_POS_INF;
+    static constexpr palma_val_t one = PALMA_NEG_INF;
+    static constexpr palma_val_t add(palma_val_t a, palma_val_t b) noexcept { return a < b ? a : b; }
+    static constexpr palma_val_t mul(palma_val_t a, palma_val_t b) noexcept { return a > b ? a : b; }
+};
+
+template <>
+struct Semiring<PALMA_BOOLEAN> {
+    static constexpr palma_val_t zero = 0;
+    static constexpr palma_val_t one = 1;
+    static constexpr palma_val_t add(palma_val_t a, palma_val_t b) noexcept { return (a || b) ? 1 : 0; }
+    static constexpr palma_val_t mul(palma_val_t a, palma_val_t b) noexcept { return (a && b) ? 1 : 0; }
+};
+
+template <palma_semiring_t S>
+class Matrix;
+
+/*============================================================================
+ * EXPRESSION TEMPLATES
+ *
+ * Every node provides rows(), cols(), reads(out) (whether a leaf overlaps
+ * out), eval_into(out) (out = expr) and accumulate_into(out) (out ⊕= expr).
+ * Element-wise subtrees (leaves and sums of leaves) also provide at(i, j)
+ * and are evaluated in one fused, inlined loop.
+ *============================================================================*/
+
+namespace detail {
+
+template <class T>
+struct is_node : std::false_type {};
+
+template <class T>
+inline constexpr bool is_node_v = is_node<std::decay_t<T>>::value;
+
+template <class T>
+struct is_matrix : std::false_type {};
+
+template <palma_semiring_t S>
+struct is_matrix<Matrix<S>> : std::true_type {};
+
+template <class T>
+inline constexpr bool is_operand_v = is_node_v<T> || is_matrix<std::decay_t<T>>::value;
+
+inline bool overlaps(const palma_matrix_t& a, const palma_matrix_t* b) noexcept {
+    const palma_val_t* a_end = a.data + (a.rows - 1) * a.stride + a.cols;
+    const palma_val_t* b_end = b->data + (b->rows - 1) * b->stride + b->cols;
+    return a.data < b_end && b->data < a_end;
+}
+
+/* out = a ⊗ b with the operations of S inlined, in the row-broadcast order of
+ * the accumulating kernels so the inner loop vectorizes; out overlaps neither */
+template <palma_semiring_t S>
+inline void mul(palma_matrix_t* out, const palma_matrix_t& a, const palma_matrix_t& b) {
+    const size_t m = a.rows, n = a.cols, p = b.cols;
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static) if (m * n * p > 100000)
+#endif
+    for (size_t i = 0; i < m; i++) {
+        palma_val_t* c = out->data + i * out->stride;
+        const palma_val_t* a_row = a.data + i * a.stride;
+        for (size_t j = 0; j < p; j++) c[j] = Semiring<S>::zero;
+        for (size_t k = 0; k < n; k++) {
+            const palma_val_t* b_row = b.data + k * b.stride;
+            const palma_val_t a_ik = a_row[k];
+            for (size_t j = 0; j < p; j++) c[j] = Semiring<S>::add(c[j], Semiring<S>::mul(a_ik, b_row[j]));
+        }
+    }
+}
+
+/* out = f(i, j), or out ⊕= f(i, j) */
+template <palma_semiring_t S, bool Acc, class F>
+inline void fill(palma_matrix_t* out, const F& f) {
+    for (size_t i = 0; i < out->rows; i++) {
+        palma_val_t* row = out->data + i * out->stride;
+        for (size_t j = 0; j < out->cols; j++) {
+            if constexpr (Acc) row[j] = Semiring<S>::add(row[j], f(i, j));
+            else row[j] = f(i, j);
+        }
+    }
+}
+
+} // namespace detail
+
+/** Leaf: a matrix (or view) referenced by an expression */
+template <palma_semiring_t S>
+class MatrixRef {
+public:
+    static constexpr palma_semiring_t semiring = S;
+    static constexpr bool elementwise = true;
+
+    explicit MatrixRef(const palma_matrix_t& m) noexcept : m_(m) {}
+
+    size_t rows() const noexcept { return m_.rows; }
+    size_t cols() const noexcept { return m_.cols; }
+    const palma_matrix_t& matrix() const noexcept { return m_; }
+
+    palma_val_t at(size_t i, size_t j) const noexcept { return m_.data[i * m_.stride + j]; }
+    bool reads(const palma_matrix_t* out) const noexcept { return detail::overlaps(m_, out); }
+
+    void eval_into(palma_matrix_t* out) const { detail::check(palma_matrix_copy(out, &m_)); }
+    void accumulate_into(palma_matrix_t* out) const {
+        detail::fill<S, true>(out, [this](size_t i, size_t j) { return at(i, j); });
+    }
+
+private:
+    palma_matrix_t m_;
+};
+
+/** Element-wise sum L ⊕ R */
+template <class L, class R>
+class AddExpr {
+public:
+    static_assert(L::semiring == R::semiring, "operands must use the same semiring");
+    static constexpr palma_semiring_t semiring = L::semiring;
+    static constexpr bool elementwise = L::elementwise && R::elementwise;
+
+    AddExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+        if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) throw Error(PALMA_ERR_INVALID_DIM);
+    }
+
+    size_t rows() const noexcept { return lhs_.rows(); }
+    size_t cols() const noexcept { return lhs_.cols(); }
+
+    palma_val_t at(size_t i, size_t j) const noexcept {
+        return Semiring<semiring>::add(lhs_.at(i, j), rhs_.at(i, j));
+    }
+    bool reads(const palma_matrix_t* out) const noexcept { return lhs_.reads(out) || rhs_.reads(out); }
+
+    void eval_into(palma_matrix_t* out) const {
+        if constexpr (elementwise) {
+            detail::fill<semiring, false>(out, [this](size_t i, size_t j) { return at(i, j); });
+        } else if constexpr (L::elementwise) {
+            /* Write the product side first so the leaves fold into it */
+            rhs_.eval_into(out);
+            lhs_.accumulate_into(out);
+        } else {
+            lhs_.eval_into(out);
+            rhs_.accumulate_into(out);
+        }
+    }
+
+    void accumulate_into(palma_matrix_t* out) const {
+        if constexpr (elementwise) {
+            detail::fill<semiring, true>(out, [this](size_t i, size_t j) { return at(i, j); });
+        } else {
+            lhs_.accumulate_into(out);
+            rhs_.accumulate_into(out);
+        }
+    }
+
+private:
+    L lhs_;
+    R rhs_;
+};
+
+/** Product L ⊗ R: the semiring's inlined kernel, or palma_matrix_mul_acc_into() when accumulated */
+template <class L, class R>
+class MulExpr {
+public:
+    static_assert(L::semiring == R::semiring, "operands must use the same semiring");
+    static constexpr palma_semiring_t semiring = L::semiring;
+    static constexpr bool elementwise = false;
+
+    MulExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+        if (lhs.cols() != rhs.rows()) throw Error(PALMA_ERR_INVALID_DIM);
+    }
+
+    size_t rows() const noexcept { return lhs_.rows(); }
+    size_t cols() const noexcept { return rhs_.cols(); }
+
+    bool reads(const palma_matrix_t* out) const noexcept { return lhs_.reads(out) || rhs_.reads(out); }
+
+    void eval_into(palma_matrix_t* out) const;
+    void accumulate_into(palma_matrix_t* out) const;
+
+private:
+    L lhs_;
+    R rhs_;
+
+    template <class F>
+    void with_operands(const F& f) const;
+};
+
+namespace detail {
+
+template <palma_semiring_t S>
+struct is_node<MatrixRef<S>> : std::true_type {};
+
+template <class L, class R>
+struct is_node<AddExpr<L, R>> : std::true_type {};
+
+template <class L, class R>
+struct is_node<MulExpr<L, R>> : std::true_type {};
+
+/* Matrices enter expressions as leaves */
+template <class E>
+auto as_node(const E& e) {
+    if constexpr (is_node_v<E>) return e;
+    else return e.ref();
+}
+
+} // namespace detail
+
+/*============================================================================
+ * DENSE MATRIX
+ *============================================================================*/
+
+/**
+ * @brief Owning dense matrix over semiring S (move-only)
+ */
+template <palma_semiring_t S = PALMA_MAXPLUS>
+class Matrix {
+public:
+    static constexpr palma_semiring_t semiring = S;
+    using ops = Semiring<S>;
+
+    /** Empty matrix (no storage) */
+    Matrix() noexcept = default;
+
+    /** rows × cols filled with ε */
+    Matrix(size_t rows, size_t cols)
+        : m_(detail::check_ptr(palma_matrix_create_zero(rows, cols, S))) {}
+
+    /** Row-by-row initializer, e.g. {{0, 3}, {2, ε}} */
+    Matrix(std::initializer_list<std::initializer_list<palma_val_t>> init)
+        : Matrix(init.size(), init.size() ? init.begin()->size() : 0) {
+        size_t i = 0;
+        for (const auto& row : init) {
+            if (row.size() != cols()) throw Error(PALMA_ERR_INVALID_DIM);
+            size_t j = 0;
+            for (palma_val_t v : row) (*this)(i, j++) = v;
+            i++;
+        }
+    }
+
+    /** Evaluate an expression into a new matrix */
+    template <class E, std::enable_if_t<detail::is_node_v<E>, int> = 0>
+    Matrix(const E& e) : Matrix(uninitialized(e.rows(), e.cols())) {
+        static_assert(E::semiring == S, "expression uses a different semiring");
+        e.eval_into(m_);
+    }
+
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
+    Matrix(Matrix&& other) noexcept : m_(std::exchange(other.m_, nullptr)) {}
+
+    Matrix& operator=(Matrix&& other) noexcept {
+        if (this != &other) {
+            palma_matrix_destroy(m_);
+            m_ = std::exchange(other.m_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Matrix() { palma_matrix_destroy(m_); }
+
+    /** Identity matrix (e on the diagonal, ε elsewhere) */
+    static Matrix identity(size_t n) {
+        return adopt(detail::check_ptr(palma_matrix_create_identity(n, S)));
+    }
+
+    /** Take ownership of a matrix from the C API */
+    static Matrix adopt(palma_matrix_t* m) noexcept {
+        Matrix r;
+        r.m_ = m;
+        return r;
+    }
+
+    /** Explicit deep copy */
+    Matrix clone() const {
+        return adopt(detail::check_ptr(palma_matrix_clone(c_ptr())));
+    }
+
+    /** Give up ownership; the caller must palma_matrix_destroy() the result */
+    palma_matrix_t* release() noexcept { return std::exchange(m_, nullptr); }
+
+    palma_matrix_t* get() noexcept { return m_; }
+    const palma_matrix_t* get() const noexcept { return m_; }
+
+    bool empty() const noexcept { return m_ == nullptr; }
+    size_t rows() const noexcept { return m_ ? m_->rows : 0; }
+    size_t cols() const noexcept { return m_ ? m_->cols : 0; }
+
+    palma_val_t& operator()(size_t i, size_t j) noexcept { return m_->data[i * m_->stride + j]; }
+    palma_val_t operator()(size_t i, size_t j) const noexcept { return m_->data[i * m_->stride + j]; }
+
+    /** Assign an expression, reusing storage when the shape matches */
+    template <class E, std::enable_if_t<detail::is_node_v<E>, int> = 0>
+    Matrix& operator=(const E& e) {
+        static_assert(E::semiring == S, "expression uses a different semiring");
+        if (!m_ || rows() != e.rows() || cols() != e.cols() || e.reads(m_)) {
+            *this = Matrix(e);
+        } else {
+            e.eval_into(m_);
+        }
+        return *this;
+    }
+
+    /** this ⊕= expression */
+    template <class E, std::enable_if_t<detail::is_operand_v<E>, int> = 0>
+    Matrix& operator+=(const E& e) {
+        auto node = detail::as_node(e);
+        static_assert(decltype(node)::semiring == S, "expression uses a different semiring");
+        if (node.rows() != rows() || node.cols() != cols()) throw Error(PALMA_ERR_INVALID_DIM);
+        if (node.reads(m_)) {
+            Matrix t(node);
+            MatrixRef<S>(*t.m_).accumulate_into(m_);
+        } else {
+            node.accumulate_into(m_);
+        }
+        return *this;
+    }
+
+    /** y = A ⊗ x */
+    std::vector<palma_val_t> apply(const std::vector<palma_val_t>& x) const {
+        if (x.size() != cols()) throw Error(PALMA_ERR_INVALID_DIM);
+        std::vector<palma_val_t> y(rows());
+        detail::check(palma_matvec(c_ptr(), x.data(), y.data(), S));
+        return y;
+    }
+
+    /** A^n */
+    Matrix power(unsigned int n) const {
+        Matrix r = uninitialized(rows(), cols());
+        detail::check(palma_matrix_power_into(r.m_, c_ptr(), n, S, nullptr));
+        return r;
+    }
+
+    /** A* = I ⊕ A ⊕ A² ⊕ ... */
+    Matrix closure() const {
+        Matrix r = uninitialized(rows(), cols());
+        closure_into(r);
+        return r;
+    }
+
+    /** D = A* into an existing matrix of the same shape (D may be *this) */
+    void closure_into(Matrix& D) const {
+        detail::check(palma_matrix_closure_into(D.c_ptr(), c_ptr(), S));
+    }
+
+    /** A+ = A ⊕ A² ⊕ ... */
+    Matrix transitive_closure() const {
+        Matrix r = uninitialized(rows(), cols());
+        transitive_closure_into(r);
+        return r;
+    }
+
+    void transitive_closure_into(Matrix& D) const {
+        detail::check(palma_matrix_transitive_closure_into(D.c_ptr(), c_ptr(), S));
+    }
+
+    /** Tropical eigenvalue (maximum cycle mean) */
+    palma_val_t eigenvalue() const {
+        palma_clear_error();
+        palma_val_t lambda = palma_eigenvalue(c_ptr(), S);
+        detail::check(palma_get_last_error());
+        return lambda;
+    }
+
+    /** Leaf node for use in expressions */
+    MatrixRef<S> ref() const { return MatrixRef<S>(*c_ptr()); }
+
+private:
+    palma_matrix_t* m_ = nullptr;
+
+    /* Storage without the ε fill, for outputs that are written completely */
+    static Matrix uninitialized(size_t rows, size_t cols) {
+        return adopt(detail::check_ptr(palma_matrix_create(rows, cols)));
+    }
+
+    palma_matrix_t* c_ptr() const {
+        if (!m_) throw Error(PALMA_ERR_NULL_PTR);
+        return m_;
+    }
+};
+
+using MaxPlusMatrix = Matrix<PALMA_MAXPLUS>;
+using MinPlusMatrix = Matrix<PALMA_MINPLUS>;
+using MaxMinMatrix = Matrix<PALMA_MAXMIN>;
+using MinMaxMatrix = Matrix<PALMA_MINMAX>;
+using BoolMatrix = Matrix<PALMA_BOOLEAN>;
+
+/*============================================================================
+ * OPERATORS
+ *============================================================================*/
+
+/** Deferred product a ⊗ b */
+template <class L, class R,
+          std::enable_if_t<detail::is_operand_v<L> && detail::is_operand_v<R>, int> = 0>
+auto operator*(const L& lhs, const R& rhs) {
+    using LN = decltype(detail::as_node(lhs));
+    using RN = decltype(detail::as_node(rhs));
+    return MulExpr<LN, RN>(detail::as_node(lhs), detail::as_node(rhs));
+}
+
+/** Deferred element-wise sum a ⊕ b */
+template <class L, class R,
+          std::enable_if_t<detail::is_operand_v<L> && detail::is_operand_v<R>, int> = 0>
+auto operator+(const L& lhs, const R& rhs) {
+    using LN = decltype(detail::as_node(lhs));
+    using RN = decltype(detail::as_node(rhs));
+    return AddExpr<LN, RN>(detail::as_node(lhs), detail::as_node(rhs));
+}
+
+template <class L, class R>
+template <class F>
+void MulExpr<L, R>::with_operands(const F& f) const {
+    /* Leaves are passed straight to the kernel; composite operands are materialized */
+    Matrix<semiring> lt, rt;
+    const palma_matrix_t* a;
+    const palma_matrix_t* b;
+
+    if constexpr (std::is_same_v<L, MatrixRef<semiring>>) {
+        a = &lhs_.matrix();
+    } else {
+        lt = Matrix<semiring>(lhs_);
+        a = lt.get();
+    }
+    if constexpr (std::is_same_v<R, MatrixRef<semiring>>) {
+        b = &rhs_.matrix();
+    } else {
+        rt = Matrix<semiring>(rhs_);
+        b = rt.get();
+    }
+
+    f(a, b);
+}
+
+template <class L, class R>
+void MulExpr<L, R>::eval_into(palma_matrix_t* out) const {
+    with_operands([out](const palma_matrix_t* a, const palma_matrix_t* b) {
+        detail::mul<semiring>(out, *a, *b);
+    });
+}
+
+template <class L, class R>
+void MulExpr<L, R>::accumulate_into(palma_matrix_t* out) const {
+    /* out ⊕= a ⊗ b directly: the product itself is never stored */
+    with_operands([out](const palma_matrix_t* a, const palma_matrix_t* b) {
+        detail::check(palma_matrix_mul_acc_into(out, a, b, semiring));
+    });
+}
+
+/*============================================================================
+ * SPARSE MATRIX
+ *============================================================================*/
+
+/**
+ * @brief Owning CSR matrix over semiring S (move-only)
+ */
+template <palma_semiring_t S = PALMA_MAXPLUS>
+class SparseMatrix {
+public:
+    static constexpr palma_semiring_t semiring = S;
+
+    SparseMatrix() noexcept = default;
+
+    /** Empty rows × cols matrix with room for capacity entries */
+    SparseMatrix(size_t rows, size_t cols, size_t capacity = 16)
+        : sp_(detail::check_ptr(palma_sparse_create(rows, cols, capacity, S))) {}
+
+    /** Sparse copy of a dense matrix (ε entries dropped) */
+    explicit SparseMatrix(const Matrix<S>& dense)
+        : sp_(detail::check_ptr(palma_sparse_from_dense(dense.get(), S))) {}
+
+    SparseMatrix(const SparseMatrix&) = delete;
+    SparseMatrix& operator=(const SparseMatrix&) = delete;
+
+    SparseMatrix(SparseMatrix&& other) noexcept : sp_(std::exchange(other.sp_, nullptr)) {}
+
+    SparseMatrix& operator=(SparseMatrix&& other) noexcept {
+        if (this != &other) {
+            palma_sparse_destroy(sp_);
+            sp_ = std::exchange(other.sp_, nullptr);
+        }
+        return *this;
+    }
+
+    ~SparseMatrix() { palma_sparse_destroy(sp_); }
+
+    /** Take ownership of a sparse matrix from the C API (semiring must be S) */
+    static SparseMatrix adopt(palma_sparse_t* sp) {
+        if (sp && sp->semiring != S) throw Error(PALMA_ERR_INVALID_ARG);
+        SparseMatrix r;
+        r.sp_ = sp;
+        return r;
+    }
+
+    SparseMatrix clone() const { return adopt(detail::check_ptr(palma_sparse_clone(c_ptr()))); }
+    Matrix<S> to_dense() const { return Matrix<S>::adopt(detail::check_ptr(palma_sparse_to_dense(c_ptr()))); }
+
+    palma_sparse_t* release() noexcept { return std::exchange(sp_, nullptr); }
+    palma_sparse_t* get() noexcept { return sp_; }
+    const palma_sparse_t* get() const noexcept { return sp_; }
+
+    bool empty() const noexcept { return sp_ == nullptr; }
+    size_t rows() const noexcept { return sp_ ? sp_->rows : 0; }
+    size_t cols() const noexcept { return sp_ ? sp_->cols : 0; }
+    size_t nnz() const noexcept { return sp_ ? sp_->nnz : 0; }
+
+    palma_val_t at(size_t i, size_t j) const { return palma_sparse_get(c_ptr(), i, j); }
+    void set(size_t i, size_t j, palma_val_t v) { detail::check(palma_sparse_set(c_ptr(), i, j, v)); }
+    void compress() { detail::check(palma_sparse_compress(c_ptr())); }
+
+    /** y = A ⊗ x */
+    std::vector<palma_val_t> apply(const std::vector<palma_val_t>& x) const {
+        if (x.size() != cols()) throw Error(PALMA_ERR_INVALID_DIM);
+        std::vector<palma_val_t> y(rows());
+        detail::check(palma_sparse_matvec(c_ptr(), x.data(), y.data()));
+        return y;
+    }
+
+    /** C = A ⊗ B into an existing matrix, reusing its capacity */
+    static void multiply_into(SparseMatrix& C, const SparseMatrix& A, const SparseMatrix& B) {
+        detail::check(palma_sparse_mul_into(C.c_ptr(), A.c_ptr(), B.c_ptr()));
+    }
+
+    friend SparseMatrix operator*(const SparseMatrix& A, const SparseMatrix& B) {
+        return adopt(detail::check_ptr(palma_sparse_mul(A.c_ptr(), B.c_ptr())));
+    }
+
+    SparseMatrix closure() const { return adopt(detail::check_ptr(palma_sparse_closure(c_ptr()))); }
+
+    void closure_into(SparseMatrix& C) const {
+        detail::check(palma_sparse_closure_into(C.c_ptr(), c_ptr()));
+    }
+
+private:
+    palma_sparse_t* sp_ = nullptr;
+
+    palma_sparse_t* c_ptr() const {
+        if (!sp_) throw Error(PALMA_ERR_NULL_PTR);
+        return sp_;
+    }
+};
+
+/*============================================================================
+ * SCHEDULER
+ *============================================================================*/
+
+/**
+ * @brief Owning precedence-constrained scheduler (move-only)
+ */
+class Scheduler {
+public:
+    /** n_tasks tasks; latest times with max-plus, earliest with min-plus */
+    explicit Scheduler(size_t n_tasks, bool use_maxplus = true)
+        : s_(detail::check_ptr(palma_scheduler_create(n_tasks, use_maxplus))) {}
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    Scheduler(Scheduler&& other) noexcept : s_(std::exchange(other.s_, nullptr)) {}
+
+    Scheduler& operator=(Scheduler&& other) noexcept {
+        if (this != &other) {
+            palma_scheduler_destroy(s_);
+            s_ = std::exchange(other.s_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Scheduler() { palma_scheduler_destroy(s_); }
+
+    palma_scheduler_t* get() noexcept { return s_; }
+    const palma_scheduler_t* get() const noexcept { return s_; }
+    size_t size() const noexcept { return s_ ? s_->n_tasks : 0; }
+
+    Scheduler& set_name(size_t task, const std::string& name) {
+        detail::check(palma_scheduler_set_name(c_ptr(), task, name.c_str()));
+        return *this;
+    }
+
+    /** 'from' (taking duration) must complete before 'to' starts */
+    Scheduler& add_constraint(size_t from, size_t to, palma_val_t duration) {
+        detail::check(palma_scheduler_add_constraint(c_ptr(), from, to, duration));
+        return *this;
+    }
+
+    Scheduler& set_ready_time(size_t task, palma_val_t ready_time) {
+        detail::check(palma_scheduler_set_ready_time(c_ptr(), task, ready_time));
+        return *this;
+    }
+
+    /** Returns the number of iterations used */
+    int solve(unsigned int max_iter = 0) {
+        int iters = palma_scheduler_solve(c_ptr(), max_iter);
+        if (iters < 0) detail::check(static_cast<palma_error_t>(iters));
+        return iters;
+    }
+
+    palma_val_t completion(size_t task) const { return palma_scheduler_get_completion(c_ptr(), task); }
+    palma_val_t cycle_time() const { return palma_scheduler_cycle_time(c_ptr()); }
+    double throughput() const { return palma_scheduler_throughput(c_ptr()); }
+
+    std::vector<size_t> critical_path() const {
+        std::vector<size_t> path(size());
+        int len = palma_scheduler_critical_path(c_ptr(), path.data(), path.size());
+        if (len < 0) detail::check(palma_get_last_error());
+        path.resize(len < 0 ? 0 : static_cast<size_t>(len));
+        return path;
+    }
+
+private:
+    palma_scheduler_t* s_ = nullptr;
+
+    palma_scheduler_t* c_ptr() const {
+        if (!s_) throw Error(PALMA_ERR_NULL_PTR);
+        return s_;
+    }
+};
+
+} // namespace palma
+
+#endif /* PALMA_HPP */
@@ -0,0 +1,378 @@
+/**
+ * @file palma_batch.c
+ * @brief PALMA Batched Kernels - many independent small matrices at once
+ *
+ * Matrices in a batch are stored interleaved (structure-of-arrays): the same
+ * element of consecutive matrices is contiguous, so the innermost loop of
+ * every kernel runs across matrices and maps onto full SIMD width even for
+ * 4×4 problems. The batch is processed in chunks of PALMA_BATCH_LANES
+ * matrices; chunks are independent and distributed over OpenMP threads.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/* Chunk buffers are cache-line aligned */
+#define BATCH_ALIGN 64
+
+/*============================================================================
+ * CHUNK KERNELS
+ *
+ * One instance per semiring so ⊕/⊗ are fixed at compile time. Pointers are
+ * already offset to the first matrix of the chunk; w is the chunk width.
+ *============================================================================*/
+
+#define BATCH_KERNELS(NAME, ADD, MUL)                                           \
+static void batch_mul_##NAME(palma_val_t *C, size_t lc,                         \
+                             const palma_val_t *A, size_t la,                   \
+                             const palma_val_t *B, size_t lb,                   \
+                             size_t m, size_t n, size_t p, size_t w,            \
+                             palma_val_t zero) {                                \
+    palma_val_t acc[PALMA_BATCH_LANES];                                         \
+    for (size_t i = 0; i < m; i++) {                                            \
+        for (size_t j = 0; j < p; j++) {                                        \
+            for (size_t l = 0; l < w; l++) acc[l] = zero;                       \
+            for (size_t k = 0; k < n; k++) {                                    \
+                const palma_val_t *a = &A[(i * n + k) * la];                    \
+                const palma_val_t *b = &B[(k * p + j) * lb];                    \
+                for (size_t l = 0; l < w; l++) {                                \
+                    acc[l] = ADD(acc[l], MUL(a[l], b[l]));                      \
+                }                                                               \
+            }                                                                   \
+            memcpy(&C[(i * p + j) * lc], acc, w * sizeof(palma_val_t));         \
+        }                                                                       \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static void batch_closure_##NAME(palma_val_t *D, size_t ld, size_t n,           \
+                                 size_t w) {                                    \
+    for (size_t k = 0; k < n; k++) {                                            \
+        for (size_t i = 0; i < n; i++) {                                        \
+            const palma_val_t *d_ik = &D[(i * n + k) * ld];                     \
+            for (size_t j = 0; j < n; j++) {                                    \
+                palma_val_t *d_ij = &D[(i * n + j) * ld];                       \
+                const palma_val_t *d_kj = &D[(k * n + j) * ld];                 \
+                for (size_t l = 0; l < w; l++) {                                \
+                    d_ij[l] = ADD(d_ij[l], MUL(d_ik[l], d_kj[l]));              \
+                }                                                               \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static void batch_karp_##NAME(palma_val_t *D, const palma_val_t *A, size_t la,  \
+                              size_t n, size_t w, palma_val_t zero) {           \
+    palma_val_t best[PALMA_BATCH_LANES];                                        \
+    for (size_t k = 1; k <= n; k++) {                                           \
+        for (size_t v = 0; v < n; v++) {                                        \
+            for (size_t l = 0; l < w; l++) best[l] = zero;                      \
+            for (size_t u = 0; u < n; u++) {                                    \
+                const palma_val_t *e = &A[(u * n + v) * la];                    \
+                const palma_val_t *d = &D[((k - 1) * n + u) * PALMA_BATCH_LANES];\
+                for (size_t l = 0; l < w; l++) {                                \
+                    palma_val_t path = MUL(d[l], e[l]);                         \
+                    path = (e[l] == zero || d[l] == zero) ? zero : path;        \
+                    best[l] = ADD(best[l], path);                               \
+                }                                                               \
+            }                                                                   \
+            memcpy(&D[(k * n + v) * PALMA_BATCH_LANES], best,                   \
+                   w * sizeof(palma_val_t));                                    \
+        }                                                                       \
+    }                                                                           \
+}
+
+BATCH_KERNELS(maxplus, palma_op_max, palma_op_plus)
+BATCH_KERNELS(minplus, palma_op_min, palma_op_plus)
+BATCH_KERNELS(maxmin,  palma_op_max, palma_op_min)
+BATCH_KERNELS(minmax,  palma_op_min, palma_op_max)
+BATCH_KERNELS(boolean, palma_op_or,  palma_op_and)
+
+typedef struct {
+    void (*mul)(palma_val_t*, size_t, const palma_val_t*, size_t, const palma_val_t*, size_t,
+                size_t, size_t, size_t, size_t, palma_val_t);
+    void (*closure)(palma_val_t*, size_t, size_t, size_t);
+    void (*karp)(palma_val_t*, const palma_val_t*, size_t, size_t, size_t, palma_val_t);
+} batch_kernels_t;
+
+static const batch_kernels_t batch_kernels[] = {
+    { batch_mul_maxplus, batch_closure_maxplus, batch_karp_maxplus },
+    { batch_mul_minplus, batch_closure_minplus, batch_karp_minplus },
+    { batch_mul_maxmin,  batch_closure_maxmin,  batch_karp_maxmin  },
+    { batch_mul_minmax,  batch_closure_minmax,  batch_karp_minmax  },
+    { batch_mul_boolean, batch_closure_boolean, batch_karp_boolean }
+};
+
+static const batch_kernels_t* batch_kernels_for(palma_semiring_t semiring) {
+    if ((unsigned)semiring >= sizeof(batch_kernels) / sizeof(batch_kernels[0])) return NULL;
+    return &batch_kernels[semiring];
+}
+
+/*============================================================================
+ * BATCH LIFECYCLE
+ *============================================================================*/
+
+palma_batch_t* palma_batch_create(size_t rows, size_t cols, size_t count) {
+    if (rows == 0 || cols == 0 || count == 0) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    }
+
+    palma_batch_t *batch = (palma_batch_t*)malloc(sizeof(palma_batch_t));
+    if (!batch) {
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    batch->rows = rows;
+    batch->cols = cols;
+    batch->count = count;
+    batch->lanes = (count + PALMA_BATCH_LANES - 1) / PALMA_BATCH_LANES * PALMA_BATCH_LANES;
+    batch->owns_data = true;
+
+    /* Padding lanes are zeroed so kernels never read uninitialized memory */
+    size_t data_size = rows * cols * batch->lanes * sizeof(palma_val_t);
+    batch->data = (palma_val_t*)palma_aligned_alloc(BATCH_ALIGN, data_size);
+    if (!batch->data) {
+        free(batch);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+    memset(batch->data, 0, data_size);
+
+    palma_clear_error();
+    return batch;
+}
+
+palma_batch_t* palma_batch_wrap(palma_val_t *data, size_t rows, size_t cols,
+                                size_t count, size_t lanes) {
+    if (!data || rows == 0 || cols == 0 || count == 0 || lanes < count) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    }
+
+    palma_batch_t *batch = (palma_batch_t*)malloc(sizeof(palma_batch_t));
+    if (!batch) {
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    batch->data = data;
+    batch->rows = rows;
+    batch->cols = cols;
+    batch->count = count;
+    batch->lanes = lanes;
+    batch->owns_data = false;
+
+    palma_clear_error();
+    return batch;
+}
+
+void palma_batch_destroy(palma_batch_t *batch) {
+    if (!batch) return;
+    if (batch->owns_data && batch->data) {
+        free(batch->data);
+    }
+    free(batch);
+}
+
+palma_error_t palma_batch_set_matrix(palma_batch_t *batch, size_t index,
+                                      const palma_matrix_t *mat) {
+    if (!batch || !mat) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (index >= batch->count) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    if (mat->rows != batch->rows || mat->cols != batch->cols) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+
+    for (size_t i = 0; i < mat->rows; i++) {
+        for (size_t j = 0; j < mat->cols; j++) {
+            palma_batch_set(batch, index, i, j, palma_matrix_get(mat, i, j));
+        }
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_batch_get_matrix(const palma_batch_t *batch, size_t index,
+                                      palma_matrix_t *mat) {
+    if (!batch || !mat) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (index >= batch->count) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    if (mat->rows != batch->rows || mat->cols != batch->cols) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+
+    for (size_t i = 0; i < mat->rows; i++) {
+        for (size_t j = 0; j < mat->cols; j++) {
+            palma_matrix_set(mat, i, j, palma_batch_get(batch, index, i, j));
+        }
+    }
+
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * BATCH OPERATIONS
+ *============================================================================*/
+
+palma_error_t palma_batch_mul_into(palma_batch_t *C, const palma_batch_t *A,
+                                    const palma_batch_t *B, palma_semiring_t semiring) {
+    if (!C || !A || !B) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->cols != B->rows || C->rows != A->rows || C->cols != B->cols) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+    if (A->count != B->count || C->count != A->count) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (C == A || C == B) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    const batch_kernels_t *kern = batch_kernels_for(semiring);
+    if (!kern) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    palma_val_t zero = palma_zero(semiring);
+    size_t count = A->count;
+    size_t nchunks = (count + PALMA_BATCH_LANES - 1) / PALMA_BATCH_LANES;
+
+#if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static) if(nchunks > 1)
+#endif
+    for (size_t c = 0; c < nchunks; c++) {
+        size_t base = c * PALMA_BATCH_LANES;
+        size_t w = (count - base < PALMA_BATCH_LANES) ? count - base : PALMA_BATCH_LANES;
+        kern->mul(&C->data[base], C->lanes, &A->data[base], A->lanes, &B->data[base], B->lanes,
+                  A->rows, A->cols, B->cols, w, zero);
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_batch_closure_into(palma_batch_t *D, const palma_batch_t *A,
+                                        palma_semiring_t semiring) {
+    if (!D || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (D->rows != A->rows || D->cols != A->cols || D->count != A->count) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+
+    const batch_kernels_t *kern = batch_kernels_for(semiring);
+    if (!kern) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    size_t n = A->rows;
+    size_t count = A->count;
+    size_t nchunks = (count + PALMA_BATCH_LANES - 1) / PALMA_BATCH_LANES;
+    palma_val_t one = palma_one(semiring);
+
+#if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static) if(nchunks > 1)
+#endif
+    for (size_t c = 0; c < nchunks; c++) {
+        size_t base = c * PALMA_BATCH_LANES;
+        size_t w = (count - base < PALMA_BATCH_LANES) ? count - base : PALMA_BATCH_LANES;
+        palma_val_t *d = &D->data[base];
+
+        /* D = A ⊕ I (D may alias A) */
+        if (D != A) {
+            for (size_t e = 0; e < n * n; e++) {
+                memcpy(&d[e * D->lanes], &A->data[e * A->lanes + base], w * sizeof(palma_val_t));
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            palma_val_t *d_ii = &d[(i * n + i) * D->lanes];
+            for (size_t l = 0; l < w; l++) {
+                d_ii[l] = palma_add(d_ii[l], one, semiring);
+            }
+        }
+
+        kern->closure(d, D->lanes, n, w);
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_batch_eigenvalue(const palma_batch_t *A, palma_val_t *lambda,
+                                      palma_semiring_t semiring) {
+    if (!A || !lambda) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+
+    const batch_kernels_t *kern = batch_kernels_for(semiring);
+    if (!kern) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    size_t n = A->rows;
+    size_t count = A->count;
+    size_t nchunks = (count + PALMA_BATCH_LANES - 1) / PALMA_BATCH_LANES;
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
+    bool additive = (semiring == PALMA_MAXPLUS || semiring == PALMA_MINPLUS);
+    palma_error_t err = PALMA_SUCCESS;
+
+    /* Karp table D[k][v][lane], one per thread and reused across chunks */
+    size_t ws_size = (n + 1) * n * PALMA_BATCH_LANES * sizeof(palma_val_t);
+
+#if PALMA_USE_OPENMP
+    #pragma omp parallel if(nchunks > 1)
+#endif
+    {
+        palma_val_t *D = (palma_val_t*)palma_aligned_alloc(BATCH_ALIGN, ws_size);
+        if (!D) {
+#if PALMA_USE_OPENMP
+            #pragma omp critical(palma_batch_err)
+#endif
+            err = PALMA_ERR_OUT_OF_MEMORY;
+        }
+
+#if PALMA_USE_OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (size_t c = 0; c < nchunks; c++) {
+            if (!D) continue;
+            size_t base = c * PALMA_BATCH_LANES;
+            size_t w = (count - base < PALMA_BATCH_LANES) ? count - base : PALMA_BATCH_LANES;
+
+            for (size_t e = 0; e < n * PALMA_BATCH_LANES; e++) D[e] = one;
+            kern->karp(D, &A->data[base], A->lanes, n, w, zero);
+
+            /* λ = max_v min_k (D[n][v] - D[k][v]) / (n - k), as palma_eigenvalue() */
+            for (size_t l = 0; l < w; l++) {
+                palma_val_t max_mean = PALMA_NEG_INF;
+                for (size_t v = 0; v < n; v++) {
+                    palma_val_t d_n = D[(n * n + v) * PALMA_BATCH_LANES + l];
+                    if (d_n == zero) continue;
+
+                    palma_val_t min_for_v = PALMA_POS_INF;
+                    for (size_t k = 0; k < n; k++) {
+                        palma_val_t d_k = D[(k * n + v) * PALMA_BATCH_LANES + l];
+                        if (d_k == zero) continue;
+                        int64_t diff = additive ? (int64_t)d_n - (int64_t)d_k : 0;
+                        palma_val_t mean = (palma_val_t)(diff / (int64_t)(n - k));
+                        if (mean < min_for_v) min_for_v = mean;
+                    }
+
+                    if (min_for_v != PALMA_POS_INF && min_for_v > max_mean) {
+                        max_mean = min_for_v;
+                    }
+                }
+                lambda[base + l] = max_mean;
+            }
+        }
+
+        free(D);
+    }
+
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    palma_clear_error();
+    return PALMA_SUCCESS;
+}
@@ -0,0 +1,2050 @@
+/**
+ * @file palma_bench.c
+ * @brief PALMA Benchmark Driver - repeatable kernel timings and regression gating
+ *
+ * Every kernel runs on inputs generated from a fixed seed, is warmed up,
+ * and is then timed in repetitions until the 95% confidence interval of
+ * the mean is within a target fraction of it (or a time budget runs out).
+ * Each repetition times a batch of calls long enough to make clock
+ * resolution negligible; median, mean, standard deviation and the
+ * confidence intervals come from these batches. p95 and p99 come from a
+ * second pass over as many calls, each timed on its own, so they describe
+ * single calls (clock reads included) rather than batch means. Results are
+ * printed as a table, JSON or CSV.
+ *
+ * With --compare, the run is checked against a JSON baseline written by an
+ * earlier run: a kernel regresses when its median is slower by more than
+ * the threshold and the 95% intervals of the two medians (taken from order
+ * statistics, so no distribution is assumed) do not overlap. The exit
+ * status is 1 if anything regressed, so the driver can gate CI.
+ *
+ * With --counters, each case is followed by a counted run that reports
+ * cycles, IPC, L1D and last-level cache misses and branch misses per
+ * semiring operation (per call for kernels without an operation count).
+ *
+ * With --scaling, GEMM, matvec, closure and SpMV are timed at every thread
+ * count and reported as speedup, parallel efficiency, bandwidth and Gops/s
+ * against a roofline probed on the host (default sizes 128 and 512).
+ *
+ * With --latency, the real-time paths (scheduler solve, matvec, closure of
+ * a small DAG) are timed call by call into a histogram and reported from
+ * p50 to p99.999 and max, with the heap allocations, page faults and
+ * context switches seen while recording (default sizes 8, 16 and 32).
+ *
+ * Usage:
+ *   palma_bench [options]
+ *     -f, --filter SUBSTR     only kernels whose name contains SUBSTR
+ *     -n, --sizes N,N,...     problem sizes (default 16,64,256)
+ *     -s, --semiring NAME     maxplus (default), minplus, maxmin, minmax,
+ *                             boolean or all
+ *         --seed N            input seed (default 42)
+ *         --warmup SEC        warm-up time per case (default 0.05)
+ *         --min-reps N        minimum repetitions (default 10)
+ *         --max-reps N        maximum repetitions (default 1000)
+ *         --max-time SEC      time budget per case (default 2)
+ *         --ci FRACTION       target CI half-width / mean (default 0.02)
+ *     -o, --format FMT        text (default), json or csv
+ *     -w, --output FILE       write results to FILE instead of stdout
+ *     -c, --compare FILE      compare against a JSON baseline
+ *     -t, --threshold FRAC    regression threshold (default 0.05)
+ *     -l, --list              list kernels and exit
+ *         --scaling           thread-scaling mode (see below)
+ *         --threads N,N,...   thread counts (default 1, 2, 4, ... max)
+ *         --numa MODE         allocation placement: none, first-touch or
+ *                             interleave
+ *         --bind              bind threads to NUMA nodes (scaling mode)
+ *         --latency           per-call latency mode (see below)
+ *         --iterations N      timed calls per case (default 1000000)
+ *         --cpu N             pin to CPU N
+ *         --fifo PRIO         run under SCHED_FIFO at PRIO (needs privileges)
+ *         --mlock             lock all current and future pages
+ *         --strict            exit 1 if a hot path allocates or faults
+ *         --counters          hardware counters per kernel (Linux perf)
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include "palma.h"
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+#define MAX_SIZES      16
+#define MAX_SEMIRINGS  5
+#define MAX_THREADS_LIST 16
+
+/* Shortest time one timed sample (a batch of calls) may take */
+#define MIN_SAMPLE_SEC 1e-4
+
+/* Most calls timed one by one for p95 and p99 */
+#define MAX_TAIL_CALLS 100000
+
+/*============================================================================
+ * OPTIONS
+ *============================================================================*/
+
+typedef enum { FORMAT_TEXT, FORMAT_JSON, FORMAT_CSV } format_t;
+
+typedef struct {
+    const char *filter;
+    size_t sizes[MAX_SIZES];
+    size_t n_sizes;
+    palma_semiring_t semirings[MAX_SEMIRINGS];
+    size_t n_semirings;
+    uint64_t seed;
+    double warmup;
+    size_t min_reps;
+    size_t max_reps;
+    double max_time;
+    double target_ci;
+    format_t format;
+    const char *output;
+    const char *baseline;
+    double threshold;
+    bool scaling;
+    size_t threads[MAX_THREADS_LIST];
+    size_t n_threads;
+    int numa;               /* palma_numa_t, or -1 to keep the default */
+    bool bind;
+    bool latency;
+    size_t iterations;      /* Timed calls per latency case */
+    int cpu;                /* CPU to pin to, or -1 */
+    int fifo;               /* SCHED_FIFO priority, or 0 */
+    bool mlock;
+    bool strict;            /* Latency: exit 1 if a hot path allocates or faults */
+    bool counters;          /* Hardware counters per kernel (perf events) */
+} options_t;
+
+static const struct { const char *name; palma_semiring_t s; } semiring_names[] = {
+    { "maxplus", PALMA_MAXPLUS }, { "minplus", PALMA_MINPLUS },
+    { "maxmin", PALMA_MAXMIN }, { "minmax", PALMA_MINMAX },
+    { "boolean", PALMA_BOOLEAN }
+};
+
+static bool semiring_from_key(const char *key, palma_semiring_t *s) {
+    for (size_t i = 0; i < sizeof(semiring_names) / sizeof(semiring_names[0]); i++) {
+        if (strcmp(semiring_names[i].name, key) == 0) {
+            *s = semiring_names[i].s;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* semiring_key(palma_semiring_t s) {
+    for (size_t i = 0; i < sizeof(semiring_names) / sizeof(semiring_names[0]); i++) {
+        if (semiring_names[i].s == s) return semiring_names[i].name;
+    }
+    return "unknown";
+}
+
+/*============================================================================
+ * DETERMINISTIC INPUTS
+ *============================================================================*/
+
+/* splitmix64: small, fast and good enough for benchmark inputs */
+static uint64_t rng_next(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint32_t rng_below(uint64_t *state, uint32_t bound) {
+    return (uint32_t)(((rng_next(state) >> 32) * bound) >> 32);
+}
+
+/* Each case gets its own stream, so filtering does not change inputs */
+static uint64_t case_seed(uint64_t seed, const char *kernel, palma_semiring_t s, size_t n) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (const char *p = kernel; *p; p++) h = (h ^ (uint8_t)*p) * 0x100000001B3ull;
+    return seed ^ h ^ ((uint64_t)s << 56) ^ (n * 0x9E3779B97F4A7C15ull);
+}
+
+/* Weights in [1, 100] with the given fraction of ε entries */
+static void fill_dense(palma_matrix_t *M, uint64_t *rng, unsigned zero_pct, palma_semiring_t s) {
+    palma_val_t zero = palma_zero(s);
+    for (size_t i = 0; i < M->rows; i++) {
+        for (size_t j = 0; j < M->cols; j++) {
+            palma_val_t v = (rng_below(rng, 100) < zero_pct) ? zero
+                          : (s == PALMA_BOOLEAN ? 1 : (palma_val_t)rng_below(rng, 100) + 1);
+            M->data[i * M->stride + j] = v;
+        }
+    }
+}
+
+/*============================================================================
+ * KERNELS
+ *
+ * setup() builds the inputs for one (kernel, semiring, n) case and returns
+ * false if the kernel does not apply; run() is the timed call and returns
+ * a non-zero status on failure. Everything hanging off the case is
+ * released by case_free().
+ *============================================================================*/
+
+typedef struct {
+    size_t n;
+    palma_semiring_t semiring;
+    uint64_t rng;
+
+    palma_matrix_t *A, *B, *C, *W;
+    palma_sparse_t *SA, *SB, *SC;
+    palma_val_t *x, *y;
+    int *flags;
+
+    palma_matrix_t **seq;
+    size_t seq_len;
+    palma_batch_t *BA, *BB, *BC;
+    palma_expr_ctx_t *expr;
+    palma_dynsparse_t *dyn;
+    palma_vmatrix_t *vm;
+    palma_scheduler_t *sched;
+    char path[256];
+} bench_case_t;
+
+typedef struct {
+    const char *name;
+    size_t max_n;                           /* Largest size run (0 = any) */
+    double (*ops)(size_t n);                /* Semiring operations per call */
+    bool (*setup)(bench_case_t *c);
+    int (*run)(bench_case_t *c);
+    const char *semiring;                   /* Only this semiring (NULL = each selected) */
+    size_t scale;                           /* Nodes per unit of --sizes (0 = 1) */
+} kernel_t;
+
+static void case_free(bench_case_t *c) {
+    palma_matrix_destroy(c->A);
+    palma_matrix_destroy(c->B);
+    palma_matrix_destroy(c->C);
+    palma_matrix_destroy(c->W);
+    palma_sparse_destroy(c->SA);
+    palma_sparse_destroy(c->SB);
+    palma_sparse_destroy(c->SC);
+    free(c->x);
+    free(c->y);
+    free(c->flags);
+    for (size_t i = 0; i < c->seq_len; i++) palma_matrix_destroy(c->seq[i]);
+    free(c->seq);
+    palma_batch_destroy(c->BA);
+    palma_batch_destroy(c->BB);
+    palma_batch_destroy(c->BC);
+    palma_expr_destroy(c->expr);
+    palma_dynsparse_destroy(c->dyn);
+    palma_vmatrix_destroy(c->vm);
+    palma_scheduler_destroy(c->sched);
+    if (c->path[0]) unlink(c->path);
+}
+
+static double ops_n2(size_t n) { return (double)n * n; }
+static double ops_n3(size_t n) { return (double)n * n * n; }
+
+/* Common inputs: dense A, B (30% ε), output C and vectors x, y */
+static bool setup_dense(bench_case_t *c) {
+    size_t n = c->n;
+    c->A = palma_matrix_create(n, n);
+    c->B = palma_matrix_create(n, n);
+    c->C = palma_matrix_create(n, n);
+    c->x = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    c->y = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    if (!c->A || !c->B || !c->C || !c->x || !c->y) return false;
+
+    fill_dense(c->A, &c->rng, 30, c->semiring);
+    fill_dense(c->B, &c->rng, 30, c->semiring);
+    for (size_t i = 0; i < n; i++) c->x[i] = (palma_val_t)rng_below(&c->rng, 100);
+    return true;
+}
+
+/* Graph-like inputs: about 8 edges per row, stored both dense and sparse */
+static bool setup_graph(bench_case_t *c) {
+    if (!setup_dense(c)) return false;
+    unsigned pct = c->n > 8 ? (unsigned)(100 - 800 / c->n) : 50;
+    fill_dense(c->A, &c->rng, pct, c->semiring);
+    fill_dense(c->B, &c->rng, pct, c->semiring);
+    c->SA = palma_sparse_from_dense(c->A, c->semiring);
+    c->SB = palma_sparse_from_dense(c->B, c->semiring);
+    c->SC = palma_sparse_create(c->n, c->n, 0, c->semiring);
+    return c->SA && c->SB && c->SC;
+}
+
+/* Closures need a matrix without improving cycles: use a random DAG */
+static bool setup_dag(bench_case_t *c) {
+    if (!setup_graph(c)) return false;
+    palma_val_t zero = palma_zero(c->semiring);
+    for (size_t i = 0; i < c->n; i++) {
+        for (size_t j = 0; j <= i; j++) c->A->data[i * c->A->stride + j] = zero;
+    }
+    palma_sparse_destroy(c->SA);
+    c->SA = palma_sparse_from_dense(c->A, c->semiring);
+    return c->SA != NULL;
+}
+
+static bool setup_power(bench_case_t *c) {
+    c->W = palma_matrix_create(2 * c->n, c->n);
+    return c->W && setup_dense(c);
+}
+
+static bool setup_flags(bench_case_t *c) {
+    c->flags = (int*)malloc(c->n * sizeof(int));
+    return c->flags && setup_dense(c);
+}
+
+static bool setup_critical(bench_case_t *c) {
+    return c->semiring == PALMA_MAXPLUS && setup_flags(c);
+}
+
+static bool setup_maxplus(bench_case_t *c) {
+    return c->semiring == PALMA_MAXPLUS && setup_dense(c);
+}
+
+static bool setup_minplus_dag(bench_case_t *c) {
+    return c->semiring == PALMA_MINPLUS && setup_dag(c);
+}
+
+static bool setup_sequence(bench_case_t *c) {
+    if (!setup_dense(c)) return false;
+    c->seq_len = 16;
+    c->seq = (palma_matrix_t**)calloc(c->seq_len, sizeof(palma_matrix_t*));
+    if (!c->seq) return false;
+    for (size_t i = 0; i < c->seq_len; i++) {
+        c->seq[i] = palma_matrix_create(c->n, c->n);
+        if (!c->seq[i]) return false;
+        fill_dense(c->seq[i], &c->rng, 30, c->semiring);
+    }
+    return true;
+}
+
+/* Batches hold 1024 matrices of size n (n ≤ 16) */
+static bool setup_batch(bench_case_t *c) {
+    size_t count = 1024;
+    if (!setup_dense(c)) return false;
+    c->BA = palma_batch_create(c->n, c->n, count);
+    c->BB = palma_batch_create(c->n, c->n, count);
+    c->BC = palma_batch_create(c->n, c->n, count);
+    c->y = (palma_val_t*)realloc(c->y, count * sizeof(palma_val_t));
+    if (!c->BA || !c->BB || !c->BC || !c->y) return false;
+    for (size_t k = 0; k < count; k++) {
+        fill_dense(c->A, &c->rng, 30, c->semiring);
+        fill_dense(c->B, &c->rng, 30, c->semiring);
+        if (palma_batch_set_matrix(c->BA, k, c->A) != PALMA_SUCCESS ||
+            palma_batch_set_matrix(c->BB, k, c->B) != PALMA_SUCCESS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool setup_expr(bench_case_t *c) {
+    if (!setup_dense(c)) return false;
+    c->W = palma_matrix_create(c->n, c->n);
+    c->expr = palma_expr_create(c->semiring);
+    if (!c->W || !c->expr) return false;
+    fill_dense(c->W, &c->rng, 30, c->semiring);
+    return true;
+}
+
+static bool setup_dynsparse(bench_case_t *c) {
+    c->dyn = palma_dynsparse_create(c->n, c->n, c->semiring);
+    return c->dyn != NULL;
+}
+
+static bool setup_vmatrix(bench_case_t *c) {
+    if (!setup_dense(c)) return false;
+    c->vm = palma_vmatrix_create(c->A, PALMA_VMATRIX_TILE);
+    return c->vm != NULL;
+}
+
+/* Random DAG of n tasks with about 4 predecessors each */
+static bool setup_scheduler(bench_case_t *c) {
+    if (c->semiring != PALMA_MAXPLUS) return false;
+    c->sched = palma_scheduler_create(c->n, true);
+    if (!c->sched) return false;
+    for (size_t to = 1; to < c->n; to++) {
+        for (int k = 0; k < 4; k++) {
+            size_t from = rng_below(&c->rng, (uint32_t)to);
+            palma_scheduler_add_constraint(c->sched, from, to, (palma_val_t)rng_below(&c->rng, 50) + 1);
+        }
+    }
+    return true;
+}
+
+static bool setup_file(bench_case_t *c, const char *suffix) {
+    const char *dir = getenv("TMPDIR");
+    snprintf(c->path, sizeof(c->path), "%s/palma_bench_%ld.%s", dir ? dir : "/tmp",
+             (long)getpid(), suffix);
+    return true;
+}
+
+static bool setup_packed(bench_case_t *c) {
+    return setup_dag(c) && setup_file(c, "plz") &&
+           palma_matrix_save_packed(c->A, c->path) == PALMA_SUCCESS;
+}
+
+static bool setup_csv(bench_case_t *c) {
+    return setup_dense(c) && setup_file(c, "csv");
+}
+
+static bool setup_dimacs(bench_case_t *c) {
+    if (c->semiring != PALMA_MINPLUS || !setup_graph(c) || !setup_file(c, "gr")) return false;
+    FILE *fp = fopen(c->path, "w");
+    if (!fp) return false;
+    fprintf(fp, "p sp %zu %zu\n", c->n, c->SA->nnz);
+    for (size_t i = 0; i < c->n; i++) {
+        for (palma_ptr_t k = c->SA->row_ptr[i]; k < c->SA->row_ptr[i + 1]; k++) {
+            fprintf(fp, "a %zu %u %d\n", i + 1, c->SA->col_idx[k] + 1, c->SA->values[k]);
+        }
+    }
+    return fclose(fp) == 0;
+}
+
+/*
+ * Generated workloads (palma_gen_*). The generator may round the node
+ * count, so the case takes its size from the graph.
+ */
+static bool setup_workload(bench_case_t *c, palma_sparse_t *G) {
+    if (!G) return false;
+    c->SA = G;
+    c->n = G->rows;
+    c->x = (palma_val_t*)calloc(c->n, sizeof(palma_val_t));
+    c->y = (palma_val_t*)calloc(c->n, sizeof(palma_val_t));
+    c->SC = palma_sparse_create(c->n, c->n, 0, c->semiring);
+    return c->x && c->y && c->SC;
+}
+
+static palma_gen_options_t workload_options(bench_case_t *c) {
+    palma_gen_options_t o;
+    palma_gen_default_options(&o);
+    o.seed = rng_next(&c->rng);
+    return o;
+}
+
+/* Power-law graph, Graph500 parameters, 16 edges per node */
+static bool setup_rmat(bench_case_t *c) {
+    palma_gen_options_t o = workload_options(c);
+    unsigned scale = 1;
+    while (((size_t)1 << scale) < c->n) scale++;
+    return setup_workload(c, palma_gen_rmat(scale, 16, PALMA_RMAT_A, PALMA_RMAT_B, PALMA_RMAT_C,
+                                            c->semiring, &o));
+}
+
+/* Square road-like grid with 10% of the streets missing */
+static bool setup_road(bench_case_t *c) {
+    palma_gen_options_t o = workload_options(c);
+    o.weights = PALMA_WEIGHTS_LOG_UNIFORM;
+    o.max_weight = 1000;
+    size_t side = (size_t)sqrt((double)c->n);
+    return setup_workload(c, palma_gen_grid(side, side, 0.9, c->semiring, &o));
+}
+
+static bool setup_er(bench_case_t *c) {
+    palma_gen_options_t o = workload_options(c);
+    double degree = c->semiring == PALMA_BOOLEAN ? 2.0 : 8.0;
+    return setup_workload(c, palma_gen_erdos_renyi(c->n, degree, c->semiring, &o));
+}
+
+/* Project plan: 4 successors among the next 32 tasks */
+static bool setup_plan(bench_case_t *c) {
+    palma_gen_options_t o = workload_options(c);
+    if (!setup_workload(c, palma_gen_dag(c->n, 4.0, 32, c->semiring, &o))) return false;
+    c->C = palma_matrix_create(c->n, c->n);
+    return c->C != NULL;
+}
+
+static bool setup_plan_scheduler(bench_case_t *c) {
+    if (!setup_plan(c)) return false;
+    c->sched = palma_scheduler_create(c->n, true);
+    if (!c->sched) return false;
+    for (size_t i = 0; i < c->n; i++) {
+        for (palma_ptr_t k = c->SA->row_ptr[i]; k < c->SA->row_ptr[i + 1]; k++) {
+            palma_scheduler_add_constraint(c->sched, i, c->SA->col_idx[k], c->SA->values[k]);
+        }
+    }
+    return true;
+}
+
+static int run_mul(bench_case_t *c) { return palma_matrix_mul_into(c->C, c->A, c->B, c->semiring); }
+static int run_add(bench_case_t *c) { return palma_matrix_add_into(c->C, c->A, c->B, c->semiring); }
+static int run_power(bench_case_t *c) { return palma_matrix_power_into(c->C, c->A, 8, c->semiring, c->W); }
+static int run_closure(bench_case_t *c) { return palma_matrix_closure_into(c->C, c->A, c->semiring); }
+static int run_tclosure(bench_case_t *c) { return palma_matrix_transitive_closure_into(c->C, c->A, c->semiring); }
+static int run_cycle_nodes(bench_case_t *c) { return palma_matrix_cycle_nodes(c->A, c->flags, c->semiring) < 0; }
+static int run_matvec(bench_case_t *c) { return palma_matvec(c->A, c->x, c->y, c->semiring); }
+static int run_iterate(bench_case_t *c) { return palma_iterate(c->A, c->x, 4, c->semiring); }
+
+static int run_dot(bench_case_t *c) {
+    c->y[0] = palma_dot(c->x, c->x, c->n, c->semiring);
+    return 0;
+}
+
+static int run_eigenvalue(bench_case_t *c) {
+    c->y[0] = palma_eigenvalue(c->A, c->semiring);
+    return 0;
+}
+
+static int run_eigenvector(bench_case_t *c) {
+    palma_val_t lambda;
+    palma_error_t err = palma_eigenvector(c->A, c->y, &lambda, c->semiring, 1000);
+    return err != PALMA_SUCCESS && err != PALMA_ERR_NOT_CONVERGED;
+}
+
+static int run_critical(bench_case_t *c) { return palma_critical_nodes(c->A, c->flags, c->semiring) < 0; }
+static int run_all_pairs(bench_case_t *c) { return palma_all_pairs_paths_into(c->C, c->A, c->semiring); }
+static int run_single_source(bench_case_t *c) { return palma_single_source_paths(c->A, 0, c->y, c->semiring); }
+static int run_reachability(bench_case_t *c) { return palma_reachability_into(c->C, c->A); }
+static int run_bottleneck(bench_case_t *c) { return palma_bottleneck_paths_into(c->C, c->A); }
+static int run_sparse_mul(bench_case_t *c) { return palma_sparse_mul_into(c->SC, c->SA, c->SB); }
+static int run_sparse_matvec(bench_case_t *c) { return palma_sparse_matvec(c->SA, c->x, c->y); }
+static int run_sparse_closure(bench_case_t *c) { return palma_sparse_closure_into(c->SC, c->SA); }
+
+static int run_sparse_from_dense(bench_case_t *c) {
+    palma_sparse_destroy(c->SC);
+    c->SC = palma_sparse_from_dense(c->A, c->semiring);
+    return c->SC == NULL;
+}
+
+static int run_sparse_to_dense(bench_case_t *c) {
+    palma_matrix_destroy(c->C);
+    c->C = palma_sparse_to_dense(c->SA);
+    return c->C == NULL;
+}
+
+static int run_auto_closure(bench_case_t *c) { return palma_auto_closure_into(c->C, c->A, c->semiring, NULL); }
+static int run_sparse_auto_closure(bench_case_t *c) { return palma_sparse_auto_closure_into(c->C, c->SA, NULL); }
+static int run_auto_single_source(bench_case_t *c) { return palma_auto_single_source(c->A, 0, c->y, c->semiring, NULL); }
+static int run_auto_mul(bench_case_t *c) { return palma_auto_mul_into(c->C, c->A, c->B, c->semiring, NULL); }
+
+static int run_sequence_product(bench_case_t *c) {
+    palma_matrix_destroy(c->C);
+    c->C = palma_matrix_sequence_product((const palma_matrix_t *const *)c->seq, c->seq_len, c->semiring);
+    return c->C == NULL;
+}
+
+static int run_sequence_apply(bench_case_t *c) {
+    return palma_matrix_sequence_apply((const palma_matrix_t *const *)c->seq, c->seq_len,
+                                       c->x, c->y, c->semiring);
+}
+
+static int run_batch_mul(bench_case_t *c) { return palma_batch_mul_into(c->BC, c->BA, c->BB, c->semiring); }
+static int run_batch_closure(bench_case_t *c) { return palma_batch_closure_into(c->BC, c->BA, c->semiring); }
+static int run_batch_eigenvalue(bench_case_t *c) { return palma_batch_eigenvalue(c->BA, c->y, c->semiring); }
+
+/* A ⊗ B ⊕ W, evaluated with the fused accumulation */
+static int run_expr(bench_case_t *c) {
+    palma_expr_reset(c->expr);
+    palma_expr_t *e = palma_expr_add(c->expr,
+        palma_expr_mul(c->expr, palma_expr_matrix(c->expr, c->A), palma_expr_matrix(c->expr, c->B)),
+        palma_expr_matrix(c->expr, c->W));
+    return e ? palma_expr_eval(c->expr, e, c->C) : -1;
+}
+
+/* n random updates, then a merge into the CSR base */
+static int run_dynsparse(bench_case_t *c) {
+    for (size_t k = 0; k < c->n; k++) {
+        size_t i = rng_below(&c->rng, (uint32_t)c->n), j = rng_below(&c->rng, (uint32_t)c->n);
+        if (palma_dynsparse_set(c->dyn, i, j, (palma_val_t)k) != PALMA_SUCCESS) return -1;
+    }
+    return palma_dynsparse_merge(c->dyn);
+}
+
+/* One-entry commit followed by a snapshot read */
+static int run_vmatrix(bench_case_t *c) {
+    palma_vmatrix_edit_t *edit = palma_vmatrix_begin(c->vm);
+    if (!edit) return -1;
+    size_t i = rng_below(&c->rng, (uint32_t)c->n), j = rng_below(&c->rng, (uint32_t)c->n);
+    palma_vmatrix_edit_set(edit, i, j, (palma_val_t)i);
+    if (palma_vmatrix_commit(edit, NULL) != PALMA_SUCCESS) return -1;
+
+    const palma_vsnapshot_t *snap = palma_vmatrix_snapshot(c->vm);
+    if (!snap) return -1;
+    c->y[0] = palma_vsnapshot_get(snap, i, j);
+    palma_vsnapshot_release(snap);
+    return 0;
+}
+
+static int run_scheduler(bench_case_t *c) { return palma_scheduler_solve(c->sched, 100) < 0; }
+
+static int run_wl_sssp(bench_case_t *c) { return palma_sparse_auto_single_source(c->SA, 0, c->y, NULL); }
+static int run_wl_closure(bench_case_t *c) { return palma_sparse_auto_closure_into(c->C, c->SA, NULL); }
+static int run_wl_spgemm(bench_case_t *c) { return palma_sparse_mul_into(c->SC, c->SA, c->SA); }
+static int run_wl_reach(bench_case_t *c) { return palma_sparse_closure_into(c->SC, c->SA); }
+
+static int run_save_packed(bench_case_t *c) { return palma_matrix_save_packed(c->A, c->path); }
+
+static int run_load_packed(bench_case_t *c) {
+    palma_matrix_destroy(c->C);
+    c->C = palma_matrix_load_packed(c->path);
+    return c->C == NULL;
+}
+
+static int run_save_csv(bench_case_t *c) { return palma_matrix_save_csv(c->A, c->path, c->semiring); }
+
+static int run_load_dimacs(bench_case_t *c) {
+    palma_sparse_destroy(c->SC);
+    c->SC = palma_sparse_load_dimacs(c->path, c->semiring);
+    return c->SC == NULL;
+}
+
+static const kernel_t kernels[] = {
+    /* Dense */
+    { "mul",                    0,    ops_n3, setup_dense,          run_mul,                 NULL,      0 },
+    { "add",                    0,    ops_n2, setup_dense,          run_add,                 NULL,      0 },
+    { "power8",                 0,    NULL,   setup_power,          run_power,               NULL,      0 },
+    { "closure",                0,    ops_n3, setup_dag,            run_closure,             NULL,      0 },
+    { "transitive_closure",     0,    ops_n3, setup_dag,            run_tclosure,            NULL,      0 },
+    { "cycle_nodes",            0,    NULL,   setup_flags,          run_cycle_nodes,         NULL,      0 },
+    { "matvec",                 0,    ops_n2, setup_dense,          run_matvec,              NULL,      0 },
+    { "iterate4",               0,    NULL,   setup_dense,          run_iterate,             NULL,      0 },
+    { "dot",                    0,    NULL,   setup_dense,          run_dot,                 NULL,      0 },
+    { "eigenvalue",             256,  NULL,   setup_dense,          run_eigenvalue,          NULL,      0 },
+    { "eigenvector",            256,  NULL,   setup_maxplus,        run_eigenvector,         NULL,      0 },
+    { "critical_nodes",         256,  NULL,   setup_critical,       run_critical,            NULL,      0 },
+    /* Graph algorithms */
+    { "all_pairs_paths",        0,    ops_n3, setup_dag,            run_all_pairs,           NULL,      0 },
+    { "single_source_paths",    0,    NULL,   setup_dag,            run_single_source,       NULL,      0 },
+    { "reachability",           0,    ops_n3, setup_graph,          run_reachability,        NULL,      0 },
+    { "bottleneck_paths",       0,    ops_n3, setup_graph,          run_bottleneck,          NULL,      0 },
+    /* Sparse */
+    { "sparse_mul",             0,    NULL,   setup_graph,          run_sparse_mul,          NULL,      0 },
+    { "sparse_matvec",          0,    NULL,   setup_graph,          run_sparse_matvec,       NULL,      0 },
+    { "sparse_closure",         256,  NULL,   setup_dag,            run_sparse_closure,      NULL,      0 },
+    { "sparse_from_dense",      0,    ops_n2, setup_graph,          run_sparse_from_dense,   NULL,      0 },
+    { "sparse_to_dense",        0,    ops_n2, setup_graph,          run_sparse_to_dense,     NULL,      0 },
+    { "dynsparse_update_merge", 0,    NULL,   setup_dynsparse,      run_dynsparse,           NULL,      0 },
+    /* Planner */
+    { "auto_closure",           0,    NULL,   setup_dag,            run_auto_closure,        NULL,      0 },
+    { "sparse_auto_closure",    0,    NULL,   setup_dag,            run_sparse_auto_closure, NULL,      0 },
+    { "auto_single_source",     0,    NULL,   setup_minplus_dag,    run_auto_single_source,  NULL,      0 },
+    { "auto_mul",               0,    NULL,   setup_graph,          run_auto_mul,            NULL,      0 },
+    /* Composite */
+    { "sequence_product16",     256,  NULL,   setup_sequence,       run_sequence_product,    NULL,      0 },
+    { "sequence_apply16",       0,    NULL,   setup_sequence,       run_sequence_apply,      NULL,      0 },
+    { "batch1024_mul",          16,   NULL,   setup_batch,          run_batch_mul,           NULL,      0 },
+    { "batch1024_closure",      16,   NULL,   setup_batch,          run_batch_closure,       NULL,      0 },
+    { "batch1024_eigenvalue",   16,   NULL,   setup_batch,          run_batch_eigenvalue,    NULL,      0 },
+    { "expr_mul_add",           0,    ops_n3, setup_expr,           run_expr,                NULL,      0 },
+    { "vmatrix_commit_read",    0,    NULL,   setup_vmatrix,        run_vmatrix,             NULL,      0 },
+    { "scheduler_solve",        0,    NULL,   setup_scheduler,      run_scheduler,           NULL,      0 },
+    /* File I/O (page cache) */
+    { "save_packed",            0,    NULL,   setup_packed,         run_save_packed,         NULL,      0 },
+    { "load_packed",            0,    NULL,   setup_packed,         run_load_packed,         NULL,      0 },
+    { "save_csv",               0,    NULL,   setup_csv,            run_save_csv,            NULL,      0 },
+    { "load_dimacs",            0,    NULL,   setup_dimacs,         run_load_dimacs,         NULL,      0 },
+    /* Generated workloads: n is the node count, --sizes times the scale */
+    { "wl_sssp_rmat",           0,    NULL,   setup_rmat,           run_wl_sssp,             "minplus", 64 },
+    { "wl_sssp_road",           0,    NULL,   setup_road,           run_wl_sssp,             "minplus", 64 },
+    { "wl_closure_plan",        256,  NULL,   setup_plan,           run_wl_closure,          "maxplus", 4 },
+    { "wl_spgemm_rmat",         0,    NULL,   setup_rmat,           run_wl_spgemm,           "minplus", 16 },
+    { "wl_spgemm_er",           0,    NULL,   setup_er,             run_wl_spgemm,           "minplus", 16 },
+    { "wl_reach_er",            256,  NULL,   setup_er,             run_wl_reach,            "boolean", 4 },
+    { "wl_schedule_plan",       256,  NULL,   setup_plan_scheduler, run_scheduler,           "maxplus", 4 },
+};
+
+#define N_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+/*============================================================================
+ * MEASUREMENT
+ *============================================================================*/
+
+typedef struct {
+    const char *kernel;
+    const char *semiring;
+    size_t n;
+    size_t reps;
+    size_t batch;           /* Calls per timed sample */
+    bool converged;         /* CI target reached within the budget */
+    double median, mean, p95, p99, min, stddev, ci;   /* Nanoseconds per call */
+    double median_lo, median_hi;    /* 95% interval of the median */
+    size_t tail_calls;      /* Calls timed one by one for p95 and p99 */
+    double gops;            /* Semiring operations per ns (0 if not defined) */
+    palma_profile_t events; /* Hardware counters over events_calls calls (--counters) */
+    size_t events_calls;
+} result_t;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Two-sided 95% Student t quantile */
+static double t95(size_t df) {
+    static const double table[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df < sizeof(table) / sizeof(table[0])) return table[df];
+    return 1.960 + 2.4 / (double)df;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples */
+static double percentile(const double *sorted, size_t n, double p) {
+    size_t rank = (size_t)ceil(p * (double)n);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/*
+ * Distribution-free 95% interval of the median: the order statistics at
+ * ranks n/2 ∓ 0.98·√n, from the normal approximation to Binomial(n, 1/2)
+ */
+static void median_interval(const double *sorted, size_t n, double *lo, double *hi) {
+    double half = 0.98 * sqrt((double)n);
+    double l = floor(0.5 * (double)n - half), u = ceil(0.5 * (double)n + half) + 1;
+    *lo = sorted[l < 1 ? 0 : (size_t)l - 1];
+    *hi = sorted[u > (double)n ? n - 1 : (size_t)u - 1];
+}
+
+/* Time single calls for p95 and p99, as many as the batches made or the budget allows */
+static bool measure_tail(const kernel_t *k, bench_case_t *c, const options_t *opt, result_t *r) {
+    size_t calls = r->reps * r->batch;
+    if (calls > MAX_TAIL_CALLS) calls = MAX_TAIL_CALLS;
+    double *samples = (double*)malloc(calls * sizeof(double));
+    if (!samples) return false;
+
+    size_t timed = 0;
+    double start = now_sec();
+    while (timed < calls) {
+        double t0 = now_sec();
+        if (k->run(c) != 0) {
+            free(samples);
+            return false;
+        }
+        double t1 = now_sec();
+        samples[timed++] = (t1 - t0) * 1e9;
+        if (t1 - start >= opt->max_time) break;
+    }
+
+    qsort(samples, timed, sizeof(double), cmp_double);
+    r->tail_calls = timed;
+    r->p95 = percentile(samples, timed, 0.95);
+    r->p99 = percentile(samples, timed, 0.99);
+    free(samples);
+    return true;
+}
+
+/* Time calls in batches until the CI target, the budget or max_reps */
+static bool measure(const kernel_t *k, bench_case_t *c, const options_t *opt, result_t *r) {
+    /* Warm-up, also used to size the batch */
+    size_t calls = 0;
+    double start = now_sec(), elapsed;
+    do {
+        if (k->run(c) != 0) return false;
+        calls++;
+        elapsed = now_sec() - start;
+    } while (elapsed < opt->warmup);
+
+    double per_call = elapsed / (double)calls;
+    size_t batch = per_call > 0 ? (size_t)ceil(MIN_SAMPLE_SEC / per_call) : 1000;
+    if (batch < 1) batch = 1;
+
+    double *samples = (double*)malloc(opt->max_reps * sizeof(double));
+    if (!samples) return false;
+
+    double mean = 0, m2 = 0;
+    size_t reps = 0;
+    bool converged = false;
+    double budget_start = now_sec();
+
+    while (reps < opt->max_reps) {
+        double t0 = now_sec();
+        for (size_t b = 0; b < batch; b++) {
+            if (k->run(c) != 0) {
+                free(samples);
+                return false;
+            }
+        }
+        double sample = (now_sec() - t0) / (double)batch * 1e9;
+        samples[reps++] = sample;
+
+        /* Welford's running mean and variance */
+        double delta = sample - mean;
+        mean += delta / (double)reps;
+        m2 += delta * (sample - mean);
+
+        if (reps >= opt->min_reps) {
+            double sd = sqrt(m2 / (double)(reps - 1));
+            double half = t95(reps - 1) * sd / sqrt((double)reps);
+            if (half <= opt->target_ci * mean) {
+                converged = true;
+                break;
+            }
+            if (now_sec() - budget_start >= opt->max_time) break;
+        }
+    }
+
+    qsort(samples, reps, sizeof(double), cmp_double);
+    r->reps = reps;
+    r->batch = batch;
+    r->converged = converged;
+    r->mean = mean;
+    r->stddev = reps > 1 ? sqrt(m2 / (double)(reps - 1)) : 0;
+    r->ci = reps > 1 ? t95(reps - 1) * r->stddev / sqrt((double)reps) : 0;
+    r->min = samples[0];
+    r->median = (reps % 2) ? samples[reps / 2] : 0.5 * (samples[reps / 2 - 1] + samples[reps / 2]);
+    median_interval(samples, reps, &r->median_lo, &r->median_hi);
+    r->gops = (k->ops && r->median > 0) ? k->ops(c->n) / r->median : 0;
+    free(samples);
+    return measure_tail(k, c, opt, r);
+}
+
+/* Shortest counted run, so counter start/stop costs stay negligible */
+#define COUNTER_SEC 0.05
+
+/* Count hardware events over a run of about COUNTER_SEC after measuring */
+static bool count_events(palma_profiler_t *prof, const kernel_t *k, bench_case_t *c, result_t *r) {
+    size_t calls = r->median > 0 ? (size_t)(COUNTER_SEC * 1e9 / r->median) : 1;
+    if (calls < r->batch) calls = r->batch;
+
+    palma_profile_begin(prof);
+    for (size_t i = 0; i < calls; i++) {
+        if (k->run(c) != 0) return false;
+    }
+    palma_profile_end(prof, k->ops ? k->ops(c->n) * (double)calls : 0, &r->events);
+    r->events_calls = calls;
+    return true;
+}
+
+/* Counter per operation if the kernel defines ops, else per call; -1 if not counted */
+static double event_rate(const result_t *r, palma_counter_t counter) {
+    if (!r->events_calls || !(r->events.available & (1u << counter))) return -1.0;
+    if (r->events.ops > 0) return palma_profile_per_op(&r->events, counter);
+    return (double)r->events.value[counter] / (double)r->events_calls;
+}
+
+static double event_ipc(const result_t *r) {
+    uint32_t both = (1u << PALMA_COUNTER_CYCLES) | (1u << PALMA_COUNTER_INSTRUCTIONS);
+    if (!r->events_calls || (r->events.available & both) != both || !r->events.value[PALMA_COUNTER_CYCLES]) {
+        return -1.0;
+    }
+    return (double)r->events.value[PALMA_COUNTER_INSTRUCTIONS] / (double)r->events.value[PALMA_COUNTER_CYCLES];
+}
+
+/*============================================================================
+ * OUTPUT
+ *============================================================================*/
+
+static void json_string(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', fp);
+        if ((unsigned char)*s >= 0x20) fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+static void print_header(FILE *fp, const options_t *opt) {
+    switch (opt->format) {
+    case FORMAT_JSON:
+        fprintf(fp, "{\n  \"palma_bench\": 1,\n  \"version\": ");
+        json_string(fp, palma_version());
+        fprintf(fp, ",\n  \"config\": ");
+        json_string(fp, palma_build_config());
+        fprintf(fp, ",\n  \"seed\": %llu,\n  \"results\": [\n", (unsigned long long)opt->seed);
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "kernel,semiring,n,reps,batch,converged,median_ns,mean_ns,p95_ns,p99_ns,"
+                    "min_ns,stddev_ns,ci95_ns,median_lo_ns,median_hi_ns,tail_calls,gops");
+        if (opt->counters) {
+            /* Per operation when the kernel defines one, per call otherwise */
+            fprintf(fp, ",counted_per,ipc");
+            for (int i = 0; i < PALMA_COUNTER_COUNT; i++) fprintf(fp, ",%s", palma_counter_name(i));
+        }
+        fprintf(fp, "\n");
+        break;
+    case FORMAT_TEXT:
+        fprintf(fp, "PALMA %s (%s), seed %llu\n\n", palma_version(), palma_build_config(),
+                (unsigned long long)opt->seed);
+        fprintf(fp, "%-24s %-8s %6s %12s %12s %12s %9s %6s %8s\n", "kernel", "semiring", "n",
+                "median", "p95", "p99", "±ci95", "reps", "Gops/s");
+        break;
+    }
+}
+
+static void format_ns(char *buf, size_t len, double ns) {
+    if (ns < 1e3) snprintf(buf, len, "%.1f ns", ns);
+    else if (ns < 1e6) snprintf(buf, len, "%.2f us", ns / 1e3);
+    else if (ns < 1e9) snprintf(buf, len, "%.2f ms", ns / 1e6);
+    else snprintf(buf, len, "%.3f s", ns / 1e9);
+}
+
+static void print_result(FILE *fp, const options_t *opt, const result_t *r, bool first) {
+    switch (opt->format) {
+    case FORMAT_JSON:
+        /* One result per line: the baseline reader relies on it */
+        fprintf(fp, "%s    {\"kernel\": \"%s\", \"semiring\": \"%s\", \"n\": %zu, \"reps\": %zu, "
+                    "\"batch\": %zu, \"converged\": %s, \"median_ns\": %.3f, \"mean_ns\": %.3f, "
+                    "\"p95_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, \"stddev_ns\": %.3f, "
+                    "\"ci95_ns\": %.3f, \"median_lo_ns\": %.3f, \"median_hi_ns\": %.3f, "
+                    "\"tail_calls\": %zu, \"gops\": %.6f",
+                first ? "" : ",\n", r->kernel, r->semiring, r->n, r->reps, r->batch,
+                r->converged ? "true" : "false", r->median, r->mean, r->p95, r->p99, r->min,
+                r->stddev, r->ci, r->median_lo, r->median_hi, r->tail_calls, r->gops);
+        if (r->events_calls) {
+            fprintf(fp, ", \"counters\": {\"per\": \"%s\", \"calls\": %zu",
+                    r->events.ops > 0 ? "op" : "call", r->events_calls);
+            for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+                double v = event_rate(r, (palma_counter_t)i);
+                fprintf(fp, ", \"%s\": ", palma_counter_name((palma_counter_t)i));
+                if (v < 0) fprintf(fp, "null");
+                else fprintf(fp, "%.6g", v);
+            }
+            if (event_ipc(r) >= 0) fprintf(fp, ", \"ipc\": %.3f}", event_ipc(r));
+            else fprintf(fp, ", \"ipc\": null}");
+        }
+        fprintf(fp, "}");
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "%s,%s,%zu,%zu,%zu,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%zu,%.6f",
+                r->kernel, r->semiring, r->n, r->reps, r->batch, r->converged ? 1 : 0,
+                r->median, r->mean, r->p95, r->p99, r->min, r->stddev, r->ci,
+                r->median_lo, r->median_hi, r->tail_calls, r->gops);
+        if (opt->counters) {
+            /* Empty fields when the counters could not be opened */
+            fprintf(fp, ",%s,", !r->events_calls ? "" : r->events.ops > 0 ? "op" : "call");
+            if (event_ipc(r) >= 0) fprintf(fp, "%.3f", event_ipc(r));
+            for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+                double v = event_rate(r, (palma_counter_t)i);
+                fputc(',', fp);
+                if (v >= 0) fprintf(fp, "%.6g", v);
+            }
+        }
+        fprintf(fp, "\n");
+        break;
+    case FORMAT_TEXT: {
+        char med[32], p95[32], p99[32];
+        format_ns(med, sizeof(med), r->median);
+        format_ns(p95, sizeof(p95), r->p95);
+        format_ns(p99, sizeof(p99), r->p99);
+        fprintf(fp, "%-24s %-8s %6zu %12s %12s %12s %8.1f%% %6zu", r->kernel, r->semiring, r->n,
+                med, p95, p99, r->mean > 0 ? 100.0 * r->ci / r->mean : 0.0, r->reps);
+        if (r->gops > 0) fprintf(fp, " %8.2f", r->gops);
+        fprintf(fp, "%s\n", r->converged ? "" : "  (ci not reached)");
+        if (r->events_calls) {
+            fprintf(fp, "%-24s per %-4s", "", r->events.ops > 0 ? "op" : "call");
+            if (event_ipc(r) >= 0) fprintf(fp, "  ipc %.2f", event_ipc(r));
+            for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+                double v = event_rate(r, (palma_counter_t)i);
+                if (v >= 0) fprintf(fp, "  %s %.4g", palma_counter_name((palma_counter_t)i), v);
+            }
+            fprintf(fp, "\n");
+        }
+        break;
+    }
+    }
+    fflush(fp);
+}
+
+static void print_footer(FILE *fp, const options_t *opt) {
+    if (opt->format == FORMAT_JSON) fprintf(fp, "\n  ]\n}\n");
+}
+
+/*============================================================================
+ * BASELINE COMPARISON
+ *============================================================================*/
+
+typedef struct {
+    char kernel[64];
+    char semiring[16];
+    size_t n;
+    double median;
+    double median_lo;
+    double median_hi;
+} baseline_t;
+
+static bool json_field_str(const char *line, const char *key, char *out, size_t len) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": \"", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return false;
+    p += strlen(pattern);
+    size_t n = 0;
+    while (p[n] && p[n] != '"' && n + 1 < len) {
+        out[n] = p[n];
+        n++;
+    }
+    out[n] = '\0';
+    return p[n] == '"';
+}
+
+static bool json_field_num(const char *line, const char *key, double *out) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return false;
+    char *end;
+    *out = strtod(p + strlen(pattern), &end);
+    return end != p + strlen(pattern);
+}
+
+static baseline_t* load_baseline(const char *path, size_t *count) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+
+    size_t n = 0, cap = 64;
+    baseline_t *b = (baseline_t*)malloc(cap * sizeof(baseline_t));
+    char line[1024];
+
+    while (b && fgets(line, sizeof(line), fp)) {
+        baseline_t e;
+        double size, ci;
+        if (!json_field_str(line, "kernel", e.kernel, sizeof(e.kernel)) ||
+            !json_field_str(line, "semiring", e.semiring, sizeof(e.semiring)) ||
+            !json_field_num(line, "n", &size) || !json_field_num(line, "median_ns", &e.median) ||
+            !json_field_num(line, "ci95_ns", &ci)) {
+            continue;
+        }
+        /* Baselines written before the median interval existed: mean CI around the median */
+        if (!json_field_num(line, "median_lo_ns", &e.median_lo) ||
+            !json_field_num(line, "median_hi_ns", &e.median_hi)) {
+            e.median_lo = e.median - ci;
+            e.median_hi = e.median + ci;
+        }
+        e.n = (size_t)size;
+        if (n == cap) {
+            baseline_t *grown = (baseline_t*)realloc(b, 2 * cap * sizeof(baseline_t));
+            if (!grown) {
+                free(b);
+                b = NULL;
+                break;
+            }
+            b = grown;
+            cap *= 2;
+        }
+        b[n++] = e;
+    }
+
+    fclose(fp);
+    *count = n;
+    return b;
+}
+
+typedef enum { VERDICT_SAME, VERDICT_FASTER, VERDICT_SLOWER, VERDICT_NEW } verdict_t;
+
+/*
+ * A change counts only if it exceeds the threshold and the two medians'
+ * 95% intervals are disjoint; noise within either interval is not reported.
+ */
+static verdict_t compare(const baseline_t *base, size_t n_base, const result_t *r,
+                         double threshold, double *ratio) {
+    for (size_t i = 0; i < n_base; i++) {
+        const baseline_t *b = &base[i];
+        if (b->n != r->n || strcmp(b->kernel, r->kernel) != 0 || strcmp(b->semiring, r->semiring) != 0) {
+            continue;
+        }
+        *ratio = b->median > 0 ? r->median / b->median : 1.0;
+        if (*ratio > 1.0 + threshold && r->median_lo > b->median_hi) return VERDICT_SLOWER;
+        if (*ratio < 1.0 - threshold && r->median_hi < b->median_lo) return VERDICT_FASTER;
+        return VERDICT_SAME;
+    }
+    *ratio = 0;
+    return VERDICT_NEW;
+}
+
+/*============================================================================
+ * SCALING MODE
+ *
+ * --scaling sweeps thread counts for the main parallel kernels and relates
+ * each result to a roofline measured on the spot: a STREAM-style tropical
+ * triad (a[i] = max(b[i], c[i] + s)) for sustainable bandwidth, and an
+ * in-cache ⊕⊗ loop for peak operation rate. Traffic is the compulsory one
+ * (inputs read and outputs written once), so reported bandwidth is a lower
+ * bound and a kernel whose roof is bandwidth can still be cache-bound.
+ *============================================================================*/
+
+#define PROBE_ELEMS      (1u << 23)     /* Per triad array: 32 MiB, beyond caches */
+#define PROBE_REPEATS    5
+
+typedef struct {
+    kernel_t kernel;
+    double (*work)(const bench_case_t *c);      /* ⊕⊗ pairs per call */
+    double (*bytes)(const bench_case_t *c);     /* Compulsory traffic per call */
+} scaling_kernel_t;
+
+typedef struct {
+    size_t threads;
+    double bandwidth;       /* Triad GB/s */
+    double peak;            /* In-cache Gops/s */
+} roof_t;
+
+static double work_n3(const bench_case_t *c) { return (double)c->n * c->n * c->n; }
+static double work_n2(const bench_case_t *c) { return (double)c->n * c->n; }
+static double work_nnz(const bench_case_t *c) { return (double)c->SA->nnz; }
+
+/* C = A ⊗ B: read A and B, write C */
+static double bytes_mul(const bench_case_t *c) { return 3.0 * c->n * c->n * sizeof(palma_val_t); }
+
+/* y = A ⊗ x: read A and x, write y */
+static double bytes_matvec(const bench_case_t *c) {
+    return ((double)c->n * c->n + 2.0 * c->n) * sizeof(palma_val_t);
+}
+
+/* Closure in place: read and write the matrix */
+static double bytes_closure(const bench_case_t *c) { return 2.0 * c->n * c->n * sizeof(palma_val_t); }
+
+/* CSR arrays, x gathered once, y written */
+static double bytes_spmv(const bench_case_t *c) {
+    return (double)c->SA->nnz * (sizeof(palma_idx_t) + sizeof(palma_val_t)) +
+           (double)(c->n + 1) * sizeof(palma_ptr_t) + 2.0 * c->n * sizeof(palma_val_t);
+}
+
+/* Erdős–Rényi graph with 16 edges per row */
+static bool setup_spmv(bench_case_t *c) {
+    palma_gen_options_t o = workload_options(c);
+    return setup_workload(c, palma_gen_erdos_renyi(c->n, 16.0, c->semiring, &o));
+}
+
+static const scaling_kernel_t scaling_kernels[] = {
+    { { "mul",     0, NULL, setup_dense, run_mul,           NULL,      0 },   work_n3,  bytes_mul },
+    { { "matvec",  0, NULL, setup_dense, run_matvec,        NULL,      0 },   work_n2,  bytes_matvec },
+    { { "closure", 0, NULL, setup_dag,   run_closure,       NULL,      0 },   work_n3,  bytes_closure },
+    { { "spmv",    0, NULL, setup_spmv,  run_sparse_matvec, "minplus", 256 }, work_nnz, bytes_spmv },
+};
+
+#define N_SCALING_KERNELS (sizeof(scaling_kernels) / sizeof(scaling_kernels[0]))
+
+static void set_threads(size_t threads, bool bind) {
+    #if PALMA_USE_OPENMP
+    omp_set_num_threads((int)threads);
+    if (bind) palma_numa_bind_threads();
+    #else
+    (void)threads;
+    (void)bind;
+    #endif
+}
+
+/* Best-of triad bandwidth in GB/s; arrays are first-touched by the same threads */
+static double probe_bandwidth(void) {
+    size_t n = PROBE_ELEMS;
+    palma_val_t *a = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    palma_val_t *b = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    palma_val_t *c = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    if (!a || !b || !c) {
+        free(a);
+        free(b);
+        free(c);
+        return 0;
+    }
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (size_t i = 0; i < n; i++) {
+        a[i] = 0;
+        b[i] = (palma_val_t)(i & 1023);
+        c[i] = (palma_val_t)(i & 511);
+    }
+
+    double best = 1e30;
+    for (int rep = 0; rep < PROBE_REPEATS; rep++) {
+        palma_val_t s = (palma_val_t)rep;
+        double t0 = now_sec();
+        #if PALMA_USE_OPENMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for (size_t i = 0; i < n; i++) {
+            palma_val_t v = c[i] + s;
+            a[i] = b[i] > v ? b[i] : v;
+        }
+        double t = now_sec() - t0;
+        if (t < best) best = t;
+    }
+
+    volatile palma_val_t sink = a[n / 2];
+    (void)sink;
+    free(a);
+    free(b);
+    free(c);
+    return 3.0 * n * sizeof(palma_val_t) / best * 1e-9;
+}
+
+/* Best-of in-cache max-plus rate in Gops/s (one ⊕⊗ pair per element) */
+static double probe_peak(void) {
+    enum { LEN = 1024, ROUNDS = 4096 };
+    double best = 1e30;
+    size_t threads = 1;
+
+    for (int rep = 0; rep < PROBE_REPEATS; rep++) {
+        double t0 = now_sec();
+        #if PALMA_USE_OPENMP
+        #pragma omp parallel
+        #endif
+        {
+            palma_val_t acc[LEN], x[LEN];
+            for (int j = 0; j < LEN; j++) {
+                acc[j] = PALMA_NEG_INF / 2;
+                x[j] = j;
+            }
+            for (int r = 0; r < ROUNDS; r++) {
+                for (int j = 0; j < LEN; j++) {
+                    palma_val_t v = x[j] + r;
+                    acc[j] = acc[j] > v ? acc[j] : v;
+                }
+            }
+            volatile palma_val_t sink = acc[LEN - 1];
+            (void)sink;
+            #if PALMA_USE_OPENMP
+            #pragma omp single
+            threads = (size_t)omp_get_num_threads();
+            #endif
+        }
+        double t = now_sec() - t0;
+        if (t < best) best = t;
+    }
+    return (double)LEN * ROUNDS * threads / best * 1e-9;
+}
+
+static void default_threads(options_t *opt) {
+    size_t max = 1;
+    #if PALMA_USE_OPENMP
+    max = (size_t)omp_get_max_threads();
+    #endif
+    opt->n_threads = 0;
+    for (size_t t = 1; t < max && opt->n_threads < MAX_THREADS_LIST - 1; t *= 2) {
+        opt->threads[opt->n_threads++] = t;
+    }
+    opt->threads[opt->n_threads++] = max;
+}
+
+static void print_scaling_header(FILE *fp, const options_t *opt, const roof_t *roofs, size_t n_roofs) {
+    switch (opt->format) {
+    case FORMAT_JSON:
+        fprintf(fp, "{\n  \"palma_bench\": 1,\n  \"mode\": \"scaling\",\n  \"version\": ");
+        json_string(fp, palma_version());
+        fprintf(fp, ",\n  \"config\": ");
+        json_string(fp, palma_build_config());
+        fprintf(fp, ",\n  \"numa_nodes\": %d,\n  \"roofline\": [\n", palma_numa_node_count());
+        for (size_t i = 0; i < n_roofs; i++) {
+            fprintf(fp, "    {\"threads\": %zu, \"bandwidth_gbs\": %.3f, \"peak_gops\": %.3f}%s\n",
+                    roofs[i].threads, roofs[i].bandwidth, roofs[i].peak, i + 1 < n_roofs ? "," : "");
+        }
+        fprintf(fp, "  ],\n  \"results\": [\n");
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "kernel,n,threads,median_ns,ci95_ns,speedup,efficiency,gbs,gops,"
+                    "roof_gops,roof_fraction,bound\n");
+        break;
+    case FORMAT_TEXT:
+        fprintf(fp, "PALMA %s (%s), %d NUMA node(s)\n\n", palma_version(), palma_build_config(),
+                palma_numa_node_count());
+        fprintf(fp, "%8s %14s %14s\n", "threads", "triad GB/s", "peak Gops/s");
+        for (size_t i = 0; i < n_roofs; i++) {
+            fprintf(fp, "%8zu %14.2f %14.2f\n", roofs[i].threads, roofs[i].bandwidth, roofs[i].peak);
+        }
+        fprintf(fp, "\n%-8s %7s %7s %12s %8s %6s %8s %8s %8s %6s  %s\n", "kernel", "n", "threads",
+                "median", "speedup", "eff", "GB/s", "Gops/s", "roof", "%roof", "bound");
+        break;
+    }
+}
+
+typedef struct {
+    const char *kernel;
+    size_t n;
+    size_t threads;
+    double median;
+    double ci;
+    double speedup;
+    double efficiency;
+    double bandwidth;
+    double gops;
+    double roof;
+    bool memory_bound;
+} scaling_result_t;
+
+static void print_scaling_result(FILE *fp, const options_t *opt, const scaling_result_t *r, bool first) {
+    const char *bound = r->memory_bound ? "memory" : "compute";
+    switch (opt->format) {
+    case FORMAT_JSON:
+        fprintf(fp, "%s    {\"kernel\": \"%s\", \"n\": %zu, \"threads\": %zu, \"median_ns\": %.3f, "
+                    "\"ci95_ns\": %.3f, \"speedup\": %.4f, \"efficiency\": %.4f, \"gbs\": %.4f, "
+                    "\"gops\": %.4f, \"roof_gops\": %.4f, \"roof_fraction\": %.4f, \"bound\": \"%s\"}",
+                first ? "" : ",\n", r->kernel, r->n, r->threads, r->median, r->ci, r->speedup,
+                r->efficiency, r->bandwidth, r->gops, r->roof, r->roof > 0 ? r->gops / r->roof : 0,
+                bound);
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "%s,%zu,%zu,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%s\n", r->kernel, r->n,
+                r->threads, r->median, r->ci, r->speedup, r->efficiency, r->bandwidth, r->gops,
+                r->roof, r->roof > 0 ? r->gops / r->roof : 0, bound);
+        break;
+    case FORMAT_TEXT: {
+        char med[32];
+        format_ns(med, sizeof(med), r->median);
+        fprintf(fp, "%-8s %7zu %7zu %12s %7.2fx %5.0f%% %8.2f %8.2f %8.2f %5.0f%%  %s\n", r->kernel,
+                r->n, r->threads, med, r->speedup, 100.0 * r->efficiency, r->bandwidth, r->gops,
+                r->roof, r->roof > 0 ? 100.0 * r->gops / r->roof : 0.0, bound);
+        break;
+    }
+    }
+    fflush(fp);
+}
+
+static int run_scaling(const options_t *opt, FILE *out) {
+    roof_t roofs[MAX_THREADS_LIST];
+    for (size_t t = 0; t < opt->n_threads; t++) {
+        set_threads(opt->threads[t], opt->bind);
+        roofs[t].threads = opt->threads[t];
+        roofs[t].bandwidth = probe_bandwidth();
+        roofs[t].peak = probe_peak();
+    }
+    print_scaling_header(out, opt, roofs, opt->n_threads);
+
+    size_t failed = 0;
+    bool first = true;
+    for (size_t k = 0; k < N_SCALING_KERNELS; k++) {
+        const scaling_kernel_t *sk = &scaling_kernels[k];
+        if (opt->filter && !strstr(sk->kernel.name, opt->filter)) continue;
+
+        for (size_t ni = 0; ni < opt->n_sizes; ni++) {
+            double base = 0;
+            size_t base_threads = 0;
+
+            for (size_t t = 0; t < opt->n_threads; t++) {
+                size_t n = opt->sizes[ni] * (sk->kernel.scale ? sk->kernel.scale : 1);
+
+                /* Set up under the measured thread count, for first-touch placement */
+                set_threads(opt->threads[t], opt->bind);
+                bench_case_t c;
+                memset(&c, 0, sizeof(c));
+                c.n = n;
+                c.semiring = PALMA_MAXPLUS;
+                if (sk->kernel.semiring) semiring_from_key(sk->kernel.semiring, &c.semiring);
+                c.rng = case_seed(opt->seed, sk->kernel.name, c.semiring, n);
+
+                result_t r;
+                memset(&r, 0, sizeof(r));
+                if (!sk->kernel.setup(&c) || !measure(&sk->kernel, &c, opt, &r)) {
+                    fprintf(stderr, "%s/%zu/%zu threads failed: %s\n", sk->kernel.name, c.n,
+                            opt->threads[t], palma_strerror(palma_get_last_error()));
+                    failed++;
+                    case_free(&c);
+                    continue;
+                }
+
+                if (base == 0) {
+                    base = r.median;
+                    base_threads = opt->threads[t];
+                }
+
+                scaling_result_t s;
+                s.kernel = sk->kernel.name;
+                s.n = c.n;
+                s.threads = opt->threads[t];
+                s.median = r.median;
+                s.ci = r.ci;
+                s.speedup = base / r.median;
+                s.efficiency = s.speedup * (double)base_threads / (double)s.threads;
+                s.bandwidth = sk->bytes(&c) / r.median;
+                s.gops = sk->work(&c) / r.median;
+
+                /* Roofline: min(peak, intensity × bandwidth) */
+                double intensity = sk->work(&c) / sk->bytes(&c);
+                double memory_roof = intensity * roofs[t].bandwidth;
+                s.memory_bound = memory_roof < roofs[t].peak;
+                s.roof = s.memory_bound ? memory_roof : roofs[t].peak;
+
+                print_scaling_result(out, opt, &s, first);
+                first = false;
+                case_free(&c);
+            }
+        }
+    }
+    print_footer(out, opt);
+    return failed ? 2 : 0;
+}
+
+/*============================================================================
+ * ALLOCATION COUNTING
+ *
+ * On glibc the driver interposes the allocator entry points and forwards to
+ * the __libc_* implementations, counting calls while latency mode records.
+ * Sanitizer builds bring their own allocator, so counting is off there.
+ *============================================================================*/
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_COUNT_ALLOCS 1
+#else
+#define BENCH_COUNT_ALLOCS 0
+#endif
+
+#if BENCH_COUNT_ALLOCS
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void *ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+
+static int alloc_counting;
+static uint64_t alloc_count;
+
+static inline void count_alloc(void) {
+    if (__atomic_load_n(&alloc_counting, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void* malloc(size_t size) {
+    count_alloc();
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    count_alloc();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void *ptr, size_t size) {
+    count_alloc();
+    return __libc_realloc(ptr, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    count_alloc();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    count_alloc();
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1))) return EINVAL;
+    void *p = __libc_memalign(alignment, size);
+    if (!p && size) return ENOMEM;
+    *out = p;
+    return 0;
+}
+
+static void alloc_counting_begin(void) {
+    __atomic_store_n(&alloc_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&alloc_counting, 1, __ATOMIC_SEQ_CST);
+}
+
+static uint64_t alloc_counting_end(void) {
+    __atomic_store_n(&alloc_counting, 0, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+}
+
+#else
+
+static void alloc_counting_begin(void) {}
+static uint64_t alloc_counting_end(void) { return UINT64_MAX; }
+
+#endif
+
+/*============================================================================
+ * LATENCY MODE
+ *
+ * --latency times every call of the real-time paths separately and records
+ * it in a log-linear histogram: values below 2048 ns are exact, larger ones
+ * fall into 1024 sub-buckets per power of two, so any percentile is within
+ * 0.1% of the true sample. The recorded loop also counts heap allocations,
+ * page faults and context switches, none of which a deterministic path
+ * should show once warmed up.
+ *============================================================================*/
+
+#define HIST_SUB_BITS   10
+#define HIST_SUB        (1u << HIST_SUB_BITS)          /* 1024 */
+#define HIST_MAX_SHIFT  30                              /* Values up to 2^41 ns */
+#define HIST_BUCKETS    ((HIST_MAX_SHIFT + 2) * HIST_SUB)
+
+typedef struct {
+    uint64_t *counts;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+} histogram_t;
+
+static size_t hist_index(uint64_t v) {
+    if (v < 2 * HIST_SUB) return (size_t)v;
+    unsigned shift = (unsigned)(63 - __builtin_clzll(v)) - HIST_SUB_BITS;
+    if (shift > HIST_MAX_SHIFT) return HIST_BUCKETS - 1;
+    return (size_t)shift * HIST_SUB + (size_t)(v >> shift);
+}
+
+/* Largest value that lands in bucket idx */
+static uint64_t hist_value(size_t idx) {
+    if (idx < 2 * HIST_SUB) return idx;
+    unsigned shift = (unsigned)(idx / HIST_SUB) - 1;
+    uint64_t m = idx - (uint64_t)shift * HIST_SUB;
+    return ((m + 1) << shift) - 1;
+}
+
+static bool hist_init(histogram_t *h) {
+    memset(h, 0, sizeof(*h));
+    h->counts = (uint64_t*)malloc(HIST_BUCKETS * sizeof(uint64_t));
+    if (!h->counts) return false;
+    /* Written, not just allocated, so recording takes no page faults */
+    memset(h->counts, 0, HIST_BUCKETS * sizeof(uint64_t));
+    h->min = UINT64_MAX;
+    return true;
+}
+
+static inline void hist_record(histogram_t *h, uint64_t v) {
+    h->counts[hist_index(v)]++;
+    h->total++;
+    h->sum += (double)v;
+    if (v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+}
+
+static uint64_t hist_percentile(const histogram_t *h, double p) {
+    uint64_t rank = (uint64_t)ceil(p / 100.0 * (double)h->total);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t v = hist_value(i);
+            return v > h->max ? h->max : v;
+        }
+    }
+    return h->max;
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Smallest back-to-back clock reading: included in every sample */
+static uint64_t timer_overhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t t0 = now_ns(), t1 = now_ns();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    return best;
+}
+
+static const double latency_percentiles[] = { 50, 90, 99, 99.9, 99.99, 99.999 };
+#define N_LATENCY_PERCENTILES (sizeof(latency_percentiles) / sizeof(latency_percentiles[0]))
+
+static const kernel_t latency_kernels[] = {
+    { "scheduler_solve", 0, NULL, setup_scheduler, run_scheduler, "maxplus", 0 },
+    { "matvec",          0, NULL, setup_dense,     run_matvec,    "maxplus", 0 },
+    { "closure",         0, NULL, setup_dag,       run_closure,   "maxplus", 0 },
+};
+
+#define N_LATENCY_KERNELS (sizeof(latency_kernels) / sizeof(latency_kernels[0]))
+
+typedef struct {
+    const char *kernel;
+    size_t n;
+    uint64_t percentile[N_LATENCY_PERCENTILES];
+    uint64_t allocs;            /* Heap allocations in the recorded loop (UINT64_MAX = not counted) */
+    long minor_faults;
+    long major_faults;
+    long voluntary_switches;
+    long involuntary_switches;
+} latency_result_t;
+
+static bool latency_clean(const latency_result_t *r) {
+    return (r->allocs == 0 || r->allocs == UINT64_MAX) && r->minor_faults == 0 && r->major_faults == 0;
+}
+
+/* Pin, raise priority and lock memory as requested; report what took effect */
+static void latency_environment(const options_t *opt, char *desc, size_t len) {
+    size_t used = (size_t)snprintf(desc, len, "cpu %s", opt->cpu >= 0 ? "" : "any");
+
+    if (opt->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opt->cpu, &set);
+        bool ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+        used += (size_t)snprintf(desc + used, len - used, "%d%s", opt->cpu, ok ? "" : " (failed)");
+    }
+    if (opt->fifo > 0) {
+        struct sched_param sp;
+        memset(&sp, 0, sizeof(sp));
+        sp.sched_priority = opt->fifo;
+        bool ok = sched_setscheduler(0, SCHED_FIFO, &sp) == 0;
+        used += (size_t)snprintf(desc + used, len - used, ", SCHED_FIFO %d%s", opt->fifo,
+                                 ok ? "" : " (failed)");
+    }
+    if (opt->mlock) {
+        bool ok = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+        snprintf(desc + used, len - used, ", mlockall%s", ok ? "" : " (failed)");
+    }
+}
+
+static void print_latency_header(FILE *fp, const options_t *opt, const char *env, uint64_t overhead) {
+    switch (opt->format) {
+    case FORMAT_JSON:
+        fprintf(fp, "{\n  \"palma_bench\": 1,\n  \"mode\": \"latency\",\n  \"version\": ");
+        json_string(fp, palma_version());
+        fprintf(fp, ",\n  \"config\": ");
+        json_string(fp, palma_build_config());
+        fprintf(fp, ",\n  \"environment\": ");
+        json_string(fp, env);
+        fprintf(fp, ",\n  \"iterations\": %zu,\n  \"timer_overhead_ns\": %llu,\n  \"results\": [\n",
+                opt->iterations, (unsigned long long)overhead);
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "kernel,n,min_ns");
+        for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+            fprintf(fp, ",p%g_ns", latency_percentiles[i]);
+        }
+        fprintf(fp, ",max_ns,mean_ns,allocs,minor_faults,major_faults,voluntary_cs,involuntary_cs\n");
+        break;
+    case FORMAT_TEXT:
+        fprintf(fp, "PALMA %s (%s)\n%s, %zu iterations, timer overhead %llu ns (included)\n\n",
+                palma_version(), palma_build_config(), env, opt->iterations,
+                (unsigned long long)overhead);
+        fprintf(fp, "%-16s %4s %8s", "kernel", "n", "min");
+        for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+            char name[16];
+            snprintf(name, sizeof(name), "p%g", latency_percentiles[i]);
+            fprintf(fp, " %9s", name);
+        }
+        fprintf(fp, " %10s %7s %7s %9s\n", "max", "allocs", "faults", "ctx-sw");
+        break;
+    }
+}
+
+static void print_latency_result(FILE *fp, const options_t *opt, const latency_result_t *r,
+                                 const histogram_t *h, bool first) {
+    char allocs[24];
+    if (r->allocs == UINT64_MAX) snprintf(allocs, sizeof(allocs), "n/a");
+    else snprintf(allocs, sizeof(allocs), "%llu", (unsigned long long)r->allocs);
+
+    switch (opt->format) {
+    case FORMAT_JSON:
+        fprintf(fp, "%s    {\"kernel\": \"%s\", \"n\": %zu, \"count\": %llu, \"min_ns\": %llu, ",
+                first ? "" : ",\n", r->kernel, r->n, (unsigned long long)h->total,
+                (unsigned long long)h->min);
+        for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+            fprintf(fp, "\"p%g_ns\": %llu, ", latency_percentiles[i],
+                    (unsigned long long)r->percentile[i]);
+        }
+        fprintf(fp, "\"max_ns\": %llu, \"mean_ns\": %.1f, \"allocs\": %s, \"minor_faults\": %ld, "
+                    "\"major_faults\": %ld, \"voluntary_cs\": %ld, \"involuntary_cs\": %ld, "
+                    "\"clean\": %s,\n      \"histogram\": [",
+                (unsigned long long)h->max, h->sum / (double)h->total,
+                r->allocs == UINT64_MAX ? "null" : allocs, r->minor_faults, r->major_faults,
+                r->voluntary_switches, r->involuntary_switches, latency_clean(r) ? "true" : "false");
+        /* Non-empty buckets as [highest equivalent value, count] */
+        bool any = false;
+        for (size_t i = 0; i < HIST_BUCKETS; i++) {
+            if (!h->counts[i]) continue;
+            fprintf(fp, "%s[%llu, %llu]", any ? ", " : "", (unsigned long long)hist_value(i),
+                    (unsigned long long)h->counts[i]);
+            any = true;
+        }
+        fprintf(fp, "]}");
+        break;
+    case FORMAT_CSV:
+        fprintf(fp, "%s,%zu,%llu", r->kernel, r->n, (unsigned long long)h->min);
+        for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+            fprintf(fp, ",%llu", (unsigned long long)r->percentile[i]);
+        }
+        fprintf(fp, ",%llu,%.1f,%s,%ld,%ld,%ld,%ld\n", (unsigned long long)h->max,
+                h->sum / (double)h->total, allocs, r->minor_faults, r->major_faults,
+                r->voluntary_switches, r->involuntary_switches);
+        break;
+    case FORMAT_TEXT: {
+        char buf[32];
+        format_ns(buf, sizeof(buf), (double)h->min);
+        fprintf(fp, "%-16s %4zu %8s", r->kernel, r->n, buf);
+        for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+            format_ns(buf, sizeof(buf), (double)r->percentile[i]);
+            fprintf(fp, " %9s", buf);
+        }
+        format_ns(buf, sizeof(buf), (double)h->max);
+        fprintf(fp, " %10s %7s %7ld %9ld%s\n", buf, allocs, r->minor_faults + r->major_faults,
+                r->voluntary_switches + r->involuntary_switches,
+                latency_clean(r) ? "" : "  <- allocates or faults on the hot path");
+        break;
+    }
+    }
+    fflush(fp);
+}
+
+static int run_latency(const options_t *opt, FILE *out) {
+    char env[128];
+    latency_environment(opt, env, sizeof(env));
+    print_latency_header(out, opt, env, timer_overhead());
+
+    size_t failed = 0, dirty = 0;
+    bool first = true;
+    for (size_t k = 0; k < N_LATENCY_KERNELS; k++) {
+        const kernel_t *kernel = &latency_kernels[k];
+        if (opt->filter && !strstr(kernel->name, opt->filter)) continue;
+
+        for (size_t ni = 0; ni < opt->n_sizes; ni++) {
+            bench_case_t c;
+            memset(&c, 0, sizeof(c));
+            c.n = opt->sizes[ni];
+            semiring_from_key(kernel->semiring, &c.semiring);
+            c.rng = case_seed(opt->seed, kernel->name, c.semiring, c.n);
+
+            histogram_t h;
+            bool ok = hist_init(&h) && kernel->setup(&c);
+
+            /* Warm-up: caches, branch predictors, lazily mapped pages */
+            double start = now_sec();
+            while (ok && now_sec() - start < opt->warmup) ok = kernel->run(&c) == 0;
+
+            struct rusage before, after;
+            /* Whole process: OpenMP workers fault and switch too */
+            getrusage(RUSAGE_SELF, &before);
+            alloc_counting_begin();
+            for (size_t i = 0; ok && i < opt->iterations; i++) {
+                uint64_t t0 = now_ns();
+                ok = kernel->run(&c) == 0;
+                uint64_t t1 = now_ns();
+                hist_record(&h, t1 - t0);
+            }
+            uint64_t allocs = alloc_counting_end();
+            getrusage(RUSAGE_SELF, &after);
+
+            if (!ok || h.total == 0) {
+                fprintf(stderr, "%s/%zu failed: %s\n", kernel->name, c.n,
+                        palma_strerror(palma_get_last_error()));
+                failed++;
+            } else {
+                latency_result_t r;
+                r.kernel = kernel->name;
+                r.n = c.n;
+                for (size_t i = 0; i < N_LATENCY_PERCENTILES; i++) {
+                    r.percentile[i] = hist_percentile(&h, latency_percentiles[i]);
+                }
+                r.allocs = allocs;
+                r.minor_faults = after.ru_minflt - before.ru_minflt;
+                r.major_faults = after.ru_majflt - before.ru_majflt;
+                r.voluntary_switches = after.ru_nvcsw - before.ru_nvcsw;
+                r.involuntary_switches = after.ru_nivcsw - before.ru_nivcsw;
+                if (!latency_clean(&r)) dirty++;
+
+                print_latency_result(out, opt, &r, &h, first);
+                first = false;
+            }
+            free(h.counts);
+            case_free(&c);
+        }
+    }
+    print_footer(out, opt);
+
+    if (failed) return 2;
+    return (opt->strict && dirty) ? 1 : 0;
+}
+
+/*============================================================================
+ * MAIN
+ *============================================================================*/
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-f filter] [-n sizes] [-s semiring|all] [--seed N] [--warmup SEC]\n"
+            "       [--min-reps N] [--max-reps N] [--max-time SEC] [--ci FRACTION]\n"
+            "       [-o text|json|csv] [-w file] [-c baseline.json] [-t threshold] [-l]\n"
+            "       [--scaling] [--threads N,N,...] [--numa none|first-touch|interleave] [--bind]\n"
+            "       [--latency] [--iterations N] [--cpu N] [--fifo PRIO] [--mlock] [--strict]\n"
+            "       [--counters]\n",
+            prog);
+}
+
+/* Comma-separated positive integers */
+static bool parse_list(const char *arg, size_t *out, size_t max, size_t *count) {
+    *count = 0;
+    char *end;
+    while (*arg && *count < max) {
+        unsigned long n = strtoul(arg, &end, 10);
+        if (end == arg || n == 0) return false;
+        out[(*count)++] = n;
+        arg = (*end == ',') ? end + 1 : end;
+        if (end == arg && *arg) return false;
+    }
+    return *count > 0;
+}
+
+static int cmp_size(const void *a, const void *b) {
+    size_t x = *(const size_t*)a, y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
+static bool parse_semiring_arg(const char *arg, options_t *opt) {
+    size_t all = sizeof(semiring_names) / sizeof(semiring_names[0]);
+    opt->n_semirings = 0;
+    for (size_t i = 0; i < all; i++) {
+        if (strcmp(arg, "all") == 0 || strcmp(arg, semiring_names[i].name) == 0) {
+            opt->semirings[opt->n_semirings++] = semiring_names[i].s;
+        }
+    }
+    return opt->n_semirings > 0;
+}
+
+int main(int argc, char **argv) {
+    options_t opt = {
+        .filter = NULL, .sizes = { 16, 64, 256 }, .n_sizes = 3,
+        .semirings = { PALMA_MAXPLUS }, .n_semirings = 1, .seed = 42,
+        .warmup = 0.05, .min_reps = 10, .max_reps = 1000, .max_time = 2.0,
+        .target_ci = 0.02, .format = FORMAT_TEXT, .output = NULL, .baseline = NULL,
+        .threshold = 0.05, .scaling = false, .n_threads = 0, .numa = -1, .bind = false,
+        .latency = false, .iterations = 1000000, .cpu = -1, .fifo = 0, .mlock = false,
+        .strict = false, .counters = false
+    };
+    bool list = false, sizes_given = false;
+
+    enum {
+        OPT_SEED = 256, OPT_WARMUP, OPT_MIN_REPS, OPT_MAX_REPS, OPT_MAX_TIME, OPT_CI,
+        OPT_SCALING, OPT_THREADS, OPT_NUMA, OPT_BIND, OPT_LATENCY, OPT_ITERATIONS, OPT_CPU,
+        OPT_FIFO, OPT_MLOCK, OPT_STRICT, OPT_COUNTERS
+    };
+    static const struct option long_opts[] = {
+        { "filter", required_argument, NULL, 'f' },
+        { "sizes", required_argument, NULL, 'n' },
+        { "semiring", required_argument, NULL, 's' },
+        { "seed", required_argument, NULL, OPT_SEED },
+        { "warmup", required_argument, NULL, OPT_WARMUP },
+        { "min-reps", required_argument, NULL, OPT_MIN_REPS },
+        { "max-reps", required_argument, NULL, OPT_MAX_REPS },
+        { "max-time", required_argument, NULL, OPT_MAX_TIME },
+        { "ci", required_argument, NULL, OPT_CI },
+        { "format", required_argument, NULL, 'o' },
+        { "output", required_argument, NULL, 'w' },
+        { "compare", required_argument, NULL, 'c' },
+        { "threshold", required_argument, NULL, 't' },
+        { "list", no_argument, NULL, 'l' },
+        { "scaling", no_argument, NULL, OPT_SCALING },
+        { "threads", required_argument, NULL, OPT_THREADS },
+        { "numa", required_argument, NULL, OPT_NUMA },
+        { "bind", no_argument, NULL, OPT_BIND },
+        { "latency", no_argument, NULL, OPT_LATENCY },
+        { "iterations", required_argument, NULL, OPT_ITERATIONS },
+        { "cpu", required_argument, NULL, OPT_CPU },
+        { "fifo", required_argument, NULL, OPT_FIFO },
+        { "mlock", no_argument, NULL, OPT_MLOCK },
+        { "strict", no_argument, NULL, OPT_STRICT },
+        { "counters", no_argument, NULL, OPT_COUNTERS },
+        { NULL, 0, NULL, 0 }
+    };
+
+    int ch;
+    while ((ch = getopt_long(argc, argv, "f:n:s:o:w:c:t:l", long_opts, NULL)) != -1) {
+        bool ok = true;
+        switch (ch) {
+        case 'f': opt.filter = optarg; break;
+        case 'n':
+            ok = parse_list(optarg, opt.sizes, MAX_SIZES, &opt.n_sizes);
+            sizes_given = true;
+            break;
+        case 's': ok = parse_semiring_arg(optarg, &opt); break;
+        case OPT_SEED: opt.seed = strtoull(optarg, NULL, 0); break;
+        case OPT_WARMUP: opt.warmup = atof(optarg); break;
+        case OPT_MIN_REPS: opt.min_reps = strtoul(optarg, NULL, 10); break;
+        case OPT_MAX_REPS: opt.max_reps = strtoul(optarg, NULL, 10); break;
+        case OPT_MAX_TIME: opt.max_time = atof(optarg); break;
+        case OPT_CI: opt.target_ci = atof(optarg); break;
+        case 'o':
+            if (strcmp(optarg, "json") == 0) opt.format = FORMAT_JSON;
+            else if (strcmp(optarg, "csv") == 0) opt.format = FORMAT_CSV;
+            else if (strcmp(optarg, "text") == 0) opt.format = FORMAT_TEXT;
+            else ok = false;
+            break;
+        case 'w': opt.output = optarg; break;
+        case 'c': opt.baseline = optarg; break;
+        case 't': opt.threshold = atof(optarg); break;
+        case 'l': list = true; break;
+        case OPT_SCALING: opt.scaling = true; break;
+        case OPT_THREADS: ok = parse_list(optarg, opt.threads, MAX_THREADS_LIST, &opt.n_threads); break;
+        case OPT_NUMA:
+            if (strcmp(optarg, "none") == 0) opt.numa = PALMA_NUMA_NONE;
+            else if (strcmp(optarg, "first-touch") == 0) opt.numa = PALMA_NUMA_FIRST_TOUCH;
+            else if (strcmp(optarg, "interleave") == 0) opt.numa = PALMA_NUMA_INTERLEAVE;
+            else ok = false;
+            break;
+        case OPT_BIND: opt.bind = true; break;
+        case OPT_LATENCY: opt.latency = true; break;
+        case OPT_ITERATIONS: opt.iterations = strtoul(optarg, NULL, 10); ok = opt.iterations > 0; break;
+        case OPT_CPU: opt.cpu = atoi(optarg); ok = opt.cpu >= 0; break;
+        case OPT_FIFO: opt.fifo = atoi(optarg); ok = opt.fifo >= 1 && opt.fifo <= 99; break;
+        case OPT_MLOCK: opt.mlock = true; break;
+        case OPT_STRICT: opt.strict = true; break;
+        case OPT_COUNTERS: opt.counters = true; break;
+        default: ok = false; break;
+        }
+        if (!ok) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (opt.min_reps < 2) opt.min_reps = 2;
+    if (opt.max_reps < opt.min_reps) opt.max_reps = opt.min_reps;
+
+    if (opt.numa >= 0) {
+        palma_alloc_policy_t policy;
+        palma_get_alloc_policy(&policy);
+        policy.numa = (palma_numa_t)opt.numa;
+        palma_set_alloc_policy(&policy);
+    }
+    if (opt.scaling) {
+        if (opt.n_threads == 0) default_threads(&opt);
+        qsort(opt.threads, opt.n_threads, sizeof(size_t), cmp_size);
+        #if !PALMA_USE_OPENMP
+        /* Every count would time the same serial code and report fake efficiencies */
+        if (opt.threads[opt.n_threads - 1] > 1) {
+            fprintf(stderr, "built without OpenMP: scaling runs 1 thread only\n");
+            opt.threads[0] = 1;
+            opt.n_threads = 1;
+        }
+        #endif
+        if (!sizes_given) {
+            opt.sizes[0] = 128;
+            opt.sizes[1] = 512;
+            opt.n_sizes = 2;
+        }
+    }
+
+    if (opt.latency && !sizes_given) {
+        opt.sizes[0] = 8;
+        opt.sizes[1] = 16;
+        opt.sizes[2] = 32;
+        opt.n_sizes = 3;
+    }
+
+    if (list && opt.latency) {
+        for (size_t k = 0; k < N_LATENCY_KERNELS; k++) printf("%s\n", latency_kernels[k].name);
+        return 0;
+    }
+    if (list && opt.scaling) {
+        for (size_t k = 0; k < N_SCALING_KERNELS; k++) printf("%s\n", scaling_kernels[k].kernel.name);
+        return 0;
+    }
+    if (list) {
+        for (size_t k = 0; k < N_KERNELS; k++) {
+            printf("%-24s", kernels[k].name);
+            if (kernels[k].semiring) printf(" %s only", kernels[k].semiring);
+            if (kernels[k].scale) printf(", %zu nodes per size unit", kernels[k].scale);
+            if (kernels[k].max_n) printf(" (sizes <= %zu)", kernels[k].max_n);
+            printf("\n");
+        }
+        return 0;
+    }
+
+    baseline_t *base = NULL;
+    size_t n_base = 0;
+    if (opt.baseline) {
+        base = load_baseline(opt.baseline, &n_base);
+        if (!base) {
+            fprintf(stderr, "cannot read baseline %s\n", opt.baseline);
+            return 2;
+        }
+    }
+
+    FILE *out = stdout;
+    if (opt.output) {
+        out = fopen(opt.output, "w");
+        if (!out) {
+            fprintf(stderr, "cannot write %s\n", opt.output);
+            return 2;
+        }
+    }
+
+    if (opt.latency || opt.scaling) {
+        int status = opt.latency ? run_latency(&opt, out) : run_scaling(&opt, out);
+        if (out != stdout) fclose(out);
+        return status;
+    }
+
+    /* Opened before any kernel runs, so the OpenMP team inherits the counters */
+    palma_profiler_t *prof = NULL;
+    if (opt.counters) {
+        prof = palma_profiler_create();
+        if (prof) {
+            for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+                if (!palma_profiler_has(prof, (palma_counter_t)i)) {
+                    fprintf(stderr, "counter %s not available\n", palma_counter_name((palma_counter_t)i));
+                }
+            }
+        } else {
+            fprintf(stderr, "hardware counters unavailable (%s); check perf_event_paranoid\n",
+                    palma_strerror(palma_get_last_error()));
+        }
+    }
+
+    /* Comparison verdicts go to stderr when results go to stdout as data */
+    FILE *report = (opt.format == FORMAT_TEXT && out == stdout) ? stdout : stderr;
+    size_t slower = 0, faster = 0, failed = 0;
+    bool first = true;
+
+    print_header(out, &opt);
+    for (size_t k = 0; k < N_KERNELS; k++) {
+        const kernel_t *kernel = &kernels[k];
+        if (opt.filter && !strstr(kernel->name, opt.filter)) continue;
+
+        palma_semiring_t only;
+        bool fixed = kernel->semiring && semiring_from_key(kernel->semiring, &only);
+
+        for (size_t si = 0; si < (fixed ? 1 : opt.n_semirings); si++) {
+            for (size_t ni = 0; ni < opt.n_sizes; ni++) {
+                size_t n = opt.sizes[ni] * (kernel->scale ? kernel->scale : 1);
+                if (kernel->max_n && opt.sizes[ni] > kernel->max_n) continue;
+
+                bench_case_t c;
+                memset(&c, 0, sizeof(c));
+                c.n = n;
+                c.semiring = fixed ? only : opt.semirings[si];
+                c.rng = case_seed(opt.seed, kernel->name, c.semiring, n);
+
+                result_t r;
+                memset(&r, 0, sizeof(r));
+                r.kernel = kernel->name;
+                r.semiring = semiring_key(c.semiring);
+
+                if (kernel->setup(&c)) {
+                    r.n = n = c.n;
+                    if (measure(kernel, &c, &opt, &r) && (!prof || count_events(prof, kernel, &c, &r))) {
+                        print_result(out, &opt, &r, first);
+                        first = false;
+
+                        double ratio;
+                        verdict_t v = base ? compare(base, n_base, &r, opt.threshold, &ratio) : VERDICT_SAME;
+                        if (v == VERDICT_SLOWER || v == VERDICT_FASTER) {
+                            fprintf(report, "  %s: %s/%s/%zu %.2fx the baseline median\n",
+                                    v == VERDICT_SLOWER ? "REGRESSION" : "improvement",
+                                    r.kernel, r.semiring, n, ratio);
+                            if (v == VERDICT_SLOWER) slower++;
+                            else faster++;
+                        }
+                    } else {
+                        fprintf(stderr, "%s/%s/%zu failed: %s\n", kernel->name, r.semiring, n,
+                                palma_strerror(palma_get_last_error()));
+                        failed++;
+                    }
+                }
+                case_free(&c);
+            }
+        }
+    }
+    print_footer(out, &opt);
+    if (out != stdout) fclose(out);
+    palma_profiler_destroy(prof);
+
+    if (base) {
+        fprintf(report, "\ncompared with %s: %zu regression(s), %zu improvement(s)\n",
+                opt.baseline, slower, faster);
+        free(base);
+    }
+    if (failed) return 2;
+    return slower ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file palma_client.c
+ * @brief PALMA Query Client - Unix socket connection to palma_server
+ *
+ * Thin blocking transport for the protocol described in palma.h. Requests
+ * are written as one header plus a batch of items; responses are read back
+ * in the same order, which is what makes pipelining work: several sends may
+ * precede the matching receives.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+struct palma_client {
+    int fd;
+    uint32_t next_id;
+};
+
+/*============================================================================
+ * TRANSPORT
+ *============================================================================*/
+
+/* sendmsg() rather than writev() so a closed server yields an error, not SIGPIPE */
+static palma_error_t write_all(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)iovcnt;
+
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return PALMA_ERR_FILE_WRITE;
+        }
+
+        /* Skip fully written buffers, advance into a partial one */
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return PALMA_SUCCESS;
+}
+
+static palma_error_t read_all(int fd, void *buf, size_t len) {
+    char *p = (char*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return PALMA_ERR_FILE_READ;
+        p += n;
+        len -= (size_t)n;
+    }
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * CONNECTION
+ *============================================================================*/
+
+palma_client_t* palma_client_connect(const char *path) {
+    if (!path) path = PALMA_QUERY_SOCKET;
+
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    palma_client_t *client = (palma_client_t*)calloc(1, sizeof(palma_client_t));
+    if (!client) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    client->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (client->fd < 0 || connect(client->fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        if (client->fd >= 0) close(client->fd);
+        free(client);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_OPEN);
+    }
+
+    return client;
+}
+
+void palma_client_close(palma_client_t *client) {
+    if (!client) return;
+    close(client->fd);
+    free(client);
+}
+
+/*============================================================================
+ * REQUESTS
+ *============================================================================*/
+
+static size_t item_width(palma_query_op_t op) {
+    return (op == PALMA_QUERY_DISTANCE || op == PALMA_QUERY_REACHABLE) ? 2 : 1;
+}
+
+palma_error_t palma_client_send(palma_client_t *client, palma_query_op_t op, uint32_t model,
+                                const uint32_t *items, size_t count, uint32_t *id) {
+    if (!client || (count > 0 && !items)) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if ((unsigned)op > PALMA_QUERY_CYCLE_TIME || count > PALMA_QUERY_MAX_ITEMS) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    }
+
+    palma_query_header_t hdr;
+    hdr.magic = PALMA_QUERY_MAGIC;
+    hdr.op = (uint16_t)op;
+    hdr.status = 0;
+    hdr.id = client->next_id++;
+    hdr.model = model;
+    hdr.count = (uint32_t)count;
+
+    struct iovec iov[2];
+    iov[0].iov_base = &hdr;
+    iov[0].iov_len = sizeof(hdr);
+    iov[1].iov_base = (void*)items;
+    iov[1].iov_len = count * item_width(op) * sizeof(uint32_t);
+
+    palma_error_t err = write_all(client->fd, iov, count > 0 ? 2 : 1);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    if (id) *id = hdr.id;
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_client_receive(palma_client_t *client, uint32_t *id, palma_val_t *values,
+                                   size_t capacity, size_t *count) {
+    if (!client) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    palma_query_header_t hdr;
+    palma_error_t err = read_all(client->fd, &hdr, sizeof(hdr));
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    if (hdr.magic != PALMA_QUERY_MAGIC) PALMA_RETURN_ERROR(PALMA_ERR_FILE_FORMAT);
+
+    if (id) *id = hdr.id;
+    if (count) *count = hdr.count;
+
+    if (hdr.count > 0 && (!values || hdr.count > capacity)) {
+        /* Keep the stream in sync: drain the payload before failing */
+        palma_val_t sink[256];
+        size_t left = hdr.count;
+        while (left > 0 && err == PALMA_SUCCESS) {
+            size_t chunk = left < 256 ? left : 256;
+            err = read_all(client->fd, sink, chunk * sizeof(palma_val_t));
+            left -= chunk;
+        }
+        PALMA_RETURN_ERROR(err != PALMA_SUCCESS ? err : PALMA_ERR_INVALID_DIM);
+    }
+
+    err = read_all(client->fd, values, hdr.count * sizeof(palma_val_t));
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    if (hdr.status != PALMA_SUCCESS) PALMA_RETURN_ERROR((palma_error_t)hdr.status);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_client_query(palma_client_t *client, palma_query_op_t op, uint32_t model,
+                                 const uint32_t *items, size_t count, palma_val_t *values,
+                                 size_t capacity, size_t *n_values) {
+    palma_error_t err = palma_client_send(client, op, model, items, count, NULL);
+    if (err != PALMA_SUCCESS) return err;
+    return palma_client_receive(client, NULL, values, capacity, n_values);
+}
@@ -0,0 +1,380 @@
+/**
+ * @file palma_dynsparse.c
+ * @brief PALMA Dynamic Sparse Matrices - CSR base plus hashed delta buffer
+ *
+ * Updates of entries already present in the base are written in place.
+ * Inserts and deletes go to an open-addressing hash table keyed by
+ * (row, col); a delete is recorded as the semiring zero. When the buffer
+ * reaches a quarter of nnz + rows (and at least DYN_MIN_MERGE entries), it
+ * is bucketed by row, sorted within rows and merged with the base into a
+ * second CSR buffer, which then becomes the base. A merge costs
+ * O(nnz + rows + pending) and happens at most once per Θ(nnz + rows)
+ * changes, so every change is O(1) amortized.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*============================================================================
+ * TYPES
+ *============================================================================*/
+
+#define DYN_EMPTY      UINT64_MAX
+#define DYN_MIN_MERGE  256
+#define DYN_MIN_SLOTS  512
+
+typedef struct {
+    uint64_t key;               /* (row << 32) | col, DYN_EMPTY if unused */
+    palma_val_t val;            /* Semiring zero = delete */
+} delta_t;
+
+struct palma_dynsparse {
+    palma_sparse_t *base;
+    palma_sparse_t *spare;      /* Merge target, swapped with base */
+    delta_t *slots;
+    size_t n_slots;             /* Power of two */
+    unsigned slot_bits;
+    size_t pending;
+    size_t nnz;
+    palma_val_t zero;
+    delta_t *sorted;            /* Merge scratch, n_slots / 2 entries */
+    size_t *row_start;          /* Merge scratch, rows + 1 entries */
+};
+
+static inline uint64_t dyn_key(size_t row, size_t col) {
+    return ((uint64_t)row << 32) | (uint64_t)col;
+}
+
+/*============================================================================
+ * DELTA BUFFER
+ *============================================================================*/
+
+static inline size_t dyn_hash(const palma_dynsparse_t *D, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> (64 - D->slot_bits));
+}
+
+static delta_t* delta_find(const palma_dynsparse_t *D, uint64_t key) {
+    size_t mask = D->n_slots - 1;
+    for (size_t h = dyn_hash(D, key);; h = (h + 1) & mask) {
+        if (D->slots[h].key == key) return &D->slots[h];
+        if (D->slots[h].key == DYN_EMPTY) return NULL;
+    }
+}
+
+static void delta_clear(delta_t *slots, size_t n) {
+    for (size_t i = 0; i < n; i++) slots[i].key = DYN_EMPTY;
+}
+
+/* Allocate n_slots slots and matching scratch; keeps the old table on failure */
+static palma_error_t delta_alloc(palma_dynsparse_t *D, unsigned bits) {
+    size_t n = (size_t)1 << bits;
+    delta_t *slots = (delta_t*)malloc(n * sizeof(delta_t));
+    delta_t *sorted = (delta_t*)malloc((n / 2) * sizeof(delta_t));
+    if (!slots || !sorted) {
+        free(slots);
+        free(sorted);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+    delta_clear(slots, n);
+
+    /* Rehash existing entries */
+    delta_t *old = D->slots;
+    size_t old_n = D->n_slots;
+    D->slots = slots;
+    D->n_slots = n;
+    D->slot_bits = bits;
+    for (size_t i = 0; i < old_n; i++) {
+        if (old[i].key == DYN_EMPTY) continue;
+        size_t h = dyn_hash(D, old[i].key);
+        while (slots[h].key != DYN_EMPTY) h = (h + 1) & (n - 1);
+        slots[h] = old[i];
+    }
+
+    free(old);
+    free(D->sorted);
+    D->sorted = sorted;
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * BASE ACCESS
+ *============================================================================*/
+
+/* Position of (row, col) in the base, or -1 */
+static ptrdiff_t base_find(const palma_sparse_t *B, size_t row, size_t col) {
+    palma_ptr_t lo = B->row_ptr[row], hi = B->row_ptr[row + 1];
+    while (lo < hi) {
+        palma_ptr_t mid = lo + (hi - lo) / 2;
+        if (B->col_idx[mid] == col) return (ptrdiff_t)mid;
+        if (B->col_idx[mid] < col) lo = mid + 1;
+        else hi = mid;
+    }
+    return -1;
+}
+
+static palma_error_t reserve(palma_sparse_t *S, size_t needed) {
+    if (needed <= S->capacity) return PALMA_SUCCESS;
+    size_t cap = S->capacity * 2;
+    if (cap < needed) cap = needed;
+
+    palma_val_t *values = (palma_val_t*)realloc(S->values, cap * sizeof(palma_val_t));
+    if (!values) return PALMA_ERR_OUT_OF_MEMORY;
+    S->values = values;
+    palma_idx_t *col_idx = (palma_idx_t*)realloc(S->col_idx, cap * sizeof(palma_idx_t));
+    if (!col_idx) return PALMA_ERR_OUT_OF_MEMORY;
+    S->col_idx = col_idx;
+    S->capacity = cap;
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * LIFECYCLE
+ *============================================================================*/
+
+palma_dynsparse_t* palma_dynsparse_create(size_t rows, size_t cols, palma_semiring_t semiring) {
+    if (rows == 0 || cols == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    if (rows > UINT32_MAX || cols > UINT32_MAX) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+
+    palma_dynsparse_t *D = (palma_dynsparse_t*)calloc(1, sizeof(palma_dynsparse_t));
+    if (!D) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    D->zero = palma_zero(semiring);
+    D->base = palma_sparse_create(rows, cols, 0, semiring);
+    D->spare = palma_sparse_create(rows, cols, 0, semiring);
+    D->row_start = (size_t*)malloc((rows + 1) * sizeof(size_t));
+
+    unsigned bits = 0;
+    while (((size_t)1 << bits) < DYN_MIN_SLOTS) bits++;
+
+    if (!D->base || !D->spare || !D->row_start || delta_alloc(D, bits) != PALMA_SUCCESS) {
+        palma_dynsparse_destroy(D);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+    return D;
+}
+
+palma_dynsparse_t* palma_dynsparse_from_sparse(const palma_sparse_t *S) {
+    if (!S) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    palma_dynsparse_t *D = palma_dynsparse_create(S->rows, S->cols, S->semiring);
+    if (!D) return NULL;
+
+    /* Copy without stored zeros */
+    palma_sparse_t *B = D->base;
+    if (reserve(B, S->nnz) != PALMA_SUCCESS) {
+        palma_dynsparse_destroy(D);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+    size_t k = 0;
+    for (size_t i = 0; i < S->rows; i++) {
+        B->row_ptr[i] = (palma_ptr_t)k;
+        for (palma_ptr_t p = S->row_ptr[i]; p < S->row_ptr[i + 1]; p++) {
+            if (S->values[p] == D->zero) continue;
+            B->values[k] = S->values[p];
+            B->col_idx[k] = S->col_idx[p];
+            k++;
+        }
+    }
+    B->row_ptr[S->rows] = (palma_ptr_t)k;
+    B->nnz = k;
+    D->nnz = k;
+    return D;
+}
+
+void palma_dynsparse_destroy(palma_dynsparse_t *D) {
+    if (!D) return;
+    palma_sparse_destroy(D->base);
+    palma_sparse_destroy(D->spare);
+    free(D->slots);
+    free(D->sorted);
+    free(D->row_start);
+    free(D);
+}
+
+/*============================================================================
+ * MERGE
+ *============================================================================*/
+
+static void sort_row_segment(delta_t *a, size_t n) {
+    /* Rows rarely collect many changes between merges */
+    for (size_t i = 1; i < n; i++) {
+        delta_t x = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1].key > x.key) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+static int cmp_delta(const void *a, const void *b) {
+    uint64_t x = ((const delta_t*)a)->key, y = ((const delta_t*)b)->key;
+    return (x > y) - (x < y);
+}
+
+palma_error_t palma_dynsparse_merge(palma_dynsparse_t *D) {
+    if (!D) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (D->pending == 0) return PALMA_SUCCESS;
+
+    palma_sparse_t *B = D->base, *C = D->spare;
+    size_t rows = B->rows;
+
+    if (B->nnz + D->pending > PALMA_PTR_MAX) PALMA_RETURN_ERROR(PALMA_ERR_OVERFLOW);
+    palma_error_t err = reserve(C, B->nnz + D->pending);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    /* Bucket the delta by row (counting sort), then sort each bucket by column */
+    size_t *start = D->row_start;
+    memset(start, 0, (rows + 1) * sizeof(size_t));
+    for (size_t s = 0; s < D->n_slots; s++) {
+        if (D->slots[s].key != DYN_EMPTY) start[(D->slots[s].key >> 32) + 1]++;
+    }
+    for (size_t i = 0; i < rows; i++) start[i + 1] += start[i];
+    for (size_t s = 0; s < D->n_slots; s++) {
+        if (D->slots[s].key != DYN_EMPTY) D->sorted[start[D->slots[s].key >> 32]++] = D->slots[s];
+    }
+    /* start[i] now holds the end of bucket i */
+
+    size_t k = 0, d = 0;
+    for (size_t i = 0; i < rows; i++) {
+        size_t d_end = start[i];
+        size_t n = d_end - d;
+        if (n > 32) qsort(D->sorted + d, n, sizeof(delta_t), cmp_delta);
+        else if (n > 1) sort_row_segment(D->sorted + d, n);
+
+        C->row_ptr[i] = (palma_ptr_t)k;
+        palma_ptr_t p = B->row_ptr[i], p_end = B->row_ptr[i + 1];
+
+        /* Two-way merge; the delta wins on equal columns */
+        while (p < p_end || d < d_end) {
+            size_t bc = (p < p_end) ? B->col_idx[p] : SIZE_MAX;
+            size_t dc = (d < d_end) ? (size_t)(D->sorted[d].key & 0xFFFFFFFFu) : SIZE_MAX;
+            palma_val_t v;
+            size_t c;
+            if (dc <= bc) {
+                v = D->sorted[d].val;
+                c = dc;
+                d++;
+                if (dc == bc) p++;
+            } else {
+                v = B->values[p];
+                c = bc;
+                p++;
+            }
+            if (v == D->zero) continue;
+            C->values[k] = v;
+            C->col_idx[k] = (palma_idx_t)c;
+            k++;
+        }
+    }
+    C->row_ptr[rows] = (palma_ptr_t)k;
+    C->nnz = k;
+
+    D->base = C;
+    D->spare = B;
+    D->nnz = k;
+    D->pending = 0;
+    delta_clear(D->slots, D->n_slots);
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * ACCESS AND UPDATES
+ *============================================================================*/
+
+palma_val_t palma_dynsparse_get(const palma_dynsparse_t *D, size_t row, size_t col) {
+    if (!D) return 0;
+    if (row >= D->base->rows || col >= D->base->cols) return D->zero;
+
+    const delta_t *e = delta_find(D, dyn_key(row, col));
+    if (e) return e->val;
+
+    ptrdiff_t p = base_find(D->base, row, col);
+    return p >= 0 ? D->base->values[p] : D->zero;
+}
+
+palma_error_t palma_dynsparse_set(palma_dynsparse_t *D, size_t row, size_t col, palma_val_t val) {
+    if (!D) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (row >= D->base->rows || col >= D->base->cols) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+    uint64_t key = dyn_key(row, col);
+    delta_t *e = delta_find(D, key);
+    ptrdiff_t p = e ? -1 : base_find(D->base, row, col);
+
+    palma_val_t old = e ? e->val : (p >= 0 ? D->base->values[p] : D->zero);
+    if (old == D->zero && val != D->zero) D->nnz++;
+    if (old != D->zero && val == D->zero) D->nnz--;
+
+    if (e) {
+        e->val = val;
+        return PALMA_SUCCESS;
+    }
+    if (p >= 0 && val != D->zero) {
+        /* Update of a stored entry: in place, the structure is unchanged */
+        D->base->values[p] = val;
+        return PALMA_SUCCESS;
+    }
+    if (p < 0 && val == D->zero) return PALMA_SUCCESS;
+
+    /* Keep the load factor at most 1/2 */
+    if (2 * (D->pending + 1) > D->n_slots) {
+        palma_error_t err = delta_alloc(D, D->slot_bits + 1);
+        if (err != PALMA_SUCCESS) {
+            if (old == D->zero && val != D->zero) D->nnz--;
+            if (old != D->zero && val == D->zero) D->nnz++;
+            PALMA_RETURN_ERROR(err);
+        }
+    }
+
+    size_t h = dyn_hash(D, key);
+    while (D->slots[h].key != DYN_EMPTY) h = (h + 1) & (D->n_slots - 1);
+    D->slots[h].key = key;
+    D->slots[h].val = val;
+    D->pending++;
+
+    size_t threshold = (D->base->nnz + D->base->rows) / 4;
+    if (threshold < DYN_MIN_MERGE) threshold = DYN_MIN_MERGE;
+    if (D->pending >= threshold) {
+        /* The change is already recorded; a failed merge only postpones folding */
+        palma_dynsparse_merge(D);
+    }
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_dynsparse_remove(palma_dynsparse_t *D, size_t row, size_t col) {
+    if (!D) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    return palma_dynsparse_set(D, row, col, D->zero);
+}
+
+size_t palma_dynsparse_nnz(const palma_dynsparse_t *D) {
+    return D ? D->nnz : 0;
+}
+
+size_t palma_dynsparse_pending(const palma_dynsparse_t *D) {
+    return D ? D->pending : 0;
+}
+
+const palma_sparse_t* palma_dynsparse_view(palma_dynsparse_t *D) {
+    if (!D) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (palma_dynsparse_merge(D) != PALMA_SUCCESS) return NULL;
+    return D->base;
+}
@@ -0,0 +1,696 @@
+/**
+ * @file palma_expr.c
+ * @brief PALMA Deferred Expressions - operation graphs with fused evaluation
+ *
+ * Expressions are small trees of ⊗ and ⊕ nodes over matrix and vector
+ * leaves. Evaluation first rewrites the tree by estimated cost: product
+ * chains are flattened and ordered with the matrix-chain recurrence, and ⊗
+ * is distributed over ⊕ when the distributed form is cheaper (typically when
+ * the chain ends in a vector). The rewritten tree is then executed with one
+ * accumulating kernel, C ← C ⊕ A ⊗ B, so a sum of products never
+ * materializes the individual products. Temporaries come from a pool kept in
+ * the context; a larger free buffer serves a smaller request through a view.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/*============================================================================
+ * TYPES
+ *============================================================================*/
+
+typedef enum {
+    EXPR_LEAF,
+    EXPR_MUL,
+    EXPR_ADD
+} expr_kind_t;
+
+struct palma_expr {
+    expr_kind_t kind;
+    size_t rows;
+    size_t cols;
+    palma_matrix_t leaf;        /* Non-owning view of the operand (leaves only) */
+    palma_expr_t *a;
+    palma_expr_t *b;
+    palma_expr_t *plan;         /* Optimized form, computed on first use */
+    double plan_cost;
+};
+
+typedef struct {
+    palma_matrix_t *mat;
+    bool in_use;
+} pool_entry_t;
+
+struct palma_expr_ctx {
+    palma_semiring_t semiring;
+    palma_expr_t **nodes;
+    size_t n_nodes;
+    size_t cap_nodes;
+    pool_entry_t *pool;
+    size_t n_pool;
+    size_t cap_pool;
+};
+
+/*============================================================================
+ * ACCUMULATING KERNELS
+ *
+ * C = A ⊗ B, or C ← C ⊕ A ⊗ B when acc is set. Row-broadcast order so the
+ * inner loop vectorizes; a single column uses a dot-product form instead.
+ *============================================================================*/
+
+#define EXPR_KERNELS(NAME, ADD, MUL)                                            \
+static void mul_acc_##NAME(palma_matrix_t *C, const palma_matrix_t *A,          \
+                           const palma_matrix_t *B, bool acc,                   \
+                           palma_val_t zero) {                                  \
+    size_t m = A->rows, n = A->cols, p = B->cols;                               \
+    if (p == 1) {                                                               \
+        for (size_t i = 0; i < m; i++) {                                        \
+            const palma_val_t *a = &A->data[i * A->stride];                     \
+            palma_val_t sum = acc ? C->data[i * C->stride] : zero;              \
+            for (size_t k = 0; k < n; k++) {                                    \
+                sum = ADD(sum, MUL(a[k], B->data[k * B->stride]));              \
+            }                                                                   \
+            C->data[i * C->stride] = sum;                                       \
+        }                                                                       \
+        return;                                                                 \
+    }                                                                           \
+    EXPR_PARALLEL_ROWS(m * n * p)                                               \
+    for (size_t i = 0; i < m; i++) {                                            \
+        palma_val_t *c = &C->data[i * C->stride];                               \
+        const palma_val_t *a = &A->data[i * A->stride];                         \
+        if (!acc) {                                                             \
+            for (size_t j = 0; j < p; j++) c[j] = zero;                         \
+        }                                                                       \
+        for (size_t k = 0; k < n; k++) {                                        \
+            const palma_val_t *b = &B->data[k * B->stride];                     \
+            palma_val_t a_ik = a[k];                                            \
+            for (size_t j = 0; j < p; j++) c[j] = ADD(c[j], MUL(a_ik, b[j]));   \
+        }                                                                       \
+    }                                                                           \
+}
+
+#if PALMA_USE_OPENMP
+#define EXPR_PRAGMA(x) _Pragma(#x)
+#define EXPR_PARALLEL_ROWS(work) EXPR_PRAGMA(omp parallel for schedule(static) if((work) > 100000))
+#else
+#define EXPR_PARALLEL_ROWS(work)
+#endif
+
+EXPR_KERNELS(maxplus, palma_op_max, palma_op_plus)
+EXPR_KERNELS(minplus, palma_op_min, palma_op_plus)
+EXPR_KERNELS(maxmin,  palma_op_max, palma_op_min)
+EXPR_KERNELS(minmax,  palma_op_min, palma_op_max)
+EXPR_KERNELS(boolean, palma_op_or,  palma_op_and)
+
+typedef void (*mul_acc_fn)(palma_matrix_t*, const palma_matrix_t*, const palma_matrix_t*,
+                           bool, palma_val_t);
+
+/* Indexed by palma_semiring_t */
+static const mul_acc_fn mul_acc_kernels[] = {
+    mul_acc_maxplus, mul_acc_minplus, mul_acc_maxmin, mul_acc_minmax, mul_acc_boolean
+};
+
+palma_error_t palma_matrix_mul_acc_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                         const palma_matrix_t *B, palma_semiring_t semiring) {
+    if (!C || !A || !B) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if ((unsigned)semiring > PALMA_BOOLEAN) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (A->cols != B->rows || C->rows != A->rows || C->cols != B->cols) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    }
+    /* The kernel reads A and B while it updates C row by row */
+    if (palma_matrix_overlaps(C, A) || palma_matrix_overlaps(C, B)) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (C->rows == 0 || C->cols == 0) return PALMA_SUCCESS;
+
+    mul_acc_kernels[semiring](C, A, B, true, palma_zero(semiring));
+    return PALMA_SUCCESS;
+}
+
+/* out = src, or out ← out ⊕ src */
+static void add_acc(palma_matrix_t *out, const palma_matrix_t *src, bool acc,
+                    palma_semiring_t semiring) {
+    for (size_t i = 0; i < out->rows; i++) {
+        palma_val_t *o = &out->data[i * out->stride];
+        const palma_val_t *s = &src->data[i * src->stride];
+        if (!acc) {
+            memcpy(o, s, out->cols * sizeof(palma_val_t));
+            continue;
+        }
+        for (size_t j = 0; j < out->cols; j++) o[j] = palma_add(o[j], s[j], semiring);
+    }
+}
+
+/*============================================================================
+ * CONTEXT AND NODES
+ *============================================================================*/
+
+palma_expr_ctx_t* palma_expr_create(palma_semiring_t semiring) {
+    if ((unsigned)semiring > PALMA_BOOLEAN) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+
+    palma_expr_ctx_t *ctx = (palma_expr_ctx_t*)calloc(1, sizeof(palma_expr_ctx_t));
+    if (!ctx) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    ctx->semiring = semiring;
+    palma_clear_error();
+    return ctx;
+}
+
+void palma_expr_reset(palma_expr_ctx_t *ctx) {
+    if (!ctx) return;
+    for (size_t i = 0; i < ctx->n_nodes; i++) free(ctx->nodes[i]);
+    ctx->n_nodes = 0;
+}
+
+void palma_expr_destroy(palma_expr_ctx_t *ctx) {
+    if (!ctx) return;
+    palma_expr_reset(ctx);
+    for (size_t i = 0; i < ctx->n_pool; i++) palma_matrix_destroy(ctx->pool[i].mat);
+    free(ctx->pool);
+    free(ctx->nodes);
+    free(ctx);
+}
+
+static palma_expr_t* new_node(palma_expr_ctx_t *ctx, expr_kind_t kind, size_t rows, size_t cols) {
+    if (ctx->n_nodes == ctx->cap_nodes) {
+        size_t cap = ctx->cap_nodes ? 2 * ctx->cap_nodes : 16;
+        palma_expr_t **nodes = (palma_expr_t**)realloc(ctx->nodes, cap * sizeof(*nodes));
+        if (!nodes) return NULL;
+        ctx->nodes = nodes;
+        ctx->cap_nodes = cap;
+    }
+
+    palma_expr_t *e = (palma_expr_t*)calloc(1, sizeof(palma_expr_t));
+    if (!e) return NULL;
+
+    e->kind = kind;
+    e->rows = rows;
+    e->cols = cols;
+    ctx->nodes[ctx->n_nodes++] = e;
+    return e;
+}
+
+palma_expr_t* palma_expr_matrix(palma_expr_ctx_t *ctx, const palma_matrix_t *A) {
+    if (!ctx || !A) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    palma_expr_t *e = new_node(ctx, EXPR_LEAF, A->rows, A->cols);
+    if (!e) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    palma_matrix_view(&e->leaf, A, 0, 0, A->rows, A->cols);
+    return e;
+}
+
+palma_expr_t* palma_expr_vector(palma_expr_ctx_t *ctx, const palma_val_t *x, size_t n) {
+    if (!ctx || !x) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (n == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    palma_expr_t *e = new_node(ctx, EXPR_LEAF, n, 1);
+    if (!e) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    /* n × 1 with unit stride */
+    palma_matrix_t col = { (palma_val_t*)x, n, 1, 1, false, 0 };
+    e->leaf = col;
+    return e;
+}
+
+palma_expr_t* palma_expr_mul(palma_expr_ctx_t *ctx, palma_expr_t *a, palma_expr_t *b) {
+    if (!ctx || !a || !b) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (a->cols != b->rows) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    palma_expr_t *e = new_node(ctx, EXPR_MUL, a->rows, b->cols);
+    if (!e) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    e->a = a;
+    e->b = b;
+    return e;
+}
+
+palma_expr_t* palma_expr_add(palma_expr_ctx_t *ctx, palma_expr_t *a, palma_expr_t *b) {
+    if (!ctx || !a || !b) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (a->rows != b->rows || a->cols != b->cols) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    palma_expr_t *e = new_node(ctx, EXPR_ADD, a->rows, a->cols);
+    if (!e) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    e->a = a;
+    e->b = b;
+    return e;
+}
+
+void palma_expr_shape(const palma_expr_t *e, size_t *rows, size_t *cols) {
+    if (rows) *rows = e ? e->rows : 0;
+    if (cols) *cols = e ? e->cols : 0;
+}
+
+/*============================================================================
+ * FLATTENING
+ *============================================================================*/
+
+/* Operands of a run of nodes of the given kind, left to right */
+typedef struct {
+    palma_expr_t **items;
+    size_t count;
+} expr_list_t;
+
+static size_t count_operands(const palma_expr_t *e, expr_kind_t kind) {
+    if (e->kind != kind) return 1;
+    return count_operands(e->a, kind) + count_operands(e->b, kind);
+}
+
+static void fill_operands(palma_expr_t *e, expr_kind_t kind, expr_list_t *list) {
+    if (e->kind != kind) {
+        list->items[list->count++] = e;
+        return;
+    }
+    fill_operands(e->a, kind, list);
+    fill_operands(e->b, kind, list);
+}
+
+static palma_error_t flatten(palma_expr_t *e, expr_kind_t kind, expr_list_t *list) {
+    list->count = 0;
+    list->items = (palma_expr_t**)malloc(count_operands(e, kind) * sizeof(palma_expr_t*));
+    if (!list->items) return PALMA_ERR_OUT_OF_MEMORY;
+    fill_operands(e, kind, list);
+    return PALMA_SUCCESS;
+}
+
+/* Left fold of items[0..count) with kind, replacing items[skip] by sub if sub != NULL */
+static palma_expr_t* fold(palma_expr_ctx_t *ctx, expr_kind_t kind, palma_expr_t **items,
+                          size_t count, size_t skip, palma_expr_t *sub) {
+    palma_expr_t *acc = (skip == 0 && sub) ? sub : items[0];
+    for (size_t i = 1; i < count && acc; i++) {
+        palma_expr_t *next = (i == skip && sub) ? sub : items[i];
+        acc = (kind == EXPR_MUL) ? palma_expr_mul(ctx, acc, next) : palma_expr_add(ctx, acc, next);
+    }
+    return acc;
+}
+
+/*============================================================================
+ * COST MODEL AND REWRITING
+ *============================================================================*/
+
+/*
+ * Matrix-chain order for factors of dims d[0..m]. Fills split[i * m + j] and
+ * returns the ⊗-⊕ operation count of the best parenthesization.
+ */
+static double chain_order(const size_t *d, size_t m, size_t *split, double *best) {
+    for (size_t i = 0; i < m; i++) best[i * m + i] = 0.0;
+
+    for (size_t len = 2; len <= m; len++) {
+        for (size_t i = 0; i + len <= m; i++) {
+            size_t j = i + len - 1;
+            best[i * m + j] = -1.0;
+            for (size_t k = i; k < j; k++) {
+                double c = best[i * m + k] + best[(k + 1) * m + j] +
+                           (double)d[i] * (double)d[k + 1] * (double)d[j + 1];
+                if (best[i * m + j] < 0.0 || c < best[i * m + j]) {
+                    best[i * m + j] = c;
+                    split[i * m + j] = k;
+                }
+            }
+        }
+    }
+
+    return best[m - 1];
+}
+
+static double naive_cost(const palma_expr_t *e) {
+    switch (e->kind) {
+        case EXPR_MUL:
+            return naive_cost(e->a) + naive_cost(e->b) +
+                   (double)e->a->rows * (double)e->a->cols * (double)e->b->cols;
+        case EXPR_ADD:
+            return naive_cost(e->a) + naive_cost(e->b) + (double)e->rows * (double)e->cols;
+        default:
+            return 0.0;
+    }
+}
+
+static palma_expr_t* optimize(palma_expr_ctx_t *ctx, palma_expr_t *e, double *cost,
+                              bool distribute);
+
+/* Sum: operands are optimized; leaves cost a copy or ⊕ pass, products fuse */
+static palma_expr_t* optimize_add(palma_expr_ctx_t *ctx, palma_expr_t *e, double *cost,
+                                  bool distribute) {
+    expr_list_t terms;
+    if (flatten(e, EXPR_ADD, &terms) != PALMA_SUCCESS) return NULL;
+
+    *cost = 0.0;
+    for (size_t t = 0; t < terms.count; t++) {
+        double c;
+        terms.items[t] = optimize(ctx, terms.items[t], &c, distribute);
+        if (!terms.items[t]) {
+            free(terms.items);
+            return NULL;
+        }
+        *cost += c;
+        if (terms.items[t]->kind == EXPR_LEAF) *cost += (double)e->rows * (double)e->cols;
+    }
+
+    palma_expr_t *out = fold(ctx, EXPR_ADD, terms.items, terms.count, 0, NULL);
+    free(terms.items);
+    return out;
+}
+
+/*
+ * Product chain: best association, or ⊗ distributed over the first sum
+ * factor. The distributed chains keep any further sum factors whole, so a
+ * product of k sums yields one alternative of linear size rather than the
+ * 2^k full expansion.
+ */
+static palma_expr_t* optimize_mul(palma_expr_ctx_t *ctx, palma_expr_t *e, double *cost,
+                                  bool distribute) {
+    expr_list_t factors;
+    if (flatten(e, EXPR_MUL, &factors) != PALMA_SUCCESS) return NULL;
+
+    size_t m = factors.count;
+    size_t *d = (size_t*)malloc((m + 1) * sizeof(size_t));
+    size_t *split = (size_t*)malloc(m * m * sizeof(size_t));
+    double *best = (double*)malloc(m * m * sizeof(double));
+    palma_expr_t *out = NULL;
+    size_t sum_at = m;
+
+    if (!d || !split || !best) goto done;
+
+    /* Factors are evaluated once each; composite ones into a temporary */
+    *cost = 0.0;
+    for (size_t i = 0; i < m; i++) {
+        double c;
+        factors.items[i] = optimize(ctx, factors.items[i], &c, true);
+        if (!factors.items[i]) goto done;
+        *cost += c;
+        if (factors.items[i]->kind == EXPR_ADD && sum_at == m) sum_at = i;
+    }
+
+    d[0] = factors.items[0]->rows;
+    for (size_t i = 0; i < m; i++) d[i + 1] = factors.items[i]->cols;
+    *cost += chain_order(d, m, split, best);
+
+    out = fold(ctx, EXPR_MUL, factors.items, m, 0, NULL);
+
+    if (out && distribute && sum_at < m) {
+        /* X ⊗ (T1 ⊕ ... ⊕ Tk) ⊗ Y = ⊕_t X ⊗ Tt ⊗ Y */
+        expr_list_t terms;
+        if (flatten(factors.items[sum_at], EXPR_ADD, &terms) == PALMA_SUCCESS) {
+            palma_expr_t *dist = NULL;
+            for (size_t t = 0; t < terms.count; t++) {
+                palma_expr_t *chain = fold(ctx, EXPR_MUL, factors.items, m, sum_at, terms.items[t]);
+                dist = (!dist || !chain) ? chain : palma_expr_add(ctx, dist, chain);
+                if (!dist) break;
+            }
+            free(terms.items);
+
+            double alt_cost;
+            palma_expr_t *alt = dist ? optimize(ctx, dist, &alt_cost, false) : NULL;
+            if (alt && alt_cost < *cost) {
+                out = alt;
+                *cost = alt_cost;
+            }
+        }
+    }
+
+done:
+    free(d);
+    free(split);
+    free(best);
+    free(factors.items);
+    return out;
+}
+
+/*
+ * Nodes are immutable once built, so each keeps its plan: repeated cost and
+ * eval calls, and operands shared between subtrees, are optimized once and
+ * add no nodes to the context. A plan is its own plan.
+ */
+static palma_expr_t* optimize(palma_expr_ctx_t *ctx, palma_expr_t *e, double *cost,
+                              bool distribute) {
+    if (e->plan) {
+        *cost = e->plan_cost;
+        return e->plan;
+    }
+
+    palma_expr_t *out;
+    switch (e->kind) {
+        case EXPR_MUL: out = optimize_mul(ctx, e, cost, distribute); break;
+        case EXPR_ADD: out = optimize_add(ctx, e, cost, distribute); break;
+        default:
+            *cost = 0.0;
+            out = e;
+            break;
+    }
+
+    if (out) {
+        e->plan = out;
+        e->plan_cost = *cost;
+        out->plan = out;
+        out->plan_cost = *cost;
+    }
+    return out;
+}
+
+double palma_expr_cost(palma_expr_ctx_t *ctx, palma_expr_t *e, double *naive) {
+    if (!ctx || !e) {
+        palma_set_last_error(PALMA_ERR_NULL_PTR);
+        return -1.0;
+    }
+
+    double cost;
+    if (!optimize(ctx, e, &cost, true)) {
+        palma_set_last_error(PALMA_ERR_OUT_OF_MEMORY);
+        return -1.0;
+    }
+
+    if (naive) *naive = naive_cost(e);
+    return cost;
+}
+
+/*============================================================================
+ * BUFFER POOL
+ *============================================================================*/
+
+/* Smallest free buffer that fits, viewed as rows × cols; grows the pool if none */
+static palma_error_t pool_acquire(palma_expr_ctx_t *ctx, size_t rows, size_t cols,
+                                  palma_matrix_t *view, size_t *slot) {
+    size_t pick = ctx->n_pool;
+    for (size_t i = 0; i < ctx->n_pool; i++) {
+        const palma_matrix_t *m = ctx->pool[i].mat;
+        if (ctx->pool[i].in_use || m->rows < rows || m->cols < cols) continue;
+        if (pick == ctx->n_pool || m->rows * m->cols < ctx->pool[pick].mat->rows * ctx->pool[pick].mat->cols) {
+            pick = i;
+        }
+    }
+
+    if (pick == ctx->n_pool) {
+        if (ctx->n_pool == ctx->cap_pool) {
+            size_t cap = ctx->cap_pool ? 2 * ctx->cap_pool : 8;
+            pool_entry_t *pool = (pool_entry_t*)realloc(ctx->pool, cap * sizeof(pool_entry_t));
+            if (!pool) return PALMA_ERR_OUT_OF_MEMORY;
+            ctx->pool = pool;
+            ctx->cap_pool = cap;
+        }
+        palma_matrix_t *m = palma_matrix_create(rows, cols);
+        if (!m) return PALMA_ERR_OUT_OF_MEMORY;
+        ctx->pool[pick].mat = m;
+        ctx->n_pool++;
+    }
+
+    ctx->pool[pick].in_use = true;
+    *slot = pick;
+    return palma_matrix_view(view, ctx->pool[pick].mat, 0, 0, rows, cols);
+}
+
+static void pool_release(palma_expr_ctx_t *ctx, size_t slot) {
+    ctx->pool[slot].in_use = false;
+}
+
+/*============================================================================
+ * EVALUATION
+ *============================================================================*/
+
+static palma_error_t eval_into(palma_expr_ctx_t *ctx, const palma_expr_t *e,
+                               palma_matrix_t *out, bool acc);
+
+typedef struct {
+    palma_expr_ctx_t *ctx;
+    palma_matrix_t *mats;       /* Factor operands (leaf views or temporaries) */
+    const size_t *d;
+    const size_t *split;
+    size_t m;
+} chain_t;
+
+/* out (⊕)= product of factors i..j in the planned association */
+static palma_error_t eval_chain(const chain_t *ch, size_t i, size_t j,
+                                palma_matrix_t *out, bool acc) {
+    size_t k = ch->split[i * ch->m + j];
+    palma_matrix_t side[2];
+    size_t slot[2];
+    bool held[2] = { false, false };
+    palma_error_t err = PALMA_SUCCESS;
+
+    const palma_matrix_t *left = &ch->mats[i];
+    const palma_matrix_t *right = &ch->mats[j];
+
+    if (k > i) {
+        err = pool_acquire(ch->ctx, ch->d[i], ch->d[k + 1], &side[0], &slot[0]);
+        if (err == PALMA_SUCCESS) {
+            held[0] = true;
+            err = eval_chain(ch, i, k, &side[0], false);
+            left = &side[0];
+        }
+    }
+    if (err == PALMA_SUCCESS && j > k + 1) {
+        err = pool_acquire(ch->ctx, ch->d[k + 1], ch->d[j + 1], &side[1], &slot[1]);
+        if (err == PALMA_SUCCESS) {
+            held[1] = true;
+            err = eval_chain(ch, k + 1, j, &side[1], false);
+            right = &side[1];
+        }
+    }
+
+    if (err == PALMA_SUCCESS) {
+        palma_semiring_t s = ch->ctx->semiring;
+        mul_acc_kernels[s](out, left, right, acc, palma_zero(s));
+    }
+
+    if (held[0]) pool_release(ch->ctx, slot[0]);
+    if (held[1]) pool_release(ch->ctx, slot[1]);
+    return err;
+}
+
+static palma_error_t eval_mul(palma_expr_ctx_t *ctx, const palma_expr_t *e,
+                              palma_matrix_t *out, bool acc) {
+    expr_list_t factors;
+    palma_error_t err = flatten((palma_expr_t*)e, EXPR_MUL, &factors);
+    if (err != PALMA_SUCCESS) return err;
+
+    size_t m = factors.count;
+    size_t *d = (size_t*)malloc((m + 1) * sizeof(size_t));
+    size_t *split = (size_t*)malloc(m * m * sizeof(size_t));
+    double *best = (double*)malloc(m * m * sizeof(double));
+    palma_matrix_t *mats = (palma_matrix_t*)malloc(m * sizeof(palma_matrix_t));
+    size_t *slots = (size_t*)malloc(m * sizeof(size_t));
+    size_t held = 0;
+
+    if (!d || !split || !best || !mats || !slots) {
+        err = PALMA_ERR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    d[0] = factors.items[0]->rows;
+    for (size_t i = 0; i < m; i++) d[i + 1] = factors.items[i]->cols;
+    chain_order(d, m, split, best);
+
+    /* Leaves are used in place; composite factors are evaluated once */
+    for (size_t i = 0; i < m && err == PALMA_SUCCESS; i++) {
+        const palma_expr_t *f = factors.items[i];
+        if (f->kind == EXPR_LEAF) {
+            mats[i] = f->leaf;
+            continue;
+        }
+        err = pool_acquire(ctx, f->rows, f->cols, &mats[i], &slots[held]);
+        if (err == PALMA_SUCCESS) {
+            held++;
+            err = eval_into(ctx, f, &mats[i], false);
+        }
+    }
+
+    if (err == PALMA_SUCCESS) {
+        chain_t ch = { ctx, mats, d, split, m };
+        err = eval_chain(&ch, 0, m - 1, out, acc);
+    }
+
+    for (size_t h = 0; h < held; h++) pool_release(ctx, slots[h]);
+
+done:
+    free(d);
+    free(split);
+    free(best);
+    free(mats);
+    free(slots);
+    free(factors.items);
+    return err;
+}
+
+static palma_error_t eval_into(palma_expr_ctx_t *ctx, const palma_expr_t *e,
+                               palma_matrix_t *out, bool acc) {
+    switch (e->kind) {
+        case EXPR_LEAF:
+            add_acc(out, &e->leaf, acc, ctx->semiring);
+            return PALMA_SUCCESS;
+
+        case EXPR_MUL:
+            return eval_mul(ctx, e, out, acc);
+
+        case EXPR_ADD: {
+            /* Every term after the first accumulates into out */
+            expr_list_t terms;
+            palma_error_t err = flatten((palma_expr_t*)e, EXPR_ADD, &terms);
+            for (size_t t = 0; t < terms.count && err == PALMA_SUCCESS; t++) {
+                err = eval_into(ctx, terms.items[t], out, acc || t > 0);
+            }
+            free(terms.items);
+            return err;
+        }
+    }
+
+    return PALMA_ERR_INVALID_ARG;
+}
+
+static bool aliases_leaf(const palma_expr_t *e, const palma_matrix_t *out) {
+    if (e->kind == EXPR_LEAF) return palma_matrix_overlaps(&e->leaf, out);
+    return aliases_leaf(e->a, out) || aliases_leaf(e->b, out);
+}
+
+palma_error_t palma_expr_eval(palma_expr_ctx_t *ctx, palma_expr_t *e, palma_matrix_t *out) {
+    if (!ctx || !e || !out) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (out->rows != e->rows || out->cols != e->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    double cost;
+    palma_expr_t *plan = optimize(ctx, e, &cost, true);
+    if (!plan) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+
+    palma_error_t err;
+    if (aliases_leaf(plan, out)) {
+        palma_matrix_t stage;
+        size_t slot;
+        err = pool_acquire(ctx, out->rows, out->cols, &stage, &slot);
+        if (err == PALMA_SUCCESS) {
+            err = eval_into(ctx, plan, &stage, false);
+            if (err == PALMA_SUCCESS) palma_matrix_copy(out, &stage);
+            pool_release(ctx, slot);
+        }
+    } else {
+        err = eval_into(ctx, plan, out, false);
+    }
+
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_expr_eval_vector(palma_expr_ctx_t *ctx, palma_expr_t *e, palma_val_t *y) {
+    if (!ctx || !e || !y) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (e->cols != 1) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    palma_matrix_t col = { y, e->rows, 1, 1, false, 0 };
+    return palma_expr_eval(ctx, e, &col);
+}
@@ -23,6 +23,7 @@
 #define _DEFAULT_SOURCE
 
 #include "palma.h"
+#include "palma_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -33,10 +34,6 @@
 #include <arm_neon.h>
 #endif
 
-/* Binary file magic */
-#define PALMA_BINARY_MAGIC 0x504C4D41
-#define PALMA_BINARY_VERSION 1
-
 /*============================================================================
  * EIGENVALUE & EIGENVECTOR COMPUTATION
  *============================================================================*/
@@ -76,6 +73,14 @@ palma_val_t palma_eigenvalue(const palma_matrix_t *A, palma_semiring_t semiring)
     
     /* Dynamic programming: D[k][v] = ⊕_u (D[k-1][u] ⊗ A[u][v]) */
     for (size_t k = 1; k <= n; k++) {
+        palma_error_t stop = palma_interrupt_check();
+        if (stop != PALMA_SUCCESS) {
+            for (size_t j = 0; j <= n; j++) free(D[j]);
+            free(D);
+            palma_set_last_error(stop);
+            return PALMA_NEG_INF;
+        }
+        
         for (size_t v = 0; v < n; v++) {
             palma_val_t best = zero;
             for (size_t u = 0; u < n; u++) {
@@ -270,6 +275,11 @@ palma_matrix_t* palma_all_pairs_paths(const palma_matrix_t *adj, palma_semiring_
     return palma_matrix_closure(adj, semiring);
 }
 
+palma_error_t palma_all_pairs_paths_into(palma_matrix_t *dist, const palma_matrix_t *adj,
+                                          palma_semiring_t semiring) {
+    return palma_matrix_closure_into(dist, adj, semiring);
+}
+
 palma_error_t palma_single_source_paths(const palma_matrix_t *adj, size_t source,
                                          palma_val_t *dist, palma_semiring_t semiring) {
     if (!adj || !dist) return PALMA_ERR_NULL_PTR;
@@ -296,25 +306,44 @@ palma_matrix_t* palma_reachability(const palma_matrix_t *adj) {
         return NULL;
     }
     
-    /* Convert to Boolean: any non-zero value becomes 1 */
-    palma_matrix_t *bool_adj = palma_matrix_create(adj->rows, adj->cols);
-    if (!bool_adj) return NULL;
+    palma_matrix_t *reach = palma_matrix_create(adj->rows, adj->cols);
+    if (!reach) return NULL;
     
+    if (palma_reachability_into(reach, adj) != PALMA_SUCCESS) {
+        palma_matrix_destroy(reach);
+        return NULL;
+    }
+    
+    return reach;
+}
+
+palma_error_t palma_reachability_into(palma_matrix_t *reach, const palma_matrix_t *adj) {
+    if (!reach || !adj) {
+        palma_set_last_error(PALMA_ERR_NULL_PTR);
+        return PALMA_ERR_NULL_PTR;
+    }
+    if (adj->rows != adj->cols) {
+        palma_set_last_error(PALMA_ERR_NOT_SQUARE);
+        return PALMA_ERR_NOT_SQUARE;
+    }
+    if (reach->rows != adj->rows || reach->cols != adj->cols) {
+        palma_set_last_error(PALMA_ERR_INVALID_DIM);
+        return PALMA_ERR_INVALID_DIM;
+    }
+    
+    /* Convert to Boolean: any non-zero value becomes 1 (element-wise, so reach may be adj) */
     for (size_t i = 0; i < adj->rows; i++) {
         for (size_t j = 0; j < adj->cols; j++) {
             palma_val_t val = palma_matrix_get(adj, i, j);
             /* Consider anything that's not the typical "no edge" as an edge */
             bool is_edge = (val != PALMA_NEG_INF && val != PALMA_POS_INF) || 
                            (i == j);  /* Self-reachable */
-            palma_matrix_set(bool_adj, i, j, is_edge ? 1 : 0);
+            palma_matrix_set(reach, i, j, is_edge ? 1 : 0);
         }
     }
     
     /* Compute transitive closure with Boolean semiring */
-    palma_matrix_t *reach = palma_matrix_closure(bool_adj, PALMA_BOOLEAN);
-    palma_matrix_destroy(bool_adj);
-    
-    return reach;
+    return palma_matrix_closure_into(reach, reach, PALMA_BOOLEAN);
 }
 
 palma_matrix_t* palma_bottleneck_paths(const palma_matrix_t *adj) {
@@ -327,6 +356,10 @@ palma_matrix_t* palma_bottleneck_paths(const palma_matrix_t *adj) {
     return palma_matrix_closure(adj, PALMA_MAXMIN);
 }
 
+palma_error_t palma_bottleneck_paths_into(palma_matrix_t *cap, const palma_matrix_t *adj) {
+    return palma_matrix_closure_into(cap, adj, PALMA_MAXMIN);
+}
+
 /*============================================================================
  * SCHEDULING
  *============================================================================*/
@@ -571,35 +604,14 @@ palma_error_t palma_matrix_save_csv(const palma_matrix_t *mat, const char *filen
                                      palma_semiring_t semiring) {
     if (!mat || !filename) return PALMA_ERR_NULL_PTR;
     
-    FILE *fp = fopen(filename, "w");
-    if (!fp) return PALMA_ERR_FILE_OPEN;
-    
-    palma_val_t neg_inf_val = PALMA_NEG_INF;
-    palma_val_t pos_inf_val = PALMA_POS_INF;
-    
-    /* Write header comment */
-    fprintf(fp, "# PALMA matrix %zux%zu, semiring=%s\n", mat->rows, mat->cols, 
-            palma_semiring_name(semiring));
+    /* Buffered row writer (palma_stream.c) */
+    palma_writer_t *w = palma_writer_open_matrix(filename, mat->rows, mat->cols,
+                                                 semiring, PALMA_STREAM_CSV);
+    if (!w) return palma_get_last_error();
     
-    for (size_t i = 0; i < mat->rows; i++) {
-        for (size_t j = 0; j < mat->cols; j++) {
-            palma_val_t val = palma_matrix_get(mat, i, j);
-            
-            if (val == neg_inf_val) {
-                fprintf(fp, "-inf");
-            } else if (val == pos_inf_val) {
-                fprintf(fp, "inf");
-            } else {
-                fprintf(fp, "%d", val);
-            }
-            
-            if (j < mat->cols - 1) fprintf(fp, ",");
-        }
-        fprintf(fp, "\n");
-    }
-    
-    fclose(fp);
-    return PALMA_SUCCESS;
+    palma_error_t err = palma_writer_write_rows(w, mat);
+    palma_error_t close_err = palma_writer_close(w);
+    return (err != PALMA_SUCCESS) ? err : close_err;
 }
 
 palma_matrix_t* palma_matrix_load_csv(const char *filename, palma_semiring_t semiring) {
@@ -761,24 +773,13 @@ palma_matrix_t* palma_matrix_load_binary(const char *filename) {
 palma_error_t palma_sparse_save_csv(const palma_sparse_t *sp, const char *filename) {
     if (!sp || !filename) return PALMA_ERR_NULL_PTR;
     
-    FILE *fp = fopen(filename, "w");
-    if (!fp) return PALMA_ERR_FILE_OPEN;
-    
-    /* Write header */
-    fprintf(fp, "# PALMA sparse matrix %zux%zu, nnz=%zu, semiring=%s\n",
-            sp->rows, sp->cols, sp->nnz, palma_semiring_name(sp->semiring));
-    fprintf(fp, "# Format: row,col,value (COO format)\n");
-    fprintf(fp, "%zu,%zu,%zu\n", sp->rows, sp->cols, sp->nnz);
-    
-    /* Write entries */
-    for (size_t i = 0; i < sp->rows; i++) {
-        for (palma_idx_t k = sp->row_ptr[i]; k < sp->row_ptr[i + 1]; k++) {
-            fprintf(fp, "%zu,%u,%d\n", i, sp->col_idx[k], sp->values[k]);
-        }
-    }
+    palma_writer_t *w = palma_writer_open_edges(filename, sp->rows, sp->cols, sp->nnz,
+                                                sp->semiring);
+    if (!w) return palma_get_last_error();
     
-    fclose(fp);
-    return PALMA_SUCCESS;
+    palma_error_t err = palma_writer_write_sparse(w, sp, 0);
+    palma_error_t close_err = palma_writer_close(w);
+    return (err != PALMA_SUCCESS) ? err : close_err;
 }
 
 palma_sparse_t* palma_sparse_load_csv(const char *filename, palma_semiring_t semiring) {
@@ -823,7 +824,14 @@ palma_sparse_t* palma_sparse_load_csv(const char *filename, palma_semiring_t sem
         int val;
         
         if (sscanf(line, "%zu,%u,%d", &row, &col, &val) == 3) {
-            palma_sparse_set(sp, row, col, val);
+            /* Out-of-range lines are skipped; running out of room is not */
+            palma_error_t err = palma_sparse_set(sp, row, col, val);
+            if (err == PALMA_ERR_OVERFLOW || err == PALMA_ERR_OUT_OF_MEMORY) {
+                fclose(fp);
+                palma_sparse_destroy(sp);
+                palma_set_last_error(err);
+                return NULL;
+            }
         }
     }
     
@@ -1066,7 +1074,7 @@ void palma_sparse_print(const palma_sparse_t *sp, const char *name, FILE *fp) {
     for (size_t i = 0; i < sp->rows; i++) {
         if (sp->row_ptr[i] < sp->row_ptr[i + 1]) {
             fprintf(fp, "  Row %zu:", i);
-            for (palma_idx_t k = sp->row_ptr[i]; k < sp->row_ptr[i + 1]; k++) {
+            for (palma_ptr_t k = sp->row_ptr[i]; k < sp->row_ptr[i + 1]; k++) {
                 fprintf(fp, " [%u]=%d", sp->col_idx[k], sp->values[k]);
             }
             fprintf(fp, "\n");
@@ -0,0 +1,184 @@
+/**
+ * @file palma_fixed.c
+ * @brief PALMA Fixed-Size Kernels - 4×4, 8×8 and 16×16 matrices
+ *
+ * Every loop bound is a compile-time constant and the semiring is fixed per
+ * instance, so the compiler fully unrolls the loops and keeps operands in
+ * SIMD registers. The generic entry points (palma_matrix_mul_into,
+ * palma_matvec, palma_matrix_closure) call these automatically when all
+ * dimensions match one of the supported sizes. Results are bit-identical to
+ * the generic kernels.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+
+/*============================================================================
+ * KERNEL TEMPLATES
+ *============================================================================*/
+
+#define FIXED_KERNELS(N, NAME, ADD, MUL)                                        \
+static void fixed_mul_##N##_##NAME(palma_val_t *C, size_t sc,                   \
+                                   const palma_val_t *A, size_t sa,             \
+                                   const palma_val_t *B, size_t sb,             \
+                                   palma_val_t zero) {                          \
+    palma_val_t b[N * N];                                                       \
+    for (size_t k = 0; k < N; k++) {                                            \
+        for (size_t j = 0; j < N; j++) b[k * N + j] = B[k * sb + j];            \
+    }                                                                           \
+    for (size_t i = 0; i < N; i++) {                                            \
+        palma_val_t acc[N];                                                     \
+        for (size_t j = 0; j < N; j++) acc[j] = zero;                           \
+        for (size_t k = 0; k < N; k++) {                                        \
+            palma_val_t a_ik = A[i * sa + k];                                   \
+            for (size_t j = 0; j < N; j++) {                                    \
+                acc[j] = ADD(acc[j], MUL(a_ik, b[k * N + j]));                  \
+            }                                                                   \
+        }                                                                       \
+        for (size_t j = 0; j < N; j++) C[i * sc + j] = acc[j];                  \
+    }                                                                           \
+}                                                                               \
+                                                                                \
+static void fixed_matvec_##N##_##NAME(const palma_val_t *A, size_t sa,          \
+                                      const palma_val_t *x, palma_val_t *y,     \
+                                      palma_val_t zero) {                       \
+    palma_val_t xv[N];                                                          \
+    palma_val_t out[N];                                                         \
+    for (size_t j = 0; j < N; j++) xv[j] = x[j];                                \
+    for (size_t i = 0; i < N; i++) {                                            \
+        palma_val_t acc = zero;                                                 \
+        for (size_t j = 0; j < N; j++) {                                        \
+            acc = ADD(acc, MUL(A[i * sa + j], xv[j]));                          \
+        }                                                                       \
+        out[i] = acc;                                                           \
+    }                                                                           \
+    for (size_t i = 0; i < N; i++) y[i] = out[i];                               \
+}                                                                               \
+                                                                                \
+/* In-place Floyd-Warshall. When d_kk ⊕ e = e (no positive cycle at k)    */ \
+/* neither row k nor column k changes during step k, so the row is hoisted */ \
+/* and every update is a uniform broadcast. Otherwise the exact generic    */ \
+/* order is replayed: d_ik switches to its updated value after j == k.     */ \
+static void fixed_closure_##N##_##NAME(palma_val_t *D, size_t sd,              \
+                                       palma_val_t one) {                       \
+    palma_val_t d[N * N];                                                       \
+    palma_val_t row_k[N];                                                       \
+    for (size_t i = 0; i < N; i++) {                                            \
+        for (size_t j = 0; j < N; j++) d[i * N + j] = D[i * sd + j];            \
+    }                                                                           \
+    for (size_t k = 0; k < N; k++) {                                            \
+        palma_val_t d_kk = d[k * N + k];                                        \
+        if (ADD(d_kk, one) == one) {                                            \
+            for (size_t j = 0; j < N; j++) row_k[j] = d[k * N + j];             \
+            for (size_t i = 0; i < N; i++) {                                    \
+                palma_val_t d_ik = d[i * N + k];                                \
+                for (size_t j = 0; j < N; j++) {                                \
+                    d[i * N + j] = ADD(d[i * N + j], MUL(d_ik, row_k[j]));      \
+                }                                                               \
+            }                                                                   \
+            continue;                                                           \
+        }                                                                       \
+        for (size_t i = 0; i < N; i++) {                                        \
+            for (size_t j = 0; j < N; j++) {                                    \
+                d[i * N + j] = ADD(d[i * N + j], MUL(d[i * N + k], d[k * N + j])); \
+            }                                                                   \
+        }                                                                       \
+    }                                                                           \
+    for (size_t i = 0; i < N; i++) {                                            \
+        for (size_t j = 0; j < N; j++) D[i * sd + j] = d[i * N + j];            \
+    }                                                                           \
+}
+
+#define FIXED_KERNELS_ALL(N)                                                    \
+    FIXED_KERNELS(N, maxplus, palma_op_max, palma_op_plus)                      \
+    FIXED_KERNELS(N, minplus, palma_op_min, palma_op_plus)                      \
+    FIXED_KERNELS(N, maxmin,  palma_op_max, palma_op_min)                       \
+    FIXED_KERNELS(N, minmax,  palma_op_min, palma_op_max)                       \
+    FIXED_KERNELS(N, boolean, palma_op_or,  palma_op_and)
+
+FIXED_KERNELS_ALL(4)
+FIXED_KERNELS_ALL(8)
+FIXED_KERNELS_ALL(16)
+
+/*============================================================================
+ * DISPATCH
+ *============================================================================*/
+
+typedef struct {
+    void (*mul)(palma_val_t*, size_t, const palma_val_t*, size_t,
+                const palma_val_t*, size_t, palma_val_t);
+    void (*matvec)(const palma_val_t*, size_t, const palma_val_t*, palma_val_t*, palma_val_t);
+    void (*closure)(palma_val_t*, size_t, palma_val_t);
+} fixed_kernels_t;
+
+#define FIXED_ENTRY(N, NAME) \
+    { fixed_mul_##N##_##NAME, fixed_matvec_##N##_##NAME, fixed_closure_##N##_##NAME }
+
+#define FIXED_ROW(N) { \
+    FIXED_ENTRY(N, maxplus), FIXED_ENTRY(N, minplus), FIXED_ENTRY(N, maxmin), \
+    FIXED_ENTRY(N, minmax), FIXED_ENTRY(N, boolean) }
+
+static const fixed_kernels_t fixed_kernels[3][5] = {
+    FIXED_ROW(4),
+    FIXED_ROW(8),
+    FIXED_ROW(16)
+};
+
+static const fixed_kernels_t* fixed_kernels_for(size_t n, palma_semiring_t semiring) {
+    if ((unsigned)semiring > PALMA_BOOLEAN) return NULL;
+    switch (n) {
+        case 4:  return &fixed_kernels[0][semiring];
+        case 8:  return &fixed_kernels[1][semiring];
+        case 16: return &fixed_kernels[2][semiring];
+        default: return NULL;
+    }
+}
+
+bool palma_fixed_mul(palma_matrix_t *C, const palma_matrix_t *A,
+                     const palma_matrix_t *B, palma_semiring_t semiring) {
+    size_t n = A->rows;
+    if (A->cols != n || B->rows != n || B->cols != n) return false;
+
+    const fixed_kernels_t *kern = fixed_kernels_for(n, semiring);
+    if (!kern) return false;
+
+    kern->mul(C->data, C->stride, A->data, A->stride, B->data, B->stride, palma_zero(semiring));
+    return true;
+}
+
+bool palma_fixed_matvec(const palma_matrix_t *A, const palma_val_t *x,
+                        palma_val_t *y, palma_semiring_t semiring) {
+    if (A->rows != A->cols) return false;
+
+    const fixed_kernels_t *kern = fixed_kernels_for(A->rows, semiring);
+    if (!kern) return false;
+
+    kern->matvec(A->data, A->stride, x, y, palma_zero(semiring));
+    return true;
+}
+
+bool palma_fixed_closure(palma_matrix_t *D, palma_semiring_t semiring) {
+    if (D->rows != D->cols) return false;
+
+    const fixed_kernels_t *kern = fixed_kernels_for(D->rows, semiring);
+    if (!kern) return false;
+
+    kern->closure(D->data, D->stride, palma_one(semiring));
+    return true;
+}
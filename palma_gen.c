@@ -0,0 +1,472 @@
+/**
+ * @file palma_gen.c
+ * @brief PALMA Workload Generators - R-MAT, road-like grids, DAGs, Erdős–Rényi
+ *
+ * Generators must give the same graph for a seed on any machine and any
+ * thread count, so no random state is shared: each row (each edge for
+ * R-MAT, each street for grids) seeds a splitmix64 stream from the seed
+ * and its own index. Row generators run twice in parallel, once to count
+ * the row lengths and once to fill the CSR arrays at the prefix sums;
+ * R-MAT edges land in unsorted row buckets through atomic cursors. Rows
+ * that may be unsorted or hold duplicates are then canonicalized (sorted,
+ * duplicates combined with ⊕) as for imported files.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/* Stream salts, so the generators do not share streams for one seed */
+#define SALT_RMAT   0x524D4154ull
+#define SALT_PERM   0x5045524Dull
+#define SALT_GRID   0x47524944ull
+#define SALT_DAG    0x44414721ull
+#define SALT_ER     0x45524452ull
+
+/*============================================================================
+ * RANDOM STREAMS
+ *============================================================================*/
+
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/* Independent stream for (seed, salt, index) */
+static inline uint64_t stream_seed(uint64_t seed, uint64_t salt, uint64_t index) {
+    return mix64(seed ^ mix64(salt ^ mix64(index + 0x9E3779B97F4A7C15ull)));
+}
+
+static inline uint64_t rng_next(uint64_t *state) {
+    return mix64(*state += 0x9E3779B97F4A7C15ull);
+}
+
+/* Uniform in [0, 1) with 53 bits */
+static inline double rng_unit(uint64_t *state) {
+    return (double)(rng_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Uniform in [0, bound) */
+static inline uint64_t rng_below(uint64_t *state, uint64_t bound) {
+    return (uint64_t)(rng_unit(state) * (double)bound);
+}
+
+/*============================================================================
+ * WEIGHTS
+ *============================================================================*/
+
+typedef struct {
+    palma_semiring_t semiring;
+    uint64_t seed;
+    palma_weight_dist_t dist;
+    palma_val_t lo;
+    palma_val_t hi;
+    double log_lo;
+    double log_span;
+
+    /* Generator parameters */
+    size_t n;
+    size_t width;
+    size_t window;
+    double p;           /* Edge probability (grid, Erdős–Rényi) or mean degree (DAG) */
+} gen_t;
+
+static palma_error_t gen_init(gen_t *g, palma_semiring_t semiring, const palma_gen_options_t *opts) {
+    palma_gen_options_t defaults;
+    if (!opts) {
+        palma_gen_default_options(&defaults);
+        opts = &defaults;
+    }
+
+    memset(g, 0, sizeof(*g));
+    g->semiring = semiring;
+    g->seed = opts->seed;
+    g->dist = opts->weights;
+    g->lo = opts->min_weight;
+    g->hi = opts->max_weight;
+
+    if ((unsigned)semiring > PALMA_BOOLEAN) return PALMA_ERR_INVALID_ARG;
+    if (g->lo > g->hi || g->lo == PALMA_NEG_INF || g->hi == PALMA_POS_INF) {
+        return PALMA_ERR_INVALID_ARG;
+    }
+    switch (g->dist) {
+    case PALMA_WEIGHTS_UNIFORM:
+    case PALMA_WEIGHTS_CONSTANT:
+        break;
+    case PALMA_WEIGHTS_LOG_UNIFORM:
+        if (g->lo < 1) return PALMA_ERR_INVALID_ARG;
+        g->log_lo = log((double)g->lo);
+        g->log_span = log((double)g->hi) - g->log_lo;
+        break;
+    default:
+        return PALMA_ERR_INVALID_ARG;
+    }
+    return PALMA_SUCCESS;
+}
+
+static palma_val_t gen_weight(const gen_t *g, uint64_t *rng) {
+    if (g->semiring == PALMA_BOOLEAN) return 1;
+
+    switch (g->dist) {
+    case PALMA_WEIGHTS_CONSTANT:
+        return g->lo;
+    case PALMA_WEIGHTS_LOG_UNIFORM: {
+        double w = floor(exp(g->log_lo + rng_unit(rng) * g->log_span) + 0.5);
+        return (w > (double)g->hi) ? g->hi : (palma_val_t)w;
+    }
+    default:
+        return (palma_val_t)((int64_t)g->lo + (int64_t)rng_below(rng, (uint64_t)((int64_t)g->hi - g->lo) + 1));
+    }
+}
+
+void palma_gen_default_options(palma_gen_options_t *opts) {
+    if (!opts) return;
+    opts->seed = 1;
+    opts->weights = PALMA_WEIGHTS_UNIFORM;
+    opts->min_weight = 1;
+    opts->max_weight = 100;
+}
+
+/*============================================================================
+ * ROW-WISE ASSEMBLY
+ *
+ * A row function produces the entries of one row from its own stream and
+ * returns their number; with cols == NULL it only counts. It must make the
+ * same draws in both modes.
+ *============================================================================*/
+
+typedef size_t (*gen_row_fn)(const gen_t *g, size_t row, palma_idx_t *cols, palma_val_t *vals);
+
+static palma_sparse_t* gen_rows(const gen_t *g, gen_row_fn fn, bool sorted) {
+    size_t n = g->n;
+    if (n == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    if (n - 1 > PALMA_IDX_MAX) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+
+    size_t *count = (size_t*)malloc(n * sizeof(size_t));
+    if (!count) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    /* Pass 1: row lengths */
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_t i = 0; i < n; i++) {
+        count[i] = fn(g, i, NULL, NULL);
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += count[i];
+    }
+    if (total > PALMA_PTR_MAX) {
+        free(count);
+        PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+    }
+
+    palma_sparse_t *S = palma_sparse_create(n, n, total, g->semiring);
+    if (!S) {
+        free(count);
+        return NULL;
+    }
+    S->row_ptr[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        S->row_ptr[i + 1] = S->row_ptr[i] + (palma_ptr_t)count[i];
+    }
+    S->nnz = total;
+
+    /* Pass 2: fill at the prefix sums */
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+    #endif
+    for (size_t i = 0; i < n; i++) {
+        fn(g, i, S->col_idx + S->row_ptr[i], S->values + S->row_ptr[i]);
+    }
+    free(count);
+
+    if (!sorted) {
+        palma_ptr_t *len = (palma_ptr_t*)malloc(n * sizeof(palma_ptr_t));
+        palma_error_t err = len ? palma_csr_canonicalize(S, len) : PALMA_ERR_OUT_OF_MEMORY;
+        free(len);
+        if (err != PALMA_SUCCESS) {
+            palma_sparse_destroy(S);
+            PALMA_RETURN_NULL(err);
+        }
+    }
+    return S;
+}
+
+/*============================================================================
+ * ROAD-LIKE GRID
+ *============================================================================*/
+
+/*
+ * Street between u and its right (horizontal) or lower (vertical)
+ * neighbour: both endpoints draw the same existence test and weight.
+ */
+static bool grid_street(const gen_t *g, size_t u, bool vertical, palma_val_t *w) {
+    uint64_t rng = stream_seed(g->seed, SALT_GRID, 2 * (uint64_t)u + (vertical ? 1 : 0));
+    if (rng_unit(&rng) >= g->p) return false;
+    *w = gen_weight(g, &rng);
+    return true;
+}
+
+static size_t grid_row(const gen_t *g, size_t u, palma_idx_t *cols, palma_val_t *vals) {
+    size_t w = g->width, r = u / w, c = u % w, height = g->n / w, k = 0;
+    palma_val_t weight;
+
+    /* Neighbours in increasing index order: up, left, right, down */
+    struct { bool exists; size_t street; bool vertical; size_t v; } nb[4] = {
+        { r > 0,          u - w, true,  u - w },
+        { c > 0,          u - 1, false, u - 1 },
+        { c + 1 < w,      u,     false, u + 1 },
+        { r + 1 < height, u,     true,  u + w }
+    };
+
+    for (int d = 0; d < 4; d++) {
+        if (!nb[d].exists || !grid_street(g, nb[d].street, nb[d].vertical, &weight)) continue;
+        if (cols) {
+            cols[k] = (palma_idx_t)nb[d].v;
+            vals[k] = weight;
+        }
+        k++;
+    }
+    return k;
+}
+
+palma_sparse_t* palma_gen_grid(size_t width, size_t height, double keep,
+                               palma_semiring_t semiring, const palma_gen_options_t *opts) {
+    gen_t g;
+    palma_error_t err = gen_init(&g, semiring, opts);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (!(keep >= 0.0 && keep <= 1.0)) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    if (width == 0 || height == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    if (height > SIZE_MAX / width) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+
+    g.n = width * height;
+    g.width = width;
+    g.p = keep;
+    return gen_rows(&g, grid_row, true);
+}
+
+/*============================================================================
+ * RANDOM DAG
+ *============================================================================*/
+
+static size_t dag_row(const gen_t *g, size_t i, palma_idx_t *cols, palma_val_t *vals) {
+    size_t later = g->n - 1 - i;
+    size_t span = (g->window && g->window < later) ? g->window : later;
+    if (span == 0) return 0;
+
+    uint64_t rng = stream_seed(g->seed, SALT_DAG, i);
+    double whole = floor(g->p);
+    size_t degree = (size_t)whole + (rng_unit(&rng) < g->p - whole ? 1 : 0);
+
+    for (size_t k = 0; k < degree; k++) {
+        size_t j = i + 1 + (size_t)rng_below(&rng, span);
+        palma_val_t w = gen_weight(g, &rng);
+        if (cols) {
+            cols[k] = (palma_idx_t)j;
+            vals[k] = w;
+        }
+    }
+    return degree;
+}
+
+palma_sparse_t* palma_gen_dag(size_t n, double avg_degree, size_t window,
+                              palma_semiring_t semiring, const palma_gen_options_t *opts) {
+    gen_t g;
+    palma_error_t err = gen_init(&g, semiring, opts);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (!(avg_degree >= 0.0) || avg_degree > (double)PALMA_IDX_MAX) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    }
+
+    g.n = n;
+    g.window = window;
+    g.p = avg_degree;
+    return gen_rows(&g, dag_row, false);
+}
+
+/*============================================================================
+ * ERDŐS–RÉNYI
+ *============================================================================*/
+
+/*
+ * Geometric skipping (Batagelj and Brandes): the gap to the next edge among
+ * the n - 1 candidates of a row is geometric with parameter p.
+ */
+static size_t er_row(const gen_t *g, size_t i, palma_idx_t *cols, palma_val_t *vals) {
+    size_t candidates = g->n - 1, k = 0;
+    if (candidates == 0 || g->p <= 0.0) return 0;
+
+    uint64_t rng = stream_seed(g->seed, SALT_ER, i);
+    double log_q = log1p(-g->p);
+
+    for (size_t pos = 0;; pos++) {
+        if (g->p < 1.0) {
+            double skip = floor(log1p(-rng_unit(&rng)) / log_q);
+            if (skip >= (double)(candidates - pos)) break;
+            pos += (size_t)skip;
+        }
+        if (pos >= candidates) break;
+
+        palma_val_t w = gen_weight(g, &rng);
+        if (cols) {
+            cols[k] = (palma_idx_t)(pos < i ? pos : pos + 1);
+            vals[k] = w;
+        }
+        k++;
+    }
+    return k;
+}
+
+palma_sparse_t* palma_gen_erdos_renyi(size_t n, double avg_degree, palma_semiring_t semiring,
+                                      const palma_gen_options_t *opts) {
+    gen_t g;
+    palma_error_t err = gen_init(&g, semiring, opts);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (!(avg_degree >= 0.0) || (n > 0 && avg_degree > (double)(n - 1))) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    }
+
+    g.n = n;
+    g.p = (n > 1) ? avg_degree / (double)(n - 1) : 0.0;
+    return gen_rows(&g, er_row, true);
+}
+
+/*============================================================================
+ * R-MAT
+ *============================================================================*/
+
+/*
+ * Descend the initiator scale times; returns the (row, col) of edge e.
+ * Each level takes 16 random bits (quadrant probabilities resolve to
+ * 2^-16), so one draw serves four levels.
+ */
+static void rmat_edge(const gen_t *g, unsigned scale, const uint32_t *cdf, uint64_t e,
+                      uint32_t *row, uint32_t *col, palma_val_t *w) {
+    uint64_t rng = stream_seed(g->seed, SALT_RMAT, e);
+    uint64_t bits = 0;
+    uint32_t r = 0, c = 0;
+
+    for (unsigned level = 0; level < scale; level++) {
+        if ((level & 3) == 0) bits = rng_next(&rng);
+        uint32_t u = (uint32_t)(bits & 0xFFFF);
+        bits >>= 16;
+
+        /* Quadrants a | b | c | d in order: branchless, as they are unpredictable */
+        uint32_t lower = (u >= cdf[1]);
+        uint32_t right = (u >= cdf[0]) & ((u < cdf[1]) | (u >= cdf[2]));
+        r = (r << 1) | lower;
+        c = (c << 1) | right;
+    }
+    *row = r;
+    *col = c;
+    *w = gen_weight(g, &rng);
+}
+
+palma_sparse_t* palma_gen_rmat(unsigned int scale, double edge_factor, double a, double b,
+                               double c, palma_semiring_t semiring,
+                               const palma_gen_options_t *opts) {
+    gen_t g;
+    palma_error_t err = gen_init(&g, semiring, opts);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (!(a >= 0.0 && b >= 0.0 && c >= 0.0 && a + b + c <= 1.0 + 1e-12) || !(edge_factor >= 0.0)) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    }
+    if (scale == 0 || scale > 31) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    size_t n = (size_t)1 << scale;
+    double edges_d = edge_factor * (double)n;
+    if (edges_d > (double)PALMA_PTR_MAX) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+    size_t edges = (size_t)edges_d;
+
+    const uint32_t cdf[3] = {
+        (uint32_t)(a * 65536.0 + 0.5), (uint32_t)((a + b) * 65536.0 + 0.5),
+        (uint32_t)((a + b + c) * 65536.0 + 0.5)
+    };
+    palma_sparse_t *S = palma_sparse_create(n, n, edges, semiring);
+    uint32_t *perm = (uint32_t*)malloc(n * sizeof(uint32_t));
+    palma_ptr_t *cursor = (palma_ptr_t*)calloc(n, sizeof(palma_ptr_t));
+    if (!S || !perm || !cursor) {
+        err = S ? PALMA_ERR_OUT_OF_MEMORY : palma_get_last_error();
+        palma_sparse_destroy(S);
+        free(perm);
+        free(cursor);
+        PALMA_RETURN_NULL(err);
+    }
+
+    /* Seeded Fisher-Yates scramble of the vertex labels */
+    uint64_t rng = stream_seed(g.seed, SALT_PERM, 0);
+    for (size_t i = 0; i < n; i++) perm[i] = (uint32_t)i;
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j = (size_t)rng_below(&rng, i + 1);
+        uint32_t t = perm[i];
+        perm[i] = perm[j];
+        perm[j] = t;
+    }
+
+    /* Pass 1: out-degree of each scrambled source (self-loops dropped) */
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (size_t e = 0; e < edges; e++) {
+        uint32_t r, col;
+        palma_val_t w;
+        rmat_edge(&g, scale, cdf, e, &r, &col, &w);
+        if (r != col) __atomic_fetch_add(&cursor[perm[r]], 1, __ATOMIC_RELAXED);
+    }
+
+    S->row_ptr[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        S->row_ptr[i + 1] = S->row_ptr[i] + cursor[i];
+        cursor[i] = S->row_ptr[i];
+    }
+    S->nnz = S->row_ptr[n];
+
+    /* Pass 2: scatter into the row buckets, in any order */
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (size_t e = 0; e < edges; e++) {
+        uint32_t r, col;
+        palma_val_t w;
+        rmat_edge(&g, scale, cdf, e, &r, &col, &w);
+        if (r == col) continue;
+        palma_ptr_t at = __atomic_fetch_add(&cursor[perm[r]], 1, __ATOMIC_RELAXED);
+        S->col_idx[at] = perm[col];
+        S->values[at] = w;
+    }
+    free(perm);
+
+    /* Sorting makes the bucket order, and so the result, deterministic */
+    err = palma_csr_canonicalize(S, cursor);
+    free(cursor);
+    if (err != PALMA_SUCCESS) {
+        palma_sparse_destroy(S);
+        PALMA_RETURN_NULL(err);
+    }
+    return S;
+}
@@ -0,0 +1,547 @@
+/**
+ * @file palma_import.c
+ * @brief PALMA Graph Importers - Matrix Market and DIMACS shortest-path files
+ *
+ * The file is mapped read-only and the body is cut into chunks at line
+ * boundaries, which are parsed in parallel twice: the first pass validates
+ * the entries and counts them per row, the second scatters them into the
+ * CSR arrays at positions taken from the row prefix sums (a counting sort).
+ * Rows are then sorted by column and duplicate entries combined with ⊕.
+ * Apart from the result, the only extra memory is one cursor per row.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/* Minimum bytes per parse chunk */
+#define IMPORT_MIN_CHUNK (1u << 20)
+
+/*============================================================================
+ * INPUT DESCRIPTION
+ *============================================================================*/
+
+typedef enum {
+    FIELD_INTEGER,
+    FIELD_REAL,
+    FIELD_PATTERN
+} field_t;
+
+typedef enum {
+    SYM_GENERAL,
+    SYM_SYMMETRIC,
+    SYM_SKEW
+} symmetry_t;
+
+typedef struct {
+    const char *text;       /* Mapped file */
+    size_t size;
+    size_t body;            /* Offset of the first entry line */
+
+    bool dimacs;            /* "a u v w" lines, 'c' comments */
+    field_t field;
+    symmetry_t symmetry;
+    palma_val_t one;        /* Value of pattern entries */
+
+    size_t rows;
+    size_t cols;
+    size_t declared;        /* Entry lines announced by the header */
+} import_t;
+
+/*============================================================================
+ * TOKENS
+ *============================================================================*/
+
+static inline const char* skip_blanks(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+static bool parse_index(const char **s, const char *end, uint64_t *out) {
+    const char *p = skip_blanks(*s, end);
+    if (p == end || *p < '0' || *p > '9') return false;
+
+    uint64_t x = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        unsigned d = (unsigned)(*p++ - '0');
+        if (x > (UINT64_MAX - d) / 10) return false;
+        x = x * 10 + d;
+    }
+    *s = p;
+    *out = x;
+    return true;
+}
+
+static bool parse_int(const char **s, const char *end, palma_val_t *out) {
+    const char *p = skip_blanks(*s, end);
+    bool neg = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+
+    uint64_t x;
+    if (!parse_index(&p, end, &x) || x > (uint64_t)INT32_MAX + neg) return false;
+    *out = (palma_val_t)(neg ? -(int64_t)x : (int64_t)x);
+    *s = p;
+    return true;
+}
+
+/* Real values are rounded to the nearest integer */
+static bool parse_real(const char **s, const char *end, palma_val_t *out) {
+    const char *p = skip_blanks(*s, end);
+    char token[64];
+    size_t n = 0;
+    while (p + n < end && n < sizeof(token) - 1 && p[n] != ' ' && p[n] != '\t' &&
+           p[n] != '\r' && p[n] != '\n') {
+        token[n] = p[n];
+        n++;
+    }
+    if (n == 0 || n == sizeof(token) - 1) return false;
+    token[n] = '\0';
+
+    char *stop;
+    double x = strtod(token, &stop);
+    if (stop != token + n || !isfinite(x)) return false;
+    x = nearbyint(x);
+    if (x < (double)INT32_MIN || x > (double)INT32_MAX) return false;
+    *out = (palma_val_t)x;
+    *s = p + n;
+    return true;
+}
+
+/*============================================================================
+ * HEADERS
+ *============================================================================*/
+
+/* End of the line starting at pos (its newline, or the end of the file) */
+static const char* line_end(const import_t *in, size_t pos) {
+    const char *nl = (const char*)memchr(in->text + pos, '\n', in->size - pos);
+    return nl ? nl : in->text + in->size;
+}
+
+static palma_error_t read_mtx_header(import_t *in) {
+    const char *p = in->text, *end = line_end(in, 0);
+    char object[32], format[32], field[32], symmetry[32];
+
+    /* The banner is a single short line */
+    char banner[160];
+    size_t len = (size_t)(end - p) < sizeof(banner) - 1 ? (size_t)(end - p) : sizeof(banner) - 1;
+    memcpy(banner, p, len);
+    banner[len] = '\0';
+
+    if (sscanf(banner, "%%%%MatrixMarket %31s %31s %31s %31s", object, format, field, symmetry) != 4 ||
+        strcasecmp(object, "matrix") != 0) {
+        return PALMA_ERR_FILE_FORMAT;
+    }
+    if (strcasecmp(format, "coordinate") != 0) return PALMA_ERR_UNSUPPORTED;
+
+    if (strcasecmp(field, "integer") == 0) in->field = FIELD_INTEGER;
+    else if (strcasecmp(field, "real") == 0) in->field = FIELD_REAL;
+    else if (strcasecmp(field, "pattern") == 0) in->field = FIELD_PATTERN;
+    else return PALMA_ERR_UNSUPPORTED;
+
+    if (strcasecmp(symmetry, "general") == 0) in->symmetry = SYM_GENERAL;
+    else if (strcasecmp(symmetry, "symmetric") == 0) in->symmetry = SYM_SYMMETRIC;
+    else if (strcasecmp(symmetry, "skew-symmetric") == 0) in->symmetry = SYM_SKEW;
+    else return PALMA_ERR_UNSUPPORTED;
+
+    /* Not a valid combination: a pattern has no values to negate */
+    if (in->field == FIELD_PATTERN && in->symmetry == SYM_SKEW) return PALMA_ERR_FILE_FORMAT;
+
+    /* Comments, then "rows cols entries" */
+    size_t pos = (size_t)(end - in->text);
+    while (pos < in->size) {
+        pos++;
+        end = line_end(in, pos);
+        const char *q = skip_blanks(in->text + pos, end);
+        if (q == end || *q == '%') {
+            pos = (size_t)(end - in->text);
+            continue;
+        }
+
+        uint64_t rows, cols, nnz;
+        if (!parse_index(&q, end, &rows) || !parse_index(&q, end, &cols) ||
+            !parse_index(&q, end, &nnz) || skip_blanks(q, end) != end) {
+            return PALMA_ERR_FILE_FORMAT;
+        }
+        if (in->symmetry != SYM_GENERAL && rows != cols) return PALMA_ERR_FILE_FORMAT;
+
+        in->rows = (size_t)rows;
+        in->cols = (size_t)cols;
+        in->declared = (size_t)nnz;
+        in->body = (size_t)(end - in->text);
+        return PALMA_SUCCESS;
+    }
+    return PALMA_ERR_FILE_FORMAT;
+}
+
+static palma_error_t read_dimacs_header(import_t *in) {
+    size_t pos = 0;
+    while (pos < in->size) {
+        const char *end = line_end(in, pos);
+        const char *q = skip_blanks(in->text + pos, end);
+
+        if (q != end && *q == 'p') {
+            uint64_t n, m;
+            q = skip_blanks(q + 1, end);
+            if (end - q < 2 || q[0] != 's' || q[1] != 'p') return PALMA_ERR_FILE_FORMAT;
+            q += 2;
+            if (!parse_index(&q, end, &n) || !parse_index(&q, end, &m) || skip_blanks(q, end) != end) {
+                return PALMA_ERR_FILE_FORMAT;
+            }
+            in->rows = in->cols = (size_t)n;
+            in->declared = (size_t)m;
+            in->body = (size_t)(end - in->text);
+            return PALMA_SUCCESS;
+        }
+        if (q != end && *q != 'c') return PALMA_ERR_FILE_FORMAT;
+        pos = (size_t)(end - in->text) + 1;
+    }
+    return PALMA_ERR_FILE_FORMAT;
+}
+
+/*============================================================================
+ * PARALLEL PASSES
+ *============================================================================*/
+
+/*
+ * Parse the entry lines in [begin, end). With S == NULL the entries are
+ * counted per row into count[]; otherwise they are stored at
+ * cursor[row]++. Returns the number of entry lines, or sets *err.
+ */
+static size_t parse_chunk(const import_t *in, size_t begin, size_t end,
+                          palma_ptr_t *count, palma_ptr_t *cursor, palma_sparse_t *S,
+                          palma_error_t *err) {
+    const char *p = in->text + begin, *stop = in->text + end;
+    char comment = in->dimacs ? 'c' : '%';
+    size_t lines = 0;
+
+    while (p < stop) {
+        const char *eol = (const char*)memchr(p, '\n', (size_t)(stop - p));
+        if (!eol) eol = stop;
+        const char *q = skip_blanks(p, eol);
+        p = eol + 1;
+        if (q == eol || *q == comment) continue;
+
+        if (in->dimacs) {
+            if (*q != 'a') {
+                *err = PALMA_ERR_FILE_FORMAT;
+                return lines;
+            }
+            q++;
+        }
+
+        uint64_t i, j;
+        palma_val_t v = in->one;
+        bool ok = parse_index(&q, eol, &i) && parse_index(&q, eol, &j);
+        if (ok && in->field == FIELD_INTEGER) ok = parse_int(&q, eol, &v);
+        else if (ok && in->field == FIELD_REAL) ok = parse_real(&q, eol, &v);
+        if (!ok || skip_blanks(q, eol) != eol) {
+            *err = PALMA_ERR_FILE_FORMAT;
+            return lines;
+        }
+
+        /* Both formats are 1-based */
+        if (i == 0 || j == 0 || i > in->rows || j > in->cols) {
+            *err = PALMA_ERR_INDEX_BOUNDS;
+            return lines;
+        }
+        i--;
+        j--;
+
+        bool mirror = in->symmetry != SYM_GENERAL && i != j;
+        if (in->symmetry == SYM_SKEW && (i == j || v == PALMA_NEG_INF)) {
+            *err = PALMA_ERR_FILE_FORMAT;
+            return lines;
+        }
+
+        if (!S) {
+            __atomic_fetch_add(&count[i], 1, __ATOMIC_RELAXED);
+            if (mirror) __atomic_fetch_add(&count[j], 1, __ATOMIC_RELAXED);
+        } else {
+            palma_ptr_t k = __atomic_fetch_add(&cursor[i], 1, __ATOMIC_RELAXED);
+            S->col_idx[k] = (palma_idx_t)j;
+            S->values[k] = v;
+            if (mirror) {
+                k = __atomic_fetch_add(&cursor[j], 1, __ATOMIC_RELAXED);
+                S->col_idx[k] = (palma_idx_t)i;
+                S->values[k] = (in->symmetry == SYM_SKEW) ? -v : v;
+            }
+        }
+        lines++;
+    }
+    return lines;
+}
+
+/* Run one pass over all chunks; returns the total number of entry lines */
+static palma_error_t parse_pass(const import_t *in, const size_t *bounds, size_t n_chunks,
+                                palma_ptr_t *count, palma_ptr_t *cursor, palma_sparse_t *S,
+                                size_t *total) {
+    palma_error_t err = PALMA_SUCCESS;
+    size_t lines = 0;
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic) reduction(+:lines)
+    #endif
+    for (size_t c = 0; c < n_chunks; c++) {
+        palma_error_t chunk_err = PALMA_SUCCESS;
+        lines += parse_chunk(in, bounds[c], bounds[c + 1], count, cursor, S, &chunk_err);
+        if (chunk_err != PALMA_SUCCESS) {
+            #if PALMA_USE_OPENMP
+            #pragma omp critical(palma_import_error)
+            #endif
+            if (err == PALMA_SUCCESS) err = chunk_err;
+        }
+    }
+
+    *total = lines;
+    return err;
+}
+
+static void sort_keys(uint64_t *a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        uint64_t x = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1] > x) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = x;
+    }
+}
+
+static int cmp_key(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Sort each row by column and combine duplicates with ⊕, in place at the
+ * start of the row. Stores the number of distinct entries in len[i].
+ */
+static palma_error_t sort_rows(palma_sparse_t *S, palma_ptr_t *len) {
+    bool failed = false;
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel reduction(||:failed)
+    #endif
+    {
+        uint64_t *keys = NULL;
+        size_t cap = 0;
+
+        #if PALMA_USE_OPENMP
+        #pragma omp for schedule(dynamic, 256)
+        #endif
+        for (size_t i = 0; i < S->rows; i++) {
+            size_t begin = S->row_ptr[i], n = S->row_ptr[i + 1] - begin;
+            len[i] = (palma_ptr_t)n;
+            if (n < 2 || failed) continue;
+
+            if (n > cap) {
+                uint64_t *grown = (uint64_t*)realloc(keys, n * sizeof(uint64_t));
+                if (!grown) {
+                    failed = true;
+                    continue;
+                }
+                keys = grown;
+                cap = n;
+            }
+
+            /* Column in the high half: sorting the keys sorts the row */
+            for (size_t k = 0; k < n; k++) {
+                keys[k] = ((uint64_t)S->col_idx[begin + k] << 32) | (uint32_t)S->values[begin + k];
+            }
+            if (n > 32) qsort(keys, n, sizeof(uint64_t), cmp_key);
+            else sort_keys(keys, n);
+
+            size_t out = begin;
+            for (size_t k = 0; k < n; k++) {
+                palma_idx_t col = (palma_idx_t)(keys[k] >> 32);
+                palma_val_t val = (palma_val_t)(uint32_t)keys[k];
+                if (out > begin && S->col_idx[out - 1] == col) {
+                    S->values[out - 1] = palma_add(S->values[out - 1], val, S->semiring);
+                } else {
+                    S->col_idx[out] = col;
+                    S->values[out] = val;
+                    out++;
+                }
+            }
+            len[i] = (palma_ptr_t)(out - begin);
+        }
+        free(keys);
+    }
+
+    return failed ? PALMA_ERR_OUT_OF_MEMORY : PALMA_SUCCESS;
+}
+
+/* Close the gaps left by combined duplicates */
+static void compact_rows(palma_sparse_t *S, const palma_ptr_t *len) {
+    size_t out = 0;
+    for (size_t i = 0; i < S->rows; i++) {
+        size_t begin = S->row_ptr[i];
+        if (out != begin) {
+            memmove(S->col_idx + out, S->col_idx + begin, len[i] * sizeof(palma_idx_t));
+            memmove(S->values + out, S->values + begin, len[i] * sizeof(palma_val_t));
+        }
+        S->row_ptr[i] = (palma_ptr_t)out;
+        out += len[i];
+    }
+    S->row_ptr[S->rows] = (palma_ptr_t)out;
+    S->nnz = out;
+}
+
+palma_error_t palma_csr_canonicalize(palma_sparse_t *S, palma_ptr_t *len) {
+    palma_error_t err = sort_rows(S, len);
+    if (err == PALMA_SUCCESS) compact_rows(S, len);
+    return err;
+}
+
+/*============================================================================
+ * IMPORT
+ *============================================================================*/
+
+static palma_sparse_t* import_csr(import_t *in, palma_semiring_t semiring) {
+    if (in->rows == 0 || in->cols == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    /* Capacity is checked against the declared count before anything is allocated */
+    size_t mirrored = (in->symmetry != SYM_GENERAL) ? 2 : 1;
+    if (in->declared > PALMA_PTR_MAX / mirrored) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+    if (in->rows >= SIZE_MAX / sizeof(palma_ptr_t)) PALMA_RETURN_NULL(PALMA_ERR_OVERFLOW);
+
+    /* Chunk boundaries at line starts */
+    int threads = 1;
+    #if PALMA_USE_OPENMP
+    threads = omp_get_max_threads();
+    #endif
+    size_t body = in->size - in->body;
+    size_t n_chunks = (size_t)threads * 4;
+    if (n_chunks > body / IMPORT_MIN_CHUNK) n_chunks = body / IMPORT_MIN_CHUNK;
+    if (n_chunks == 0) n_chunks = 1;
+
+    size_t *bounds = (size_t*)malloc((n_chunks + 1) * sizeof(size_t));
+    palma_ptr_t *cursor = (palma_ptr_t*)malloc(in->rows * sizeof(palma_ptr_t));
+    palma_sparse_t *S = palma_sparse_create(in->rows, in->cols, in->declared * mirrored, semiring);
+    if (!bounds || !cursor || !S) {
+        palma_error_t err = S ? PALMA_ERR_OUT_OF_MEMORY : palma_get_last_error();
+        free(bounds);
+        free(cursor);
+        palma_sparse_destroy(S);
+        PALMA_RETURN_NULL(err);
+    }
+
+    bounds[0] = in->body;
+    for (size_t c = 1; c < n_chunks; c++) {
+        size_t at = in->body + body / n_chunks * c;
+        if (at < bounds[c - 1]) at = bounds[c - 1];
+        const char *nl = (const char*)memchr(in->text + at, '\n', in->size - at);
+        bounds[c] = nl ? (size_t)(nl - in->text) + 1 : in->size;
+    }
+    bounds[n_chunks] = in->size;
+
+    /* Pass 1: validate and count entries per row (row_ptr[i + 1]) */
+    size_t lines = 0;
+    palma_error_t err = parse_pass(in, bounds, n_chunks, S->row_ptr + 1, NULL, NULL, &lines);
+    if (err == PALMA_SUCCESS && lines != in->declared) err = PALMA_ERR_FILE_FORMAT;
+
+    if (err == PALMA_SUCCESS) {
+        for (size_t i = 0; i < in->rows; i++) {
+            cursor[i] = S->row_ptr[i];
+            S->row_ptr[i + 1] += S->row_ptr[i];
+        }
+
+        /* Pass 2: scatter into the row buckets */
+        err = parse_pass(in, bounds, n_chunks, NULL, cursor, S, &lines);
+    }
+
+    if (err == PALMA_SUCCESS) {
+        S->nnz = S->row_ptr[in->rows];
+        err = palma_csr_canonicalize(S, cursor);
+    }
+
+    free(bounds);
+    free(cursor);
+    if (err != PALMA_SUCCESS) {
+        palma_sparse_destroy(S);
+        PALMA_RETURN_NULL(err);
+    }
+    return S;
+}
+
+/* Map the file and run the format's header reader, then import */
+static palma_sparse_t* import_file(const char *filename, palma_semiring_t semiring, bool dimacs) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) PALMA_RETURN_NULL(PALMA_ERR_FILE_OPEN);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_READ);
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_FORMAT);
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) PALMA_RETURN_NULL(PALMA_ERR_FILE_READ);
+    #ifdef MADV_SEQUENTIAL
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    #endif
+
+    import_t in;
+    memset(&in, 0, sizeof(in));
+    in.text = (const char*)map;
+    in.size = (size_t)st.st_size;
+    in.dimacs = dimacs;
+    in.field = dimacs ? FIELD_INTEGER : FIELD_PATTERN;
+    in.symmetry = SYM_GENERAL;
+    in.one = palma_one(semiring);
+
+    palma_error_t err = dimacs ? read_dimacs_header(&in) : read_mtx_header(&in);
+    palma_sparse_t *S = NULL;
+    if (err == PALMA_SUCCESS) S = import_csr(&in, semiring);
+    else palma_set_last_error(err);
+
+    munmap(map, (size_t)st.st_size);
+    if (S) palma_clear_error();
+    return S;
+}
+
+palma_sparse_t* palma_sparse_load_mtx(const char *filename, palma_semiring_t semiring) {
+    return import_file(filename, semiring, false);
+}
+
+palma_sparse_t* palma_sparse_load_dimacs(const char *filename, palma_semiring_t semiring) {
+    return import_file(filename, semiring, true);
+}
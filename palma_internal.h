@@ -0,0 +1,135 @@
+/**
+ * @file palma_internal.h
+ * @brief PALMA internal helpers shared between translation units
+ *
+ * Not installed and not part of the public API.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ *
+ * @license MIT
+ */
+
+#ifndef PALMA_INTERNAL_H
+#define PALMA_INTERNAL_H
+
+#include "palma.h"
+
+/*============================================================================
+ * ERROR HELPERS
+ *============================================================================*/
+
+/* Set error and return it */
+#define PALMA_RETURN_ERROR(err) do { \
+    palma_set_last_error(err); \
+    return (err); \
+} while(0)
+
+/* Set error and return NULL */
+#define PALMA_RETURN_NULL(err) do { \
+    palma_set_last_error(err); \
+    return NULL; \
+} while(0)
+
+/*
+ * Cooperative interruption (palma_job.c). Long-running kernels call this once
+ * per outer iteration from the thread that entered them. It returns
+ * PALMA_ERR_CANCELLED or PALMA_ERR_TIMEOUT when the job running on this
+ * thread should stop, and PALMA_SUCCESS otherwise (always outside jobs).
+ */
+palma_error_t palma_interrupt_check(void);
+
+/* Header of palma_matrix_save_binary files (palma_ext.c, palma_stream.c) */
+#define PALMA_BINARY_MAGIC 0x504C4D41  /* "PLMA" */
+#define PALMA_BINARY_VERSION 1
+
+/*============================================================================
+ * MEMORY HELPERS
+ *============================================================================*/
+
+/* Aligned allocation (release with free()) */
+void* palma_aligned_alloc(size_t alignment, size_t size);
+
+/*
+ * Place freshly allocated, untouched matrix storage according to the NUMA
+ * mode (palma_numa.c). First touch zero-fills rows with the static OpenMP
+ * schedule used by the row-parallel kernels.
+ */
+void palma_numa_place(palma_val_t *data, size_t rows, size_t stride, palma_numa_t mode);
+
+/*
+ * True if the storage spans of two matrices or views intersect, from the
+ * first element to the last element of the last row. Conservative for
+ * strided views that interleave without sharing elements.
+ */
+static inline bool palma_matrix_overlaps(const palma_matrix_t *a, const palma_matrix_t *b) {
+    if (a->rows == 0 || a->cols == 0 || b->rows == 0 || b->cols == 0) return false;
+    const palma_val_t *a_end = a->data + (a->rows - 1) * a->stride + a->cols;
+    const palma_val_t *b_end = b->data + (b->rows - 1) * b->stride + b->cols;
+    return a->data < b_end && b->data < a_end;
+}
+
+/*============================================================================
+ * CSR ASSEMBLY (palma_import.c)
+ *============================================================================*/
+
+/*
+ * Sort each row of S (filled up to row_ptr, nnz set) by column, combine
+ * duplicate entries with ⊕ and close the gaps. len is scratch of S->rows
+ * entries. Rows are processed in parallel.
+ */
+palma_error_t palma_csr_canonicalize(palma_sparse_t *S, palma_ptr_t *len);
+
+/*============================================================================
+ * FIXED-SIZE KERNELS (palma_fixed.c)
+ *
+ * Return true if the dimensions matched a fixed size and the result was
+ * written, false if the caller should fall back to the generic kernel.
+ *============================================================================*/
+
+bool palma_fixed_mul(palma_matrix_t *C, const palma_matrix_t *A,
+                     const palma_matrix_t *B, palma_semiring_t semiring);
+
+bool palma_fixed_matvec(const palma_matrix_t *A, const palma_val_t *x,
+                        palma_val_t *y, palma_semiring_t semiring);
+
+bool palma_fixed_closure(palma_matrix_t *D, palma_semiring_t semiring);
+
+/*============================================================================
+ * BRANCHLESS SEMIRING OPERATIONS
+ *
+ * Element-wise versions of palma_add()/palma_mul() with the semiring fixed
+ * at compile time. They produce exactly the same results as the generic
+ * functions but contain only selects, so loops over them auto-vectorize.
+ *============================================================================*/
+
+static inline palma_val_t palma_op_max(palma_val_t a, palma_val_t b) {
+    return (a > b) ? a : b;
+}
+
+static inline palma_val_t palma_op_min(palma_val_t a, palma_val_t b) {
+    return (a < b) ? a : b;
+}
+
+static inline palma_val_t palma_op_or(palma_val_t a, palma_val_t b) {
+    return (a || b) ? 1 : 0;
+}
+
+static inline palma_val_t palma_op_and(palma_val_t a, palma_val_t b) {
+    return (a && b) ? 1 : 0;
+}
+
+/* Saturating a + b with -∞ absorbing and +∞ dominating finite values */
+static inline palma_val_t palma_op_plus(palma_val_t a, palma_val_t b) {
+    /* Wrapping 32-bit add; overflow iff the sign of r differs from both inputs */
+    palma_val_t r = (palma_val_t)((uint32_t)a + (uint32_t)b);
+    palma_val_t sat = (a < 0) ? PALMA_NEG_INF : PALMA_POS_INF;
+    r = (((a ^ r) & (b ^ r)) < 0) ? sat : r;
+    r = (a == PALMA_POS_INF || b == PALMA_POS_INF) ? PALMA_POS_INF : r;
+    r = (a == PALMA_NEG_INF || b == PALMA_NEG_INF) ? PALMA_NEG_INF : r;
+    return r;
+}
+
+#endif /* PALMA_INTERNAL_H */
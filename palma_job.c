@@ -0,0 +1,529 @@
+/**
+ * @file palma_job.c
+ * @brief PALMA Asynchronous Jobs - worker pool, notification and cancellation
+ *
+ * Jobs are queued in FIFO order and executed by a small pool of pthreads
+ * started on the first submission. One mutex protects the queue and every
+ * job's state; finished jobs are announced on a shared condition variable,
+ * through the optional callback and through an optional eventfd. The final
+ * state and the eventfd write are published under the mutex together, so a
+ * caller that sees either one also sees the other; the callback runs after
+ * both.
+ *
+ * Cancellation is cooperative. While a worker runs a job, a thread-local
+ * pointer names that job, and palma_interrupt_check() (called by the long
+ * kernels once per outer iteration) reports a cancel request or an expired
+ * time budget. Outside jobs the check is a single thread-local load.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+/*============================================================================
+ * TYPES
+ *============================================================================*/
+
+typedef enum {
+    JOB_CLOSURE,
+    JOB_TRANSITIVE_CLOSURE,
+    JOB_ALL_PAIRS,
+    JOB_EIGENVALUE
+} job_kind_t;
+
+struct palma_job {
+    job_kind_t kind;
+    palma_semiring_t semiring;
+    palma_matrix_t *input;          /* Private copy, freed once computed */
+    palma_matrix_t *result;
+    palma_val_t value;
+    palma_error_t error;
+    palma_job_state_t state;
+    bool cancel;                    /* Written under g_lock, read atomically by the worker */
+    bool busy;                      /* A worker still references the job */
+    double deadline;                /* Monotonic seconds, 0 = none */
+    palma_job_callback_t callback;
+    void *user_data;
+    int event_fd;
+    palma_job_t *next;
+};
+
+/*============================================================================
+ * POOL STATE
+ *============================================================================*/
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_work = PTHREAD_COND_INITIALIZER;    /* Queue non-empty or shutdown */
+static pthread_cond_t g_done = PTHREAD_COND_INITIALIZER;    /* Some job changed state */
+
+static palma_job_t *g_head = NULL;
+static palma_job_t *g_tail = NULL;
+static pthread_t *g_workers = NULL;
+static size_t g_n_workers = 0;
+static size_t g_target_workers = 1;
+static bool g_shutdown = false;     /* Same rule as job->cancel */
+
+/*
+ * Job executed by the current thread, if any. Must be per thread: a shared
+ * pointer would stop one worker with another's cancellation or deadline.
+ * __extension__ lets the C99 build use the C11 keyword without a warning.
+ */
+__extension__ static _Thread_local palma_job_t *g_current = NULL;
+
+/*============================================================================
+ * HELPERS
+ *============================================================================*/
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static bool is_final(palma_job_state_t state) {
+    return state == PALMA_JOB_DONE || state == PALMA_JOB_FAILED || state == PALMA_JOB_CANCELLED;
+}
+
+/* Unlink a queued job; caller holds g_lock */
+static void queue_remove(palma_job_t *job) {
+    palma_job_t **link = &g_head;
+    palma_job_t *prev = NULL;
+
+    while (*link && *link != job) {
+        prev = *link;
+        link = &(*link)->next;
+    }
+    if (!*link) return;
+
+    *link = job->next;
+    if (g_tail == job) g_tail = prev;
+    job->next = NULL;
+}
+
+/*
+ * Publish a final state and signal the eventfd; caller holds g_lock. The
+ * eventfd is non-blocking and the counter cannot overflow from one write,
+ * so writing under the lock never stalls.
+ */
+static void finish(palma_job_t *job, palma_job_state_t state) {
+    job->state = state;
+
+#if defined(__linux__)
+    if (job->event_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(job->event_fd, &one, sizeof(one));
+        (void)written;
+    }
+#endif
+
+    pthread_cond_broadcast(&g_done);
+}
+
+/* Completion callback; called without g_lock after finish() */
+static void notify(palma_job_t *job) {
+    if (job->callback) job->callback(job, job->user_data);
+}
+
+palma_error_t palma_interrupt_check(void) {
+    palma_job_t *job = g_current;
+    if (!job) return PALMA_SUCCESS;
+
+    /* Called once per outer iteration by every worker: read the flags
+     * without g_lock. palma_job_shutdown() cancels running jobs as well. */
+    bool cancel = __atomic_load_n(&job->cancel, __ATOMIC_ACQUIRE) ||
+                  __atomic_load_n(&g_shutdown, __ATOMIC_ACQUIRE);
+
+    if (cancel) return PALMA_ERR_CANCELLED;
+    if (job->deadline > 0.0 && monotonic_seconds() > job->deadline) return PALMA_ERR_TIMEOUT;
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * WORKERS
+ *============================================================================*/
+
+static void run_job(palma_job_t *job) {
+    palma_error_t err = palma_interrupt_check();
+    const palma_matrix_t *A = job->input;
+
+    if (err == PALMA_SUCCESS && job->kind != JOB_EIGENVALUE) {
+        job->result = palma_matrix_create(A->rows, A->cols);
+        if (!job->result) err = PALMA_ERR_OUT_OF_MEMORY;
+    }
+
+    if (err == PALMA_SUCCESS) {
+        switch (job->kind) {
+            case JOB_CLOSURE:
+                err = palma_matrix_closure_into(job->result, A, job->semiring);
+                break;
+            case JOB_TRANSITIVE_CLOSURE:
+                err = palma_matrix_transitive_closure_into(job->result, A, job->semiring);
+                break;
+            case JOB_ALL_PAIRS:
+                err = palma_all_pairs_paths_into(job->result, A, job->semiring);
+                break;
+            case JOB_EIGENVALUE:
+                palma_clear_error();
+                job->value = palma_eigenvalue(A, job->semiring);
+                err = palma_get_last_error();
+                break;
+        }
+    }
+
+    if (err != PALMA_SUCCESS) {
+        palma_matrix_destroy(job->result);
+        job->result = NULL;
+        job->value = PALMA_NEG_INF;
+    }
+
+    palma_matrix_destroy(job->input);
+    job->input = NULL;
+    job->error = err;
+}
+
+static void* worker_main(void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&g_lock);
+    for (;;) {
+        while (!g_head && !g_shutdown) pthread_cond_wait(&g_work, &g_lock);
+        if (!g_head) break;
+
+        palma_job_t *job = g_head;
+        queue_remove(job);
+        job->state = PALMA_JOB_RUNNING;
+        job->busy = true;
+        pthread_cond_broadcast(&g_done);
+        pthread_mutex_unlock(&g_lock);
+
+        g_current = job;
+        run_job(job);
+        g_current = NULL;
+
+        pthread_mutex_lock(&g_lock);
+        finish(job, (job->error == PALMA_SUCCESS) ? PALMA_JOB_DONE :
+                    (job->error == PALMA_ERR_CANCELLED) ? PALMA_JOB_CANCELLED : PALMA_JOB_FAILED);
+        pthread_mutex_unlock(&g_lock);
+
+        notify(job);
+
+        pthread_mutex_lock(&g_lock);
+        job->busy = false;
+        pthread_cond_broadcast(&g_done);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    return NULL;
+}
+
+/* Start workers up to the target count; caller holds g_lock */
+static palma_error_t ensure_workers(void) {
+    if (g_shutdown) return PALMA_ERR_UNSUPPORTED;
+    if (g_n_workers >= g_target_workers) return PALMA_SUCCESS;
+
+    pthread_t *workers = (pthread_t*)realloc(g_workers, g_target_workers * sizeof(pthread_t));
+    if (!workers) return PALMA_ERR_OUT_OF_MEMORY;
+    g_workers = workers;
+
+    while (g_n_workers < g_target_workers) {
+        if (pthread_create(&g_workers[g_n_workers], NULL, worker_main, NULL) != 0) {
+            return g_n_workers > 0 ? PALMA_SUCCESS : PALMA_ERR_UNSUPPORTED;
+        }
+        g_n_workers++;
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_job_set_workers(size_t n) {
+    if (n == 0) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    palma_error_t err = PALMA_SUCCESS;
+
+    pthread_mutex_lock(&g_lock);
+    if (n < g_n_workers) {
+        err = PALMA_ERR_UNSUPPORTED;
+    } else {
+        g_target_workers = n;
+        if (g_n_workers > 0) err = ensure_workers();
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+void palma_job_shutdown(void) {
+    palma_job_t *cancelled = NULL;
+
+    pthread_mutex_lock(&g_lock);
+    while (g_head) {
+        palma_job_t *job = g_head;
+        queue_remove(job);
+        job->error = PALMA_ERR_CANCELLED;
+        job->busy = true;
+        finish(job, PALMA_JOB_CANCELLED);
+        job->next = cancelled;
+        cancelled = job;
+    }
+    __atomic_store_n(&g_shutdown, true, __ATOMIC_RELEASE);   /* Seen at the next interrupt check */
+    pthread_cond_broadcast(&g_work);
+    pthread_cond_broadcast(&g_done);
+    pthread_mutex_unlock(&g_lock);
+
+    while (cancelled) {
+        palma_job_t *job = cancelled;
+        cancelled = job->next;
+        job->next = NULL;
+        notify(job);
+        pthread_mutex_lock(&g_lock);
+        job->busy = false;
+        pthread_cond_broadcast(&g_done);
+        pthread_mutex_unlock(&g_lock);
+    }
+
+    for (size_t i = 0; i < g_n_workers; i++) pthread_join(g_workers[i], NULL);
+
+    pthread_mutex_lock(&g_lock);
+    free(g_workers);
+    g_workers = NULL;
+    g_n_workers = 0;
+    __atomic_store_n(&g_shutdown, false, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_lock);
+}
+
+/*============================================================================
+ * SUBMISSION
+ *============================================================================*/
+
+static palma_job_t* job_submit(job_kind_t kind, const palma_matrix_t *A,
+                               palma_semiring_t semiring, const palma_job_options_t *opts) {
+    if (!A) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_NULL(PALMA_ERR_NOT_SQUARE);
+    if ((unsigned)semiring > PALMA_BOOLEAN) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+
+    palma_job_t *job = (palma_job_t*)calloc(1, sizeof(palma_job_t));
+    if (!job) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    job->kind = kind;
+    job->semiring = semiring;
+    job->value = PALMA_NEG_INF;
+    job->state = PALMA_JOB_QUEUED;
+    job->event_fd = -1;
+
+    job->input = palma_matrix_create(A->rows, A->cols);
+    if (!job->input) {
+        free(job);
+        return NULL;
+    }
+    palma_matrix_copy(job->input, A);
+
+    if (opts) {
+        if (opts->time_budget > 0.0) job->deadline = monotonic_seconds() + opts->time_budget;
+        job->callback = opts->callback;
+        job->user_data = opts->user_data;
+
+        if (opts->notify_fd) {
+#if defined(__linux__)
+            job->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#endif
+            if (job->event_fd < 0) {
+                palma_matrix_destroy(job->input);
+                free(job);
+                PALMA_RETURN_NULL(PALMA_ERR_UNSUPPORTED);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&g_lock);
+    palma_error_t err = ensure_workers();
+    if (err == PALMA_SUCCESS) {
+        if (g_tail) g_tail->next = job;
+        else g_head = job;
+        g_tail = job;
+        pthread_cond_signal(&g_work);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (err != PALMA_SUCCESS) {
+        if (job->event_fd >= 0) close(job->event_fd);
+        palma_matrix_destroy(job->input);
+        free(job);
+        PALMA_RETURN_NULL(err);
+    }
+
+    return job;
+}
+
+palma_job_t* palma_job_closure(const palma_matrix_t *A, palma_semiring_t semiring,
+                               const palma_job_options_t *opts) {
+    return job_submit(JOB_CLOSURE, A, semiring, opts);
+}
+
+palma_job_t* palma_job_transitive_closure(const palma_matrix_t *A, palma_semiring_t semiring,
+                                          const palma_job_options_t *opts) {
+    return job_submit(JOB_TRANSITIVE_CLOSURE, A, semiring, opts);
+}
+
+palma_job_t* palma_job_all_pairs_paths(const palma_matrix_t *adj, palma_semiring_t semiring,
+                                       const palma_job_options_t *opts) {
+    return job_submit(JOB_ALL_PAIRS, adj, semiring, opts);
+}
+
+palma_job_t* palma_job_eigenvalue(const palma_matrix_t *A, palma_semiring_t semiring,
+                                  const palma_job_options_t *opts) {
+    return job_submit(JOB_EIGENVALUE, A, semiring, opts);
+}
+
+/*============================================================================
+ * OBSERVATION AND CONTROL
+ *============================================================================*/
+
+palma_job_state_t palma_job_poll(palma_job_t *job) {
+    if (!job) return PALMA_JOB_FAILED;
+
+    pthread_mutex_lock(&g_lock);
+    palma_job_state_t state = job->state;
+    pthread_mutex_unlock(&g_lock);
+
+    return state;
+}
+
+palma_job_state_t palma_job_wait(palma_job_t *job, double timeout) {
+    if (!job) return PALMA_JOB_FAILED;
+
+    struct timespec until;
+    if (timeout >= 0.0) {
+        clock_gettime(CLOCK_REALTIME, &until);
+        double secs = (double)until.tv_sec + (double)until.tv_nsec * 1e-9 + timeout;
+        until.tv_sec = (time_t)secs;
+        until.tv_nsec = (long)((secs - (double)until.tv_sec) * 1e9);
+    }
+
+    pthread_mutex_lock(&g_lock);
+    while (!is_final(job->state)) {
+        if (timeout < 0.0) {
+            pthread_cond_wait(&g_done, &g_lock);
+        } else if (pthread_cond_timedwait(&g_done, &g_lock, &until) != 0) {
+            break;
+        }
+    }
+    palma_job_state_t state = job->state;
+    pthread_mutex_unlock(&g_lock);
+
+    return state;
+}
+
+void palma_job_cancel(palma_job_t *job) {
+    if (!job) return;
+
+    bool dequeued = false;
+
+    pthread_mutex_lock(&g_lock);
+    __atomic_store_n(&job->cancel, true, __ATOMIC_RELEASE);
+    if (job->state == PALMA_JOB_QUEUED) {
+        queue_remove(job);
+        job->error = PALMA_ERR_CANCELLED;
+        job->busy = true;
+        dequeued = true;
+        finish(job, PALMA_JOB_CANCELLED);
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (dequeued) {
+        palma_matrix_destroy(job->input);
+        job->input = NULL;
+        notify(job);
+
+        pthread_mutex_lock(&g_lock);
+        job->busy = false;
+        pthread_cond_broadcast(&g_done);
+        pthread_mutex_unlock(&g_lock);
+    }
+}
+
+palma_error_t palma_job_error(palma_job_t *job) {
+    if (!job) return PALMA_ERR_NULL_PTR;
+
+    pthread_mutex_lock(&g_lock);
+    palma_error_t err = is_final(job->state) ? job->error : PALMA_SUCCESS;
+    pthread_mutex_unlock(&g_lock);
+
+    return err;
+}
+
+palma_matrix_t* palma_job_take_matrix(palma_job_t *job) {
+    if (!job) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    palma_matrix_t *result = NULL;
+
+    pthread_mutex_lock(&g_lock);
+    if (job->state == PALMA_JOB_DONE) {
+        result = job->result;
+        job->result = NULL;
+    }
+    pthread_mutex_unlock(&g_lock);
+
+    if (!result) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    return result;
+}
+
+palma_val_t palma_job_value(palma_job_t *job) {
+    if (!job) return PALMA_NEG_INF;
+
+    pthread_mutex_lock(&g_lock);
+    palma_val_t value = (job->state == PALMA_JOB_DONE) ? job->value : PALMA_NEG_INF;
+    pthread_mutex_unlock(&g_lock);
+
+    return value;
+}
+
+int palma_job_fd(const palma_job_t *job) {
+    return job ? job->event_fd : -1;
+}
+
+void palma_job_destroy(palma_job_t *job) {
+    if (!job) return;
+
+    pthread_mutex_lock(&g_lock);
+    __atomic_store_n(&job->cancel, true, __ATOMIC_RELEASE);
+    if (job->state == PALMA_JOB_QUEUED) {
+        queue_remove(job);
+        job->error = PALMA_ERR_CANCELLED;
+        finish(job, PALMA_JOB_CANCELLED);
+    }
+    while (!is_final(job->state) || job->busy) pthread_cond_wait(&g_done, &g_lock);
+    pthread_mutex_unlock(&g_lock);
+
+    if (job->event_fd >= 0) close(job->event_fd);
+    palma_matrix_destroy(job->input);
+    palma_matrix_destroy(job->result);
+    free(job);
+}
@@ -0,0 +1,259 @@
+/**
+ * @file palma_numa.c
+ * @brief PALMA NUMA Placement - first touch, interleaving and thread binding
+ *
+ * Linux places a page on the node of the thread that first writes it. A
+ * matrix initialized by one thread therefore lives entirely on one socket
+ * and every OpenMP thread on the other socket reads it over the
+ * interconnect. The helpers here first-touch new matrices with the same
+ * static row partition the parallel kernels use, pin OpenMP threads to nodes
+ * so that partition stays local, and interleave shared read-only operands.
+ *
+ * Node topology is read from sysfs and memory policy is set with the raw
+ * mbind system call, so no libnuma is required. On other platforms every
+ * function degrades to a single-node no-op.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/*============================================================================
+ * INTERNAL CONSTANTS
+ *============================================================================*/
+
+/* Smaller matrices are not worth an OpenMP team or an mbind call */
+#define NUMA_MIN_BYTES (256u * 1024u)
+
+/* Upper bound on node ids handled (size of the mbind node mask) */
+#define NUMA_MAX_NODES 64
+
+/* From <linux/mempolicy.h>, which is not always installed */
+#define NUMA_MPOL_INTERLEAVE 3
+#define NUMA_MPOL_MF_MOVE (1 << 1)
+
+/*============================================================================
+ * TOPOLOGY
+ *============================================================================*/
+
+#if defined(__linux__)
+
+/*
+ * Parse a sysfs list such as "0-3,8,10-11". Calls fn for every id.
+ * Returns the number of ids, or -1 if the file cannot be read.
+ */
+static int parse_id_list(const char *path, void (*fn)(int id, void *ctx), void *ctx) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char buf[4096];
+    size_t len = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[len] = '\0';
+
+    int count = 0;
+    char *p = buf;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) break;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long id = lo; id <= hi; id++) {
+            if (fn) fn((int)id, ctx);
+            count++;
+        }
+        if (*p == ',') p++;
+        else break;
+    }
+
+    return count;
+}
+
+static void collect_node(int id, void *ctx) {
+    int *nodes = (int*)ctx;
+    if (nodes[0] < NUMA_MAX_NODES && id < NUMA_MAX_NODES) {
+        nodes[1 + nodes[0]++] = id;
+    }
+}
+
+#if PALMA_USE_OPENMP
+static void collect_cpu(int id, void *ctx) {
+    cpu_set_t *set = (cpu_set_t*)ctx;
+    if (id >= 0 && id < CPU_SETSIZE) CPU_SET(id, set);
+}
+#endif
+
+/* nodes[0] = count, nodes[1..count] = node ids; read once */
+static int numa_nodes[1 + NUMA_MAX_NODES];
+static pthread_once_t numa_nodes_once = PTHREAD_ONCE_INIT;
+
+static void load_nodes(void) {
+    numa_nodes[0] = 0;
+    parse_id_list("/sys/devices/system/node/online", collect_node, numa_nodes);
+    if (numa_nodes[0] == 0) {
+        numa_nodes[0] = 1;
+        numa_nodes[1] = 0;
+    }
+}
+
+/* Any thread may place a matrix: pthread_once, with or without OpenMP */
+static const int* online_nodes(void) {
+    pthread_once(&numa_nodes_once, load_nodes);
+    return numa_nodes;
+}
+
+static long sys_mbind(void *addr, size_t len, int mode, const unsigned long *mask,
+                      unsigned long maxnode, unsigned flags) {
+#if defined(SYS_mbind)
+    return syscall(SYS_mbind, addr, len, mode, mask, maxnode, flags);
+#else
+    (void)addr; (void)len; (void)mode; (void)mask; (void)maxnode; (void)flags;
+    return -1;
+#endif
+}
+
+/* Interleave the whole pages inside [data, data + size) across all nodes */
+static int interleave_range(void *data, size_t size, unsigned flags) {
+    const int *nodes = online_nodes();
+    if (nodes[0] < 2) return 0;
+
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) return -1;
+
+    uintptr_t start = ((uintptr_t)data + (uintptr_t)page - 1) & ~((uintptr_t)page - 1);
+    uintptr_t end = ((uintptr_t)data + size) & ~((uintptr_t)page - 1);
+    if (end <= start) return 0;
+
+    unsigned long mask[NUMA_MAX_NODES / (8 * sizeof(unsigned long)) + 1];
+    memset(mask, 0, sizeof(mask));
+    for (int i = 1; i <= nodes[0]; i++) {
+        int id = nodes[i];
+        mask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+    }
+
+    return (int)sys_mbind((void*)start, end - start, NUMA_MPOL_INTERLEAVE,
+                          mask, NUMA_MAX_NODES + 1, flags);
+}
+
+#endif /* __linux__ */
+
+int palma_numa_node_count(void) {
+#if defined(__linux__)
+    return online_nodes()[0];
+#else
+    return 1;
+#endif
+}
+
+/*============================================================================
+ * THREAD BINDING
+ *============================================================================*/
+
+palma_error_t palma_numa_bind_threads(void) {
+#if defined(__linux__) && PALMA_USE_OPENMP
+    const int *nodes = online_nodes();
+    if (nodes[0] < 2) return PALMA_SUCCESS;
+
+    int failed = 0;
+
+    #pragma omp parallel reduction(|:failed)
+    {
+        int t = omp_get_thread_num();
+        int nt = omp_get_num_threads();
+
+        /* Block distribution, matching schedule(static) row ownership */
+        int node = nodes[1 + (int)((long)t * nodes[0] / nt)];
+
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (parse_id_list(path, collect_cpu, &set) <= 0 ||
+            sched_setaffinity(0, sizeof(set), &set) != 0) {
+            failed = 1;
+        }
+    }
+
+    if (failed) PALMA_RETURN_ERROR(PALMA_ERR_UNSUPPORTED);
+#endif
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * PLACEMENT
+ *============================================================================*/
+
+void palma_numa_place(palma_val_t *data, size_t rows, size_t stride, palma_numa_t mode) {
+    size_t size = rows * stride * sizeof(palma_val_t);
+    if (mode == PALMA_NUMA_NONE || size < NUMA_MIN_BYTES) return;
+
+#if defined(__linux__)
+    if (palma_numa_node_count() < 2) return;
+
+    if (mode == PALMA_NUMA_INTERLEAVE) {
+        /* Policy only; pages are placed when first written */
+        interleave_range(data, size, 0);
+        return;
+    }
+
+#if PALMA_USE_OPENMP
+    /* Same partition as the schedule(static) row loops in the kernels */
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < rows; i++) {
+        memset(&data[i * stride], 0, stride * sizeof(palma_val_t));
+    }
+#endif
+#else
+    (void)data; (void)rows; (void)stride;
+#endif
+}
+
+palma_error_t palma_matrix_numa_interleave(palma_matrix_t *A) {
+    if (!A || !A->data) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+#if defined(__linux__)
+    /* Views end at their last column, not at the parent's row end */
+    size_t size = ((A->rows - 1) * A->stride + A->cols) * sizeof(palma_val_t);
+    if (interleave_range(A->data, size, NUMA_MPOL_MF_MOVE) != 0) {
+        PALMA_RETURN_ERROR(PALMA_ERR_UNSUPPORTED);
+    }
+#endif
+    return PALMA_SUCCESS;
+}
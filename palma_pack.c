@@ -0,0 +1,733 @@
+/**
+ * @file palma_pack.c
+ * @brief PALMA Packed Files - compressed dense and sparse matrices
+ *
+ * A packed file is a header, a chunk offset table and independent chunks of
+ * PALMA_PACK_CHUNK_ROWS rows each, so chunks can be decoded in parallel and
+ * a row range can be read without touching the rest of the file.
+ *
+ * Dense chunk:
+ *   varint n_finite, varint runs_bytes
+ *   runs:   per row, varints (length << 2 | kind) covering the row, where
+ *           kind 0 = -∞ run, 1 = +∞ run, 2 = run of finite values
+ *   values: the finite values in row-major order, frame-of-reference packed
+ *
+ * Sparse chunk:
+ *   varint nnz, then one varint length per row
+ *   columns: per row, the first column, then gaps minus one (varints)
+ *   values:  frame-of-reference packed
+ *
+ * Frame of reference: blocks of PACK_BLOCK values stored as an int32 base,
+ * a bit width w and the offsets from the base packed in w bits each.
+ * Multi-byte fields are in host byte order, as in palma_matrix_save_binary.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/*============================================================================
+ * FORMAT
+ *============================================================================*/
+
+#define PACK_MAGIC    0x5A4D4C50u  /* "PLMZ" */
+#define PACK_VERSION  1
+#define PACK_DENSE    0
+#define PACK_SPARSE   1
+#define PACK_BLOCK    128
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t kind;
+    int32_t semiring;       /* Sparse only */
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t nnz;           /* Sparse only */
+    uint32_t chunk_rows;
+    uint32_t n_chunks;
+} pack_header_t;            /* Followed by n_chunks + 1 uint64_t offsets */
+
+/*============================================================================
+ * BYTE BUFFERS
+ *============================================================================*/
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+    bool failed;
+} buf_t;
+
+static bool buf_reserve(buf_t *b, size_t extra) {
+    if (b->failed) return false;
+    if (b->len + extra <= b->cap) return true;
+    size_t cap = b->cap ? b->cap * 2 : 4096;
+    while (cap < b->len + extra) cap *= 2;
+    uint8_t *data = (uint8_t*)realloc(b->data, cap);
+    if (!data) {
+        b->failed = true;
+        return false;
+    }
+    b->data = data;
+    b->cap = cap;
+    return true;
+}
+
+static void put_bytes(buf_t *b, const void *p, size_t n) {
+    if (!buf_reserve(b, n)) return;
+    memcpy(b->data + b->len, p, n);
+    b->len += n;
+}
+
+static void put_varint(buf_t *b, uint64_t x) {
+    if (!buf_reserve(b, 10)) return;
+    while (x >= 0x80) {
+        b->data[b->len++] = (uint8_t)(x | 0x80);
+        x >>= 7;
+    }
+    b->data[b->len++] = (uint8_t)x;
+}
+
+/* Frame-of-reference: per block, base (int32), width (uint8), packed offsets */
+static void put_for(buf_t *b, const palma_val_t *v, size_t n) {
+    for (size_t s = 0; s < n; s += PACK_BLOCK) {
+        size_t m = (n - s < PACK_BLOCK) ? n - s : PACK_BLOCK;
+        palma_val_t lo = v[s], hi = v[s];
+        for (size_t k = 1; k < m; k++) {
+            if (v[s + k] < lo) lo = v[s + k];
+            if (v[s + k] > hi) hi = v[s + k];
+        }
+        uint32_t range = (uint32_t)((int64_t)hi - (int64_t)lo);
+        uint8_t width = 0;
+        while (width < 32 && (range >> width) != 0) width++;
+
+        int32_t base = lo;
+        put_bytes(b, &base, sizeof(base));
+        put_bytes(b, &width, 1);
+        if (width == 0 || !buf_reserve(b, (m * width + 7) / 8)) continue;
+
+        uint64_t acc = 0;
+        unsigned bits = 0;
+        for (size_t k = 0; k < m; k++) {
+            acc |= (uint64_t)(uint32_t)((int64_t)v[s + k] - (int64_t)lo) << bits;
+            bits += width;
+            while (bits >= 8) {
+                b->data[b->len++] = (uint8_t)acc;
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0) b->data[b->len++] = (uint8_t)acc;
+    }
+}
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool bad;
+} reader_t;
+
+static uint64_t get_varint(reader_t *r) {
+    uint64_t x = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (r->p >= r->end) break;
+        uint8_t byte = *r->p++;
+        x |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return x;
+    }
+    r->bad = true;
+    return 0;
+}
+
+static bool get_for(reader_t *r, palma_val_t *out, size_t n) {
+    for (size_t s = 0; s < n; s += PACK_BLOCK) {
+        size_t m = (n - s < PACK_BLOCK) ? n - s : PACK_BLOCK;
+        if ((size_t)(r->end - r->p) < 5) return false;
+
+        int32_t base;
+        memcpy(&base, r->p, sizeof(base));
+        uint8_t width = r->p[4];
+        r->p += 5;
+        if (width > 32) return false;
+
+        size_t bytes = (m * width + 7) / 8;
+        if ((size_t)(r->end - r->p) < bytes) return false;
+
+        if (width == 0) {
+            for (size_t k = 0; k < m; k++) out[s + k] = base;
+            continue;
+        }
+
+        uint64_t acc = 0, mask = ((uint64_t)1 << width) - 1;
+        unsigned bits = 0;
+        const uint8_t *q = r->p;
+        for (size_t k = 0; k < m; k++) {
+            while (bits < width) {
+                acc |= (uint64_t)*q++ << bits;
+                bits += 8;
+            }
+            out[s + k] = (palma_val_t)((int64_t)base + (int64_t)(acc & mask));
+            acc >>= width;
+            bits -= width;
+        }
+        r->p += bytes;
+    }
+    return true;
+}
+
+/*============================================================================
+ * CHUNK CODECS
+ *============================================================================*/
+
+static inline unsigned value_kind(palma_val_t v) {
+    return v == PALMA_NEG_INF ? 0 : (v == PALMA_POS_INF ? 1 : 2);
+}
+
+static void encode_dense_chunk(buf_t *out, const palma_matrix_t *A, size_t r0, size_t r1,
+                               palma_val_t *finite) {
+    buf_t runs = {0};
+    size_t n_finite = 0;
+
+    for (size_t i = r0; i < r1; i++) {
+        const palma_val_t *row = A->data + i * A->stride;
+        size_t j = 0;
+        while (j < A->cols) {
+            unsigned kind = value_kind(row[j]);
+            size_t k = j;
+            while (k < A->cols && value_kind(row[k]) == kind) {
+                if (kind == 2) finite[n_finite++] = row[k];
+                k++;
+            }
+            put_varint(&runs, ((uint64_t)(k - j) << 2) | kind);
+            j = k;
+        }
+    }
+
+    put_varint(out, n_finite);
+    put_varint(out, runs.len);
+    put_bytes(out, runs.data, runs.len);
+    put_for(out, finite, n_finite);
+    if (runs.failed) out->failed = true;
+    free(runs.data);
+}
+
+/* Decode a dense chunk into n_rows rows of out, starting at row `at` */
+static bool decode_dense_chunk(reader_t *r, palma_matrix_t *out, size_t at, size_t n_rows,
+                               palma_val_t **scratch, size_t *scratch_cap) {
+    uint64_t n_finite = get_varint(r);
+    uint64_t runs_bytes = get_varint(r);
+    if (r->bad || runs_bytes > (uint64_t)(r->end - r->p)) return false;
+    if (n_finite > (uint64_t)n_rows * out->cols) return false;
+
+    reader_t runs = { r->p, r->p + runs_bytes, false };
+    r->p += runs_bytes;
+
+    if (n_finite > *scratch_cap) {
+        palma_val_t *s = (palma_val_t*)realloc(*scratch, n_finite * sizeof(palma_val_t));
+        if (!s) return false;
+        *scratch = s;
+        *scratch_cap = n_finite;
+    }
+    if (!get_for(r, *scratch, n_finite)) return false;
+
+    const palma_val_t *fin = *scratch;
+    size_t used = 0;
+    for (size_t i = 0; i < n_rows; i++) {
+        palma_val_t *row = out->data + (at + i) * out->stride;
+        size_t j = 0;
+        while (j < out->cols) {
+            uint64_t token = get_varint(&runs);
+            uint64_t len = token >> 2;
+            unsigned kind = (unsigned)(token & 3);
+            if (runs.bad || len == 0 || len > out->cols - j || kind > 2) return false;
+
+            if (kind == 2) {
+                if (len > n_finite - used) return false;
+                memcpy(row + j, fin + used, len * sizeof(palma_val_t));
+                used += len;
+            } else {
+                palma_val_t v = kind ? PALMA_POS_INF : PALMA_NEG_INF;
+                for (size_t k = 0; k < len; k++) row[j + k] = v;
+            }
+            j += len;
+        }
+    }
+    return used == n_finite && runs.p == runs.end;
+}
+
+/*
+ * Walk the run tokens of a dense chunk without decoding values: each of
+ * n_rows rows must be covered by exactly cols elements. Run lengths are
+ * unbounded varints, so this is the only way to tell a wide matrix from a
+ * corrupt cols field before the output is allocated.
+ */
+static bool dense_chunk_shape_ok(reader_t r, size_t n_rows, uint64_t cols) {
+    uint64_t n_finite = get_varint(&r);
+    uint64_t runs_bytes = get_varint(&r);
+    if (r.bad || runs_bytes > (uint64_t)(r.end - r.p)) return false;
+
+    reader_t runs = { r.p, r.p + runs_bytes, false };
+    uint64_t finite = 0;
+    for (size_t i = 0; i < n_rows; i++) {
+        uint64_t j = 0;
+        while (j < cols) {
+            uint64_t token = get_varint(&runs);
+            uint64_t len = token >> 2;
+            if (runs.bad || len == 0 || len > cols - j || (token & 3) > 2) return false;
+            if ((token & 3) == 2) finite += len;
+            j += len;
+        }
+    }
+    return finite == n_finite && runs.p == runs.end;
+}
+
+static bool encode_sparse_chunk(buf_t *out, const palma_sparse_t *S, size_t r0, size_t r1) {
+    size_t begin = S->row_ptr[r0], end = S->row_ptr[r1];
+
+    put_varint(out, end - begin);
+    for (size_t i = r0; i < r1; i++) put_varint(out, S->row_ptr[i + 1] - S->row_ptr[i]);
+
+    for (size_t i = r0; i < r1; i++) {
+        for (palma_ptr_t k = S->row_ptr[i]; k < S->row_ptr[i + 1]; k++) {
+            if (k == S->row_ptr[i]) {
+                put_varint(out, S->col_idx[k]);
+            } else {
+                /* Gaps need strictly increasing columns */
+                if (S->col_idx[k] <= S->col_idx[k - 1]) return false;
+                put_varint(out, (uint64_t)S->col_idx[k] - S->col_idx[k - 1] - 1);
+            }
+        }
+    }
+
+    put_for(out, S->values + begin, end - begin);
+    return true;
+}
+
+/* Decode a sparse chunk into entries [at, limit) and row pointers from `row` on */
+static bool decode_sparse_chunk(reader_t *r, palma_sparse_t *out, size_t row, size_t n_rows,
+                                size_t at, size_t limit) {
+    uint64_t nnz = get_varint(r);
+    if (r->bad || nnz != limit - at) return false;
+
+    size_t k = at;
+    for (size_t i = 0; i < n_rows; i++) {
+        out->row_ptr[row + i] = (palma_ptr_t)k;
+        uint64_t len = get_varint(r);
+        if (r->bad || len > at + nnz - k) return false;
+        k += len;
+    }
+    if (k != at + nnz) return false;
+
+    for (size_t i = 0; i < n_rows; i++) {
+        size_t p = out->row_ptr[row + i];
+        size_t q = (i + 1 < n_rows) ? out->row_ptr[row + i + 1] : at + nnz;
+        uint64_t col = 0;
+        for (; p < q; p++) {
+            uint64_t x = get_varint(r);
+            col = (p == out->row_ptr[row + i]) ? x : col + x + 1;
+            if (r->bad || col >= out->cols) return false;
+            out->col_idx[p] = (palma_idx_t)col;
+        }
+    }
+
+    return get_for(r, out->values + at, nnz);
+}
+
+/*============================================================================
+ * FILE ACCESS
+ *============================================================================*/
+
+static palma_error_t write_file(const char *filename, const pack_header_t *hdr,
+                                buf_t *chunks) {
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) return PALMA_ERR_FILE_OPEN;
+
+    uint64_t offset = sizeof(*hdr) + (hdr->n_chunks + 1) * sizeof(uint64_t);
+    bool ok = fwrite(hdr, sizeof(*hdr), 1, fp) == 1;
+    for (uint32_t c = 0; c <= hdr->n_chunks && ok; c++) {
+        ok = fwrite(&offset, sizeof(offset), 1, fp) == 1;
+        if (c < hdr->n_chunks) offset += chunks[c].len;
+    }
+    for (uint32_t c = 0; c < hdr->n_chunks && ok; c++) {
+        ok = chunks[c].len == 0 || fwrite(chunks[c].data, 1, chunks[c].len, fp) == chunks[c].len;
+    }
+
+    if (fclose(fp) != 0) ok = false;
+    return ok ? PALMA_SUCCESS : PALMA_ERR_FILE_WRITE;
+}
+
+/*
+ * Open a packed file and read chunks [c0, c1) into memory. On success the
+ * caller owns *data (the chunk bytes) and *offsets (rebased to *data).
+ */
+static palma_error_t read_chunks(const char *filename, uint32_t kind, pack_header_t *hdr,
+                                 size_t first_row, size_t n_rows, uint32_t *c0, uint32_t *c1,
+                                 uint8_t **data, uint64_t **offsets) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return PALMA_ERR_FILE_OPEN;
+
+    palma_error_t err = PALMA_SUCCESS;
+    uint64_t *off = NULL;
+    uint8_t *bytes = NULL;
+    long file_size = -1;
+    uint64_t table_end = 0;
+
+    if (fread(hdr, sizeof(*hdr), 1, fp) != 1) {
+        err = PALMA_ERR_FILE_READ;
+    } else if (hdr->magic != PACK_MAGIC || hdr->version != PACK_VERSION || hdr->kind != kind ||
+               hdr->chunk_rows == 0 || hdr->rows == 0 || hdr->cols == 0 ||
+               hdr->n_chunks != (hdr->rows + hdr->chunk_rows - 1) / hdr->chunk_rows) {
+        err = PALMA_ERR_FILE_FORMAT;
+    } else if (fseek(fp, 0, SEEK_END) != 0 || (file_size = ftell(fp)) < 0 ||
+               fseek(fp, (long)sizeof(*hdr), SEEK_SET) != 0) {
+        err = PALMA_ERR_FILE_READ;
+    }
+
+    /*
+     * Nothing below may be sized by an unchecked header field. Every row
+     * costs at least one byte of payload (a run token or a row length), so
+     * rows beyond the payload mean a corrupt header, not a large matrix.
+     */
+    if (err == PALMA_SUCCESS) {
+        table_end = sizeof(*hdr) + ((uint64_t)hdr->n_chunks + 1) * sizeof(uint64_t);
+        if ((uint64_t)file_size < table_end || hdr->rows > (uint64_t)file_size - table_end) {
+            err = PALMA_ERR_FILE_FORMAT;
+        } else if (hdr->rows > SIZE_MAX / 2 || hdr->cols > SIZE_MAX / 2 ||
+                   (kind == PACK_DENSE && hdr->cols > (SIZE_MAX / 2) / sizeof(palma_val_t) / hdr->rows)) {
+            err = PALMA_ERR_OVERFLOW;
+        } else if (n_rows == SIZE_MAX) {
+            n_rows = hdr->rows;
+        }
+    }
+
+    if (err == PALMA_SUCCESS && (first_row >= hdr->rows || n_rows == 0 || n_rows > hdr->rows - first_row)) {
+        err = PALMA_ERR_INDEX_BOUNDS;
+    }
+
+    if (err == PALMA_SUCCESS) {
+        off = (uint64_t*)malloc(((size_t)hdr->n_chunks + 1) * sizeof(uint64_t));
+        if (!off) err = PALMA_ERR_OUT_OF_MEMORY;
+        else if (fread(off, sizeof(uint64_t), (size_t)hdr->n_chunks + 1, fp) != (size_t)hdr->n_chunks + 1) {
+            err = PALMA_ERR_FILE_READ;
+        }
+    }
+
+    if (err == PALMA_SUCCESS) {
+        *c0 = (uint32_t)(first_row / hdr->chunk_rows);
+        *c1 = (uint32_t)((first_row + n_rows - 1) / hdr->chunk_rows + 1);
+        if (off[*c0] < table_end || off[*c1] > (uint64_t)file_size) err = PALMA_ERR_FILE_FORMAT;
+        for (uint32_t c = *c0; c < *c1 && err == PALMA_SUCCESS; c++) {
+            if (off[c] > off[c + 1]) err = PALMA_ERR_FILE_FORMAT;
+        }
+    }
+
+    if (err == PALMA_SUCCESS) {
+        size_t len = (size_t)(off[*c1] - off[*c0]);
+        bytes = (uint8_t*)malloc(len ? len : 1);
+        if (!bytes) {
+            err = PALMA_ERR_OUT_OF_MEMORY;
+        } else if (fseek(fp, (long)off[*c0], SEEK_SET) != 0 || fread(bytes, 1, len, fp) != len) {
+            err = PALMA_ERR_FILE_READ;
+        }
+    }
+
+    fclose(fp);
+    if (err != PALMA_SUCCESS) {
+        free(off);
+        free(bytes);
+        return err;
+    }
+
+    uint64_t base = off[*c0];
+    for (uint32_t c = *c0; c <= *c1; c++) off[c] -= base;
+    *data = bytes;
+    *offsets = off;
+    return PALMA_SUCCESS;
+}
+
+static uint32_t chunk_count(size_t rows) {
+    return (uint32_t)((rows + PALMA_PACK_CHUNK_ROWS - 1) / PALMA_PACK_CHUNK_ROWS);
+}
+
+static void free_chunks(buf_t *chunks, uint32_t n) {
+    for (uint32_t c = 0; c < n; c++) free(chunks[c].data);
+    free(chunks);
+}
+
+/*============================================================================
+ * DENSE MATRICES
+ *============================================================================*/
+
+palma_error_t palma_matrix_save_packed(const palma_matrix_t *mat, const char *filename) {
+    if (!mat || !filename) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (mat->rows == 0 || mat->cols == 0) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    pack_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = PACK_MAGIC;
+    hdr.version = PACK_VERSION;
+    hdr.kind = PACK_DENSE;
+    hdr.rows = mat->rows;
+    hdr.cols = mat->cols;
+    hdr.chunk_rows = PALMA_PACK_CHUNK_ROWS;
+    hdr.n_chunks = chunk_count(mat->rows);
+
+    buf_t *chunks = (buf_t*)calloc(hdr.n_chunks, sizeof(buf_t));
+    if (!chunks) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+
+    bool failed = false;
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel reduction(||:failed)
+    #endif
+    {
+        palma_val_t *finite = (palma_val_t*)malloc(PALMA_PACK_CHUNK_ROWS * mat->cols * sizeof(palma_val_t));
+        if (!finite) failed = true;
+
+        #if PALMA_USE_OPENMP
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (uint32_t c = 0; c < hdr.n_chunks; c++) {
+            if (!finite) continue;
+            size_t r0 = (size_t)c * PALMA_PACK_CHUNK_ROWS;
+            size_t r1 = (r0 + PALMA_PACK_CHUNK_ROWS < mat->rows) ? r0 + PALMA_PACK_CHUNK_ROWS : mat->rows;
+            encode_dense_chunk(&chunks[c], mat, r0, r1, finite);
+            if (chunks[c].failed) failed = true;
+        }
+        free(finite);
+    }
+
+    palma_error_t err = failed ? PALMA_ERR_OUT_OF_MEMORY : write_file(filename, &hdr, chunks);
+    free_chunks(chunks, hdr.n_chunks);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_matrix_t* palma_matrix_load_packed_rows(const char *filename, size_t first, size_t count) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    pack_header_t hdr;
+    uint32_t c0, c1;
+    uint8_t *data;
+    uint64_t *off;
+    palma_error_t err = read_chunks(filename, PACK_DENSE, &hdr, first, count, &c0, &c1, &data, &off);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (count == SIZE_MAX) count = hdr.rows;
+
+    /* Whole chunks are decoded into a staging matrix when the range is unaligned */
+    size_t span = (size_t)(c1 - c0) * hdr.chunk_rows;
+    if ((size_t)c0 * hdr.chunk_rows + span > hdr.rows) span = hdr.rows - (size_t)c0 * hdr.chunk_rows;
+    bool direct = (first == (size_t)c0 * hdr.chunk_rows && count == span);
+
+    for (uint32_t c = c0; c < c1; c++) {
+        size_t at = (size_t)(c - c0) * hdr.chunk_rows;
+        size_t n = (at + hdr.chunk_rows < span) ? hdr.chunk_rows : span - at;
+        reader_t r = { data + off[c], data + off[c + 1], false };
+        if (!dense_chunk_shape_ok(r, n, hdr.cols)) {
+            free(data);
+            free(off);
+            PALMA_RETURN_NULL(PALMA_ERR_FILE_FORMAT);
+        }
+    }
+
+    palma_matrix_t *stage = palma_matrix_create(span, hdr.cols);
+    if (!stage) {
+        free(data);
+        free(off);
+        return NULL;
+    }
+
+    bool failed = false;
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel reduction(||:failed)
+    #endif
+    {
+        palma_val_t *scratch = NULL;
+        size_t cap = 0;
+
+        #if PALMA_USE_OPENMP
+        #pragma omp for schedule(dynamic)
+        #endif
+        for (uint32_t c = c0; c < c1; c++) {
+            size_t at = (size_t)(c - c0) * hdr.chunk_rows;
+            size_t n = (at + hdr.chunk_rows < span) ? hdr.chunk_rows : span - at;
+            reader_t r = { data + off[c], data + off[c + 1], false };
+            if (!decode_dense_chunk(&r, stage, at, n, &scratch, &cap)) failed = true;
+        }
+        free(scratch);
+    }
+
+    free(data);
+    free(off);
+    if (failed) {
+        palma_matrix_destroy(stage);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_FORMAT);
+    }
+    if (direct) return stage;
+
+    palma_matrix_t *out = palma_matrix_create(count, hdr.cols);
+    if (out) {
+        size_t skip = first - (size_t)c0 * hdr.chunk_rows;
+        for (size_t i = 0; i < count; i++) {
+            memcpy(out->data + i * out->stride, stage->data + (skip + i) * stage->stride,
+                   hdr.cols * sizeof(palma_val_t));
+        }
+    }
+    palma_matrix_destroy(stage);
+    return out;
+}
+
+palma_matrix_t* palma_matrix_load_packed(const char *filename) {
+    return palma_matrix_load_packed_rows(filename, 0, SIZE_MAX);
+}
+
+/*============================================================================
+ * SPARSE MATRICES
+ *============================================================================*/
+
+palma_error_t palma_sparse_save_packed(const palma_sparse_t *sp, const char *filename) {
+    if (!sp || !filename) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    pack_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = PACK_MAGIC;
+    hdr.version = PACK_VERSION;
+    hdr.kind = PACK_SPARSE;
+    hdr.semiring = (int32_t)sp->semiring;
+    hdr.rows = sp->rows;
+    hdr.cols = sp->cols;
+    hdr.nnz = sp->nnz;
+    hdr.chunk_rows = PALMA_PACK_CHUNK_ROWS;
+    hdr.n_chunks = chunk_count(sp->rows);
+
+    buf_t *chunks = (buf_t*)calloc(hdr.n_chunks, sizeof(buf_t));
+    if (!chunks) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+
+    bool failed = false, unsorted = false;
+
+    #if PALMA_USE_OPENMP
+    #pragma omp parallel for schedule(dynamic) reduction(||:failed, unsorted)
+    #endif
+    for (uint32_t c = 0; c < hdr.n_chunks; c++) {
+        size_t r0 = (size_t)c * PALMA_PACK_CHUNK_ROWS;
+        size_t r1 = (r0 + PALMA_PACK_CHUNK_ROWS < sp->rows) ? r0 + PALMA_PACK_CHUNK_ROWS : sp->rows;
+        if (!encode_sparse_chunk(&chunks[c], sp, r0, r1)) unsorted = true;
+        if (chunks[c].failed) failed = true;
+    }
+
+    palma_error_t err = unsorted ? PALMA_ERR_SPARSE_FORMAT
+                      : failed ? PALMA_ERR_OUT_OF_MEMORY
+                      : write_file(filename, &hdr, chunks);
+    free_chunks(chunks, hdr.n_chunks);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_sparse_t* palma_sparse_load_packed_rows(const char *filename, size_t first, size_t count) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    pack_header_t hdr;
+    uint32_t c0, c1;
+    uint8_t *data;
+    uint64_t *off;
+    palma_error_t err = read_chunks(filename, PACK_SPARSE, &hdr, first, count, &c0, &c1, &data, &off);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_NULL(err);
+    if (count == SIZE_MAX) count = hdr.rows;
+
+    size_t span = (size_t)(c1 - c0) * hdr.chunk_rows;
+    if ((size_t)c0 * hdr.chunk_rows + span > hdr.rows) span = hdr.rows - (size_t)c0 * hdr.chunk_rows;
+
+    /* Entry counts lead each chunk: prefix sums give every chunk its output slot */
+    size_t *at = (size_t*)malloc(((size_t)(c1 - c0) + 1) * sizeof(size_t));
+    if (!at) err = PALMA_ERR_OUT_OF_MEMORY;
+    else at[0] = 0;
+    for (uint32_t c = c0; c < c1 && err == PALMA_SUCCESS; c++) {
+        reader_t r = { data + off[c], data + off[c + 1], false };
+        uint64_t nnz = get_varint(&r);
+        /* Each entry costs at least one byte for its column */
+        if (r.bad || nnz > (uint64_t)(r.end - r.p)) err = PALMA_ERR_FILE_FORMAT;
+        else if (nnz > PALMA_PTR_MAX) err = PALMA_ERR_OVERFLOW;
+        else at[c - c0 + 1] = at[c - c0] + (size_t)nnz;
+    }
+    if (err == PALMA_SUCCESS && c0 == 0 && c1 == hdr.n_chunks && at[c1 - c0] != hdr.nnz) {
+        err = PALMA_ERR_FILE_FORMAT;
+    }
+    if (err == PALMA_SUCCESS && (at[c1 - c0] > PALMA_PTR_MAX || hdr.cols - 1 > PALMA_IDX_MAX)) {
+        err = PALMA_ERR_OVERFLOW;
+    }
+    if (err == PALMA_SUCCESS && (hdr.semiring < PALMA_MAXPLUS || hdr.semiring > PALMA_BOOLEAN)) {
+        err = PALMA_ERR_FILE_FORMAT;
+    }
+
+    palma_sparse_t *stage = NULL;
+    if (err == PALMA_SUCCESS) {
+        stage = palma_sparse_create(span, hdr.cols, at[c1 - c0], (palma_semiring_t)hdr.semiring);
+        if (!stage) err = palma_get_last_error();
+    }
+
+    bool failed = false;
+    if (err == PALMA_SUCCESS) {
+        #if PALMA_USE_OPENMP
+        #pragma omp parallel for schedule(dynamic) reduction(||:failed)
+        #endif
+        for (uint32_t c = c0; c < c1; c++) {
+            size_t row = (size_t)(c - c0) * hdr.chunk_rows;
+            size_t n = (row + hdr.chunk_rows < span) ? hdr.chunk_rows : span - row;
+            reader_t r = { data + off[c], data + off[c + 1], false };
+            if (!decode_sparse_chunk(&r, stage, row, n, at[c - c0], at[c - c0 + 1])) failed = true;
+        }
+        stage->row_ptr[span] = (palma_ptr_t)at[c1 - c0];
+        stage->nnz = at[c1 - c0];
+        if (failed) err = PALMA_ERR_FILE_FORMAT;
+    }
+
+    free(at);
+    free(data);
+    free(off);
+    if (err != PALMA_SUCCESS) {
+        palma_sparse_destroy(stage);
+        PALMA_RETURN_NULL(err);
+    }
+
+    size_t skip = first - (size_t)c0 * hdr.chunk_rows;
+    if (skip == 0 && count == span) return stage;
+
+    /* Trim to the requested rows */
+    size_t b = stage->row_ptr[skip], e = stage->row_ptr[skip + count];
+    palma_sparse_t *out = palma_sparse_create(count, hdr.cols, e - b, stage->semiring);
+    if (out) {
+        memcpy(out->values, stage->values + b, (e - b) * sizeof(palma_val_t));
+        memcpy(out->col_idx, stage->col_idx + b, (e - b) * sizeof(palma_idx_t));
+        for (size_t i = 0; i <= count; i++) out->row_ptr[i] = (palma_ptr_t)(stage->row_ptr[skip + i] - b);
+        out->nnz = e - b;
+    }
+    palma_sparse_destroy(stage);
+    return out;
+}
+
+palma_sparse_t* palma_sparse_load_packed(const char *filename) {
+    return palma_sparse_load_packed_rows(filename, 0, SIZE_MAX);
+}
@@ -0,0 +1,850 @@
+/**
+ * @file palma_plan.c
+ * @brief PALMA Algorithm Selection - structure analysis and engine dispatch
+ *
+ * The dense kernels are O(n³) regardless of how many edges a graph has. For
+ * sparse, acyclic or monotone graphs the classical graph algorithms are far
+ * cheaper: a topological sweep on a DAG, Dijkstra when no edge can improve a
+ * path, label-correcting Bellman-Ford otherwise. This module analyzes the
+ * input once, estimates the cost of every applicable engine and runs the
+ * cheapest. All engines produce the closure / path values the dense
+ * algorithms would.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if PALMA_USE_OPENMP
+#include <omp.h>
+#endif
+
+/*============================================================================
+ * INTERNAL CONSTANTS
+ *============================================================================*/
+
+/* Relative cost of one sparse (indexed or heap-driven) operation vs a dense one */
+#define SPARSE_OP_COST 3.0
+
+/*============================================================================
+ * GRAPH REPRESENTATION
+ *============================================================================*/
+
+/* CSR adjacency without ε entries and without non-improving self-loops */
+typedef struct {
+    size_t n;
+    size_t nnz;
+    palma_ptr_t *row_ptr;
+    palma_idx_t *col;
+    palma_val_t *w;
+} graph_t;
+
+static void graph_free(graph_t *g) {
+    free(g->row_ptr);
+    free(g->col);
+    free(g->w);
+    memset(g, 0, sizeof(*g));
+}
+
+/* A self-loop matters only if it can improve a path: w ⊕ e ≠ e */
+static bool keep_entry(size_t i, size_t j, palma_val_t w, palma_val_t zero,
+                       palma_val_t one, palma_semiring_t semiring) {
+    if (w == zero) return false;
+    if (i == j && palma_add(w, one, semiring) == one) return false;
+    return true;
+}
+
+static palma_error_t graph_alloc(graph_t *g, size_t n, size_t nnz) {
+    if (nnz > PALMA_PTR_MAX) return PALMA_ERR_OVERFLOW;
+    g->n = n;
+    g->nnz = nnz;
+    g->row_ptr = (palma_ptr_t*)malloc((n + 1) * sizeof(palma_ptr_t));
+    g->col = (palma_idx_t*)malloc((nnz ? nnz : 1) * sizeof(palma_idx_t));
+    g->w = (palma_val_t*)malloc((nnz ? nnz : 1) * sizeof(palma_val_t));
+
+    if (!g->row_ptr || !g->col || !g->w) {
+        graph_free(g);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+    return PALMA_SUCCESS;
+}
+
+static palma_error_t graph_from_dense(graph_t *g, const palma_matrix_t *A, palma_semiring_t semiring) {
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
+    size_t n = A->rows;
+
+    size_t nnz = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (keep_entry(i, j, palma_matrix_get(A, i, j), zero, one, semiring)) nnz++;
+        }
+    }
+
+    palma_error_t err = graph_alloc(g, n, nnz);
+    if (err != PALMA_SUCCESS) return err;
+
+    size_t idx = 0;
+    for (size_t i = 0; i < n; i++) {
+        g->row_ptr[i] = (palma_ptr_t)idx;
+        for (size_t j = 0; j < n; j++) {
+            palma_val_t w = palma_matrix_get(A, i, j);
+            if (keep_entry(i, j, w, zero, one, semiring)) {
+                g->col[idx] = (palma_idx_t)j;
+                g->w[idx] = w;
+                idx++;
+            }
+        }
+    }
+    g->row_ptr[n] = (palma_ptr_t)idx;
+
+    return PALMA_SUCCESS;
+}
+
+static palma_error_t graph_from_sparse(graph_t *g, const palma_sparse_t *A) {
+    palma_semiring_t semiring = A->semiring;
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
+    size_t n = A->rows;
+
+    palma_error_t err = graph_alloc(g, n, A->nnz);
+    if (err != PALMA_SUCCESS) return err;
+
+    size_t idx = 0;
+    for (size_t i = 0; i < n; i++) {
+        g->row_ptr[i] = (palma_ptr_t)idx;
+        for (palma_ptr_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            if (keep_entry(i, A->col_idx[k], A->values[k], zero, one, semiring)) {
+                g->col[idx] = A->col_idx[k];
+                g->w[idx] = A->values[k];
+                idx++;
+            }
+        }
+    }
+    g->row_ptr[n] = (palma_ptr_t)idx;
+    g->nnz = idx;
+
+    return PALMA_SUCCESS;
+}
+
+/*
+ * Kahn's algorithm. Sets *is_dag and, for a DAG, fills order (length n) with
+ * a topological order. order may be NULL.
+ */
+static palma_error_t graph_topo_order(const graph_t *g, palma_idx_t *order, bool *is_dag) {
+    size_t n = g->n;
+    palma_idx_t *indeg = (palma_idx_t*)calloc(n, sizeof(palma_idx_t));
+    palma_idx_t *queue = order ? order : (palma_idx_t*)malloc(n * sizeof(palma_idx_t));
+    if (!indeg || !queue) {
+        free(indeg);
+        if (!order) free(queue);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+
+    for (size_t k = 0; k < g->nnz; k++) indeg[g->col[k]]++;
+
+    size_t head = 0, tail = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (indeg[i] == 0) queue[tail++] = (palma_idx_t)i;
+    }
+
+    while (head < tail) {
+        palma_idx_t u = queue[head++];
+        for (palma_ptr_t k = g->row_ptr[u]; k < g->row_ptr[u + 1]; k++) {
+            if (--indeg[g->col[k]] == 0) queue[tail++] = g->col[k];
+        }
+    }
+
+    *is_dag = (tail == n);
+
+    free(indeg);
+    if (!order) free(queue);
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * ANALYSIS
+ *============================================================================*/
+
+static palma_error_t analyze_graph(palma_structure_t *info, const graph_t *g,
+                                   palma_semiring_t semiring) {
+    palma_val_t one = palma_one(semiring);
+
+    info->n = g->n;
+    info->nnz = g->nnz;
+    info->density = (double)g->nnz / ((double)g->n * (double)g->n);
+    info->semiring = semiring;
+
+    info->nonnegative = true;
+    for (size_t k = 0; k < g->nnz; k++) {
+        if (palma_add(g->w[k], one, semiring) != one) {
+            info->nonnegative = false;
+            break;
+        }
+    }
+
+    return graph_topo_order(g, NULL, &info->is_dag);
+}
+
+palma_error_t palma_analyze(palma_structure_t *info, const palma_matrix_t *A,
+                            palma_semiring_t semiring) {
+    if (!info || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+
+    graph_t g;
+    palma_error_t err = graph_from_dense(&g, A, semiring);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = analyze_graph(info, &g, semiring);
+    graph_free(&g);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    info->symmetric = true;
+    for (size_t i = 0; i < A->rows && info->symmetric; i++) {
+        for (size_t j = i + 1; j < A->cols; j++) {
+            if (palma_matrix_get(A, i, j) != palma_matrix_get(A, j, i)) {
+                info->symmetric = false;
+                break;
+            }
+        }
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_sparse_analyze(palma_structure_t *info, const palma_sparse_t *A) {
+    if (!info || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+
+    graph_t g;
+    palma_error_t err = graph_from_sparse(&g, A);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = analyze_graph(info, &g, A->semiring);
+    graph_free(&g);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    /* Every stored entry must have an equal mirror (binary search per entry) */
+    info->symmetric = true;
+    for (size_t i = 0; i < A->rows && info->symmetric; i++) {
+        for (palma_ptr_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+            if (palma_sparse_get(A, A->col_idx[k], i) != A->values[k]) {
+                info->symmetric = false;
+                break;
+            }
+        }
+    }
+
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * COST MODEL
+ *============================================================================*/
+
+static double log2_nodes(size_t n) {
+    return log2((double)n + 2.0);
+}
+
+static void plan_pick(palma_plan_t *plan, palma_engine_t engine, double cost) {
+    if (cost < plan->cost) {
+        plan->engine = engine;
+        plan->cost = cost;
+    }
+}
+
+palma_error_t palma_plan_closure(palma_plan_t *plan, const palma_structure_t *info) {
+    if (!plan || !info) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    double n = (double)info->n;
+    double nnz = (double)info->nnz;
+
+    plan->engine = PALMA_ENGINE_FLOYD_WARSHALL;
+    plan->cost = plan->dense_cost = n * n * n;
+
+    /* Per-source engines also write the n² result */
+    if (info->is_dag) {
+        plan_pick(plan, PALMA_ENGINE_DAG_SWEEP, SPARSE_OP_COST * nnz * n + n * n);
+    }
+    if (info->nonnegative) {
+        plan_pick(plan, PALMA_ENGINE_DIJKSTRA,
+                  SPARSE_OP_COST * n * (nnz + n) * log2_nodes(info->n) + n * n);
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_plan_single_source(palma_plan_t *plan, const palma_structure_t *info) {
+    if (!plan || !info) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    double n = (double)info->n;
+    double nnz = (double)info->nnz;
+
+    /* Worst case n rounds for both label-correcting variants */
+    plan->engine = PALMA_ENGINE_DENSE_BELLMAN_FORD;
+    plan->cost = plan->dense_cost = n * n * n;
+
+    plan_pick(plan, PALMA_ENGINE_BELLMAN_FORD, SPARSE_OP_COST * n * (nnz + n));
+    if (info->nonnegative) {
+        plan_pick(plan, PALMA_ENGINE_DIJKSTRA, SPARSE_OP_COST * (nnz + n) * log2_nodes(info->n));
+    }
+    if (info->is_dag) {
+        plan_pick(plan, PALMA_ENGINE_DAG_SWEEP, SPARSE_OP_COST * (nnz + n));
+    }
+
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_plan_mul(palma_plan_t *plan, size_t m, size_t k, size_t p,
+                             size_t nnz_a, size_t nnz_b, bool dense_inputs) {
+    if (!plan) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (m == 0 || k == 0 || p == 0) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    double dm = (double)m, dk = (double)k, dp = (double)p;
+
+    plan->engine = PALMA_ENGINE_DENSE_GEMM;
+    plan->cost = plan->dense_cost = dm * dk * dp;
+
+    /* Expected products with uniformly spread entries, plus the per-row accumulator */
+    double flops = (double)nnz_a * (double)nnz_b / dk;
+    double sparse = SPARSE_OP_COST * flops + dm * dp;
+    if (dense_inputs) sparse += dm * dk + dk * dp + dm * dp;
+
+    plan_pick(plan, PALMA_ENGINE_SPARSE_GEMM, sparse);
+    return PALMA_SUCCESS;
+}
+
+const char* palma_engine_name(palma_engine_t engine) {
+    switch (engine) {
+        case PALMA_ENGINE_FLOYD_WARSHALL:     return "Floyd-Warshall";
+        case PALMA_ENGINE_DAG_SWEEP:          return "DAG sweep";
+        case PALMA_ENGINE_DIJKSTRA:           return "Dijkstra";
+        case PALMA_ENGINE_BELLMAN_FORD:       return "Bellman-Ford";
+        case PALMA_ENGINE_DENSE_BELLMAN_FORD: return "dense Bellman-Ford";
+        case PALMA_ENGINE_DENSE_GEMM:         return "dense GEMM";
+        case PALMA_ENGINE_SPARSE_GEMM:        return "sparse GEMM";
+        default:                              return "unknown";
+    }
+}
+
+/*============================================================================
+ * SINGLE-SOURCE ENGINES
+ *============================================================================*/
+
+/* v ← v ⊕ (f ⊗ w), keeping ε absorbing even where palma_mul lets -∞ win */
+static inline palma_val_t relax(palma_val_t v, palma_val_t f, palma_val_t w,
+                                palma_val_t zero, palma_semiring_t semiring) {
+    if (f == zero || w == zero) return v;
+    return palma_add(v, palma_mul(f, w, semiring), semiring);
+}
+
+static void sweep_single_source(const graph_t *g, const palma_idx_t *order, size_t source,
+                                palma_val_t *dist, palma_semiring_t semiring) {
+    palma_val_t zero = palma_zero(semiring);
+
+    for (size_t i = 0; i < g->n; i++) dist[i] = zero;
+    dist[source] = palma_one(semiring);
+
+    for (size_t t = 0; t < g->n; t++) {
+        palma_idx_t u = order[t];
+        palma_val_t du = dist[u];
+        if (du == zero) continue;
+        for (palma_ptr_t k = g->row_ptr[u]; k < g->row_ptr[u + 1]; k++) {
+            dist[g->col[k]] = relax(dist[g->col[k]], du, g->w[k], zero, semiring);
+        }
+    }
+}
+
+/* Binary min-heap on keys with lazy deletion; one per thread */
+typedef struct {
+    int64_t *key;
+    palma_idx_t *node;
+    size_t size;
+    unsigned char *settled;
+} dijkstra_ws_t;
+
+static palma_error_t dijkstra_ws_init(dijkstra_ws_t *ws, const graph_t *g) {
+    size_t cap = g->nnz + 1;
+    ws->key = (int64_t*)malloc(cap * sizeof(int64_t));
+    ws->node = (palma_idx_t*)malloc(cap * sizeof(palma_idx_t));
+    ws->settled = (unsigned char*)malloc(g->n);
+    ws->size = 0;
+
+    if (!ws->key || !ws->node || !ws->settled) {
+        free(ws->key);
+        free(ws->node);
+        free(ws->settled);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+    return PALMA_SUCCESS;
+}
+
+static void dijkstra_ws_free(dijkstra_ws_t *ws) {
+    free(ws->key);
+    free(ws->node);
+    free(ws->settled);
+}
+
+static void heap_push(dijkstra_ws_t *ws, int64_t key, palma_idx_t node) {
+    size_t i = ws->size++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (ws->key[parent] <= key) break;
+        ws->key[i] = ws->key[parent];
+        ws->node[i] = ws->node[parent];
+        i = parent;
+    }
+    ws->key[i] = key;
+    ws->node[i] = node;
+}
+
+static palma_idx_t heap_pop(dijkstra_ws_t *ws) {
+    palma_idx_t top = ws->node[0];
+    int64_t key = ws->key[--ws->size];
+    palma_idx_t node = ws->node[ws->size];
+
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= ws->size) break;
+        if (child + 1 < ws->size && ws->key[child + 1] < ws->key[child]) child++;
+        if (key <= ws->key[child]) break;
+        ws->key[i] = ws->key[child];
+        ws->node[i] = ws->node[child];
+        i = child;
+    }
+    if (ws->size > 0) {
+        ws->key[i] = key;
+        ws->node[i] = node;
+    }
+    return top;
+}
+
+/*
+ * Label-setting search. Valid when no edge improves a path, so the best
+ * tentative label is final. Keys order labels best-first: ⊕ = min keeps the
+ * value, ⊕ = max negates it.
+ */
+static void dijkstra_single_source(const graph_t *g, dijkstra_ws_t *ws, size_t source,
+                                   palma_val_t *dist, palma_semiring_t semiring) {
+    palma_val_t zero = palma_zero(semiring);
+    bool min_first = (semiring == PALMA_MINPLUS || semiring == PALMA_MINMAX);
+
+    for (size_t i = 0; i < g->n; i++) dist[i] = zero;
+    memset(ws->settled, 0, g->n);
+    ws->size = 0;
+
+    dist[source] = palma_one(semiring);
+    heap_push(ws, 0, (palma_idx_t)source);
+
+    while (ws->size > 0) {
+        palma_idx_t u = heap_pop(ws);
+        if (ws->settled[u]) continue;
+        ws->settled[u] = 1;
+
+        palma_val_t du = dist[u];
+        for (palma_ptr_t k = g->row_ptr[u]; k < g->row_ptr[u + 1]; k++) {
+            palma_idx_t v = g->col[k];
+            if (ws->settled[v]) continue;
+            palma_val_t nv = relax(dist[v], du, g->w[k], zero, semiring);
+            if (nv != dist[v]) {
+                dist[v] = nv;
+                heap_push(ws, min_first ? (int64_t)nv : -(int64_t)nv, v);
+            }
+        }
+    }
+}
+
+/* Label-correcting rounds over the nodes updated in the previous round */
+static palma_error_t bellman_ford_single_source(const graph_t *g, size_t source,
+                                                palma_val_t *dist, palma_semiring_t semiring) {
+    size_t n = g->n;
+    palma_val_t zero = palma_zero(semiring);
+    unsigned char *active = (unsigned char*)calloc(2 * n, 1);
+    if (!active) return PALMA_ERR_OUT_OF_MEMORY;
+
+    unsigned char *cur = active, *next = active + n;
+
+    for (size_t i = 0; i < n; i++) dist[i] = zero;
+    dist[source] = palma_one(semiring);
+    cur[source] = 1;
+
+    for (size_t round = 0; round < n; round++) {
+        bool changed = false;
+        memset(next, 0, n);
+
+        for (size_t u = 0; u < n; u++) {
+            if (!cur[u]) continue;
+            for (palma_ptr_t k = g->row_ptr[u]; k < g->row_ptr[u + 1]; k++) {
+                palma_idx_t v = g->col[k];
+                palma_val_t nv = relax(dist[v], dist[u], g->w[k], zero, semiring);
+                if (nv != dist[v]) {
+                    dist[v] = nv;
+                    next[v] = 1;
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed) break;
+        unsigned char *tmp = cur; cur = next; next = tmp;
+    }
+
+    free(active);
+    return PALMA_SUCCESS;
+}
+
+static palma_error_t dense_bellman_ford_single_source(const palma_matrix_t *A, size_t source,
+                                                      palma_val_t *dist, palma_semiring_t semiring) {
+    size_t n = A->rows;
+    palma_val_t zero = palma_zero(semiring);
+    unsigned char *active = (unsigned char*)calloc(2 * n, 1);
+    if (!active) return PALMA_ERR_OUT_OF_MEMORY;
+
+    unsigned char *cur = active, *next = active + n;
+
+    for (size_t i = 0; i < n; i++) dist[i] = zero;
+    dist[source] = palma_one(semiring);
+    cur[source] = 1;
+
+    for (size_t round = 0; round < n; round++) {
+        bool changed = false;
+        memset(next, 0, n);
+
+        for (size_t u = 0; u < n; u++) {
+            if (!cur[u]) continue;
+            const palma_val_t *row = &A->data[u * A->stride];
+            for (size_t v = 0; v < n; v++) {
+                palma_val_t nv = relax(dist[v], dist[u], row[v], zero, semiring);
+                if (nv != dist[v]) {
+                    dist[v] = nv;
+                    next[v] = 1;
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed) break;
+        unsigned char *tmp = cur; cur = next; next = tmp;
+    }
+
+    free(active);
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * CLOSURE ENGINES
+ *============================================================================*/
+
+/*
+ * DAG closure in reverse topological order: row i of A* is e_i ⊕ the
+ * w-weighted rows of its successors, which are already final.
+ */
+static palma_error_t sweep_closure(palma_matrix_t *D, const graph_t *g, const palma_idx_t *order,
+                                   palma_semiring_t semiring) {
+    size_t n = g->n;
+    palma_val_t zero = palma_zero(semiring);
+    palma_val_t one = palma_one(semiring);
+
+    for (size_t t = n; t-- > 0; ) {
+        palma_idx_t i = order[t];
+        palma_val_t *row_i = palma_matrix_row(D, i);
+
+        for (size_t j = 0; j < n; j++) row_i[j] = zero;
+        row_i[i] = one;
+
+        for (palma_ptr_t k = g->row_ptr[i]; k < g->row_ptr[i + 1]; k++) {
+            const palma_val_t *row_j = palma_matrix_row(D, g->col[k]);
+            palma_val_t w = g->w[k];
+
+            if (palma_mul(w, zero, semiring) == zero) {
+                for (size_t j = 0; j < n; j++) {
+                    row_i[j] = palma_add(row_i[j], palma_mul(w, row_j[j], semiring), semiring);
+                }
+            } else {
+                for (size_t j = 0; j < n; j++) {
+                    row_i[j] = relax(row_i[j], w, row_j[j], zero, semiring);
+                }
+            }
+        }
+    }
+
+    return PALMA_SUCCESS;
+}
+
+/* One Dijkstra per source, sources distributed over threads */
+static palma_error_t dijkstra_closure(palma_matrix_t *D, const graph_t *g, palma_semiring_t semiring) {
+    palma_error_t err = PALMA_SUCCESS;
+
+#if PALMA_USE_OPENMP
+    #pragma omp parallel if(g->n >= 64)
+#endif
+    {
+        dijkstra_ws_t ws;
+        palma_error_t local = dijkstra_ws_init(&ws, g);
+
+        if (local != PALMA_SUCCESS) {
+#if PALMA_USE_OPENMP
+            #pragma omp critical(palma_plan_error)
+#endif
+            err = local;
+        }
+
+#if PALMA_USE_OPENMP
+        #pragma omp for schedule(dynamic, 16)
+#endif
+        for (size_t s = 0; s < g->n; s++) {
+            if (local == PALMA_SUCCESS) {
+                dijkstra_single_source(g, &ws, s, palma_matrix_row(D, s), semiring);
+            }
+        }
+
+        if (local == PALMA_SUCCESS) dijkstra_ws_free(&ws);
+    }
+
+    return err;
+}
+
+/*============================================================================
+ * DISPATCH
+ *============================================================================*/
+
+/* Run the planned closure engine; D may alias the matrix g was built from */
+static palma_error_t run_closure(palma_matrix_t *D, const graph_t *g,
+                                 const palma_plan_t *plan, palma_semiring_t semiring) {
+    palma_error_t err;
+
+    if (plan->engine == PALMA_ENGINE_DAG_SWEEP) {
+        palma_idx_t *order = (palma_idx_t*)malloc((g->n ? g->n : 1) * sizeof(palma_idx_t));
+        if (!order) return PALMA_ERR_OUT_OF_MEMORY;
+        bool is_dag;
+        err = graph_topo_order(g, order, &is_dag);
+        if (err == PALMA_SUCCESS) err = sweep_closure(D, g, order, semiring);
+        free(order);
+        return err;
+    }
+
+    return dijkstra_closure(D, g, semiring);
+}
+
+palma_error_t palma_auto_closure_into(palma_matrix_t *D, const palma_matrix_t *A,
+                                      palma_semiring_t semiring, palma_plan_t *plan) {
+    if (!D || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (D->rows != A->rows || D->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    graph_t g;
+    palma_structure_t info;
+    palma_plan_t local;
+    if (!plan) plan = &local;
+
+    palma_error_t err = graph_from_dense(&g, A, semiring);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = analyze_graph(&info, &g, semiring);
+    if (err == PALMA_SUCCESS) {
+        info.symmetric = false;     /* not used by the closure cost model */
+        err = palma_plan_closure(plan, &info);
+    }
+
+    if (err == PALMA_SUCCESS) {
+        if (plan->engine == PALMA_ENGINE_FLOYD_WARSHALL) {
+            err = palma_matrix_closure_into(D, A, semiring);
+        } else {
+            err = run_closure(D, &g, plan, semiring);
+        }
+    }
+
+    graph_free(&g);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_sparse_auto_closure_into(palma_matrix_t *D, const palma_sparse_t *A,
+                                             palma_plan_t *plan) {
+    if (!D || !A) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (D->rows != A->rows || D->cols != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    palma_semiring_t semiring = A->semiring;
+    graph_t g;
+    palma_structure_t info;
+    palma_plan_t local;
+    if (!plan) plan = &local;
+
+    palma_error_t err = graph_from_sparse(&g, A);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = analyze_graph(&info, &g, semiring);
+    if (err == PALMA_SUCCESS) {
+        info.symmetric = false;
+        err = palma_plan_closure(plan, &info);
+    }
+
+    if (err == PALMA_SUCCESS) {
+        if (plan->engine == PALMA_ENGINE_FLOYD_WARSHALL) {
+            palma_val_t zero = palma_zero(semiring);
+            for (size_t i = 0; i < A->rows; i++) {
+                palma_val_t *row = palma_matrix_row(D, i);
+                for (size_t j = 0; j < A->cols; j++) row[j] = zero;
+                for (palma_ptr_t k = A->row_ptr[i]; k < A->row_ptr[i + 1]; k++) {
+                    row[A->col_idx[k]] = A->values[k];
+                }
+            }
+            err = palma_matrix_closure_into(D, D, semiring);
+        } else {
+            err = run_closure(D, &g, plan, semiring);
+        }
+    }
+
+    graph_free(&g);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+/* Shared by the dense and sparse single-source entry points; A may be NULL */
+static palma_error_t run_single_source(const graph_t *g, const palma_matrix_t *A, size_t source,
+                                       palma_val_t *dist, palma_semiring_t semiring,
+                                       palma_plan_t *plan) {
+    palma_structure_t info;
+    palma_error_t err = analyze_graph(&info, g, semiring);
+    if (err != PALMA_SUCCESS) return err;
+    info.symmetric = false;
+
+    err = palma_plan_single_source(plan, &info);
+    if (err != PALMA_SUCCESS) return err;
+
+    /* Without the dense matrix, its engine is replaced by the sparse one */
+    if (plan->engine == PALMA_ENGINE_DENSE_BELLMAN_FORD && !A) {
+        plan->engine = PALMA_ENGINE_BELLMAN_FORD;
+        plan->cost = SPARSE_OP_COST * (double)g->n * (double)(g->nnz + g->n);
+    }
+
+    switch (plan->engine) {
+        case PALMA_ENGINE_DAG_SWEEP: {
+            palma_idx_t *order = (palma_idx_t*)malloc((g->n ? g->n : 1) * sizeof(palma_idx_t));
+            if (!order) return PALMA_ERR_OUT_OF_MEMORY;
+            bool is_dag;
+            err = graph_topo_order(g, order, &is_dag);
+            if (err == PALMA_SUCCESS) sweep_single_source(g, order, source, dist, semiring);
+            free(order);
+            return err;
+        }
+        case PALMA_ENGINE_DIJKSTRA: {
+            dijkstra_ws_t ws;
+            err = dijkstra_ws_init(&ws, g);
+            if (err != PALMA_SUCCESS) return err;
+            dijkstra_single_source(g, &ws, source, dist, semiring);
+            dijkstra_ws_free(&ws);
+            return PALMA_SUCCESS;
+        }
+        case PALMA_ENGINE_DENSE_BELLMAN_FORD:
+            return dense_bellman_ford_single_source(A, source, dist, semiring);
+        default:
+            return bellman_ford_single_source(g, source, dist, semiring);
+    }
+}
+
+palma_error_t palma_auto_single_source(const palma_matrix_t *adj, size_t source,
+                                       palma_val_t *dist, palma_semiring_t semiring,
+                                       palma_plan_t *plan) {
+    if (!adj || !dist) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (adj->rows != adj->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (source >= adj->rows) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+    graph_t g;
+    palma_plan_t local;
+
+    palma_error_t err = graph_from_dense(&g, adj, semiring);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = run_single_source(&g, adj, source, dist, semiring, plan ? plan : &local);
+    graph_free(&g);
+
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_sparse_auto_single_source(const palma_sparse_t *A, size_t source,
+                                              palma_val_t *dist, palma_plan_t *plan) {
+    if (!A || !dist) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->rows != A->cols) PALMA_RETURN_ERROR(PALMA_ERR_NOT_SQUARE);
+    if (source >= A->rows) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+    graph_t g;
+    palma_plan_t local;
+
+    palma_error_t err = graph_from_sparse(&g, A);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+
+    err = run_single_source(&g, NULL, source, dist, A->semiring, plan ? plan : &local);
+    graph_free(&g);
+
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+static size_t count_nonzero(const palma_matrix_t *A, palma_val_t zero) {
+    size_t nnz = 0;
+    for (size_t i = 0; i < A->rows; i++) {
+        for (size_t j = 0; j < A->cols; j++) {
+            nnz += (palma_matrix_get(A, i, j) != zero);
+        }
+    }
+    return nnz;
+}
+
+palma_error_t palma_auto_mul_into(palma_matrix_t *C, const palma_matrix_t *A,
+                                  const palma_matrix_t *B, palma_semiring_t semiring,
+                                  palma_plan_t *plan) {
+    if (!C || !A || !B) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (A->cols != B->rows) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (C->rows != A->rows || C->cols != B->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    palma_plan_t local;
+    if (!plan) plan = &local;
+
+    palma_val_t zero = palma_zero(semiring);
+    palma_plan_mul(plan, A->rows, A->cols, B->cols,
+                   count_nonzero(A, zero), count_nonzero(B, zero), true);
+
+    if (plan->engine == PALMA_ENGINE_DENSE_GEMM) {
+        return palma_matrix_mul_into(C, A, B, semiring);
+    }
+
+    palma_sparse_t *sa = palma_sparse_from_dense(A, semiring);
+    palma_sparse_t *sb = sa ? palma_sparse_from_dense(B, semiring) : NULL;
+    palma_sparse_t *sc = sb ? palma_sparse_mul(sa, sb) : NULL;
+    palma_sparse_destroy(sa);
+    palma_sparse_destroy(sb);
+    if (!sc) return palma_get_last_error();
+
+    for (size_t i = 0; i < C->rows; i++) {
+        palma_val_t *row = palma_matrix_row(C, i);
+        for (size_t j = 0; j < C->cols; j++) row[j] = zero;
+        for (palma_ptr_t k = sc->row_ptr[i]; k < sc->row_ptr[i + 1]; k++) {
+            row[sc->col_idx[k]] = sc->values[k];
+        }
+    }
+
+    palma_sparse_destroy(sc);
+    return PALMA_SUCCESS;
+}
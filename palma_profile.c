@@ -0,0 +1,235 @@
+/**
+ * @file palma_profile.c
+ * @brief PALMA Performance Counters - hardware events per kernel invocation
+ *
+ * A profiler opens one Linux perf event per counter (cycles, instructions,
+ * L1D read misses, last-level cache misses, branch misses) for the calling
+ * thread and every thread it creates afterwards, so an OpenMP team started
+ * later is included. palma_profile_begin resets and enables the counters,
+ * palma_profile_end stops them and reports the counts together with the
+ * number of tropical operations the caller attributes to the region.
+ *
+ * Events are opened independently rather than as a group: when the PMU has
+ * fewer slots than requested events the kernel multiplexes them, and each
+ * count is scaled by its enabled/running time ratio. Counters the host does
+ * not expose (common in virtual machines) are simply marked unavailable.
+ * Only user-space events are counted, which works at the default
+ * perf_event_paranoid level. On other platforms creation fails with
+ * PALMA_ERR_UNSUPPORTED.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/*============================================================================
+ * PROFILER STATE
+ *============================================================================*/
+
+struct palma_profiler {
+    int fd[PALMA_COUNTER_COUNT];        /* -1 if the event could not be opened */
+    uint64_t start_ns;
+};
+
+static const char *counter_names[PALMA_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"
+};
+
+static uint64_t profile_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*============================================================================
+ * PERF EVENTS
+ *============================================================================*/
+
+#if defined(__linux__)
+
+static int open_counter(palma_counter_t counter) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+
+    switch (counter) {
+    case PALMA_COUNTER_CYCLES:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case PALMA_COUNTER_INSTRUCTIONS:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case PALMA_COUNTER_L1D_MISSES:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D |
+                      ((uint64_t)PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    case PALMA_COUNTER_LLC_MISSES:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case PALMA_COUNTER_BRANCH_MISSES:
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        return -1;
+    }
+
+    attr.disabled = 1;
+    attr.inherit = 1;               /* Threads created later, e.g. the OpenMP team */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/* Count scaled for multiplexing; false if the event never ran */
+static bool read_counter(int fd, uint64_t *value) {
+    uint64_t data[3];       /* value, time enabled, time running */
+    if (read(fd, data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) return false;
+    *value = data[2] < data[1] ? (uint64_t)((double)data[0] * (double)data[1] / (double)data[2])
+                               : data[0];
+    return true;
+}
+
+#endif
+
+/*============================================================================
+ * PUBLIC API
+ *============================================================================*/
+
+palma_profiler_t* palma_profiler_create(void) {
+#if defined(__linux__)
+    palma_profiler_t *prof = (palma_profiler_t*)malloc(sizeof(palma_profiler_t));
+    if (!prof) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    size_t opened = 0;
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        prof->fd[i] = open_counter((palma_counter_t)i);
+        if (prof->fd[i] >= 0) opened++;
+    }
+    prof->start_ns = 0;
+
+    if (opened == 0) {
+        free(prof);
+        PALMA_RETURN_NULL(PALMA_ERR_UNSUPPORTED);
+    }
+    palma_clear_error();
+    return prof;
+#else
+    PALMA_RETURN_NULL(PALMA_ERR_UNSUPPORTED);
+#endif
+}
+
+void palma_profiler_destroy(palma_profiler_t *prof) {
+    if (!prof) return;
+#if defined(__linux__)
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (prof->fd[i] >= 0) close(prof->fd[i]);
+    }
+#endif
+    free(prof);
+}
+
+bool palma_profiler_has(const palma_profiler_t *prof, palma_counter_t counter) {
+    return prof && counter >= 0 && counter < PALMA_COUNTER_COUNT && prof->fd[counter] >= 0;
+}
+
+palma_error_t palma_profile_begin(palma_profiler_t *prof) {
+    if (!prof) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+#if defined(__linux__)
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (prof->fd[i] < 0) continue;
+        ioctl(prof->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(prof->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+    prof->start_ns = profile_now_ns();
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_profile_end(palma_profiler_t *prof, double ops, palma_profile_t *out) {
+    if (!prof || !out) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    uint64_t end_ns = profile_now_ns();
+    memset(out, 0, sizeof(*out));
+#if defined(__linux__)
+    /* Stop everything first so reading one counter is not counted by the next */
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (prof->fd[i] >= 0) ioctl(prof->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (prof->fd[i] >= 0 && read_counter(prof->fd[i], &out->value[i])) {
+            out->available |= 1u << i;
+        }
+    }
+#endif
+    out->time_ns = end_ns - prof->start_ns;
+    out->ops = ops;
+    return PALMA_SUCCESS;
+}
+
+double palma_profile_per_op(const palma_profile_t *p, palma_counter_t counter) {
+    if (!p || counter < 0 || counter >= PALMA_COUNTER_COUNT) return -1.0;
+    if (!(p->available & (1u << counter)) || p->ops <= 0) return -1.0;
+    return (double)p->value[counter] / p->ops;
+}
+
+const char* palma_counter_name(palma_counter_t counter) {
+    if (counter < 0 || counter >= PALMA_COUNTER_COUNT) return "unknown";
+    return counter_names[counter];
+}
+
+void palma_profile_print(const palma_profile_t *p, const char *name, FILE *fp) {
+    if (!p || !fp) return;
+
+    fprintf(fp, "%s: %.3f ms", name ? name : "profile", (double)p->time_ns / 1e6);
+    if (p->ops > 0) fprintf(fp, ", %.0f ops", p->ops);
+    fprintf(fp, "\n");
+
+    for (int i = 0; i < PALMA_COUNTER_COUNT; i++) {
+        if (!(p->available & (1u << i))) {
+            fprintf(fp, "  %-14s %18s\n", counter_names[i], "not available");
+            continue;
+        }
+        fprintf(fp, "  %-14s %18llu", counter_names[i], (unsigned long long)p->value[i]);
+        if (p->ops > 0) fprintf(fp, "  %10.4f / op", (double)p->value[i] / p->ops);
+        fprintf(fp, "\n");
+    }
+
+    uint32_t ipc = (1u << PALMA_COUNTER_CYCLES) | (1u << PALMA_COUNTER_INSTRUCTIONS);
+    if ((p->available & ipc) == ipc && p->value[PALMA_COUNTER_CYCLES] > 0) {
+        fprintf(fp, "  %-14s %18.2f\n", "IPC",
+                (double)p->value[PALMA_COUNTER_INSTRUCTIONS] / (double)p->value[PALMA_COUNTER_CYCLES]);
+    }
+}
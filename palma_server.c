@@ -0,0 +1,524 @@
+/**
+ * @file palma_server.c
+ * @brief PALMA Query Server - resident models served over a Unix socket
+ *
+ * Loads each model once, precomputes its closure A* (with the algorithm
+ * planner), the completion time of every task and the cycle time, frees the
+ * input and then answers batched queries from any number of local clients.
+ * All answers are table lookups, so one thread multiplexing connections
+ * with poll() keeps up with pipelined clients.
+ *
+ * Usage:
+ *   palma_server [-s socket] model[@semiring] ...
+ *
+ * Models are binary files (palma_matrix_save_binary) or CSV files (*.csv)
+ * and are numbered from 0 in argument order. The semiring defaults to
+ * max-plus; accepted names are maxplus, minplus, maxmin, minmax, boolean.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         NM-AIST / AIMS-RIC
+ * @email  rnguessan@aimsric.org
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "palma.h"
+
+/* Stop answering a client whose unread responses exceed this */
+#define MAX_PENDING_OUTPUT (64u * 1024u * 1024u)
+
+/* Largest request: a header and PALMA_QUERY_MAX_ITEMS pairs; bounds the input buffer */
+#define MAX_REQUEST_SIZE (sizeof(palma_query_header_t) + (size_t)PALMA_QUERY_MAX_ITEMS * 2 * sizeof(uint32_t))
+
+#define READ_CHUNK 65536
+
+/*============================================================================
+ * MODELS
+ *============================================================================*/
+
+typedef struct {
+    const char *path;
+    palma_semiring_t semiring;
+    palma_matrix_t *star;           /* A* */
+    palma_val_t *completion;        /* ⊕_j A*[i, j]: completion with all inputs at e */
+    palma_val_t cycle_time;
+    palma_error_t cycle_status;
+} model_t;
+
+static bool parse_semiring(const char *name, palma_semiring_t *s) {
+    static const struct { const char *name; palma_semiring_t s; } names[] = {
+        { "maxplus", PALMA_MAXPLUS }, { "minplus", PALMA_MINPLUS },
+        { "maxmin", PALMA_MAXMIN }, { "minmax", PALMA_MINMAX },
+        { "boolean", PALMA_BOOLEAN }
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i].name) == 0) {
+            *s = names[i].s;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool load_model(model_t *m, char *spec) {
+    m->semiring = PALMA_MAXPLUS;
+    char *at = strrchr(spec, '@');
+    if (at) {
+        *at = '\0';
+        if (!parse_semiring(at + 1, &m->semiring)) {
+            fprintf(stderr, "unknown semiring '%s'\n", at + 1);
+            return false;
+        }
+    }
+    m->path = spec;
+
+    size_t len = strlen(spec);
+    palma_matrix_t *A = (len > 4 && strcmp(spec + len - 4, ".csv") == 0)
+                        ? palma_matrix_load_csv(spec, m->semiring)
+                        : palma_matrix_load_binary(spec);
+    if (!A) {
+        fprintf(stderr, "%s: %s\n", spec, palma_strerror(palma_get_last_error()));
+        return false;
+    }
+    if (A->rows != A->cols) {
+        fprintf(stderr, "%s: matrix must be square\n", spec);
+        palma_matrix_destroy(A);
+        return false;
+    }
+
+    size_t n = A->rows;
+    palma_plan_t plan;
+    m->star = palma_matrix_create(n, n);
+    m->completion = (palma_val_t*)malloc(n * sizeof(palma_val_t));
+    if (!m->star || !m->completion ||
+        palma_auto_closure_into(m->star, A, m->semiring, &plan) != PALMA_SUCCESS) {
+        fprintf(stderr, "%s: closure failed: %s\n", spec, palma_strerror(palma_get_last_error()));
+        palma_matrix_destroy(A);
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        palma_val_t best = palma_zero(m->semiring);
+        for (size_t j = 0; j < n; j++) {
+            best = palma_add(best, palma_matrix_get(m->star, i, j), m->semiring);
+        }
+        m->completion[i] = best;
+    }
+
+    if (m->semiring == PALMA_MAXPLUS || m->semiring == PALMA_MINPLUS) {
+        palma_clear_error();
+        m->cycle_time = palma_eigenvalue(A, m->semiring);
+        m->cycle_status = palma_get_last_error();
+    } else {
+        m->cycle_time = PALMA_NEG_INF;
+        m->cycle_status = PALMA_ERR_UNSUPPORTED;
+    }
+
+    printf("model %s: %zu nodes, %s, closure by %s\n", spec, n,
+           palma_semiring_name(m->semiring), palma_engine_name(plan.engine));
+
+    palma_matrix_destroy(A);
+    return true;
+}
+
+/*============================================================================
+ * CONNECTIONS
+ *============================================================================*/
+
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+    size_t pos;         /* Consumed prefix */
+} buffer_t;
+
+typedef struct {
+    int fd;
+    buffer_t in;
+    buffer_t out;
+} client_t;
+
+static bool buffer_reserve(buffer_t *b, size_t extra) {
+    if (b->pos > 0 && b->len + extra > b->cap) {
+        memmove(b->data, b->data + b->pos, b->len - b->pos);
+        b->len -= b->pos;
+        b->pos = 0;
+    }
+    if (b->len + extra <= b->cap) return true;
+
+    size_t cap = b->cap ? b->cap : READ_CHUNK;
+    while (cap < b->len + extra) cap *= 2;
+    char *data = (char*)realloc(b->data, cap);
+    if (!data) return false;
+    b->data = data;
+    b->cap = cap;
+    return true;
+}
+
+static bool buffer_append(buffer_t *b, const void *src, size_t len) {
+    if (!buffer_reserve(b, len)) return false;
+    memcpy(b->data + b->len, src, len);
+    b->len += len;
+    return true;
+}
+
+static size_t item_width(uint16_t op) {
+    return (op == PALMA_QUERY_DISTANCE || op == PALMA_QUERY_REACHABLE) ? 2 : 1;
+}
+
+/* Answer one request; values are written straight into the output buffer */
+static bool answer(client_t *c, const palma_query_header_t *req, const uint32_t *items,
+                   const model_t *models, size_t n_models) {
+    palma_query_header_t resp = *req;
+    resp.status = PALMA_SUCCESS;
+    resp.count = 0;
+
+    const model_t *m = (req->model < n_models) ? &models[req->model] : NULL;
+    size_t n = m ? m->star->rows : 0;
+    size_t count = req->count;
+
+    if (!m) {
+        resp.status = PALMA_ERR_INVALID_ARG;
+    } else if (req->op == PALMA_QUERY_INFO || req->op == PALMA_QUERY_CYCLE_TIME) {
+        resp.count = (req->op == PALMA_QUERY_INFO) ? 2 : 1;
+        if (req->op == PALMA_QUERY_CYCLE_TIME) resp.status = (int16_t)m->cycle_status;
+    } else if (req->op > PALMA_QUERY_CYCLE_TIME) {
+        resp.status = PALMA_ERR_INVALID_ARG;
+    } else {
+        size_t w = item_width(req->op);
+        for (size_t i = 0; i < count * w; i++) {
+            if (items[i] >= n) {
+                resp.status = PALMA_ERR_INDEX_BOUNDS;
+                break;
+            }
+        }
+        if (resp.status == PALMA_SUCCESS) resp.count = req->count;
+    }
+
+    if (!buffer_append(&c->out, &resp, sizeof(resp))) return false;
+    if (resp.count == 0) return true;
+    if (!buffer_reserve(&c->out, resp.count * sizeof(palma_val_t))) return false;
+
+    palma_val_t *v = (palma_val_t*)(c->out.data + c->out.len);
+    c->out.len += resp.count * sizeof(palma_val_t);
+
+    switch (req->op) {
+        case PALMA_QUERY_INFO:
+            v[0] = (palma_val_t)n;
+            v[1] = (palma_val_t)m->semiring;
+            break;
+        case PALMA_QUERY_CYCLE_TIME:
+            v[0] = m->cycle_time;
+            break;
+        case PALMA_QUERY_DISTANCE:
+            for (size_t i = 0; i < count; i++) {
+                v[i] = palma_matrix_get(m->star, items[2 * i], items[2 * i + 1]);
+            }
+            break;
+        case PALMA_QUERY_REACHABLE: {
+            palma_val_t zero = palma_zero(m->semiring);
+            for (size_t i = 0; i < count; i++) {
+                v[i] = palma_matrix_get(m->star, items[2 * i], items[2 * i + 1]) != zero;
+            }
+            break;
+        }
+        case PALMA_QUERY_COMPLETION:
+            for (size_t i = 0; i < count; i++) v[i] = m->completion[items[i]];
+            break;
+    }
+
+    return true;
+}
+
+static bool output_full(const client_t *c) {
+    return c->out.len - c->out.pos >= MAX_PENDING_OUTPUT;
+}
+
+/* A whole request (or a malformed header, which drops the client) is buffered */
+static bool request_ready(const buffer_t *in) {
+    if (in->len - in->pos < sizeof(palma_query_header_t)) return false;
+
+    palma_query_header_t req;
+    memcpy(&req, in->data + in->pos, sizeof(req));
+    if (req.magic != PALMA_QUERY_MAGIC || req.count > PALMA_QUERY_MAX_ITEMS) return true;
+
+    size_t payload = (size_t)req.count * item_width(req.op) * sizeof(uint32_t);
+    return in->len - in->pos >= sizeof(req) + payload;
+}
+
+/*
+ * Answer complete requests from the input buffer until it runs out or the
+ * client has MAX_PENDING_OUTPUT unread; the rest waits until the client
+ * reads. False drops the client.
+ */
+static bool process_input(client_t *c, const model_t *models, size_t n_models) {
+    buffer_t *in = &c->in;
+
+    while (in->len - in->pos >= sizeof(palma_query_header_t) && !output_full(c)) {
+        palma_query_header_t req;
+        memcpy(&req, in->data + in->pos, sizeof(req));
+        if (req.magic != PALMA_QUERY_MAGIC || req.count > PALMA_QUERY_MAX_ITEMS) return false;
+
+        size_t payload = (size_t)req.count * item_width(req.op) * sizeof(uint32_t);
+        if (in->len - in->pos < sizeof(req) + payload) break;
+
+        /* Items are copied out so they stay aligned regardless of framing */
+        uint32_t *items = NULL;
+        if (payload > 0) {
+            items = (uint32_t*)malloc(payload);
+            if (!items) return false;
+            memcpy(items, in->data + in->pos + sizeof(req), payload);
+        }
+
+        bool ok = answer(c, &req, items, models, n_models);
+        free(items);
+        if (!ok) return false;
+
+        in->pos += sizeof(req) + payload;
+    }
+
+    if (in->pos == in->len) in->pos = in->len = 0;
+    return true;
+}
+
+/*
+ * Read until a whole request is buffered or the socket is drained. Requests
+ * still queued in the socket stay there, so a client that does not read its
+ * answers is throttled by the kernel instead of growing the buffer.
+ */
+static bool read_client(client_t *c) {
+    while (!request_ready(&c->in)) {
+        size_t held = c->in.len - c->in.pos;
+        size_t want = MAX_REQUEST_SIZE - held < READ_CHUNK ? MAX_REQUEST_SIZE - held : READ_CHUNK;
+        if (!buffer_reserve(&c->in, want)) return false;
+
+        ssize_t n = read(c->fd, c->in.data + c->in.len, want);
+        if (n > 0) {
+            c->in.len += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;   /* EOF or error */
+    }
+    return true;
+}
+
+static bool write_client(client_t *c) {
+    buffer_t *out = &c->out;
+    while (out->pos < out->len) {
+        ssize_t n = send(c->fd, out->data + out->pos, out->len - out->pos, MSG_NOSIGNAL);
+        if (n > 0) {
+            out->pos += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+    out->pos = out->len = 0;
+    return true;
+}
+
+static void drop_client(client_t *c) {
+    close(c->fd);
+    free(c->in.data);
+    free(c->out.data);
+    memset(c, 0, sizeof(*c));
+    c->fd = -1;
+}
+
+/*============================================================================
+ * MAIN LOOP
+ *============================================================================*/
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+/*
+ * Remove a leftover socket from a previous run. Anything else at the path
+ * (a file, a link, another user's socket, a live server) is left alone and
+ * reported, since the default path is in a world-writable directory.
+ */
+static bool remove_stale_socket(const char *path, const struct sockaddr_un *addr) {
+    struct stat st;
+    if (lstat(path, &st) != 0) return errno == ENOENT;
+
+    if (!S_ISSOCK(st.st_mode) || st.st_uid != geteuid()) {
+        errno = EEXIST;
+        return false;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) return false;
+    int rc = connect(probe, (const struct sockaddr*)addr, sizeof(*addr));
+    int err = errno;
+    close(probe);
+
+    if (rc == 0) {
+        errno = EADDRINUSE;
+        return false;
+    }
+    if (err != ECONNREFUSED) {
+        errno = err;
+        return false;
+    }
+    return unlink(path) == 0;
+}
+
+static int listen_on(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (!remove_stale_socket(path, &addr)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s socket] model[@semiring] ...\n", prog);
+}
+
+int main(int argc, char **argv) {
+    const char *sock_path = PALMA_QUERY_SOCKET;
+    int first = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+        sock_path = argv[2];
+        first = 3;
+    }
+    if (first >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    size_t n_models = (size_t)(argc - first);
+    model_t *models = (model_t*)calloc(n_models, sizeof(model_t));
+    if (!models) return 1;
+
+    for (size_t i = 0; i < n_models; i++) {
+        if (!load_model(&models[i], argv[first + (int)i])) return 1;
+    }
+
+    int listen_fd = listen_on(sock_path);
+    if (listen_fd < 0) {
+        fprintf(stderr, "cannot listen on %s: %s\n", sock_path, strerror(errno));
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("serving %zu model(s) on %s\n", n_models, sock_path);
+    fflush(stdout);
+
+    size_t cap = 16;
+    client_t *clients = (client_t*)malloc(cap * sizeof(client_t));
+    struct pollfd *pfd = (struct pollfd*)malloc((cap + 1) * sizeof(struct pollfd));
+    size_t n_clients = 0;
+    if (!clients || !pfd) return 1;
+
+    while (!g_stop) {
+        /* Don't sleep while a client has a buffered request it has room to receive */
+        int timeout = -1;
+        pfd[0].fd = listen_fd;
+        pfd[0].events = POLLIN;
+        for (size_t i = 0; i < n_clients; i++) {
+            client_t *c = &clients[i];
+            bool ready = request_ready(&c->in);
+            pfd[i + 1].fd = c->fd;
+            pfd[i + 1].events = 0;
+            if (!ready && !output_full(c)) pfd[i + 1].events |= POLLIN;
+            if (c->out.pos < c->out.len) pfd[i + 1].events |= POLLOUT;
+            if (ready && !output_full(c)) timeout = 0;
+        }
+
+        if (poll(pfd, n_clients + 1, timeout) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (size_t i = 0; i < n_clients; i++) {
+            client_t *c = &clients[i];
+            short ev = pfd[i + 1].revents;
+            bool ok = true;
+            if (ev & (POLLIN | POLLHUP | POLLERR)) ok = read_client(c);
+            if (ok) ok = process_input(c, models, n_models);
+            if (ok && c->out.pos < c->out.len) ok = write_client(c);
+            if (!ok) drop_client(c);
+        }
+
+        /* Compact dropped clients before the array may grow */
+        size_t kept = 0;
+        for (size_t i = 0; i < n_clients; i++) {
+            if (clients[i].fd >= 0) clients[kept++] = clients[i];
+        }
+        n_clients = kept;
+
+        if (pfd[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+                if (n_clients == cap) {
+                    client_t *nc = (client_t*)realloc(clients, 2 * cap * sizeof(client_t));
+                    struct pollfd *np = nc ? (struct pollfd*)realloc(pfd, (2 * cap + 1) * sizeof(struct pollfd)) : NULL;
+                    if (nc) clients = nc;
+                    if (!np) {
+                        close(fd);
+                        break;
+                    }
+                    pfd = np;
+                    cap *= 2;
+                }
+                memset(&clients[n_clients], 0, sizeof(client_t));
+                clients[n_clients++].fd = fd;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n_clients; i++) drop_client(&clients[i]);
+    free(clients);
+    free(pfd);
+    close(listen_fd);
+    unlink(sock_path);
+
+    for (size_t i = 0; i < n_models; i++) {
+        palma_matrix_destroy(models[i].star);
+        free(models[i].completion);
+    }
+    free(models);
+
+    return 0;
+}
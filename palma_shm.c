@@ -0,0 +1,455 @@
+/**
+ * @file palma_shm.c
+ * @brief PALMA Shared-Memory Tables - zero-copy publication across processes
+ *
+ * A publication is a small control segment holding the current version
+ * number and one data segment per version. Publishing never modifies a
+ * segment that readers can see: the new table is written to a fresh
+ * segment, the version word is switched with a single atomic store, and the
+ * old segment is unlinked. POSIX keeps an unlinked segment alive while it is
+ * mapped, so attached readers keep a consistent table without any lock.
+ *
+ * A reader that loses the race (the version it read is unlinked before it
+ * opens the segment) simply reads the version word again.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*============================================================================
+ * LAYOUT
+ *============================================================================*/
+
+/* Control segment. `tag` is set once, by whichever producer creates it. */
+typedef struct {
+    uint64_t tag;           /* (PALMA_SHM_MAGIC << 32) | PALMA_SHM_FORMAT */
+    uint64_t version;       /* Current version, 0 = nothing published */
+    uint64_t next;          /* Last version number handed out */
+} shm_control_t;
+
+#define SHM_TAG      (((uint64_t)PALMA_SHM_MAGIC << 32) | PALMA_SHM_FORMAT)
+#define SHM_ALIGN    64
+#define SHM_NAME_MAX 240
+#define SHM_RETRIES  64
+
+struct palma_shm_view {
+    char name[SHM_NAME_MAX + 1];
+    const shm_control_t *control;
+    void *base;
+    size_t size;
+    uint64_t version;
+    palma_semiring_t semiring;
+    palma_shm_kind_t kind;
+    palma_matrix_t matrix;
+    palma_sparse_t sparse;
+};
+
+static size_t align_up(size_t n) {
+    return (n + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1);
+}
+
+static bool valid_name(const char *name) {
+    if (!name || name[0] != '/' || name[1] == '\0') return false;
+    if (strlen(name) > SHM_NAME_MAX) return false;
+    return strchr(name + 1, '/') == NULL;
+}
+
+static void segment_name(char *out, const char *name, uint64_t version) {
+    snprintf(out, SHM_NAME_MAX + 24, "%s.%llu", name, (unsigned long long)version);
+}
+
+/*============================================================================
+ * CONTROL SEGMENT
+ *============================================================================*/
+
+static shm_control_t* control_open(const char *name, bool create) {
+    int fd = shm_open(name, create ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd < 0) return NULL;
+
+    /* Extending to the same size is a no-op, so racing creators agree */
+    struct stat st;
+    if ((create && ftruncate(fd, sizeof(shm_control_t)) != 0) ||
+        fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(shm_control_t)) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    void *p = mmap(NULL, sizeof(shm_control_t), create ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                   MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return NULL;
+
+    shm_control_t *ctl = (shm_control_t*)p;
+    uint64_t tag = 0;
+    if (create) {
+        __atomic_compare_exchange_n(&ctl->tag, &tag, SHM_TAG, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+        if (tag == 0) tag = SHM_TAG;
+    } else {
+        tag = __atomic_load_n(&ctl->tag, __ATOMIC_ACQUIRE);
+    }
+    if (tag != SHM_TAG) {
+        munmap(p, sizeof(shm_control_t));
+        errno = EPROTO;
+        return NULL;
+    }
+    return ctl;
+}
+
+static void control_close(const shm_control_t *ctl) {
+    if (ctl) munmap((void*)ctl, sizeof(shm_control_t));
+}
+
+/*============================================================================
+ * PUBLISHING
+ *============================================================================*/
+
+/*
+ * Create the data segment for a new version, let fill() write the payload,
+ * then make it current. A slower producer whose version has been overtaken
+ * discards its own segment instead of going back in time.
+ */
+typedef void (*shm_fill_fn)(void *base, const palma_shm_header_t *hdr, const void *src);
+
+static palma_error_t publish(const char *name, palma_shm_header_t *hdr,
+                             shm_fill_fn fill, const void *src, uint64_t *version) {
+    shm_control_t *ctl = control_open(name, true);
+    if (!ctl) return errno == EPROTO ? PALMA_ERR_FILE_FORMAT : PALMA_ERR_FILE_OPEN;
+
+    uint64_t v = __atomic_add_fetch(&ctl->next, 1, __ATOMIC_ACQ_REL);
+    char seg[SHM_NAME_MAX + 24];
+    segment_name(seg, name, v);
+
+    int fd = shm_open(seg, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        control_close(ctl);
+        return PALMA_ERR_FILE_OPEN;
+    }
+    if (ftruncate(fd, (off_t)hdr->size) != 0) {
+        close(fd);
+        shm_unlink(seg);
+        control_close(ctl);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+
+    void *base = mmap(NULL, hdr->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(seg);
+        control_close(ctl);
+        return PALMA_ERR_OUT_OF_MEMORY;
+    }
+
+    hdr->version = v;
+    memcpy(base, hdr, sizeof(*hdr));
+    fill(base, hdr, src);
+    munmap(base, hdr->size);
+
+    /* Switch: readers that load the new version find a complete segment */
+    uint64_t cur = __atomic_load_n(&ctl->version, __ATOMIC_ACQUIRE);
+    while (cur < v && !__atomic_compare_exchange_n(&ctl->version, &cur, v, false,
+                                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    }
+    control_close(ctl);
+
+    if (cur > v) {
+        shm_unlink(seg);
+    } else if (cur > 0) {
+        segment_name(seg, name, cur);
+        shm_unlink(seg);
+    }
+
+    if (version) *version = v;
+    return PALMA_SUCCESS;
+}
+
+static void fill_dense(void *base, const palma_shm_header_t *hdr, const void *src) {
+    const palma_matrix_t *A = (const palma_matrix_t*)src;
+    palma_val_t *dst = (palma_val_t*)((char*)base + hdr->values_offset);
+    for (size_t i = 0; i < A->rows; i++) {
+        memcpy(dst + i * hdr->stride, A->data + i * A->stride, A->cols * sizeof(palma_val_t));
+    }
+}
+
+static void fill_sparse(void *base, const palma_shm_header_t *hdr, const void *src) {
+    const palma_sparse_t *S = (const palma_sparse_t*)src;
+    char *b = (char*)base;
+    memcpy(b + hdr->values_offset, S->values, S->nnz * sizeof(palma_val_t));
+    memcpy(b + hdr->col_idx_offset, S->col_idx, S->nnz * sizeof(palma_idx_t));
+    memcpy(b + hdr->row_ptr_offset, S->row_ptr, (S->rows + 1) * sizeof(palma_ptr_t));
+}
+
+static void header_init(palma_shm_header_t *hdr, palma_shm_kind_t kind, palma_semiring_t semiring,
+                        size_t rows, size_t cols) {
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = PALMA_SHM_MAGIC;
+    hdr->format = PALMA_SHM_FORMAT;
+    hdr->kind = (uint32_t)kind;
+    hdr->semiring = (int32_t)semiring;
+    hdr->val_size = (uint16_t)sizeof(palma_val_t);
+    hdr->idx_size = (uint16_t)sizeof(palma_idx_t);
+    hdr->ptr_size = (uint16_t)sizeof(palma_ptr_t);
+    hdr->rows = rows;
+    hdr->cols = cols;
+}
+
+palma_error_t palma_shm_publish_matrix(const char *name, const palma_matrix_t *A,
+                                       palma_semiring_t semiring, uint64_t *version) {
+    if (!A || !A->data) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (!valid_name(name)) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    palma_shm_header_t hdr;
+    header_init(&hdr, PALMA_SHM_DENSE, semiring, A->rows, A->cols);
+    hdr.stride = palma_alloc_stride(A->cols);
+    if (hdr.stride > 0 && A->rows > (SIZE_MAX / 2) / sizeof(palma_val_t) / hdr.stride) {
+        PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    }
+    hdr.values_offset = align_up(sizeof(hdr));
+    hdr.size = hdr.values_offset + A->rows * hdr.stride * sizeof(palma_val_t);
+
+    palma_error_t err = publish(name, &hdr, fill_dense, A, version);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_shm_publish_sparse(const char *name, const palma_sparse_t *S,
+                                       uint64_t *version) {
+    if (!S || !S->row_ptr) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (!valid_name(name)) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    palma_shm_header_t hdr;
+    header_init(&hdr, PALMA_SHM_SPARSE, S->semiring, S->rows, S->cols);
+    hdr.nnz = S->nnz;
+    hdr.values_offset = align_up(sizeof(hdr));
+    hdr.col_idx_offset = align_up(hdr.values_offset + S->nnz * sizeof(palma_val_t));
+    hdr.row_ptr_offset = align_up(hdr.col_idx_offset + S->nnz * sizeof(palma_idx_t));
+    hdr.size = hdr.row_ptr_offset + (S->rows + 1) * sizeof(palma_ptr_t);
+
+    palma_error_t err = publish(name, &hdr, fill_sparse, S, version);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_shm_unlink(const char *name) {
+    if (!valid_name(name)) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    shm_control_t *ctl = control_open(name, false);
+    if (!ctl) PALMA_RETURN_ERROR(PALMA_ERR_FILE_OPEN);
+    uint64_t v = __atomic_load_n(&ctl->version, __ATOMIC_ACQUIRE);
+    control_close(ctl);
+
+    if (v > 0) {
+        char seg[SHM_NAME_MAX + 24];
+        segment_name(seg, name, v);
+        shm_unlink(seg);
+    }
+    shm_unlink(name);
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * ATTACHING
+ *============================================================================*/
+
+/* Reject anything a corrupt or foreign segment could use to point outside itself */
+static bool header_valid(const palma_shm_header_t *h, uint64_t version, size_t size) {
+    if (h->magic != PALMA_SHM_MAGIC || h->format != PALMA_SHM_FORMAT) return false;
+    if (h->version != version || h->size > size) return false;
+    if (h->val_size != sizeof(palma_val_t) || h->idx_size != sizeof(palma_idx_t) ||
+        h->ptr_size != sizeof(palma_ptr_t)) {
+        return false;
+    }
+    if (h->semiring < PALMA_MAXPLUS || h->semiring > PALMA_BOOLEAN) return false;
+    if (h->rows > SIZE_MAX / 2 || h->cols > SIZE_MAX / 2) return false;
+
+    uint64_t avail = h->size;
+    if (h->values_offset < sizeof(*h) || h->values_offset > avail) return false;
+    if (h->values_offset % sizeof(palma_val_t) != 0) return false;
+
+    if (h->kind == PALMA_SHM_DENSE) {
+        if (h->stride < h->cols || (h->rows > 0 && h->stride > (SIZE_MAX / 2) / h->rows)) return false;
+        return h->rows * h->stride <= (avail - h->values_offset) / sizeof(palma_val_t);
+    }
+    if (h->kind == PALMA_SHM_SPARSE) {
+        if (h->col_idx_offset > avail || h->row_ptr_offset > avail) return false;
+        if (h->col_idx_offset % sizeof(palma_idx_t) != 0 || h->row_ptr_offset % sizeof(palma_ptr_t) != 0) {
+            return false;
+        }
+        if (h->nnz > (avail - h->values_offset) / sizeof(palma_val_t)) return false;
+        if (h->nnz > (avail - h->col_idx_offset) / sizeof(palma_idx_t)) return false;
+        return h->rows + 1 <= (avail - h->row_ptr_offset) / sizeof(palma_ptr_t);
+    }
+    return false;
+}
+
+/* The header only bounds the arrays; matvec and friends index through their
+ * contents, so a sparse table must also be a well-formed CSR. One O(rows + nnz) pass. */
+static bool sparse_valid(const char *base, const palma_shm_header_t *h) {
+    const palma_ptr_t *row_ptr = (const palma_ptr_t*)(base + h->row_ptr_offset);
+    const palma_idx_t *col_idx = (const palma_idx_t*)(base + h->col_idx_offset);
+
+    if (row_ptr[0] != 0 || row_ptr[h->rows] != h->nnz) return false;
+    for (uint64_t i = 0; i < h->rows; i++) {
+        if (row_ptr[i] > row_ptr[i + 1]) return false;
+    }
+    for (uint64_t k = 0; k < h->nnz; k++) {
+        if (col_idx[k] >= h->cols) return false;
+    }
+    return true;
+}
+
+/* Map one version read-only; ENOENT means it was replaced meanwhile */
+static palma_error_t map_version(palma_shm_view_t *view, const char *name, uint64_t v) {
+    char seg[SHM_NAME_MAX + 24];
+    segment_name(seg, name, v);
+
+    int fd = shm_open(seg, O_RDONLY, 0);
+    if (fd < 0) return errno == ENOENT ? PALMA_ERR_FILE_READ : PALMA_ERR_FILE_OPEN;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(palma_shm_header_t)) {
+        close(fd);
+        return PALMA_ERR_FILE_FORMAT;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return PALMA_ERR_OUT_OF_MEMORY;
+
+    const palma_shm_header_t *h = (const palma_shm_header_t*)base;
+    if (!header_valid(h, v, (size_t)st.st_size)) {
+        munmap(base, (size_t)st.st_size);
+        return PALMA_ERR_FILE_FORMAT;
+    }
+    if (h->kind == PALMA_SHM_SPARSE && !sparse_valid((const char*)base, h)) {
+        munmap(base, (size_t)st.st_size);
+        return PALMA_ERR_SPARSE_FORMAT;
+    }
+
+    view->base = base;
+    view->size = (size_t)st.st_size;
+    view->version = v;
+    view->semiring = (palma_semiring_t)h->semiring;
+    view->kind = (palma_shm_kind_t)h->kind;
+
+    /* Wrap the mapping; the casts drop const because the structs are shared with writable code */
+    char *b = (char*)base;
+    if (view->kind == PALMA_SHM_DENSE) {
+        view->matrix.data = (palma_val_t*)(b + h->values_offset);
+        view->matrix.rows = h->rows;
+        view->matrix.cols = h->cols;
+        view->matrix.stride = h->stride;
+        view->matrix.owns_data = false;
+        view->matrix.map_size = 0;
+    } else {
+        view->sparse.values = (palma_val_t*)(b + h->values_offset);
+        view->sparse.col_idx = (palma_idx_t*)(b + h->col_idx_offset);
+        view->sparse.row_ptr = (palma_ptr_t*)(b + h->row_ptr_offset);
+        view->sparse.rows = h->rows;
+        view->sparse.cols = h->cols;
+        view->sparse.nnz = h->nnz;
+        view->sparse.capacity = h->nnz;
+        view->sparse.semiring = view->semiring;
+    }
+    return PALMA_SUCCESS;
+}
+
+palma_shm_view_t* palma_shm_attach(const char *name) {
+    if (!valid_name(name)) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+
+    palma_shm_view_t *view = (palma_shm_view_t*)calloc(1, sizeof(palma_shm_view_t));
+    if (!view) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    strcpy(view->name, name);
+    view->control = control_open(name, false);
+    if (!view->control) {
+        palma_error_t err = errno == EPROTO ? PALMA_ERR_FILE_FORMAT : PALMA_ERR_FILE_OPEN;
+        free(view);
+        PALMA_RETURN_NULL(err);
+    }
+
+    palma_error_t err = PALMA_ERR_FILE_OPEN;
+    for (int attempt = 0; attempt < SHM_RETRIES; attempt++) {
+        uint64_t v = __atomic_load_n(&view->control->version, __ATOMIC_ACQUIRE);
+        if (v == 0) {
+            err = PALMA_ERR_FILE_OPEN;
+            break;
+        }
+        err = map_version(view, name, v);
+        if (err != PALMA_ERR_FILE_READ) break;
+    }
+
+    if (err != PALMA_SUCCESS) {
+        control_close(view->control);
+        free(view);
+        PALMA_RETURN_NULL(err);
+    }
+    return view;
+}
+
+void palma_shm_detach(palma_shm_view_t *view) {
+    if (!view) return;
+    if (view->base) munmap(view->base, view->size);
+    control_close(view->control);
+    free(view);
+}
+
+bool palma_shm_stale(const palma_shm_view_t *view) {
+    if (!view) return false;
+    return __atomic_load_n(&view->control->version, __ATOMIC_ACQUIRE) != view->version;
+}
+
+palma_error_t palma_shm_refresh(palma_shm_view_t **view) {
+    if (!view || !*view) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (!palma_shm_stale(*view)) return PALMA_SUCCESS;
+
+    palma_shm_view_t *old = *view;
+    palma_shm_view_t *fresh = palma_shm_attach(old->name);
+    if (!fresh) return palma_get_last_error();
+
+    palma_shm_detach(old);
+    *view = fresh;
+    return PALMA_SUCCESS;
+}
+
+uint64_t palma_shm_version(const palma_shm_view_t *view) {
+    return view ? view->version : 0;
+}
+
+palma_semiring_t palma_shm_semiring(const palma_shm_view_t *view) {
+    return view ? view->semiring : PALMA_MAXPLUS;
+}
+
+const palma_matrix_t* palma_shm_matrix(const palma_shm_view_t *view) {
+    return (view && view->kind == PALMA_SHM_DENSE) ? &view->matrix : NULL;
+}
+
+const palma_sparse_t* palma_shm_sparse(const palma_shm_view_t *view) {
+    return (view && view->kind == PALMA_SHM_SPARSE) ? &view->sparse : NULL;
+}
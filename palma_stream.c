@@ -0,0 +1,657 @@
+/**
+ * @file palma_stream.c
+ * @brief PALMA Streaming I/O - row-wise writers and readers
+ *
+ * Writers and readers move one block of rows (or one batch of edges) at a
+ * time through a PALMA_STREAM_BUFFER byte buffer, so memory use does not
+ * depend on the size of the file. Text output formats integers with a
+ * two-digit lookup table and issues one large fwrite per buffer; text input
+ * is parsed in place, one line at a time.
+ *
+ * The files are the ones produced by palma_matrix_save_csv,
+ * palma_matrix_save_binary and palma_sparse_save_csv, and are readable by
+ * the corresponding loaders.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* Longest formatted value or edge, with separators */
+#define STREAM_MAX_TOKEN 64
+
+/* Width of the edge count when it is filled in on close */
+#define STREAM_COUNT_WIDTH 20
+
+typedef enum {
+    STREAM_MATRIX_CSV,
+    STREAM_MATRIX_BINARY,
+    STREAM_EDGES
+} stream_kind_t;
+
+/*============================================================================
+ * INTEGER FORMATTING
+ *============================================================================*/
+
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Write x in decimal at p; returns the number of characters */
+static size_t format_u64(char *p, uint64_t x) {
+    char tmp[20];
+    char *q = tmp + sizeof(tmp);
+
+    while (x >= 100) {
+        unsigned d = (unsigned)(x % 100) * 2;
+        x /= 100;
+        *--q = digit_pairs[d + 1];
+        *--q = digit_pairs[d];
+    }
+    if (x >= 10) {
+        unsigned d = (unsigned)x * 2;
+        *--q = digit_pairs[d + 1];
+        *--q = digit_pairs[d];
+    } else {
+        *--q = (char)('0' + x);
+    }
+
+    size_t n = (size_t)(tmp + sizeof(tmp) - q);
+    memcpy(p, q, n);
+    return n;
+}
+
+/* Tropical value as written by palma_matrix_save_csv */
+static size_t format_value(char *p, palma_val_t v) {
+    if (v == PALMA_NEG_INF) {
+        memcpy(p, "-inf", 4);
+        return 4;
+    }
+    if (v == PALMA_POS_INF) {
+        memcpy(p, "inf", 3);
+        return 3;
+    }
+    if (v < 0) {
+        *p = '-';
+        return 1 + format_u64(p + 1, (uint64_t)(-(int64_t)v));
+    }
+    return format_u64(p, (uint64_t)v);
+}
+
+/*============================================================================
+ * WRITERS
+ *============================================================================*/
+
+struct palma_writer {
+    FILE *fp;
+    stream_kind_t kind;
+    char *buf;
+    size_t len;
+    palma_error_t err;      /* First failure; later calls return it */
+
+    size_t rows;
+    size_t cols;
+    size_t written;         /* Rows (matrices) or edges written so far */
+    size_t expected;        /* Declared edge count, or PALMA_STREAM_UNKNOWN */
+    long count_at;          /* File offset of the edge count to fill in */
+};
+
+static palma_error_t writer_flush(palma_writer_t *w) {
+    if (w->len > 0 && w->err == PALMA_SUCCESS) {
+        if (fwrite(w->buf, 1, w->len, w->fp) != w->len) w->err = PALMA_ERR_FILE_WRITE;
+    }
+    w->len = 0;
+    return w->err;
+}
+
+/* Make room for one token */
+static inline bool writer_reserve(palma_writer_t *w) {
+    if (w->len + STREAM_MAX_TOKEN > PALMA_STREAM_BUFFER) writer_flush(w);
+    return w->err == PALMA_SUCCESS;
+}
+
+static void writer_puts(palma_writer_t *w, const char *s) {
+    size_t n = strlen(s);
+    if (w->len + n > PALMA_STREAM_BUFFER) writer_flush(w);
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static palma_writer_t* writer_open(const char *filename, stream_kind_t kind,
+                                   size_t rows, size_t cols) {
+    palma_writer_t *w = (palma_writer_t*)calloc(1, sizeof(palma_writer_t));
+    if (!w) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    w->buf = (char*)malloc(PALMA_STREAM_BUFFER);
+    if (!w->buf) {
+        free(w);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    w->fp = fopen(filename, kind == STREAM_MATRIX_BINARY ? "wb" : "w");
+    if (!w->fp) {
+        free(w->buf);
+        free(w);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_OPEN);
+    }
+
+    /* The writer does its own buffering */
+    setvbuf(w->fp, NULL, _IONBF, 0);
+    w->kind = kind;
+    w->rows = rows;
+    w->cols = cols;
+    return w;
+}
+
+palma_writer_t* palma_writer_open_matrix(const char *filename, size_t rows, size_t cols,
+                                         palma_semiring_t semiring,
+                                         palma_stream_format_t format) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (rows == 0 || cols == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    if (format != PALMA_STREAM_CSV && format != PALMA_STREAM_BINARY) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+    }
+    if (format == PALMA_STREAM_BINARY && (rows > UINT32_MAX || cols > UINT32_MAX)) {
+        PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+    }
+
+    palma_writer_t *w = writer_open(filename,
+                                    format == PALMA_STREAM_BINARY ? STREAM_MATRIX_BINARY
+                                                                  : STREAM_MATRIX_CSV,
+                                    rows, cols);
+    if (!w) return NULL;
+
+    if (format == PALMA_STREAM_BINARY) {
+        uint32_t header[4] = { PALMA_BINARY_MAGIC, PALMA_BINARY_VERSION,
+                               (uint32_t)rows, (uint32_t)cols };
+        memcpy(w->buf, header, sizeof(header));
+        w->len = sizeof(header);
+    } else {
+        w->len = (size_t)snprintf(w->buf, STREAM_MAX_TOKEN * 2, "# PALMA matrix %zux%zu, semiring=%s\n",
+                                  rows, cols, palma_semiring_name(semiring));
+    }
+    return w;
+}
+
+palma_writer_t* palma_writer_open_edges(const char *filename, size_t rows, size_t cols,
+                                        size_t nnz, palma_semiring_t semiring) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (rows == 0 || cols == 0) PALMA_RETURN_NULL(PALMA_ERR_INVALID_DIM);
+
+    palma_writer_t *w = writer_open(filename, STREAM_EDGES, rows, cols);
+    if (!w) return NULL;
+    w->expected = nnz;
+
+    char line[STREAM_MAX_TOKEN * 2];
+    if (nnz != PALMA_STREAM_UNKNOWN) {
+        snprintf(line, sizeof(line), "# PALMA sparse matrix %zux%zu, nnz=%zu, semiring=%s\n",
+                 rows, cols, nnz, palma_semiring_name(semiring));
+        writer_puts(w, line);
+        writer_puts(w, "# Format: row,col,value (COO format)\n");
+        snprintf(line, sizeof(line), "%zu,%zu,%zu\n", rows, cols, nnz);
+        writer_puts(w, line);
+    } else {
+        /* The count is left blank and filled in by palma_writer_close */
+        snprintf(line, sizeof(line), "# PALMA sparse matrix %zux%zu, semiring=%s\n",
+                 rows, cols, palma_semiring_name(semiring));
+        writer_puts(w, line);
+        writer_puts(w, "# Format: row,col,value (COO format)\n");
+        snprintf(line, sizeof(line), "%zu,%zu,", rows, cols);
+        writer_puts(w, line);
+        w->count_at = (long)w->len;
+        memset(w->buf + w->len, ' ', STREAM_COUNT_WIDTH);
+        w->len += STREAM_COUNT_WIDTH;
+        w->buf[w->len++] = '\n';
+    }
+    return w;
+}
+
+palma_error_t palma_writer_write_rows(palma_writer_t *w, const palma_matrix_t *block) {
+    if (!w || !block) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (w->kind == STREAM_EDGES) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (w->err != PALMA_SUCCESS) PALMA_RETURN_ERROR(w->err);
+    if (block->cols != w->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+    if (block->rows > w->rows - w->written) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+    for (size_t i = 0; i < block->rows; i++) {
+        const palma_val_t *row = block->data + i * block->stride;
+
+        if (w->kind == STREAM_MATRIX_BINARY) {
+            size_t bytes = block->cols * sizeof(palma_val_t);
+            if (w->len + bytes > PALMA_STREAM_BUFFER) writer_flush(w);
+            if (bytes > PALMA_STREAM_BUFFER) {
+                if (w->err == PALMA_SUCCESS && fwrite(row, 1, bytes, w->fp) != bytes) {
+                    w->err = PALMA_ERR_FILE_WRITE;
+                }
+            } else {
+                memcpy(w->buf + w->len, row, bytes);
+                w->len += bytes;
+            }
+        } else {
+            for (size_t j = 0; j < block->cols; j++) {
+                if (!writer_reserve(w)) break;
+                w->len += format_value(w->buf + w->len, row[j]);
+                w->buf[w->len++] = (j + 1 < block->cols) ? ',' : '\n';
+            }
+        }
+        if (w->err != PALMA_SUCCESS) PALMA_RETURN_ERROR(w->err);
+    }
+
+    w->written += block->rows;
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_writer_write_edge(palma_writer_t *w, size_t row, size_t col, palma_val_t val) {
+    if (!w) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (w->kind != STREAM_EDGES) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (w->err != PALMA_SUCCESS) PALMA_RETURN_ERROR(w->err);
+    if (row >= w->rows || col >= w->cols) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    if (!writer_reserve(w)) PALMA_RETURN_ERROR(w->err);
+
+    char *p = w->buf + w->len;
+    p += format_u64(p, row);
+    *p++ = ',';
+    p += format_u64(p, col);
+    *p++ = ',';
+    p += format_value(p, val);
+    *p++ = '\n';
+    w->len = (size_t)(p - w->buf);
+    w->written++;
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_writer_write_sparse(palma_writer_t *w, const palma_sparse_t *sp,
+                                        size_t first_row) {
+    if (!w || !sp) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (w->kind != STREAM_EDGES) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (sp->cols > w->cols || first_row > w->rows || sp->rows > w->rows - first_row) {
+        PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+    }
+
+    for (size_t i = 0; i < sp->rows; i++) {
+        for (palma_ptr_t k = sp->row_ptr[i]; k < sp->row_ptr[i + 1]; k++) {
+            palma_error_t err = palma_writer_write_edge(w, first_row + i, sp->col_idx[k], sp->values[k]);
+            if (err != PALMA_SUCCESS) return err;
+        }
+    }
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_writer_close(palma_writer_t *w) {
+    if (!w) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+
+    palma_error_t err = writer_flush(w);
+
+    if (err == PALMA_SUCCESS && w->kind == STREAM_EDGES && w->expected == PALMA_STREAM_UNKNOWN) {
+        char count[STREAM_COUNT_WIDTH + 1];
+        size_t n = format_u64(count, w->written);
+        if (fseek(w->fp, w->count_at, SEEK_SET) != 0 || fwrite(count, 1, n, w->fp) != n) {
+            err = PALMA_ERR_FILE_WRITE;
+        }
+    }
+    if (fclose(w->fp) != 0 && err == PALMA_SUCCESS) err = PALMA_ERR_FILE_WRITE;
+
+    /* A short file is still closed, but reported */
+    if (err == PALMA_SUCCESS) {
+        if (w->kind == STREAM_EDGES) {
+            if (w->expected != PALMA_STREAM_UNKNOWN && w->written != w->expected) {
+                err = PALMA_ERR_INVALID_DIM;
+            }
+        } else if (w->written != w->rows) {
+            err = PALMA_ERR_INVALID_DIM;
+        }
+    }
+
+    free(w->buf);
+    free(w);
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * READERS
+ *============================================================================*/
+
+struct palma_reader {
+    FILE *fp;
+    stream_kind_t kind;
+    char *buf;
+    size_t cap;             /* Buffer size; grows to hold the longest line */
+    size_t pos;
+    size_t end;
+    bool eof;
+
+    char *pending;          /* Line read ahead while opening */
+
+    size_t rows;
+    size_t cols;
+    size_t nnz;             /* Edge lists: count from the header */
+    size_t read;            /* Rows read so far (matrices) */
+};
+
+/*
+ * Next line, NUL-terminated in place with the newline (and any '\r')
+ * removed. Returns NULL at end of file, with *err set on failure.
+ */
+static char* reader_line(palma_reader_t *r, palma_error_t *err) {
+    if (r->pending) {
+        char *line = r->pending;
+        r->pending = NULL;
+        return line;
+    }
+
+    for (;;) {
+        char *nl = (char*)memchr(r->buf + r->pos, '\n', r->end - r->pos);
+        if (nl || (r->eof && r->pos < r->end)) {
+            char *line = r->buf + r->pos;
+            char *stop = nl ? nl : r->buf + r->end;
+            r->pos = (size_t)(stop - r->buf) + (nl ? 1 : 0);
+            *stop = '\0';
+            if (stop > line && stop[-1] == '\r') stop[-1] = '\0';
+            return line;
+        }
+        if (r->eof) return NULL;
+
+        /* Keep the partial line, growing the buffer if it fills it */
+        size_t tail = r->end - r->pos;
+        if (r->pos > 0) {
+            memmove(r->buf, r->buf + r->pos, tail);
+            r->pos = 0;
+            r->end = tail;
+        } else if (tail == r->cap) {
+            char *grown = (char*)realloc(r->buf, r->cap * 2 + 1);
+            if (!grown) {
+                *err = PALMA_ERR_OUT_OF_MEMORY;
+                return NULL;
+            }
+            r->buf = grown;
+            r->cap *= 2;
+        }
+
+        /* One byte past cap is kept free for the terminator of a last line */
+        size_t got = fread(r->buf + r->end, 1, r->cap - r->end, r->fp);
+        r->end += got;
+        if (got == 0) {
+            if (ferror(r->fp)) {
+                *err = PALMA_ERR_FILE_READ;
+                return NULL;
+            }
+            r->eof = true;
+        }
+    }
+}
+
+/* Data lines skip comments and blank lines */
+static char* reader_data_line(palma_reader_t *r, palma_error_t *err) {
+    char *line;
+    while ((line = reader_line(r, err)) != NULL) {
+        while (*line == ' ' || *line == '\t') line++;
+        if (*line != '#' && *line != '\0') break;
+    }
+    return line;
+}
+
+static const char* skip_blanks(const char *p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static bool parse_u64(const char **s, uint64_t *out) {
+    const char *p = skip_blanks(*s);
+    if (*p < '0' || *p > '9') return false;
+
+    uint64_t x = 0;
+    for (; *p >= '0' && *p <= '9'; p++) {
+        unsigned d = (unsigned)(*p - '0');
+        if (x > (UINT64_MAX - d) / 10) return false;
+        x = x * 10 + d;
+    }
+    *s = skip_blanks(p);
+    *out = x;
+    return true;
+}
+
+/* Integer or ±inf, as accepted by palma_matrix_load_csv */
+static bool parse_value(const char **s, palma_val_t *out) {
+    const char *p = skip_blanks(*s);
+    bool neg = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+
+    if ((p[0] == 'i' || p[0] == 'I') && p[1] == 'n' && p[2] == 'f') {
+        *out = neg ? PALMA_NEG_INF : PALMA_POS_INF;
+        *s = skip_blanks(p + 3);
+        return true;
+    }
+
+    uint64_t x;
+    if (!parse_u64(&p, &x) || x > (uint64_t)INT32_MAX + neg) return false;
+    *out = (palma_val_t)(neg ? -(int64_t)x : (int64_t)x);
+    *s = p;
+    return true;
+}
+
+static palma_reader_t* reader_open(const char *filename, const char *mode) {
+    palma_reader_t *r = (palma_reader_t*)calloc(1, sizeof(palma_reader_t));
+    if (!r) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    r->cap = PALMA_STREAM_BUFFER;
+    r->buf = (char*)malloc(r->cap + 1);
+    if (!r->buf) {
+        free(r);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    r->fp = fopen(filename, mode);
+    if (!r->fp) {
+        free(r->buf);
+        free(r);
+        PALMA_RETURN_NULL(PALMA_ERR_FILE_OPEN);
+    }
+    return r;
+}
+
+static palma_reader_t* reader_fail(palma_reader_t *r, palma_error_t err) {
+    palma_reader_close(r);
+    PALMA_RETURN_NULL(err);
+}
+
+/*
+ * Matrix CSV without a "# PALMA matrix" header: count the data lines after
+ * the current one, then start again from the first.
+ */
+static palma_error_t reader_count_rows(palma_reader_t *r) {
+    palma_error_t err = PALMA_SUCCESS;
+    size_t rows = 1;
+
+    while (reader_data_line(r, &err)) rows++;
+    if (err != PALMA_SUCCESS) return err;
+
+    rewind(r->fp);
+    r->pos = r->end = 0;
+    r->eof = false;
+    r->rows = rows;
+    r->pending = reader_data_line(r, &err);
+    return err;
+}
+
+palma_reader_t* palma_reader_open_matrix(const char *filename) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    palma_reader_t *r = reader_open(filename, "rb");
+    if (!r) return NULL;
+
+    uint32_t header[4];
+    if (fread(header, sizeof(uint32_t), 4, r->fp) == 4 && header[0] == PALMA_BINARY_MAGIC) {
+        if (header[2] == 0 || header[3] == 0) return reader_fail(r, PALMA_ERR_FILE_FORMAT);
+        r->kind = STREAM_MATRIX_BINARY;
+        r->rows = header[2];
+        r->cols = header[3];
+        return r;
+    }
+    rewind(r->fp);
+    r->kind = STREAM_MATRIX_CSV;
+
+    /* Header comment gives the shape; otherwise rows are counted */
+    palma_error_t err = PALMA_SUCCESS;
+    char *line;
+    static const char tag[] = "# PALMA matrix ";
+    while ((line = reader_line(r, &err)) != NULL) {
+        /* Digits only: sscanf's %zu would take "-1" as SIZE_MAX */
+        const char *q = line + sizeof(tag) - 1;
+        uint64_t rows, cols;
+        if (strncmp(line, tag, sizeof(tag) - 1) == 0 && parse_u64(&q, &rows) && *q++ == 'x' &&
+            parse_u64(&q, &cols) && rows <= SIZE_MAX && cols <= SIZE_MAX) {
+            r->rows = (size_t)rows;
+            r->cols = (size_t)cols;
+        }
+        const char *p = skip_blanks(line);
+        if (*p != '#' && *p != '\0') break;
+    }
+    if (err != PALMA_SUCCESS) return reader_fail(r, err);
+    if (!line) return reader_fail(r, PALMA_ERR_FILE_FORMAT);
+
+    size_t cols = 1;
+    for (const char *p = line; *p; p++) cols += (*p == ',');
+    if (r->cols != 0 && r->cols != cols) return reader_fail(r, PALMA_ERR_FILE_FORMAT);
+    r->cols = cols;
+
+    if (r->rows == 0) {
+        err = reader_count_rows(r);
+        if (err != PALMA_SUCCESS) return reader_fail(r, err);
+    } else {
+        r->pending = line;
+    }
+    return r;
+}
+
+palma_reader_t* palma_reader_open_edges(const char *filename) {
+    if (!filename) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    palma_reader_t *r = reader_open(filename, "r");
+    if (!r) return NULL;
+    r->kind = STREAM_EDGES;
+
+    palma_error_t err = PALMA_SUCCESS;
+    char *line = reader_data_line(r, &err);
+    if (err != PALMA_SUCCESS) return reader_fail(r, err);
+
+    const char *p = line;
+    uint64_t rows, cols, nnz;
+    if (!line || !parse_u64(&p, &rows) || *p++ != ',' || !parse_u64(&p, &cols) ||
+        *p++ != ',' || !parse_u64(&p, &nnz) || *p != '\0' || rows == 0 || cols == 0) {
+        return reader_fail(r, PALMA_ERR_FILE_FORMAT);
+    }
+    /* Columns are returned as palma_idx_t; a wider file would be truncated */
+    if (cols - 1 > PALMA_IDX_MAX) return reader_fail(r, PALMA_ERR_OVERFLOW);
+
+    r->rows = (size_t)rows;
+    r->cols = (size_t)cols;
+    r->nnz = (size_t)nnz;
+    return r;
+}
+
+palma_error_t palma_reader_shape(const palma_reader_t *r, size_t *rows, size_t *cols) {
+    if (!r || !rows || !cols) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    *rows = r->rows;
+    *cols = r->cols;
+    return PALMA_SUCCESS;
+}
+
+size_t palma_reader_edge_count(const palma_reader_t *r) {
+    return (r && r->kind == STREAM_EDGES) ? r->nnz : 0;
+}
+
+palma_error_t palma_reader_read_rows(palma_reader_t *r, palma_matrix_t *block, size_t *n_read) {
+    if (!r || !block || !n_read) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    *n_read = 0;
+    if (r->kind == STREAM_EDGES) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+    if (block->cols != r->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    size_t want = block->rows < r->rows - r->read ? block->rows : r->rows - r->read;
+
+    for (size_t i = 0; i < want; i++) {
+        palma_val_t *row = block->data + i * block->stride;
+
+        if (r->kind == STREAM_MATRIX_BINARY) {
+            if (fread(row, sizeof(palma_val_t), r->cols, r->fp) != r->cols) {
+                PALMA_RETURN_ERROR(ferror(r->fp) ? PALMA_ERR_FILE_READ : PALMA_ERR_FILE_FORMAT);
+            }
+        } else {
+            palma_error_t err = PALMA_SUCCESS;
+            const char *p = reader_data_line(r, &err);
+            if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+            if (!p) PALMA_RETURN_ERROR(PALMA_ERR_FILE_FORMAT);
+
+            for (size_t j = 0; j < r->cols; j++) {
+                if (!parse_value(&p, &row[j]) || *p != (j + 1 < r->cols ? ',' : '\0')) {
+                    PALMA_RETURN_ERROR(PALMA_ERR_FILE_FORMAT);
+                }
+                p++;
+            }
+        }
+        r->read++;
+        (*n_read)++;
+    }
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_reader_read_edges(palma_reader_t *r, size_t *rows, palma_idx_t *cols,
+                                      palma_val_t *values, size_t max, size_t *n_read) {
+    if (!r || !rows || !cols || !values || !n_read) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    *n_read = 0;
+    if (r->kind != STREAM_EDGES) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_ARG);
+
+    palma_error_t err = PALMA_SUCCESS;
+    while (*n_read < max) {
+        const char *p = reader_data_line(r, &err);
+        if (!p) break;
+
+        uint64_t i, j;
+        palma_val_t v;
+        if (!parse_u64(&p, &i) || *p++ != ',' || !parse_u64(&p, &j) || *p++ != ',' ||
+            !parse_value(&p, &v) || *p != '\0') {
+            PALMA_RETURN_ERROR(PALMA_ERR_FILE_FORMAT);
+        }
+        if (i >= r->rows || j >= r->cols) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+        rows[*n_read] = (size_t)i;
+        cols[*n_read] = (palma_idx_t)j;
+        values[*n_read] = v;
+        (*n_read)++;
+    }
+    if (err != PALMA_SUCCESS) PALMA_RETURN_ERROR(err);
+    return PALMA_SUCCESS;
+}
+
+void palma_reader_close(palma_reader_t *r) {
+    if (!r) return;
+    fclose(r->fp);
+    free(r->buf);
+    free(r);
+}
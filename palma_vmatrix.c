@@ -0,0 +1,404 @@
+/**
+ * @file palma_vmatrix.c
+ * @brief PALMA Versioned Matrices - copy-on-write tiles and lock-free snapshots
+ *
+ * A version is an immutable grid of reference-counted tiles. Writers build
+ * the next version by copying only the tiles they modify, then swap the
+ * current-version pointer. Readers pin a version by incrementing its
+ * reference count.
+ *
+ * The only delicate step is the gap between a reader loading the pointer
+ * and incrementing the count, during which a writer could drop the last
+ * reference. Readers announce that window on one of two counters selected
+ * by an epoch parity; after swapping the pointer a writer flips the epoch
+ * and waits for the counter of the previous parity to drain, then does the
+ * same for the other parity, since a reader that sampled the parity before
+ * an earlier commit registers on the stale counter. New readers register
+ * on the counter not being drained, so the wait is bounded by the
+ * acquisitions already in flight (a handful of instructions each), as in
+ * SRCU.
+ *
+ * @author Gnankan Landry Regis N'guessan
+ *         Axiom Research Group
+ *         Department of Applied Mathematics and Computational Science,
+ *         The Nelson Mandela African Institution of Science and Technology (NM-AIST),
+ *         Arusha, Tanzania
+ *         African Institute for Mathematical Sciences (AIMS),
+ *         Research and Innovation Centre (RIC), Kigali, Rwanda
+ * @email  rnguessan@aimsric.org
+ *
+ * @version 1.0.0
+ * @date    2024
+ * @license MIT
+ *
+ * @copyright Copyright (c) 2024 Gnankan Landry Regis N'guessan
+ *            All rights reserved.
+ */
+
+#define _GNU_SOURCE
+
+#include "palma.h"
+#include "palma_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*============================================================================
+ * TYPES
+ *============================================================================*/
+
+#define VMATRIX_MAX_TILE 4096
+
+typedef struct {
+    size_t refs;                /* Versions that contain this tile */
+    palma_val_t data[];         /* tile × tile, row-major */
+} vtile_t;
+
+struct palma_vsnapshot {
+    size_t refs;
+    uint64_t version;
+    size_t rows;
+    size_t cols;
+    unsigned shift;             /* log2(tile) */
+    size_t tile_cols;           /* Tiles per tile row */
+    size_t n_tiles;
+    vtile_t **tiles;            /* Allocated with the snapshot */
+};
+
+/* Keep the two reader counters on separate cache lines */
+typedef struct {
+    size_t count;
+    char pad[64 - sizeof(size_t)];
+} reader_count_t;
+
+struct palma_vmatrix {
+    palma_vsnapshot_t *current;
+    reader_count_t readers[2];
+    unsigned epoch;
+    uint64_t version;
+    pthread_mutex_t write_lock;
+    size_t rows;
+    size_t cols;
+    size_t tile;
+    unsigned shift;
+    size_t tile_rows;
+    size_t tile_cols;
+};
+
+struct palma_vmatrix_edit {
+    palma_vmatrix_t *vm;
+    palma_vsnapshot_t *base;
+    vtile_t **tiles;
+    unsigned char *owned;       /* Tile is a private copy made by this edit */
+    size_t changed;
+};
+
+/*============================================================================
+ * TILES AND SNAPSHOTS
+ *============================================================================*/
+
+static vtile_t* tile_alloc(size_t tile) {
+    vtile_t *t = (vtile_t*)malloc(sizeof(vtile_t) + tile * tile * sizeof(palma_val_t));
+    if (t) t->refs = 1;
+    return t;
+}
+
+static void tile_release(vtile_t *t) {
+    if (__atomic_sub_fetch(&t->refs, 1, __ATOMIC_ACQ_REL) == 0) free(t);
+}
+
+static palma_vsnapshot_t* snapshot_alloc(const palma_vmatrix_t *vm, uint64_t version) {
+    size_t n = vm->tile_rows * vm->tile_cols;
+    palma_vsnapshot_t *s = (palma_vsnapshot_t*)malloc(sizeof(palma_vsnapshot_t) + n * sizeof(vtile_t*));
+    if (!s) return NULL;
+    s->refs = 1;
+    s->version = version;
+    s->rows = vm->rows;
+    s->cols = vm->cols;
+    s->shift = vm->shift;
+    s->tile_cols = vm->tile_cols;
+    s->n_tiles = n;
+    s->tiles = (vtile_t**)(s + 1);
+    return s;
+}
+
+void palma_vsnapshot_release(const palma_vsnapshot_t *snap) {
+    if (!snap) return;
+    palma_vsnapshot_t *s = (palma_vsnapshot_t*)snap;
+    if (__atomic_sub_fetch(&s->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+
+    for (size_t t = 0; t < s->n_tiles; t++) tile_release(s->tiles[t]);
+    free(s);
+}
+
+uint64_t palma_vsnapshot_version(const palma_vsnapshot_t *snap) {
+    return snap ? snap->version : 0;
+}
+
+void palma_vsnapshot_shape(const palma_vsnapshot_t *snap, size_t *rows, size_t *cols) {
+    if (rows) *rows = snap ? snap->rows : 0;
+    if (cols) *cols = snap ? snap->cols : 0;
+}
+
+palma_val_t palma_vsnapshot_get(const palma_vsnapshot_t *snap, size_t i, size_t j) {
+    size_t mask = ((size_t)1 << snap->shift) - 1;
+    const vtile_t *t = snap->tiles[(i >> snap->shift) * snap->tile_cols + (j >> snap->shift)];
+    return t->data[((i & mask) << snap->shift) + (j & mask)];
+}
+
+palma_error_t palma_vsnapshot_copy_into(palma_matrix_t *out, const palma_vsnapshot_t *snap) {
+    if (!out || !snap) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (out->rows != snap->rows || out->cols != snap->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    size_t tile = (size_t)1 << snap->shift;
+    for (size_t i = 0; i < snap->rows; i++) {
+        const vtile_t *const *row = (const vtile_t *const *)snap->tiles + (i >> snap->shift) * snap->tile_cols;
+        size_t r = (i & (tile - 1)) << snap->shift;
+        palma_val_t *dst = out->data + i * out->stride;
+        for (size_t tj = 0, j = 0; j < snap->cols; tj++, j += tile) {
+            size_t w = (snap->cols - j < tile) ? snap->cols - j : tile;
+            memcpy(dst + j, row[tj]->data + r, w * sizeof(palma_val_t));
+        }
+    }
+    return PALMA_SUCCESS;
+}
+
+/*============================================================================
+ * LIFECYCLE AND READERS
+ *============================================================================*/
+
+palma_vmatrix_t* palma_vmatrix_create(const palma_matrix_t *initial, size_t tile) {
+    if (!initial || !initial->data) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+    if (tile == 0) tile = PALMA_VMATRIX_TILE;
+    if ((tile & (tile - 1)) != 0 || tile > VMATRIX_MAX_TILE) PALMA_RETURN_NULL(PALMA_ERR_INVALID_ARG);
+
+    palma_vmatrix_t *vm = (palma_vmatrix_t*)calloc(1, sizeof(palma_vmatrix_t));
+    if (!vm) PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+
+    vm->rows = initial->rows;
+    vm->cols = initial->cols;
+    vm->tile = tile;
+    while (((size_t)1 << vm->shift) < tile) vm->shift++;
+    vm->tile_rows = (vm->rows + tile - 1) / tile;
+    vm->tile_cols = (vm->cols + tile - 1) / tile;
+    vm->version = 1;
+    pthread_mutex_init(&vm->write_lock, NULL);
+
+    palma_vsnapshot_t *s = snapshot_alloc(vm, 1);
+    if (!s) {
+        pthread_mutex_destroy(&vm->write_lock);
+        free(vm);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    size_t n = vm->tile_rows * vm->tile_cols;
+    for (size_t t = 0; t < n; t++) {
+        s->tiles[t] = tile_alloc(tile);
+        if (!s->tiles[t]) {
+            while (t-- > 0) free(s->tiles[t]);
+            free(s);
+            pthread_mutex_destroy(&vm->write_lock);
+            free(vm);
+            PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+        }
+
+        /* Padding beyond the last row/column is never read; keep it defined */
+        size_t i0 = (t / vm->tile_cols) * tile, j0 = (t % vm->tile_cols) * tile;
+        palma_val_t *d = s->tiles[t]->data;
+        for (size_t k = 0; k < tile * tile; k++) d[k] = PALMA_NEG_INF;
+        for (size_t i = i0; i < i0 + tile && i < vm->rows; i++) {
+            size_t w = (vm->cols - j0 < tile) ? vm->cols - j0 : tile;
+            memcpy(d + (i - i0) * tile, initial->data + i * initial->stride + j0, w * sizeof(palma_val_t));
+        }
+    }
+
+    vm->current = s;
+    return vm;
+}
+
+void palma_vmatrix_destroy(palma_vmatrix_t *vm) {
+    if (!vm) return;
+    palma_vsnapshot_release(vm->current);
+    pthread_mutex_destroy(&vm->write_lock);
+    free(vm);
+}
+
+const palma_vsnapshot_t* palma_vmatrix_snapshot(palma_vmatrix_t *vm) {
+    if (!vm) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    unsigned e = __atomic_load_n(&vm->epoch, __ATOMIC_SEQ_CST) & 1;
+    __atomic_add_fetch(&vm->readers[e].count, 1, __ATOMIC_SEQ_CST);
+    palma_vsnapshot_t *s = __atomic_load_n(&vm->current, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&s->refs, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&vm->readers[e].count, 1, __ATOMIC_RELEASE);
+    return s;
+}
+
+uint64_t palma_vmatrix_version(const palma_vmatrix_t *vm) {
+    return vm ? __atomic_load_n(&vm->version, __ATOMIC_ACQUIRE) : 0;
+}
+
+/* Called with write_lock held */
+static void install(palma_vmatrix_t *vm, palma_vsnapshot_t *s) {
+    palma_vsnapshot_t *old = __atomic_exchange_n(&vm->current, s, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&vm->version, s->version, __ATOMIC_RELEASE);
+
+    /* Grace period: wait out readers that may have loaded `old` unpinned.
+     * A reader can sample the parity before one commit and register after
+     * it, so it may sit on either counter: drain both, one flip each. */
+    for (int pass = 0; pass < 2; pass++) {
+        unsigned e = __atomic_fetch_add(&vm->epoch, 1, __ATOMIC_SEQ_CST) & 1;
+        while (__atomic_load_n(&vm->readers[e].count, __ATOMIC_ACQUIRE) != 0) sched_yield();
+    }
+
+    palma_vsnapshot_release(old);
+}
+
+/*============================================================================
+ * WRITERS
+ *============================================================================*/
+
+palma_vmatrix_edit_t* palma_vmatrix_begin(palma_vmatrix_t *vm) {
+    if (!vm) PALMA_RETURN_NULL(PALMA_ERR_NULL_PTR);
+
+    size_t n = vm->tile_rows * vm->tile_cols;
+    palma_vmatrix_edit_t *edit = (palma_vmatrix_edit_t*)malloc(sizeof(palma_vmatrix_edit_t));
+    vtile_t **tiles = (vtile_t**)malloc(n * sizeof(vtile_t*));
+    unsigned char *owned = (unsigned char*)calloc(n, 1);
+    if (!edit || !tiles || !owned) {
+        free(edit);
+        free(tiles);
+        free(owned);
+        PALMA_RETURN_NULL(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    pthread_mutex_lock(&vm->write_lock);
+
+    /* The current version cannot change while we hold the lock */
+    edit->vm = vm;
+    edit->base = vm->current;
+    edit->tiles = tiles;
+    edit->owned = owned;
+    edit->changed = 0;
+    memcpy(tiles, edit->base->tiles, n * sizeof(vtile_t*));
+    return edit;
+}
+
+/* Make tile t private to the edit */
+static vtile_t* edit_own(palma_vmatrix_edit_t *edit, size_t t) {
+    if (edit->owned[t]) return edit->tiles[t];
+
+    size_t tile = edit->vm->tile;
+    vtile_t *copy = tile_alloc(tile);
+    if (!copy) return NULL;
+    memcpy(copy->data, edit->tiles[t]->data, tile * tile * sizeof(palma_val_t));
+    edit->tiles[t] = copy;
+    edit->owned[t] = 1;
+    edit->changed++;
+    return copy;
+}
+
+palma_error_t palma_vmatrix_edit_set(palma_vmatrix_edit_t *edit, size_t i, size_t j,
+                                     palma_val_t value) {
+    if (!edit) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    palma_vmatrix_t *vm = edit->vm;
+    if (i >= vm->rows || j >= vm->cols) PALMA_RETURN_ERROR(PALMA_ERR_INDEX_BOUNDS);
+
+    size_t t = (i >> vm->shift) * vm->tile_cols + (j >> vm->shift);
+    size_t off = ((i & (vm->tile - 1)) << vm->shift) + (j & (vm->tile - 1));
+
+    /* Writing the value already there leaves the tile shared */
+    if (!edit->owned[t] && edit->tiles[t]->data[off] == value) return PALMA_SUCCESS;
+
+    vtile_t *tile = edit_own(edit, t);
+    if (!tile) PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    tile->data[off] = value;
+    return PALMA_SUCCESS;
+}
+
+palma_val_t palma_vmatrix_edit_get(const palma_vmatrix_edit_t *edit, size_t i, size_t j) {
+    const palma_vmatrix_t *vm = edit->vm;
+    size_t t = (i >> vm->shift) * vm->tile_cols + (j >> vm->shift);
+    return edit->tiles[t]->data[((i & (vm->tile - 1)) << vm->shift) + (j & (vm->tile - 1))];
+}
+
+static void edit_free(palma_vmatrix_edit_t *edit) {
+    pthread_mutex_unlock(&edit->vm->write_lock);
+    free(edit->tiles);
+    free(edit->owned);
+    free(edit);
+}
+
+void palma_vmatrix_abort(palma_vmatrix_edit_t *edit) {
+    if (!edit) return;
+    size_t n = edit->vm->tile_rows * edit->vm->tile_cols;
+    for (size_t t = 0; t < n; t++) {
+        if (edit->owned[t]) free(edit->tiles[t]);
+    }
+    edit_free(edit);
+}
+
+palma_error_t palma_vmatrix_commit(palma_vmatrix_edit_t *edit, uint64_t *version) {
+    if (!edit) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    palma_vmatrix_t *vm = edit->vm;
+
+    if (edit->changed == 0) {
+        if (version) *version = edit->base->version;
+        palma_vmatrix_abort(edit);
+        return PALMA_SUCCESS;
+    }
+
+    palma_vsnapshot_t *s = snapshot_alloc(vm, edit->base->version + 1);
+    if (!s) {
+        palma_vmatrix_abort(edit);
+        PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+    }
+
+    /* Shared tiles gain a reference; the base version keeps them alive meanwhile */
+    size_t n = vm->tile_rows * vm->tile_cols;
+    for (size_t t = 0; t < n; t++) {
+        s->tiles[t] = edit->tiles[t];
+        if (!edit->owned[t]) __atomic_add_fetch(&s->tiles[t]->refs, 1, __ATOMIC_RELAXED);
+    }
+
+    install(vm, s);
+    if (version) *version = s->version;
+    edit_free(edit);
+    return PALMA_SUCCESS;
+}
+
+palma_error_t palma_vmatrix_publish(palma_vmatrix_t *vm, const palma_matrix_t *M,
+                                    uint64_t *version) {
+    if (!vm || !M || !M->data) PALMA_RETURN_ERROR(PALMA_ERR_NULL_PTR);
+    if (M->rows != vm->rows || M->cols != vm->cols) PALMA_RETURN_ERROR(PALMA_ERR_INVALID_DIM);
+
+    palma_vmatrix_edit_t *edit = palma_vmatrix_begin(vm);
+    if (!edit) return palma_get_last_error();
+
+    size_t tile = vm->tile;
+    for (size_t t = 0; t < vm->tile_rows * vm->tile_cols; t++) {
+        size_t i0 = (t / vm->tile_cols) * tile, j0 = (t % vm->tile_cols) * tile;
+        size_t h = (vm->rows - i0 < tile) ? vm->rows - i0 : tile;
+        size_t w = (vm->cols - j0 < tile) ? vm->cols - j0 : tile;
+
+        const palma_val_t *cur = edit->tiles[t]->data;
+        size_t i = 0;
+        while (i < h && memcmp(cur + i * tile, M->data + (i0 + i) * M->stride + j0,
+                               w * sizeof(palma_val_t)) == 0) {
+            i++;
+        }
+        if (i == h) continue;
+
+        vtile_t *own = edit_own(edit, t);
+        if (!own) {
+            palma_vmatrix_abort(edit);
+            PALMA_RETURN_ERROR(PALMA_ERR_OUT_OF_MEMORY);
+        }
+        for (; i < h; i++) {
+            memcpy(own->data + i * tile, M->data + (i0 + i) * M->stride + j0, w * sizeof(palma_val_t));
+        }
+    }
+
+    return palma_vmatrix_commit(edit, version);
+}